@@ -1852,6 +1852,68 @@ struct WaveAudioFormatTests : public UnitTest
             expect (reader != nullptr);
             expect (reader->metadataValues == metadataValues, "Somehow, the metadata is different!");
         }
+
+        {
+            beginTest ("Recording and reading a file asynchronously");
+
+            TemporaryFile temp (".wav");
+            AsyncFileIO io;
+            TimeSliceThread thread ("Wave test writer");
+            thread.startThread();
+
+            const int numSamples = 200000;
+            AudioSampleBuffer source (numTestAudioBufferChannels, numSamples);
+            auto random = getRandom();
+
+            for (int chan = 0; chan < source.getNumChannels(); ++chan)
+                for (int i = 0; i < numSamples; ++i)
+                    source.setSample (chan, i, random.nextFloat() * 2.0f - 1.0f);
+
+            {
+                auto* writer = format.createAsyncWriterFor (temp.getFile(), io, 44100.0, numTestAudioBufferChannels,
+                                                            32, StringPairArray(), 0);
+                expect (writer != nullptr);
+
+                AudioFormatWriter::ThreadedWriter threadedWriter (writer, thread, 16384);
+
+                for (int pos = 0; pos < numSamples;)
+                {
+                    auto num = jmin (1000, numSamples - pos);
+                    const float* channels[] = { source.getReadPointer (0, pos), source.getReadPointer (1, pos) };
+
+                    if (threadedWriter.write (channels, num))
+                        pos += num;
+                    else
+                        Thread::sleep (1);
+                }
+            }
+
+            thread.stopThread (1000);
+
+            AudioFormatManager manager;
+            manager.registerFormat (new WavAudioFormat(), true);
+
+            ScopedPointer<AudioFormatReader> reader (manager.createReaderFor (temp.getFile(), io));
+            expect (reader != nullptr);
+            expectEquals (reader->lengthInSamples, (int64) numSamples);
+
+            AudioSampleBuffer readBack (numTestAudioBufferChannels, numSamples);
+            readBack.clear();
+
+            // read the whole file in order, and then some random sections of it
+            reader->read (&readBack, 0, numSamples, 0, true, true);
+            expect (samplesMatch (source, readBack, 0, numSamples));
+
+            for (int i = 0; i < 20; ++i)
+            {
+                auto start = random.nextInt (numSamples);
+                auto num = random.nextInt (jmin (20000, numSamples - start) + 1);
+
+                readBack.clear();
+                reader->read (&readBack, start, num, start, true, true);
+                expect (samplesMatch (source, readBack, start, num));
+            }
+        }
     }
 
 private:
@@ -1861,6 +1923,16 @@ private:
         numTestAudioBufferSamples = 256
     };
 
+    static bool samplesMatch (const AudioSampleBuffer& a, const AudioSampleBuffer& b, int start, int num)
+    {
+        for (int chan = 0; chan < a.getNumChannels(); ++chan)
+            for (int i = start; i < start + num; ++i)
+                if (std::abs (a.getSample (chan, i) - b.getSample (chan, i)) > 1.0e-6f)
+                    return false;
+
+        return true;
+    }
+
     StringPairArray createDefaultSMPLMetadata() const
     {
         StringPairArray m;
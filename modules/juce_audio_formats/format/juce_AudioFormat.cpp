@@ -89,4 +89,32 @@ AudioFormatWriter* AudioFormat::createWriterFor (OutputStream* streamToWriteTo,
     return nullptr;
 }
 
+AudioFormatWriter* AudioFormat::createAsyncWriterFor (const File& file,
+                                                      AsyncFileIO& io,
+                                                      double sampleRateToUse,
+                                                      unsigned int numberOfChannels,
+                                                      int bitsPerSample,
+                                                      const StringPairArray& metadataValues,
+                                                      int qualityOptionIndex)
+{
+    if (! file.deleteFile())
+        return nullptr;
+
+    ScopedPointer<AsyncFileOutputStream> out (new AsyncFileOutputStream (file, io));
+
+    if (out->openedOk())
+    {
+        if (auto* w = createWriterFor (out, sampleRateToUse, numberOfChannels,
+                                       bitsPerSample, metadataValues, qualityOptionIndex))
+        {
+            out.release();
+            return w;
+        }
+    }
+
+    out = nullptr;
+    file.deleteFile();
+    return nullptr;
+}
+
 } // namespace juce
@@ -192,6 +192,30 @@ public:
                                                 const StringPairArray& metadataValues,
                                                 int qualityOptionIndex);
 
+    /** Tries to create an object that writes a new file with this audio format, using an
+        AsyncFileOutputStream so that the thread which writes to it doesn't have to wait
+        for the disk.
+
+        This is handy when combined with an AudioFormatWriter::ThreadedWriter, as it allows
+        a single background thread to keep up with many recordings at once.
+
+        If the file already exists, it'll be replaced. If it can't be opened, or a writer
+        can't be created with these settings, this will return nullptr. The other parameters
+        have the same meaning as for createWriterFor().
+
+        @param fileToWriteTo    the file to create
+        @param ioToUse          the AsyncFileIO object that will do the writing - this must
+                                not be deleted before the writer that is returned
+        @see createWriterFor, AsyncFileOutputStream
+    */
+    AudioFormatWriter* createAsyncWriterFor (const File& fileToWriteTo,
+                                             AsyncFileIO& ioToUse,
+                                             double sampleRateToUse,
+                                             unsigned int numberOfChannels,
+                                             int bitsPerSample,
+                                             const StringPairArray& metadataValues,
+                                             int qualityOptionIndex);
+
 protected:
     /** Creates an AudioFormat object.
 
@@ -133,6 +133,32 @@ AudioFormatReader* AudioFormatManager::createReaderFor (const File& file)
     return nullptr;
 }
 
+AudioFormatReader* AudioFormatManager::createReaderFor (const File& file, AsyncFileIO& io)
+{
+    // you need to actually register some formats before the manager can
+    // use them to open a file!
+    jassert (getNumKnownFormats() > 0);
+
+    for (auto* af : knownFormats)
+    {
+        if (af->canHandleFile (file))
+        {
+            ScopedPointer<AsyncFileInputStream> in (new AsyncFileInputStream (file, io));
+
+            if (in->openedOk())
+            {
+                if (auto* r = af->createReaderFor (in, false))
+                {
+                    in.release();
+                    return r;
+                }
+            }
+        }
+    }
+
+    return nullptr;
+}
+
 AudioFormatReader* AudioFormatManager::createReaderFor (InputStream* audioFileStream)
 {
     // you need to actually register some formats before the manager can
@@ -118,6 +118,21 @@ public:
     */
     AudioFormatReader* createReaderFor (const File& audioFile);
 
+    /** Searches through the known formats to try to create a suitable reader for
+        this file, reading it through an AsyncFileInputStream.
+
+        The stream fetches the file's data in the background ahead of the position
+        being read, so reading sequentially through the file won't often have to
+        wait for the disk.
+
+        The AsyncFileIO object must not be deleted until the reader that is returned
+        has been. If none of the registered formats can open the file, it'll return
+        nullptr. It's the caller's responsibility to delete the reader that is returned.
+
+        @see AsyncFileInputStream
+    */
+    AudioFormatReader* createReaderFor (const File& audioFile, AsyncFileIO& ioToUse);
+
     /** Searches through the known formats to try to create a suitable reader for
         this stream.
 
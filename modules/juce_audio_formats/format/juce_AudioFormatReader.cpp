@@ -417,4 +417,46 @@ void MemoryMappedAudioFormatReader::touchSample (int64 sample) const noexcept
         jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
 }
 
+int64 MemoryMappedAudioFormatReader::touchSamples (Range<int64> samples) const noexcept
+{
+    if (map == nullptr || ! mappedSection.contains (samples))
+    {
+        jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+        return 0;
+    }
+
+    if (samples.isEmpty())
+        return 0;
+
+    auto faultsBefore = MemoryMappedFile::getPageFaultCounts();
+
+    auto* start = static_cast<const char*> (sampleToPointer (samples.getStart()));
+    auto* end = static_cast<const char*> (sampleToPointer (samples.getEnd()));
+    auto pageSize = (size_t) SystemStats::getPageSize();
+    int total = 0;
+
+    for (auto* p = start; p < end; p += pageSize)
+        total += *p;
+
+    total += *(end - 1);
+    memoryReadDummyVariable += total;
+
+    return MemoryMappedFile::getPageFaultCounts().numFaults - faultsBefore.numFaults;
+}
+
+bool MemoryMappedAudioFormatReader::prefetchSamples (Range<int64> samples) const noexcept
+{
+    return map != nullptr && map->prefetch ({ sampleToFilePos (samples.getStart()), sampleToFilePos (samples.getEnd()) });
+}
+
+bool MemoryMappedAudioFormatReader::lockSamplesInMemory (Range<int64> samples) noexcept
+{
+    return map != nullptr && map->lockInMemory ({ sampleToFilePos (samples.getStart()), sampleToFilePos (samples.getEnd()) });
+}
+
+bool MemoryMappedAudioFormatReader::unlockSamplesFromMemory (Range<int64> samples) noexcept
+{
+    return map != nullptr && map->unlockFromMemory ({ sampleToFilePos (samples.getStart()), sampleToFilePos (samples.getEnd()) });
+}
+
 } // namespace juce
@@ -178,6 +178,10 @@ public:
     /**
         Provides a FIFO for an AudioFormatWriter, allowing you to push incoming
         data into a buffer which will be flushed to disk by a background thread.
+
+        If the writer was created with AudioFormat::createAsyncWriterFor(), the background
+        thread won't have to wait for the disk either, so a single thread can keep up with
+        many simultaneous recordings.
     */
     class ThreadedWriter
     {
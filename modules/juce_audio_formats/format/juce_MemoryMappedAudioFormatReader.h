@@ -71,6 +71,31 @@ public:
     /** Touches the memory for the given sample, to force it to be loaded into active memory. */
     void touchSample (int64 sample) const noexcept;
 
+    /** Touches the memory for a range of samples, to force it all to be loaded into active memory.
+
+        This blocks until every page in the range has been loaded, so it should be called from a
+        background thread a little ahead of the position that an audio thread is going to read from.
+        The samples must all lie within the mapped section.
+
+        @returns the number of page faults that occurred while doing so, which shows how far ahead
+                 of the reader the loading is (if it's zero, the data was already in memory)
+    */
+    int64 touchSamples (Range<int64> samples) const noexcept;
+
+    /** Asks the OS to start loading a range of samples into memory in the background.
+        Unlike touchSamples(), this returns immediately.
+        @see MemoryMappedFile::prefetch
+    */
+    bool prefetchSamples (Range<int64> samples) const noexcept;
+
+    /** Locks a range of samples into physical memory, so that they can't be paged out.
+        @see MemoryMappedFile::lockInMemory
+    */
+    bool lockSamplesInMemory (Range<int64> samples) noexcept;
+
+    /** Releases a lock that was taken with lockSamplesInMemory(). */
+    bool unlockSamplesFromMemory (Range<int64> samples) noexcept;
+
     /** Returns the samples for all channels at a given sample position.
         The result array must be large enough to hold a value for each channel
         that this reader contains.
@@ -0,0 +1,583 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, using an open-addressed table.
+
+    This has the same interface as HashMap, and can use the same hash function classes,
+    but instead of allocating a separate object for each item and chaining them together,
+    the items are stored directly in a single contiguous array using "Robin Hood" linear
+    probing. This means that adding an item doesn't need any allocation unless the table
+    has to grow, and that looking up a key will usually only touch one or two cache lines,
+    so for big maps it's much faster than a HashMap.
+
+    The trade-off is that the items get moved around when the table grows, or when
+    other items are removed, so unlike a HashMap, references to values that are returned
+    by getReference() or find() are only valid until the map is next modified.
+
+    Items can be looked up using any type that the hash function can hash and that the
+    key type can be compared with, which lets you search a map of String or Identifier
+    keys using a StringRef, without having to create a temporary String:
+
+    @code
+    FlatHashMap<String, int> map;
+    map.set ("one", 1);
+    map.set ("two", 2);
+
+    if (auto* value = map.find (StringRef ("two")))
+        DBG (*value); // prints "2"
+
+    for (FlatHashMap<String, int>::Iterator i (map); i.next();)
+        DBG (i.getKey() << " -> " << i.getValue());
+    @endcode
+
+    @tparam HashFunctionType The class of hash function, which must be copy-constructible.
+                             See the HashMap class for details of its form. This class will
+                             always ask it for a value in the full positive int range and
+                             then mix the bits itself, so simple functions which just return
+                             the key modulo the upper-limit work fine.
+    @see HashMap, DefaultHashFunctions
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = DefaultHashFunctions,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+class FlatHashMap
+{
+private:
+    typedef typename TypeHelpers::ParameterType<KeyType>::type   KeyTypeParameter;
+    typedef typename TypeHelpers::ParameterType<ValueType>::type ValueTypeParameter;
+
+    // Only class types get passed straight through to the hash function when used as keys - anything
+    // else (e.g. a string literal) is converted to the map's own key type, as it would be with a HashMap.
+    template <typename LookupKeyType, typename ResultType>
+    struct LookupResult  : public std::enable_if<std::is_class<LookupKeyType>::value, ResultType> {};
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+
+        @param initialCapacity  the number of items to allocate space for. The map will
+                                grow automatically if necessary, or you can make it allocate
+                                more space later with ensureStorageAllocated().
+        @param hashFunction     an instance of HashFunctionType, which will be copied and
+                                stored to use with the map. This parameter can be omitted
+                                if HashFunctionType has a default constructor.
+    */
+    explicit FlatHashMap (int initialCapacity = 0,
+                          HashFunctionType hashFunction = HashFunctionType())
+       : hashFunctionToUse (hashFunction)
+    {
+        if (initialCapacity > 0)
+            ensureStorageAllocated (initialCapacity);
+    }
+
+    /** Creates a copy of another map. */
+    FlatHashMap (const FlatHashMap& other)
+       : hashFunctionToUse (other.hashFunctionToUse)
+    {
+        const ScopedLockType sl (other.getLock());
+
+        ensureStorageAllocated (other.numItems);
+
+        for (int i = 0; i < other.numSlots; ++i)
+            if (other.slots[i].hash != 0)
+                insertNewEntry (other.slots[i].hash, Entry (other.slots[i].getEntry()));
+    }
+
+    /** Move constructor. */
+    FlatHashMap (FlatHashMap&& other) noexcept
+       : hashFunctionToUse (other.hashFunctionToUse)
+    {
+        swapWith (other);
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Removes all values from the map.
+        This won't release the storage that the table is using.
+    */
+    void clear()
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            if (slots[i].hash != 0)
+            {
+                slots[i].getEntry().~Entry();
+                slots[i].hash = 0;
+            }
+        }
+
+        numItems = 0;
+    }
+
+    /** Returns the current number of items in the map. */
+    inline int size() const noexcept                        { return numItems; }
+
+    /** Returns true if the map is empty. */
+    inline bool isEmpty() const noexcept                    { return numItems == 0; }
+
+    /** Returns the number of slots in the table, which is always a power of two. */
+    inline int getNumSlots() const noexcept                 { return numSlots; }
+
+    //==============================================================================
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+    */
+    ValueType operator[] (KeyTypeParameter keyToLookFor) const          { return getValue (keyToLookFor); }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if
+        the map doesn't contain it.
+        The pointer is only valid until the map is next modified.
+    */
+    ValueType* find (KeyTypeParameter keyToLookFor) noexcept            { return getValuePointer (keyToLookFor); }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if
+        the map doesn't contain it.
+        The pointer is only valid until the map is next modified.
+    */
+    const ValueType* find (KeyTypeParameter keyToLookFor) const noexcept { return getValuePointer (keyToLookFor); }
+
+    /** Returns true if the map contains an item with the specified key. */
+    bool contains (KeyTypeParameter keyToLookFor) const                 { return containsKey (keyToLookFor); }
+
+    //==============================================================================
+    /** These versions of the lookup methods take any class that the hash function and
+        the key type's operator== can deal with, so that for example a map with String
+        or Identifier keys can be searched using a StringRef.
+    */
+    template <typename LookupKeyType>
+    typename LookupResult<LookupKeyType, ValueType>::type operator[] (const LookupKeyType& keyToLookFor) const    { return getValue (keyToLookFor); }
+
+    /** @see operator[] */
+    template <typename LookupKeyType>
+    typename LookupResult<LookupKeyType, ValueType*>::type find (const LookupKeyType& keyToLookFor) noexcept      { return getValuePointer (keyToLookFor); }
+
+    /** @see operator[] */
+    template <typename LookupKeyType>
+    typename LookupResult<LookupKeyType, const ValueType*>::type find (const LookupKeyType& keyToLookFor) const noexcept   { return getValuePointer (keyToLookFor); }
+
+    /** @see operator[] */
+    template <typename LookupKeyType>
+    typename LookupResult<LookupKeyType, bool>::type contains (const LookupKeyType& keyToLookFor) const          { return containsKey (keyToLookFor); }
+
+    //==============================================================================
+    /** Returns true if the map contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots; ++i)
+            if (slots[i].hash != 0 && slots[i].getEntry().value == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    /** Returns a reference to the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is
+        added to the map and a reference to this is returned.
+        The reference is only valid until the map is next modified.
+    */
+    ValueType& getReference (KeyTypeParameter keyToLookFor)
+    {
+        const ScopedLockType sl (getLock());
+        auto hash = getHash (keyToLookFor);
+        auto index = findIndex (keyToLookFor, hash);
+
+        if (index >= 0)
+            return slots[index].getEntry().value;
+
+        // keeping the table no more than half full keeps the probe sequences short
+        if ((numItems + 1) * 2 > numSlots)
+            rehash (jmax ((int) minimumNumSlots, numSlots * 2));
+
+        return slots[insertNewEntry (hash, Entry (keyToLookFor, ValueType()))].getEntry().value;
+    }
+
+    /** Adds or replaces an element in the map.
+        If there's already an item with the given key, this will replace its value. Otherwise, a new item
+        will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)        { getReference (newKey) = newValue; }
+
+    /** Removes the item with the given key, if there is one. */
+    void remove (KeyTypeParameter keyToRemove)                          { removeKey (keyToRemove); }
+
+    /** @see operator[] */
+    template <typename LookupKeyType>
+    typename LookupResult<LookupKeyType, void>::type remove (const LookupKeyType& keyToRemove)   { removeKey (keyToRemove); }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots;)
+        {
+            // removing an entry can shift a later one back into this slot, so it has to be re-checked
+            if (slots[i].hash != 0 && slots[i].getEntry().value == valueToRemove)
+                removeEntry (i);
+            else
+                ++i;
+        }
+    }
+
+    /** Makes sure that the table is large enough to hold a given number of items
+        without having to grow.
+    */
+    void ensureStorageAllocated (int minNumItems)
+    {
+        const ScopedLockType sl (getLock());
+        int needed = minimumNumSlots;
+
+        while (needed < minNumItems * 2)
+            needed *= 2;
+
+        if (needed > numSlots)
+            rehash (needed);
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two maps. */
+    void swapWith (FlatHashMap& otherMap) noexcept
+    {
+        const ScopedLockType lock1 (getLock());
+        const ScopedLockType lock2 (otherMap.getLock());
+
+        slots.swapWith (otherMap.slots);
+        std::swap (numSlots, otherMap.numSlots);
+        std::swap (numItems, otherMap.numItems);
+    }
+
+    /** Replaces the contents of this map with a copy of another one. */
+    FlatHashMap& operator= (const FlatHashMap& other)
+    {
+        if (this != &other)
+        {
+            FlatHashMap copy (other);
+            swapWith (copy);
+        }
+
+        return *this;
+    }
+
+    /** Move assignment operator. */
+    FlatHashMap& operator= (FlatHashMap&& other) noexcept
+    {
+        swapWith (other);
+        return *this;
+    }
+
+    //==============================================================================
+    /** Returns the CriticalSection that locks this structure.
+        To lock, you can call getLock().enter() and getLock().exit(), or preferably use
+        an object of ScopedLockType as an RAII lock for it.
+    */
+    inline const TypeOfCriticalSectionToUse& getLock() const noexcept      { return lock; }
+
+    /** Returns the type of scoped lock to use for locking this map. */
+    typedef typename TypeOfCriticalSectionToUse::ScopedLockType ScopedLockType;
+
+    //==============================================================================
+    /** Iterates over the items in a FlatHashMap.
+
+        To use it, repeatedly call next() until it returns false, e.g.
+        @code
+        for (FlatHashMap<String, int>::Iterator i (myMap); i.next();)
+            DBG (i.getKey() << " -> " << i.getValue());
+        @endcode
+
+        The order in which items are iterated bears no resemblance to the order in which
+        they were originally added, and any non-const call on the map will invalidate
+        the iterator.
+    */
+    struct Iterator
+    {
+        Iterator (const FlatHashMap& mapToIterate) noexcept
+            : map (mapToIterate), index (-1)
+        {}
+
+        /** Moves to the next item, if one is available.
+            When this returns true, you can get the item's key and value using getKey() and
+            getValue(). If it returns false, the iteration has finished and you should stop.
+        */
+        bool next() noexcept
+        {
+            while (++index < map.numSlots)
+                if (map.slots[index].hash != 0)
+                    return true;
+
+            return false;
+        }
+
+        /** Returns the current item's key.
+            This should only be called when a call to next() has just returned true.
+        */
+        const KeyType& getKey() const noexcept              { return map.slots[index].getEntry().key; }
+
+        /** Returns the current item's value.
+            This should only be called when a call to next() has just returned true.
+        */
+        const ValueType& getValue() const noexcept          { return map.slots[index].getEntry().value; }
+
+        /** Resets the iterator to its starting position. */
+        void reset() noexcept                                   { index = -1; }
+
+        Iterator& operator++() noexcept                         { next(); return *this; }
+        const ValueType& operator*() const noexcept             { return getValue(); }
+        bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+        void resetToEnd() noexcept                              { index = map.numSlots; }
+
+    private:
+        const FlatHashMap& map;
+        int index;
+
+        Iterator& operator= (const Iterator&) JUCE_DELETED_FUNCTION;
+    };
+
+    /** Returns a start iterator for the values in this map. */
+    Iterator begin() const noexcept             { Iterator i (*this); i.next(); return i; }
+
+    /** Returns an end iterator for the values in this map. */
+    Iterator end() const noexcept               { Iterator i (*this); i.resetToEnd(); return i; }
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        Entry (KeyTypeParameter k, ValueTypeParameter v)  : key (k), value (v) {}
+        Entry (const Entry& other)  : key (other.key), value (other.value) {}
+        Entry (Entry&& other)  : key (static_cast<KeyType&&> (other.key)), value (static_cast<ValueType&&> (other.value)) {}
+
+        Entry& operator= (Entry&& other)
+        {
+            key = static_cast<KeyType&&> (other.key);
+            value = static_cast<ValueType&&> (other.value);
+            return *this;
+        }
+
+        KeyType key;
+        ValueType value;
+    };
+
+    enum { minimumNumSlots = 16 };
+
+    HashFunctionType hashFunctionToUse;
+    // Keeping each hash next to its entry means that a lookup will usually only need to touch
+    // a single cache line.
+    struct Slot
+    {
+        uint32 hash;  // zero for an empty slot, otherwise the entry's hash with its top bit set
+        typename std::aligned_storage<sizeof (Entry), alignof (Entry)>::type storage;
+
+        Entry& getEntry() const noexcept    { return *reinterpret_cast<Entry*> (const_cast<void*> (static_cast<const void*> (&storage))); }
+    };
+
+    HeapBlock<Slot> slots;
+    int numSlots = 0, numItems = 0;
+    TypeOfCriticalSectionToUse lock;
+
+    template <typename LookupKeyType>
+    uint32 getHash (const LookupKeyType& key) const noexcept
+    {
+        auto h = (uint32) hashFunctionToUse.generateHash (key, std::numeric_limits<int>::max());
+
+        // the hash functions don't have to spread their bits very well, so give them a mix
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+
+        return h | 0x80000000u;
+    }
+
+    inline int getProbeDistance (int index, uint32 hash) const noexcept
+    {
+        return (index - (int) (hash & (uint32) (numSlots - 1))) & (numSlots - 1);
+    }
+
+    template <typename LookupKeyType>
+    ValueType getValue (const LookupKeyType& key) const
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (key);
+        return index >= 0 ? slots[index].getEntry().value : ValueType();
+    }
+
+    template <typename LookupKeyType>
+    ValueType* getValuePointer (const LookupKeyType& key) const noexcept
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (key);
+        return index >= 0 ? &(slots[index].getEntry().value) : nullptr;
+    }
+
+    template <typename LookupKeyType>
+    bool containsKey (const LookupKeyType& key) const
+    {
+        const ScopedLockType sl (getLock());
+        return findIndex (key) >= 0;
+    }
+
+    template <typename LookupKeyType>
+    void removeKey (const LookupKeyType& key)
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (key);
+
+        if (index >= 0)
+            removeEntry (index);
+    }
+
+    template <typename LookupKeyType>
+    int findIndex (const LookupKeyType& key) const noexcept
+    {
+        return numItems > 0 ? findIndex (key, getHash (key)) : -1;
+    }
+
+    template <typename LookupKeyType>
+    int findIndex (const LookupKeyType& key, uint32 hash) const noexcept
+    {
+        if (numSlots == 0)
+            return -1;
+
+        auto mask = numSlots - 1;
+        auto index = (int) (hash & (uint32) mask);
+
+        for (int distance = 0;; ++distance)
+        {
+            auto& slot = slots[index];
+
+            if (slot.hash == hash && slot.getEntry().key == key)
+                return index;
+
+            // an empty slot, or an item which is closer to its home slot than we'd be,
+            // means that the key can't be in the table
+            if (slot.hash == 0 || getProbeDistance (index, slot.hash) < distance)
+                return -1;
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    int insertNewEntry (uint32 hash, Entry&& newEntry)
+    {
+        jassert (numItems < numSlots);
+
+        auto mask = numSlots - 1;
+        auto index = (int) (hash & (uint32) mask);
+        int distance = 0, result = -1;
+        Entry pending (static_cast<Entry&&> (newEntry));
+
+        for (;;)
+        {
+            auto h = slots[index].hash;
+
+            if (h == 0)
+            {
+                new (&(slots[index].storage)) Entry (static_cast<Entry&&> (pending));
+                slots[index].hash = hash;
+                ++numItems;
+                return result >= 0 ? result : index;
+            }
+
+            auto existingDistance = getProbeDistance (index, h);
+
+            // steal the slot from any item that's nearer to home than the one we're carrying
+            if (existingDistance < distance)
+            {
+                std::swap (hash, slots[index].hash);
+                std::swap (pending, slots[index].getEntry());
+                distance = existingDistance;
+
+                if (result < 0)
+                    result = index;
+            }
+
+            index = (index + 1) & mask;
+            ++distance;
+        }
+    }
+
+    void removeEntry (int index)
+    {
+        auto mask = numSlots - 1;
+        auto next = (index + 1) & mask;
+
+        // shift any following items that are displaced back by one slot, so there's never a gap in a probe sequence
+        while (slots[next].hash != 0 && getProbeDistance (next, slots[next].hash) != 0)
+        {
+            slots[index].getEntry() = static_cast<Entry&&> (slots[next].getEntry());
+            slots[index].hash = slots[next].hash;
+            index = next;
+            next = (next + 1) & mask;
+        }
+
+        slots[index].getEntry().~Entry();
+        slots[index].hash = 0;
+        --numItems;
+    }
+
+    void rehash (int newNumSlots)
+    {
+        jassert (isPowerOfTwo (newNumSlots) && newNumSlots >= numItems * 2);
+
+        HeapBlock<Slot> oldSlots;
+        oldSlots.swapWith (slots);
+        slots.malloc (newNumSlots);
+
+        for (int i = 0; i < newNumSlots; ++i)
+            slots[i].hash = 0;
+
+        auto oldNumSlots = numSlots;
+        numSlots = newNumSlots;
+        numItems = 0;
+
+        for (int i = 0; i < oldNumSlots; ++i)
+        {
+            auto& slot = oldSlots[i];
+
+            if (slot.hash != 0)
+            {
+                insertNewEntry (slot.hash, static_cast<Entry&&> (slot.getEntry()));
+                slot.getEntry().~Entry();
+            }
+        }
+    }
+
+    JUCE_LEAK_DETECTOR (FlatHashMap)
+};
+
+} // namespace juce
@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct FlatHashMapTest : public UnitTest
+{
+    FlatHashMapTest() : UnitTest ("FlatHashMap", "Containers") {}
+
+    void runTest() override
+    {
+        doTest<AddElementsTest> ("AddElementsTest");
+        doTest<AccessTest> ("AccessTest");
+        doTest<RemoveTest> ("RemoveTest");
+        doTest<CopyTest> ("CopyTest");
+
+        beginTest ("Heterogeneous lookup");
+        {
+            FlatHashMap<String, int> map;
+            FlatHashMap<Identifier, int> identifierMap;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                map.set ("item" + String (i), i);
+                identifierMap.set (Identifier ("item" + String (i)), i);
+            }
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto name = "item" + String (i);
+                StringRef ref (name);
+
+                expectEquals (map[ref], i);
+                expectEquals (identifierMap[ref], i);
+                expect (map.contains (ref));
+                expect (map.find (ref) != nullptr && *map.find (ref) == i);
+            }
+
+            expectEquals (map["item12"], 12);
+            expect (! map.contains (StringRef ("item1000")));
+            expect (map.find (StringRef ("")) == nullptr);
+
+            map.remove (StringRef ("item12"));
+            expect (! map.contains ("item12"));
+            expectEquals (map.size(), 999);
+        }
+
+        beginTest ("Lookups take the map's lock");
+        {
+            typedef FlatHashMap<String, int, DefaultHashFunctions, CriticalSection> LockedMap;
+            LockedMap map;
+            map.set ("one", 1);
+
+            struct LookupThread  : public Thread
+            {
+                LookupThread (LockedMap& m, std::function<int (LockedMap&)> f)
+                    : Thread ("FlatHashMap test"), map (m), lookup (f) {}
+
+                void run() override
+                {
+                    started.signal();
+                    result = lookup (map);
+                }
+
+                LockedMap& map;
+                std::function<int (LockedMap&)> lookup;
+                WaitableEvent started;
+                Atomic<int> result;
+            };
+
+            auto checkLookupWaitsForLock = [this, &map] (std::function<int (LockedMap&)> lookup)
+            {
+                LookupThread thread (map, lookup);
+
+                {
+                    const LockedMap::ScopedLockType sl (map.getLock());
+                    thread.startThread();
+                    thread.started.wait();
+                    Thread::sleep (50);
+                    expectEquals (thread.result.get(), 0);
+                }
+
+                expect (thread.waitForThreadToExit (5000));
+                expectEquals (thread.result.get(), 1);
+            };
+
+            checkLookupWaitsForLock ([] (LockedMap& m) { return *m.find ("one"); });
+            checkLookupWaitsForLock ([] (LockedMap& m) { return *static_cast<const LockedMap&> (m).find ("one"); });
+            checkLookupWaitsForLock ([] (LockedMap& m) { return *m.find (StringRef ("one")); });
+            checkLookupWaitsForLock ([] (LockedMap& m) { return *static_cast<const LockedMap&> (m).find (StringRef ("one")); });
+            checkLookupWaitsForLock ([] (LockedMap& m) { return m[StringRef ("one")]; });
+            checkLookupWaitsForLock ([] (LockedMap& m) { return m.contains ("one") ? 1 : 0; });
+        }
+
+        beginTest ("RemoveValue");
+        {
+            FlatHashMap<int, int> map;
+
+            for (int i = 0; i < 5000; ++i)
+                map.set (i, i % 3);
+
+            map.removeValue (1);
+            expect (! map.containsValue (1));
+            expectEquals (map.size(), 3333);
+
+            for (int i = 0; i < 5000; ++i)
+                expectEquals ((int) map.contains (i), (int) (i % 3 != 1));
+        }
+    }
+
+    //==============================================================================
+    struct AddElementsTest
+    {
+        template <typename KeyType>
+        static void run (UnitTest& u)
+        {
+            AssociativeMap<KeyType, int> groundTruth;
+            FlatHashMap<KeyType, int> hashMap;
+
+            RandomKeys<KeyType> keyOracle (300, 3827829);
+            Random valueOracle (48735);
+
+            int totalValues = 0;
+            for (int i = 0; i < 10000; ++i)
+            {
+                auto key = keyOracle.next();
+                auto value = valueOracle.nextInt();
+
+                bool contains = (groundTruth.find (key) != nullptr);
+                u.expectEquals ((int) contains, (int) hashMap.contains (key));
+
+                groundTruth.add (key, value);
+                hashMap.set (key, value);
+
+                if (! contains) totalValues++;
+
+                u.expectEquals (hashMap.size(), totalValues);
+            }
+        }
+    };
+
+    struct AccessTest
+    {
+        template <typename KeyType>
+        static void run (UnitTest& u)
+        {
+            AssociativeMap<KeyType, int> groundTruth;
+            FlatHashMap<KeyType, int> hashMap;
+
+            fillWithRandomValues (hashMap, groundTruth);
+
+            for (auto pair : groundTruth.pairs)
+                u.expectEquals (hashMap[pair.key], pair.value);
+
+            int numIterated = 0;
+
+            for (typename FlatHashMap<KeyType, int>::Iterator i (hashMap); i.next();)
+            {
+                auto* expected = groundTruth.find (i.getKey());
+                u.expect (expected != nullptr && *expected == i.getValue());
+                ++numIterated;
+            }
+
+            u.expectEquals (numIterated, groundTruth.size());
+        }
+    };
+
+    struct RemoveTest
+    {
+        template <typename KeyType>
+        static void run (UnitTest& u)
+        {
+            AssociativeMap<KeyType, int> groundTruth;
+            FlatHashMap<KeyType, int> hashMap;
+
+            fillWithRandomValues (hashMap, groundTruth);
+            auto n = groundTruth.size();
+
+            Random r (3827387);
+
+            for (int i = 0; i < 100; ++i)
+            {
+                auto idx = r.nextInt (n-- - 1);
+                auto key = groundTruth.pairs.getReference (idx).key;
+
+                groundTruth.pairs.remove (idx);
+                hashMap.remove (key);
+
+                u.expect (! hashMap.contains (key));
+                u.expectEquals (hashMap.size(), groundTruth.size());
+
+                for (auto pair : groundTruth.pairs)
+                    u.expectEquals (hashMap[pair.key], pair.value);
+            }
+        }
+    };
+
+    struct CopyTest
+    {
+        template <typename KeyType>
+        static void run (UnitTest& u)
+        {
+            AssociativeMap<KeyType, int> groundTruth;
+            FlatHashMap<KeyType, int> hashMap;
+
+            fillWithRandomValues (hashMap, groundTruth);
+
+            FlatHashMap<KeyType, int> copy (hashMap);
+            hashMap.clear();
+            u.expect (hashMap.isEmpty());
+
+            FlatHashMap<KeyType, int> moved (static_cast<FlatHashMap<KeyType, int>&&> (copy));
+            u.expectEquals (moved.size(), groundTruth.size());
+
+            for (auto pair : groundTruth.pairs)
+                u.expectEquals (moved[pair.key], pair.value);
+        }
+    };
+
+    //==============================================================================
+    template <class Test>
+    void doTest (const String& testName)
+    {
+        beginTest (testName);
+
+        Test::template run<int> (*this);
+        Test::template run<void*> (*this);
+        Test::template run<String> (*this);
+    }
+
+    //==============================================================================
+    template <typename KeyType, typename ValueType>
+    struct AssociativeMap
+    {
+        struct KeyValuePair { KeyType key; ValueType value; };
+
+        ValueType* find (KeyType key)
+        {
+            auto n = pairs.size();
+
+            for (int i = 0; i < n; ++i)
+            {
+                auto& pair = pairs.getReference (i);
+
+                if (pair.key == key)
+                    return &pair.value;
+            }
+
+            return nullptr;
+        }
+
+        void add (KeyType key, ValueType value)
+        {
+            if (ValueType* v = find (key))
+                *v = value;
+            else
+                pairs.add ({key, value});
+        }
+
+        int size() const { return pairs.size(); }
+
+        Array<KeyValuePair> pairs;
+    };
+
+    template <typename KeyType, typename ValueType>
+    static void fillWithRandomValues (FlatHashMap<KeyType, int>& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
+    {
+        RandomKeys<KeyType> keyOracle (300, 3827829);
+        Random valueOracle (48735);
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            auto key = keyOracle.next();
+            auto value = valueOracle.nextInt();
+
+            groundTruth.add (key, value);
+            hashMap.set (key, value);
+        }
+    }
+
+    //==============================================================================
+    template <typename KeyType>
+    class RandomKeys
+    {
+    public:
+        RandomKeys (int maxUniqueKeys, int seed) : r (seed)
+        {
+            for (int i = 0; i < maxUniqueKeys; ++i)
+                keys.add (generateRandomKey (r));
+        }
+
+        const KeyType& next()
+        {
+            int i = r.nextInt (keys.size() - 1);
+            return keys.getReference (i);
+        }
+    private:
+        static KeyType generateRandomKey (Random&);
+
+        Random r;
+        Array<KeyType> keys;
+    };
+};
+
+template <> int   FlatHashMapTest::RandomKeys<int>  ::generateRandomKey (Random& rnd) { return rnd.nextInt(); }
+template <> void* FlatHashMapTest::RandomKeys<void*>::generateRandomKey (Random& rnd) { return reinterpret_cast<void*> (rnd.nextInt64()); }
+
+template <> String FlatHashMapTest::RandomKeys<String>::generateRandomKey (Random& rnd)
+{
+    String str;
+
+    int len = rnd.nextInt (8)+1;
+    for (int i = 0; i < len; ++i)
+        str += static_cast<char> (rnd.nextInt (95) + 32);
+
+    return str;
+}
+
+static FlatHashMapTest flatHashMapTest;
+
+} // namespace juce
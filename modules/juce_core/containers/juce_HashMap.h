@@ -41,6 +41,16 @@ struct DefaultHashFunctions
     static int generateHash (int64 key, int upperLimit) noexcept            { return generateHash ((uint64) key, upperLimit); }
     /** Generates a simple hash from a string. */
     static int generateHash (const String& key, int upperLimit) noexcept    { return generateHash ((uint32) key.hashCode(), upperLimit); }
+    /** Generates a simple hash from a StringRef or Identifier, which will match the one generated for an equivalent String. */
+    static int generateHash (StringRef key, int upperLimit) noexcept
+    {
+        uint32 hash = 0;
+
+        for (auto t = key.text; ! t.isEmpty();)
+            hash = 31 * hash + (uint32) t.getAndAdvance();
+
+        return generateHash (hash, upperLimit);
+    }
     /** Generates a simple hash from a variant. */
     static int generateHash (const var& key, int upperLimit) noexcept       { return generateHash (key.toString(), upperLimit); }
     /** Generates a simple hash from a void ptr. */
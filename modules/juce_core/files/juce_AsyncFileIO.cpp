@@ -0,0 +1,467 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct AsyncFileIO::Request
+{
+    Request (OpenFile& f, int64 pos, void* data, size_t num, bool write, CompletionCallback&& cb)
+        : file (f), position (pos), buffer (data), numBytes (num), isWrite (write),
+          callback (static_cast<CompletionCallback&&> (cb))
+    {
+    }
+
+    OpenFile& file;
+    const int64 position;
+    void* const buffer;
+    const size_t numBytes;
+    const bool isWrite;
+    CompletionCallback callback;
+
+    // Performs the request with blocking calls, looping until it's complete or hits the end of the file
+    int64 perform()
+    {
+        auto* data = static_cast<char*> (buffer);
+        size_t numDone = 0;
+
+        while (numDone < numBytes)
+        {
+            auto num = isWrite ? file.writeAt (position + (int64) numDone, data + numDone, numBytes - numDone)
+                               : file.readAt  (position + (int64) numDone, data + numDone, numBytes - numDone);
+
+            if (num < 0)
+                return num;
+
+            if (num == 0)
+                break;
+
+            numDone += (size_t) num;
+        }
+
+        return (int64) numDone;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Request)
+};
+
+//==============================================================================
+struct AsyncFileIO::Backend
+{
+    virtual ~Backend() {}
+
+    // Takes ownership of the requests, and must eventually call requestFinished() for each one
+    virtual void start (const Array<Request*>&) = 0;
+    virtual bool isIoUring() const noexcept      { return false; }
+
+    void requestFinished (Request* r, int64 result)
+    {
+        {
+            ScopedPointer<Request> deleter (r);
+
+            if (r->callback)
+                r->callback (result);
+        }
+
+        --numInProgress;
+        finished.signal();
+    }
+
+    bool waitForCompletion (int timeoutMilliseconds)
+    {
+        auto endTime = Time::getMillisecondCounter() + (uint32) timeoutMilliseconds;
+
+        while (numInProgress.get() > 0)
+        {
+            auto timeToWait = 100;
+
+            if (timeoutMilliseconds >= 0)
+            {
+                auto remaining = (int) (endTime - Time::getMillisecondCounter());
+
+                if (remaining <= 0)
+                    return false;
+
+                timeToWait = jmin (timeToWait, remaining);
+            }
+
+            finished.wait (timeToWait);
+        }
+
+        return true;
+    }
+
+    Atomic<int> numInProgress;
+    WaitableEvent finished;
+};
+
+//==============================================================================
+struct AsyncFileIO::ThreadPoolBackend  : public AsyncFileIO::Backend
+{
+    ThreadPoolBackend (int maxRequestsInFlight)
+        : pool (jlimit (1, 4, maxRequestsInFlight))
+    {
+    }
+
+    void start (const Array<Request*>& requests) override
+    {
+        for (auto* r : requests)
+            pool.addJob ([this, r] { requestFinished (r, r->perform()); });
+    }
+
+    ThreadPool pool;
+};
+
+#if ! (JUCE_LINUX && JUCE_USE_IO_URING)
+AsyncFileIO::Backend* AsyncFileIO::createNativeBackend (int)   { return nullptr; }
+#endif
+
+//==============================================================================
+AsyncFileIO::AsyncFileIO (int maxRequestsInFlight)
+{
+    jassert (maxRequestsInFlight > 0);
+
+    backend = createNativeBackend (maxRequestsInFlight);
+
+    if (backend == nullptr)
+        backend = new ThreadPoolBackend (maxRequestsInFlight);
+}
+
+AsyncFileIO::~AsyncFileIO()
+{
+    submit();
+    waitForCompletion();
+    backend = nullptr;
+}
+
+AsyncFileIO::OpenFile::OpenFile (const File& f, bool forWriting, bool useDirectIO)
+    : file (f), directIO (useDirectIO)
+{
+    openHandle (forWriting);
+}
+
+AsyncFileIO::OpenFile::~OpenFile()
+{
+    if (fileHandle != nullptr)
+        closeHandle();
+}
+
+AsyncFileIO::OpenFile* AsyncFileIO::openForReading (const File& f, bool useDirectIO)
+{
+    return new OpenFile (f, false, useDirectIO);
+}
+
+AsyncFileIO::OpenFile* AsyncFileIO::openForWriting (const File& f, bool useDirectIO)
+{
+    return new OpenFile (f, true, useDirectIO);
+}
+
+void AsyncFileIO::read (OpenFile& file, int64 filePosition, void* destBuffer, size_t numBytes,
+                        CompletionCallback callback)
+{
+    addRequest (new Request (file, filePosition, destBuffer, numBytes, false, static_cast<CompletionCallback&&> (callback)));
+}
+
+void AsyncFileIO::write (OpenFile& file, int64 filePosition, const void* sourceData, size_t numBytes,
+                         CompletionCallback callback)
+{
+    addRequest (new Request (file, filePosition, const_cast<void*> (sourceData), numBytes, true,
+                             static_cast<CompletionCallback&&> (callback)));
+}
+
+void AsyncFileIO::addRequest (Request* r)
+{
+    // Direct I/O requires everything to be aligned!
+    jassert (! r->file.isUsingDirectIO()
+              || ((r->position % (int64) getDirectIOAlignment()) == 0
+                   && (r->numBytes % getDirectIOAlignment()) == 0
+                   && (((pointer_sized_int) r->buffer) % (pointer_sized_int) getDirectIOAlignment()) == 0));
+
+    if (! r->file.openedOk())
+    {
+        if (r->callback)
+            r->callback (-1);
+
+        delete r;
+        return;
+    }
+
+    const ScopedLock sl (queueLock);
+    queuedRequests.add (r);
+}
+
+int AsyncFileIO::submit()
+{
+    Array<Request*> requests;
+
+    {
+        const ScopedLock sl (queueLock);
+        requests.swapWith (queuedRequests);
+    }
+
+    if (requests.size() > 0)
+    {
+        backend->numInProgress += requests.size();
+        backend->start (requests);
+    }
+
+    return requests.size();
+}
+
+bool AsyncFileIO::waitForCompletion (int timeoutMilliseconds)
+{
+    return backend->waitForCompletion (timeoutMilliseconds);
+}
+
+int AsyncFileIO::getNumRequestsInProgress() const noexcept
+{
+    return backend->numInProgress.get();
+}
+
+bool AsyncFileIO::isUsingIoUring() const noexcept
+{
+    return backend->isIoUring();
+}
+
+//==============================================================================
+AsyncFileIO::AlignedBuffer::AlignedBuffer (size_t minimumSize)
+    : size (jmax ((size_t) 1, (minimumSize + getDirectIOAlignment() - 1) / getDirectIOAlignment()) * getDirectIOAlignment())
+{
+   #if JUCE_WINDOWS
+    data = _aligned_malloc (size, getDirectIOAlignment());
+   #else
+    if (posix_memalign (&data, getDirectIOAlignment(), size) != 0)
+        data = nullptr;
+   #endif
+
+    jassert (data != nullptr);
+}
+
+AsyncFileIO::AlignedBuffer::~AlignedBuffer()
+{
+   #if JUCE_WINDOWS
+    _aligned_free (data);
+   #else
+    free (data);
+   #endif
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AsyncFileIOTests  : public UnitTest
+{
+    AsyncFileIOTests()   : UnitTest ("AsyncFileIO", "Files") {}
+
+    void runTest() override
+    {
+        Random rng = getRandom();
+        MemoryBlock data ((size_t) 300000 + (size_t) rng.nextInt (10000));
+
+        for (size_t i = 0; i < data.getSize(); ++i)
+            data[i] = (char) rng.nextInt (256);
+
+        TemporaryFile temp;
+        const File& f = temp.getFile();
+
+        beginTest ("Writing and reading");
+
+        {
+            AsyncFileIO io (8);
+            ScopedPointer<AsyncFileIO::OpenFile> out (io.openForWriting (f));
+            expect (out->openedOk());
+
+            const size_t chunkSize = 10000;
+            Atomic<int> numCallbacks, numErrors;
+
+            for (size_t pos = 0; pos < data.getSize(); pos += chunkSize)
+            {
+                auto num = jmin (chunkSize, data.getSize() - pos);
+
+                io.write (*out, (int64) pos, addBytesToPointer (data.getData(), pos), num,
+                          [&numCallbacks, &numErrors, num] (int64 result)
+                          {
+                              if (result != (int64) num)
+                                  ++numErrors;
+
+                              ++numCallbacks;
+                          });
+            }
+
+            expectEquals (io.submit(), (int) ((data.getSize() + chunkSize - 1) / chunkSize));
+            expect (io.waitForCompletion (10000));
+            expectEquals (io.getNumRequestsInProgress(), 0);
+            expectEquals (numCallbacks.get(), (int) ((data.getSize() + chunkSize - 1) / chunkSize));
+            expectEquals (numErrors.get(), 0);
+            out = nullptr;
+
+            MemoryBlock written;
+            f.loadFileAsData (written);
+            expect (written == data);
+
+            ScopedPointer<AsyncFileIO::OpenFile> in (io.openForReading (f));
+            MemoryBlock readBack (data.getSize() + 100);
+            int64 lastResult = 0;
+
+            io.read (*in, 0, readBack.getData(), readBack.getSize() / 2, nullptr);
+            io.read (*in, (int64) readBack.getSize() / 2, addBytesToPointer (readBack.getData(), readBack.getSize() / 2),
+                     readBack.getSize() - readBack.getSize() / 2, [&] (int64 result) { lastResult = result; });
+
+            io.submit();
+            expect (io.waitForCompletion (10000));
+            expectEquals (lastResult, (int64) (data.getSize() - readBack.getSize() / 2));
+            expect (memcmp (readBack.getData(), data.getData(), data.getSize()) == 0);
+        }
+
+        beginTest ("Errors");
+
+        {
+            AsyncFileIO io;
+            ScopedPointer<AsyncFileIO::OpenFile> missing (io.openForReading (f.getSiblingFile ("doesnt_exist_" + String (rng.nextInt()))));
+            expect (! missing->openedOk());
+
+            char buffer[16];
+            int64 result = 0;
+            io.read (*missing, 0, buffer, sizeof (buffer), [&] (int64 r) { result = r; });
+            expect (result < 0);
+        }
+
+        beginTest ("Direct I/O");
+
+        {
+            AsyncFileIO io;
+            ScopedPointer<AsyncFileIO::OpenFile> in (io.openForReading (f, true));
+
+            // not all filesystems allow direct I/O
+            if (in->openedOk())
+            {
+                auto alignment = AsyncFileIO::getDirectIOAlignment();
+                AsyncFileIO::AlignedBuffer buffer (alignment * 8);
+                expect (((pointer_sized_int) buffer.getData()) % (pointer_sized_int) alignment == 0);
+
+                int64 result = 0;
+                io.read (*in, (int64) alignment, buffer.getData(), buffer.getSize(), [&] (int64 r) { result = r; });
+                io.submit();
+                expect (io.waitForCompletion (10000));
+
+                if (result > 0)
+                {
+                    expectEquals (result, (int64) buffer.getSize());
+                    expect (memcmp (buffer.getData(), addBytesToPointer (data.getData(), alignment), buffer.getSize()) == 0);
+                }
+            }
+        }
+
+        beginTest ("AsyncFileOutputStream");
+
+        {
+            f.deleteFile();
+            MemoryOutputStream expected;
+
+            {
+                AsyncFileOutputStream out (f, 4096, 3);
+                expect (out.openedOk());
+
+                for (size_t pos = 0; pos < data.getSize();)
+                {
+                    auto num = jmin ((size_t) rng.nextInt (9000), data.getSize() - pos);
+                    auto* src = addBytesToPointer (data.getData(), pos);
+                    expect (out.write (src, num));
+                    expected.write (src, num);
+                    pos += num;
+
+                    if (rng.nextInt (20) == 0)
+                    {
+                        auto newPos = rng.nextInt ((int) out.getPosition() + 1);
+                        expect (out.setPosition (newPos));
+                        expected.setPosition (newPos);
+
+                        out.writeInt (0x12345678);
+                        expected.writeInt (0x12345678);
+
+                        expect (out.setPosition ((int64) expected.getDataSize()));
+                        expected.setPosition ((int64) expected.getDataSize());
+                    }
+                }
+
+                expectEquals (out.getPosition(), (int64) expected.getDataSize());
+            }
+
+            MemoryBlock written;
+            f.loadFileAsData (written);
+            expect (written == expected.getMemoryBlock());
+
+            {
+                AsyncFileOutputStream out (f);
+                expectEquals (out.getPosition(), (int64) expected.getDataSize());
+                out << "end";
+            }
+
+            expectEquals (f.getSize(), (int64) expected.getDataSize() + 3);
+        }
+
+        beginTest ("AsyncFileInputStream");
+
+        {
+            expect (f.replaceWithData (data.getData(), data.getSize()));
+
+            AsyncFileInputStream in (f, 4096, 3);
+            expect (in.openedOk());
+            expectEquals (in.getTotalLength(), (int64) data.getSize());
+
+            MemoryBlock readBack (data.getSize());
+
+            // a mixture of sequential reads of different sizes, and jumps to random places
+            for (int i = 0; i < 400; ++i)
+            {
+                if (rng.nextInt (10) == 0)
+                    expect (in.setPosition (rng.nextInt ((int) data.getSize())));
+
+                auto pos = in.getPosition();
+                auto num = rng.nextInt (10000);
+                auto expectedNum = (int) jmin ((int64) num, (int64) data.getSize() - pos);
+
+                expectEquals (in.read (addBytesToPointer (readBack.getData(), pos), num), expectedNum);
+                expectEquals (in.getPosition(), pos + expectedNum);
+                expect (memcmp (addBytesToPointer (readBack.getData(), pos),
+                                addBytesToPointer (data.getData(), pos), (size_t) expectedNum) == 0);
+            }
+
+            expect (in.setPosition (0));
+            MemoryBlock all;
+            expectEquals ((size_t) in.readIntoMemoryBlock (all), data.getSize());
+            expect (all == data);
+            expect (in.isExhausted());
+            expectEquals (in.read (all.getData(), 100), 0);
+            expect (in.getStatus().wasOk());
+
+            AsyncFileInputStream missing (f.getSiblingFile ("doesnt_exist"));
+            expect (missing.failedToOpen());
+        }
+    }
+};
+
+static AsyncFileIOTests asyncFileIOTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Performs file reads and writes asynchronously.
+
+    Requests are queued with read() and write(), and then handed over in a batch by
+    calling submit(). Each request has a callback, which is invoked on a background
+    thread when the request completes, with either the number of bytes transferred or
+    a negative value if it failed.
+
+    On Linux, if JUCE_USE_IO_URING is enabled and the kernel supports it, the requests
+    are passed to the kernel through an io_uring, so no threads are blocked waiting for
+    the disk. Everywhere else, a small pool of threads performs them with ordinary
+    blocking reads and writes.
+
+    Files can be opened for direct (unbuffered) I/O, which bypasses the OS's page cache.
+    When doing this, the buffers, file positions and sizes of all requests must be
+    multiples of getDirectIOAlignment(), and the AlignedBuffer class can be used to
+    allocate suitable memory.
+
+    E.g.
+    @code
+    AsyncFileIO io;
+    ScopedPointer<AsyncFileIO::OpenFile> file (io.openForReading (myFile));
+    AsyncFileIO::AlignedBuffer buffer (65536);
+
+    io.read (*file, 0, buffer.getData(), buffer.getSize(), [] (int64 numBytesRead)
+    {
+        // called on a background thread..
+    });
+
+    io.submit();
+    io.waitForCompletion();
+    @endcode
+
+    @see AsyncFileOutputStream
+*/
+class JUCE_API  AsyncFileIO
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileIO object.
+
+        @param maxRequestsInFlight  the maximum number of requests that will be handed to the
+                                    OS at any one time. More than this can be submitted, but
+                                    the extra ones will wait until earlier ones have finished.
+    */
+    explicit AsyncFileIO (int maxRequestsInFlight = 64);
+
+    /** Destructor.
+        This submits any requests that are still queued, and waits for them all to finish.
+    */
+    ~AsyncFileIO();
+
+    //==============================================================================
+    /** A file that has been opened by an AsyncFileIO object.
+
+        These are created by AsyncFileIO::openForReading() and AsyncFileIO::openForWriting(),
+        and the caller is responsible for deleting them. An OpenFile must not be deleted
+        while it has any requests in progress.
+    */
+    class JUCE_API  OpenFile
+    {
+    public:
+        /** Destructor. */
+        ~OpenFile();
+
+        /** Returns the file that this refers to. */
+        const File& getFile() const noexcept                { return file; }
+
+        /** Returns the status of the file.
+            If the file couldn't be opened, this will contain an error message.
+        */
+        const Result& getStatus() const noexcept            { return status; }
+
+        /** Returns true if the file was opened successfully. */
+        bool openedOk() const noexcept                      { return status.wasOk(); }
+
+        /** Returns true if the file was opened for direct (unbuffered) I/O. */
+        bool isUsingDirectIO() const noexcept               { return directIO; }
+
+    private:
+        //==============================================================================
+        friend class AsyncFileIO;
+
+        OpenFile (const File&, bool forWriting, bool useDirectIO);
+
+        const File file;
+        void* fileHandle = nullptr;
+        Result status { Result::ok() };
+        bool directIO;
+
+        void openHandle (bool forWriting);
+        void closeHandle();
+        int64 readAt (int64 position, void* destBuffer, size_t numBytes);
+        int64 writeAt (int64 position, const void* sourceData, size_t numBytes);
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenFile)
+    };
+
+    /** Opens a file for reading.
+        The caller must delete the object that is returned. Check OpenFile::openedOk() to
+        find out whether it was successful.
+    */
+    OpenFile* openForReading (const File& file, bool useDirectIO = false);
+
+    /** Opens a file for writing, creating it if it doesn't already exist.
+        Unlike FileOutputStream, an existing file's content is left in place, and data can
+        be written at any position. The caller must delete the object that is returned.
+    */
+    OpenFile* openForWriting (const File& file, bool useDirectIO = false);
+
+    //==============================================================================
+    /** The type of callback that is used to report the result of a request.
+        The value is the number of bytes that were transferred, which may be less than was
+        asked for if a read reaches the end of the file, or negative if an error occurred.
+    */
+    typedef std::function<void (int64 result)> CompletionCallback;
+
+    /** Queues a read request.
+        The destination buffer must remain valid until the request's callback is called.
+        The request won't be started until submit() is called. If the file couldn't be
+        opened, the callback is called immediately with a negative result.
+    */
+    void read (OpenFile& file, int64 filePosition, void* destBuffer, size_t numBytes,
+               CompletionCallback callback);
+
+    /** Queues a write request.
+        The source data must remain valid until the request's callback is called.
+        The request won't be started until submit() is called. If the file couldn't be
+        opened, the callback is called immediately with a negative result.
+    */
+    void write (OpenFile& file, int64 filePosition, const void* sourceData, size_t numBytes,
+                CompletionCallback callback);
+
+    /** Starts all of the requests that have been queued since the last call.
+        @returns the number of requests that were submitted
+    */
+    int submit();
+
+    /** Waits until all of the submitted requests have finished.
+        @returns true if they finished, or false if the timeout expired first
+    */
+    bool waitForCompletion (int timeoutMilliseconds = -1);
+
+    /** Returns the number of requests that have been submitted but haven't yet finished. */
+    int getNumRequestsInProgress() const noexcept;
+
+    /** Returns true if the requests are being performed by an io_uring. */
+    bool isUsingIoUring() const noexcept;
+
+    //==============================================================================
+    /** Returns the alignment required for buffers, positions and sizes when using direct I/O. */
+    static size_t getDirectIOAlignment() noexcept       { return 4096; }
+
+    /** A block of memory which is aligned to getDirectIOAlignment(), and so can be used
+        for direct I/O requests.
+    */
+    class JUCE_API  AlignedBuffer
+    {
+    public:
+        /** Allocates a buffer, rounding its size up to a multiple of getDirectIOAlignment(). */
+        explicit AlignedBuffer (size_t minimumSize);
+
+        /** Destructor. */
+        ~AlignedBuffer();
+
+        /** Returns the buffer's data. */
+        void* getData() const noexcept                  { return data; }
+
+        /** Returns the size of the buffer in bytes. */
+        size_t getSize() const noexcept                 { return size; }
+
+    private:
+        void* data = nullptr;
+        size_t size;
+
+        JUCE_DECLARE_NON_COPYABLE (AlignedBuffer)
+    };
+
+private:
+    //==============================================================================
+    struct Request;
+    struct Backend;
+    struct ThreadPoolBackend;
+    struct IoUringBackend;
+
+    friend struct ContainerDeletePolicy<Backend>;
+    ScopedPointer<Backend> backend;
+    Array<Request*> queuedRequests;
+    CriticalSection queueLock;
+
+    static Backend* createNativeBackend (int maxRequestsInFlight);
+    void addRequest (Request*);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileIO)
+};
+
+} // namespace juce
@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+struct AsyncFileInputStream::Buffer
+{
+    Buffer (size_t size)  : data (size), finished (true) {}
+
+    HeapBlock<char> data;
+    int64 position = 0, numAvailable = 0, result = 0;
+    bool isReading = false;
+    WaitableEvent finished;
+};
+
+AsyncFileInputStream::AsyncFileInputStream (const File& f, AsyncFileIO& ioToUse,
+                                            size_t bufferSizeToUse, int numBuffers)
+    : file (f), io (&ioToUse, false), bufferSize (jmax ((size_t) 16, bufferSizeToUse))
+{
+    init (numBuffers);
+}
+
+AsyncFileInputStream::AsyncFileInputStream (const File& f, size_t bufferSizeToUse, int numBuffers)
+    : file (f), io (new AsyncFileIO (jmax (2, numBuffers)), true), bufferSize (jmax ((size_t) 16, bufferSizeToUse))
+{
+    init (numBuffers);
+}
+
+AsyncFileInputStream::~AsyncFileInputStream()
+{
+    // the callbacks for any reads that are in progress still refer to the buffers
+    for (auto* b : buffers)
+        waitForBuffer (*b);
+}
+
+void AsyncFileInputStream::init (int numBuffers)
+{
+    openFile = io->openForReading (file);
+    status = openFile->getStatus();
+
+    if (status.wasOk())
+    {
+        totalLength = file.getSize();
+
+        for (int i = jmax (2, numBuffers); --i >= 0;)
+            buffers.add (new Buffer (bufferSize));
+    }
+}
+
+void AsyncFileInputStream::startReading (Buffer& b, int64 position)
+{
+    b.position = position;
+    b.numAvailable = 0;
+
+    if (position >= totalLength)
+        return;
+
+    b.isReading = true;
+    b.finished.reset();
+
+    auto* buffer = &b;
+
+    io->read (*openFile, position, b.data, (size_t) jmin ((int64) bufferSize, totalLength - position),
+              [buffer] (int64 result)
+              {
+                  buffer->result = result;
+                  buffer->finished.signal();
+              });
+}
+
+void AsyncFileInputStream::startReadingFrom (int64 position)
+{
+    for (auto* b : buffers)
+        waitForBuffer (*b);
+
+    currentBuffer = 0;
+
+    for (int i = 0; i < buffers.size(); ++i)
+        startReading (*buffers.getUnchecked (i), position + (int64) bufferSize * i);
+
+    io->submit();
+}
+
+void AsyncFileInputStream::waitForBuffer (Buffer& b)
+{
+    if (b.isReading)
+    {
+        b.finished.wait();
+        b.isReading = false;
+        b.numAvailable = jmax ((int64) 0, b.result);
+
+        if (b.result < 0 && status.wasOk())
+            status = Result::fail ("Couldn't read from the file " + file.getFullPathName());
+    }
+}
+
+int64 AsyncFileInputStream::getTotalLength()
+{
+    return totalLength;
+}
+
+int AsyncFileInputStream::read (void* destBuffer, int maxBytesToRead)
+{
+    jassert (destBuffer != nullptr && maxBytesToRead >= 0);
+
+    if (buffers.size() == 0)
+        return 0;
+
+    auto* dest = static_cast<char*> (destBuffer);
+    int numRead = 0;
+    bool hasRestarted = false;
+
+    while (numRead < maxBytesToRead && currentPosition < totalLength)
+    {
+        auto& b = *buffers.getUnchecked (currentBuffer);
+        waitForBuffer (b);
+
+        if (currentPosition < b.position || currentPosition >= b.position + b.numAvailable)
+        {
+            // if a fresh read didn't get this far, the file must have failed or shrunk
+            if (hasRestarted)
+                break;
+
+            startReadingFrom (currentPosition);
+            hasRestarted = true;
+            continue;
+        }
+
+        auto offset = currentPosition - b.position;
+        auto numToCopy = (int) jmin ((int64) (maxBytesToRead - numRead), b.numAvailable - offset);
+
+        memcpy (dest + numRead, b.data + offset, (size_t) numToCopy);
+        numRead += numToCopy;
+        currentPosition += numToCopy;
+        hasRestarted = false;
+
+        if (currentPosition == b.position + b.numAvailable)
+        {
+            // this block is used up, so its buffer can go on to fetch the one after the last
+            startReading (b, b.position + (int64) bufferSize * buffers.size());
+            io->submit();
+            currentBuffer = (currentBuffer + 1) % buffers.size();
+        }
+    }
+
+    return numRead;
+}
+
+bool AsyncFileInputStream::isExhausted()
+{
+    return currentPosition >= totalLength;
+}
+
+int64 AsyncFileInputStream::getPosition()
+{
+    return currentPosition;
+}
+
+bool AsyncFileInputStream::setPosition (int64 newPosition)
+{
+    if (newPosition < 0 || buffers.size() == 0)
+        return false;
+
+    currentPosition = newPosition;
+    return true;
+}
+
+} // namespace juce
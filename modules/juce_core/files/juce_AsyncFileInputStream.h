@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An input stream that reads a file using an AsyncFileIO object, fetching the data
+    ahead of the position that is being read from.
+
+    The file is read in blocks, and while the caller is reading from one block, the
+    following ones are already being fetched in the background. When the stream is
+    read sequentially, the caller only has to wait for the disk if it gets ahead of
+    the read-ahead. Calling setPosition() to move outside the blocks that have been
+    fetched will discard them and start again from the new position.
+
+    AudioFormatManager::createReaderFor() can use one of these to open an audio file.
+
+    @see AsyncFileIO, AsyncFileOutputStream, FileInputStream
+*/
+class JUCE_API  AsyncFileInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a stream that performs its reads with the given AsyncFileIO object.
+        The AsyncFileIO must not be deleted before this stream.
+    */
+    AsyncFileInputStream (const File& fileToRead, AsyncFileIO& ioToUse,
+                          size_t bufferSize = 32768, int numBuffers = 3);
+
+    /** Creates a stream that uses its own AsyncFileIO object. */
+    AsyncFileInputStream (const File& fileToRead,
+                          size_t bufferSize = 32768, int numBuffers = 3);
+
+    /** Destructor.
+        This will wait for any reads that are still in progress before returning.
+    */
+    ~AsyncFileInputStream();
+
+    //==============================================================================
+    /** Returns the file that this stream is reading from. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the status of the stream.
+        The result will be ok if the file opened successfully. If an error occurs while
+        opening or reading the file, this will contain an error message.
+    */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the stream couldn't be opened for some reason. */
+    bool failedToOpen() const noexcept                  { return openFile == nullptr || ! openFile->openedOk(); }
+
+    /** Returns true if the stream opened without problems. */
+    bool openedOk() const noexcept                      { return ! failedToOpen(); }
+
+    //==============================================================================
+    int64 getTotalLength() override;
+    int read (void*, int) override;
+    bool isExhausted() override;
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+
+private:
+    //==============================================================================
+    struct Buffer;
+
+    File file;
+    OptionalScopedPointer<AsyncFileIO> io;
+    ScopedPointer<AsyncFileIO::OpenFile> openFile;
+    OwnedArray<Buffer> buffers;
+    const size_t bufferSize;
+    int currentBuffer = 0;
+    int64 currentPosition = 0, totalLength = 0;
+    Result status { Result::ok() };
+
+    void init (int numBuffers);
+    void startReading (Buffer&, int64 position);
+    void startReadingFrom (int64 position);
+    void waitForBuffer (Buffer&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileInputStream)
+};
+
+} // namespace juce
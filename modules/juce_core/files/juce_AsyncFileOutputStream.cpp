@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct AsyncFileOutputStream::Buffer
+{
+    Buffer (size_t size)  : data (size), finished (true) {}
+
+    HeapBlock<char> data;
+    size_t numUsed = 0;
+    int64 position = 0, result = 0;
+    bool isWriting = false;
+    WaitableEvent finished;
+};
+
+AsyncFileOutputStream::AsyncFileOutputStream (const File& f, AsyncFileIO& ioToUse,
+                                              size_t bufferSizeToUse, int numBuffers)
+    : file (f), io (&ioToUse, false), bufferSize (jmax ((size_t) 16, bufferSizeToUse))
+{
+    init (numBuffers);
+}
+
+AsyncFileOutputStream::AsyncFileOutputStream (const File& f, size_t bufferSizeToUse, int numBuffers)
+    : file (f), io (new AsyncFileIO (jmax (1, numBuffers)), true), bufferSize (jmax ((size_t) 16, bufferSizeToUse))
+{
+    init (numBuffers);
+}
+
+AsyncFileOutputStream::~AsyncFileOutputStream()
+{
+    flush();
+}
+
+void AsyncFileOutputStream::init (int numBuffers)
+{
+    openFile = io->openForWriting (file);
+    status = openFile->getStatus();
+
+    if (status.wasOk())
+    {
+        currentPosition = file.getSize();
+
+        for (int i = jmax (2, numBuffers); --i >= 0;)
+            buffers.add (new Buffer (bufferSize));
+
+        buffers.getUnchecked (0)->position = currentPosition;
+    }
+}
+
+void AsyncFileOutputStream::startWritingCurrentBuffer()
+{
+    auto& b = *buffers.getUnchecked (currentBuffer);
+
+    if (b.numUsed == 0)
+        return;
+
+    b.isWriting = true;
+    b.finished.reset();
+
+    auto* buffer = &b;
+
+    io->write (*openFile, b.position, b.data, b.numUsed, [buffer] (int64 result)
+    {
+        buffer->result = result;
+        buffer->finished.signal();
+    });
+
+    io->submit();
+
+    currentBuffer = (currentBuffer + 1) % buffers.size();
+
+    auto& next = *buffers.getUnchecked (currentBuffer);
+    waitForBuffer (next);
+    next.numUsed = 0;
+    next.position = currentPosition;
+}
+
+void AsyncFileOutputStream::waitForBuffer (Buffer& b)
+{
+    if (b.isWriting)
+    {
+        b.finished.wait();
+        b.isWriting = false;
+
+        if (b.result != (int64) b.numUsed && status.wasOk())
+            status = Result::fail ("Couldn't write to the file " + file.getFullPathName());
+    }
+}
+
+void AsyncFileOutputStream::flush()
+{
+    if (buffers.size() == 0)
+        return;
+
+    startWritingCurrentBuffer();
+
+    for (auto* b : buffers)
+        waitForBuffer (*b);
+}
+
+int64 AsyncFileOutputStream::getPosition()
+{
+    return currentPosition;
+}
+
+bool AsyncFileOutputStream::setPosition (int64 newPosition)
+{
+    if (buffers.size() == 0)
+        return false;
+
+    if (newPosition != currentPosition)
+    {
+        flush();
+        currentPosition = newPosition;
+
+        auto& b = *buffers.getUnchecked (currentBuffer);
+        b.numUsed = 0;
+        b.position = currentPosition;
+    }
+
+    return newPosition == currentPosition;
+}
+
+bool AsyncFileOutputStream::write (const void* src, size_t numBytes)
+{
+    jassert (src != nullptr && ((ssize_t) numBytes) >= 0);
+
+    if (status.failed())
+        return false;
+
+    auto* source = static_cast<const char*> (src);
+
+    while (numBytes > 0)
+    {
+        auto& b = *buffers.getUnchecked (currentBuffer);
+        auto numToCopy = jmin (numBytes, bufferSize - b.numUsed);
+
+        memcpy (b.data + b.numUsed, source, numToCopy);
+        b.numUsed += numToCopy;
+        source += numToCopy;
+        numBytes -= numToCopy;
+        currentPosition += (int64) numToCopy;
+
+        if (b.numUsed == bufferSize)
+            startWritingCurrentBuffer();
+    }
+
+    return status.wasOk();
+}
+
+} // namespace juce
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An output stream that writes to a file using an AsyncFileIO object, so that the
+    thread doing the writing doesn't have to wait for the disk.
+
+    Data is collected in a set of buffers, and as each one fills up, it's handed to the
+    AsyncFileIO to be written in the background while the next one is being filled. The
+    writing thread only has to block if it gets ahead of the disk by more than the total
+    size of the buffers, or when setPosition() or flush() are called.
+
+    This makes it a good choice for streaming large amounts of data, e.g. by passing one
+    to an AudioFormat to create an AudioFormatWriter.
+
+    @see AsyncFileIO, FileOutputStream
+*/
+class JUCE_API  AsyncFileOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates a stream that performs its writes with the given AsyncFileIO object.
+
+        The AsyncFileIO must not be deleted before this stream. As with FileOutputStream,
+        the file is created if it doesn't exist, and if it does, the stream's write position
+        will start at the end of it.
+    */
+    AsyncFileOutputStream (const File& fileToWriteTo, AsyncFileIO& ioToUse,
+                           size_t bufferSize = 65536, int numBuffers = 4);
+
+    /** Creates a stream that uses its own AsyncFileIO object. */
+    AsyncFileOutputStream (const File& fileToWriteTo,
+                           size_t bufferSize = 65536, int numBuffers = 4);
+
+    /** Destructor.
+        This will wait for all of the data to be written before returning.
+    */
+    ~AsyncFileOutputStream();
+
+    //==============================================================================
+    /** Returns the file that this stream is writing to. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the status of the stream.
+        The result will be ok if the file opened successfully. If an error occurs while
+        opening or writing to the file, this will contain an error message. Because the
+        writes happen in the background, an error may not be reported until a later call.
+    */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the stream couldn't be opened for some reason. */
+    bool failedToOpen() const noexcept                  { return openFile == nullptr || ! openFile->openedOk(); }
+
+    /** Returns true if the stream opened without problems. */
+    bool openedOk() const noexcept                      { return ! failedToOpen(); }
+
+    //==============================================================================
+    /** Waits until all the data that has been written so far has been passed to the OS. */
+    void flush() override;
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+    struct Buffer;
+
+    File file;
+    OptionalScopedPointer<AsyncFileIO> io;
+    ScopedPointer<AsyncFileIO::OpenFile> openFile;
+    OwnedArray<Buffer> buffers;
+    const size_t bufferSize;
+    int currentBuffer = 0;
+    int64 currentPosition = 0;
+    Result status { Result::ok() };
+
+    void init (int numBuffers);
+    void startWritingCurrentBuffer();
+    void waitForBuffer (Buffer&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileOutputStream)
+};
+
+} // namespace juce
@@ -989,16 +989,32 @@ bool File::createSymbolicLink (const File& linkFileToCreate, bool overwriteExist
 }
 
 //==============================================================================
-MemoryMappedFile::MemoryMappedFile (const File& file, MemoryMappedFile::AccessMode mode, bool exclusive)
+MemoryMappedFile::MemoryMappedFile (const File& file, MemoryMappedFile::AccessMode mode, bool exclusive, bool preloadPages)
     : range (0, file.getSize())
 {
-    openInternal (file, mode, exclusive);
+    openInternal (file, mode, exclusive, preloadPages);
 }
 
-MemoryMappedFile::MemoryMappedFile (const File& file, const Range<int64>& fileRange, AccessMode mode, bool exclusive)
+MemoryMappedFile::MemoryMappedFile (const File& file, const Range<int64>& fileRange, AccessMode mode,
+                                    bool exclusive, bool preloadPages)
     : range (fileRange.getIntersectionWith (Range<int64> (0, file.getSize())))
 {
-    openInternal (file, mode, exclusive);
+    openInternal (file, mode, exclusive, preloadPages);
+}
+
+Range<size_t> MemoryMappedFile::getPageRangeWithinMapping (Range<int64> fileRange) const noexcept
+{
+    auto r = fileRange.getIntersectionWith (range);
+
+    if (address == nullptr || r.isEmpty())
+        return {};
+
+    // the start of the mapping is always page-aligned, so rounding the offset down keeps the address aligned
+    auto pageSize = (int64) SystemStats::getPageSize();
+    auto start = r.getStart() - range.getStart();
+    start -= start % pageSize;
+
+    return Range<size_t> ((size_t) start, (size_t) (r.getEnd() - range.getStart()));
 }
 
 
@@ -1184,6 +1200,39 @@ public:
             expect (tempFile2.deleteFile());
         }
 
+        {
+            const File tempFile2 (tempFile.getNonexistentSibling (false));
+            MemoryBlock data (300000);
+
+            for (size_t i = 0; i < data.getSize(); ++i)
+                data[i] = (char) i;
+
+            expect (tempFile2.replaceWithData (data.getData(), data.getSize()));
+
+            {
+                auto faultsBefore = MemoryMappedFile::getPageFaultCounts();
+
+                MemoryMappedFile mmf (tempFile2, Range<int64> (5000, 250000), MemoryMappedFile::readOnly, false, true);
+                expect (mmf.getData() != nullptr);
+                expect (mmf.getRange().contains (Range<int64> (5000, 250000)));
+                expect (memcmp (mmf.getData(), addBytesToPointer (data.getData(), mmf.getRange().getStart()), mmf.getSize()) == 0);
+
+                auto faultsAfter = MemoryMappedFile::getPageFaultCounts();
+                expect (faultsAfter.numFaults >= faultsBefore.numFaults);
+                expect (faultsAfter.numMajorFaults <= faultsAfter.numFaults);
+
+                expect (mmf.setAccessPattern (MemoryMappedFile::randomAccess) || ! JUCE_LINUX);
+                expect (mmf.prefetch (Range<int64> (10000, 20000)) || ! JUCE_LINUX);
+                expect (! mmf.prefetch (Range<int64> (260000, 270000)));
+
+                // the OS may not allow any memory to be locked, but unlocking must work after a lock
+                if (mmf.lockInMemory (Range<int64> (6000, 7000)))
+                    expect (mmf.unlockFromMemory (Range<int64> (6000, 7000)));
+            }
+
+            expect (tempFile2.deleteFile());
+        }
+
         beginTest ("More writing");
 
         expect (tempFile.appendData ("abcdefghij", 10));
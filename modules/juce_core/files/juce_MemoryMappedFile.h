@@ -54,8 +54,12 @@ public:
         mapping as an effective way of communicating. If exclusive is true then the mapped file will
         be opened exclusively - preventing other apps to access the file which may improve the
         performance of accessing the file.
+
+        If preloadPages is true, the OS will be asked to read the whole mapping into memory straight
+        away, so that later accesses won't cause page faults. On Linux this uses MAP_POPULATE, and the
+        constructor blocks until it's done, but elsewhere it's the same as calling prefetch().
     */
-    MemoryMappedFile (const File& file, AccessMode mode, bool exclusive = false);
+    MemoryMappedFile (const File& file, AccessMode mode, bool exclusive = false, bool preloadPages = false);
 
     /** Opens a section of a file and maps it to an area of virtual memory.
 
@@ -72,11 +76,14 @@ public:
         NOTE: the start of the actual range used may be rounded-down to a multiple of the OS's page-size,
         so do not assume that the mapped memory will begin at exactly the position you requested - always
         use getRange() to check the actual range that is being used.
+
+        See the other constructor for an explanation of the exclusive and preloadPages flags.
     */
     MemoryMappedFile (const File& file,
                       const Range<int64>& fileRange,
                       AccessMode mode,
-                      bool exclusive = false);
+                      bool exclusive = false,
+                      bool preloadPages = false);
 
     /** Destructor. */
     ~MemoryMappedFile();
@@ -94,6 +101,67 @@ public:
     /** Returns the section of the file at which the mapped memory represents. */
     Range<int64> getRange() const noexcept      { return range; }
 
+    //==============================================================================
+    /** Hints that can be given to the OS about how the mapped memory will be accessed.
+        @see setAccessPattern
+    */
+    enum AccessPattern
+    {
+        normalAccess,       /**< No particular pattern - the OS will use its default read-ahead. */
+        sequentialAccess,   /**< The data will be read in order, so aggressive read-ahead is worthwhile.
+                                 This is what a newly-opened file uses. */
+        randomAccess        /**< The data will be read in a random order, so read-ahead would be wasted. */
+    };
+
+    /** Tells the OS how the memory is going to be accessed, so that it can adjust its read-ahead.
+        This does nothing on Windows, where the hint can only be given when a file is opened.
+        @returns true if the OS accepted the hint
+    */
+    bool setAccessPattern (AccessPattern) noexcept;
+
+    /** Asks the OS to start loading a section of the file into memory in the background.
+
+        This returns immediately, so it's a cheap way of avoiding page faults when a thread that
+        can't afford to block (e.g. an audio thread) is soon going to read the given section.
+        The range is a section of the file, as with getRange(), and will be clipped to the
+        mapped range.
+
+        @returns true if the OS accepted the request
+    */
+    bool prefetch (Range<int64> fileRange) const noexcept;
+
+    /** Locks a section of the mapped memory into physical memory, so that it can't be paged out.
+
+        The range is a section of the file, as with getRange(). The OS limits the amount of memory
+        that a process may lock, so this may fail for large ranges. Any locks are released when
+        this object is deleted.
+
+        @returns true if the section was locked
+        @see unlockFromMemory
+    */
+    bool lockInMemory (Range<int64> fileRange) noexcept;
+
+    /** Releases a lock that was taken with lockInMemory(). */
+    bool unlockFromMemory (Range<int64> fileRange) noexcept;
+
+    //==============================================================================
+    /** Holds the number of page faults that have occurred. @see getPageFaultCounts */
+    struct PageFaultCounts
+    {
+        int64 numFaults = 0;        /**< The total number of page faults. */
+        int64 numMajorFaults = 0;   /**< The faults that had to wait for data to be read from disk. This
+                                         will be zero on platforms that don't distinguish them. */
+    };
+
+    /** Returns the number of page faults that have occurred so far.
+
+        Comparing the counts before and after some code runs shows how often it had to wait for
+        mapped memory to be paged in. When forCallingThreadOnly is true, the counts only include
+        the faults caused by the calling thread, if the platform can provide that (Linux can),
+        otherwise they're for the whole process.
+    */
+    static PageFaultCounts getPageFaultCounts (bool forCallingThreadOnly = true) noexcept;
+
 private:
     //==============================================================================
     void* address = nullptr;
@@ -105,7 +173,8 @@ private:
     int fileHandle = 0;
    #endif
 
-    void openInternal (const File&, AccessMode, bool);
+    void openInternal (const File&, AccessMode, bool exclusive, bool preloadPages);
+    Range<size_t> getPageRangeWithinMapping (Range<int64> fileRange) const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryMappedFile)
 };
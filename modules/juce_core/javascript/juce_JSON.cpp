@@ -23,303 +23,143 @@
 namespace juce
 {
 
-struct JSONParser
+//==============================================================================
+/** Builds a var from the callbacks made by a JSONStreamParser. */
+struct JSONVarBuilder  : public JSONStreamParser::Handler
 {
-    static Result parseObjectOrArray (String::CharPointerType t, var& result)
+    JSONVarBuilder (bool mustBeObjectOrArray)  : requireObjectOrArray (mustBeObjectOrArray)
     {
-        t = t.findEndOfWhitespace();
+        containers.ensureStorageAllocated (32);
+    }
 
-        switch (t.getAndAdvance())
+    bool startObject() override
+    {
+        if (auto* v = createValue())
         {
-            case 0:      result = var(); return Result::ok();
-            case '{':    return parseObject (t, result);
-            case '[':    return parseArray  (t, result);
+            *v = new DynamicObject();
+            containers.add (v);
+            return true;
         }
 
-        return createFail ("Expected '{' or '['", &t);
+        return false;
     }
 
-    static Result parseString (const juce_wchar quoteChar, String::CharPointerType& t, var& result)
+    bool startArray() override
     {
-        MemoryOutputStream buffer (256);
-
-        for (;;)
+        if (auto* v = createValue())
         {
-            auto c = t.getAndAdvance();
-
-            if (c == quoteChar)
-                break;
-
-            if (c == '\\')
-            {
-                c = t.getAndAdvance();
-
-                switch (c)
-                {
-                    case '"':
-                    case '\'':
-                    case '\\':
-                    case '/':  break;
-
-                    case 'a':  c = '\a'; break;
-                    case 'b':  c = '\b'; break;
-                    case 'f':  c = '\f'; break;
-                    case 'n':  c = '\n'; break;
-                    case 'r':  c = '\r'; break;
-                    case 't':  c = '\t'; break;
-
-                    case 'u':
-                    {
-                        c = 0;
-
-                        for (int i = 4; --i >= 0;)
-                        {
-                            auto digitValue = CharacterFunctions::getHexDigitValue (t.getAndAdvance());
-
-                            if (digitValue < 0)
-                                return createFail ("Syntax error in unicode escape sequence");
-
-                            c = (juce_wchar) ((c << 4) + static_cast<juce_wchar> (digitValue));
-                        }
-
-                        break;
-                    }
-                }
-            }
-
-            if (c == 0)
-                return createFail ("Unexpected end-of-input in string constant");
-
-            buffer.appendUTF8Char (c);
+            *v = var (Array<var>());
+            containers.add (v);
+            return true;
         }
 
-        result = buffer.toUTF8();
-        return Result::ok();
+        return false;
     }
 
-    static Result parseAny (String::CharPointerType& t, var& result)
-    {
-        t = t.findEndOfWhitespace();
-        auto t2 = t;
+    bool endObject() override               { containers.removeLast(); return true; }
+    bool endArray() override                { containers.removeLast(); return true; }
 
-        switch (t2.getAndAdvance())
+    bool propertyName (const JSONStreamParser::Text& name) override
+    {
+        if (name.isEmpty())
         {
-            case '{':    t = t2; return parseObject (t, result);
-            case '[':    t = t2; return parseArray  (t, result);
-            case '"':    t = t2; return parseString ('"',  t, result);
-            case '\'':   t = t2; return parseString ('\'', t, result);
-
-            case '-':
-                t2 = t2.findEndOfWhitespace();
-                if (! CharacterFunctions::isDigit (*t2))
-                    break;
-
-                t = t2;
-                return parseNumber (t, result, true);
-
-            case '0': case '1': case '2': case '3': case '4':
-            case '5': case '6': case '7': case '8': case '9':
-                return parseNumber (t, result, false);
-
-            case 't':   // "true"
-                if (t2.getAndAdvance() == 'r' && t2.getAndAdvance() == 'u' && t2.getAndAdvance() == 'e')
-                {
-                    t = t2;
-                    result = var (true);
-                    return Result::ok();
-                }
-                break;
-
-            case 'f':   // "false"
-                if (t2.getAndAdvance() == 'a' && t2.getAndAdvance() == 'l'
-                      && t2.getAndAdvance() == 's' && t2.getAndAdvance() == 'e')
-                {
-                    t = t2;
-                    result = var (false);
-                    return Result::ok();
-                }
-                break;
-
-            case 'n':   // "null"
-                if (t2.getAndAdvance() == 'u' && t2.getAndAdvance() == 'l' && t2.getAndAdvance() == 'l')
-                {
-                    t = t2;
-                    result = var();
-                    return Result::ok();
-                }
-                break;
-
-            default:
-                break;
+            error = "Expected object member declaration, but found: \"\"";
+            return false;
         }
 
-        return createFail ("Syntax error", &t);
+        propertyID = Identifier (name.start, name.end);
+        return true;
     }
 
-private:
-    static Result createFail (const char* const message, const String::CharPointerType* location = nullptr)
+    bool stringValue (const JSONStreamParser::Text& value) override  { return setValue (value.toString()); }
+    bool doubleValue (double value) override                         { return setValue (value); }
+    bool boolValue (bool value) override                             { return setValue (value); }
+    bool nullValue() override                                        { return setValue (var()); }
+
+    bool intValue (int64 value) override
     {
-        String m (message);
-        if (location != nullptr)
-            m << ": \"" << String (*location, 20) << '"';
+        if (((value < 0 ? -value : value) >> 31) != 0)
+            return setValue (value);
 
-        return Result::fail (m);
+        return setValue ((int) value);
     }
 
-    static Result parseNumber (String::CharPointerType& t, var& result, const bool isNegative)
+    Result parseText (const String& text)
     {
-        auto oldT = t;
+        auto t = text.getCharPointer().findEndOfWhitespace();
 
-        int64 intValue = t.getAndAdvance() - '0';
-        jassert (intValue >= 0 && intValue < 10);
+        if (t.isEmpty())
+            return Result::ok();
 
-        for (;;)
-        {
-            auto previousChar = t;
-            auto c = t.getAndAdvance();
-            auto digit = ((int) c) - '0';
-
-            if (isPositiveAndBelow (digit, 10))
-            {
-                intValue = intValue * 10 + digit;
-                continue;
-            }
-
-            if (c == 'e' || c == 'E' || c == '.')
-            {
-                t = oldT;
-                auto asDouble = CharacterFunctions::readDoubleValue (t);
-                result = isNegative ? -asDouble : asDouble;
-                return Result::ok();
-            }
-
-            if (CharacterFunctions::isWhitespace (c)
-                 || c == ',' || c == '}' || c == ']' || c == 0)
-            {
-                t = previousChar;
-                break;
-            }
+        if (requireObjectOrArray && *t != '{' && *t != '[')
+            return Result::fail ("Expected '{' or '[': \"" + String (t, 20) + "\"");
 
-            return createFail ("Syntax error in number", &oldT);
-        }
-
-        auto correctedValue = isNegative ? -intValue : intValue;
-
-        if ((intValue >> 31) != 0)
-            result = correctedValue;
-        else
-            result = (int) correctedValue;
-
-        return Result::ok();
+        return getResult (JSONStreamParser::parse (text.toRawUTF8(), text.getNumBytesAsUTF8(), *this));
     }
 
-    static Result parseObject (String::CharPointerType& t, var& result)
+    Result getResult (const Result& r)
     {
-        auto resultObject = new DynamicObject();
-        result = resultObject;
-        auto& resultProperties = resultObject->getProperties();
-
-        for (;;)
+        if (r.failed())
         {
-            t = t.findEndOfWhitespace();
-
-            auto oldT = t;
-            auto c = t.getAndAdvance();
-
-            if (c == '}')
-                break;
-
-            if (c == 0)
-                return createFail ("Unexpected end-of-input in object declaration");
-
-            if (c == '"')
-            {
-                var propertyNameVar;
-                auto r = parseString ('"', t, propertyNameVar);
-
-                if (r.failed())
-                    return r;
-
-                const Identifier propertyName (propertyNameVar.toString());
-
-                if (propertyName.isValid())
-                {
-                    t = t.findEndOfWhitespace();
-                    oldT = t;
-
-                    auto c2 = t.getAndAdvance();
-
-                    if (c2 != ':')
-                        return createFail ("Expected ':', but found", &oldT);
-
-                    resultProperties.set (propertyName, var());
-                    var* propertyValue = resultProperties.getVarPointer (propertyName);
+            result = var();
+            return error.isNotEmpty() ? Result::fail (error) : r;
+        }
 
-                    auto r2 = parseAny (t, *propertyValue);
+        return r;
+    }
 
-                    if (r2.failed())
-                        return r2;
+    var result;
+    bool hasStarted = false;
 
-                    t = t.findEndOfWhitespace();
-                    oldT = t;
+private:
+    const bool requireObjectOrArray;
+    Array<var*> containers;
+    Identifier propertyID;
+    String error;
 
-                    auto nextChar = t.getAndAdvance();
+    var* createValue()
+    {
+        if (containers.isEmpty())
+        {
+            if (hasStarted)
+                return nullptr;
 
-                    if (nextChar == ',')
-                        continue;
+            hasStarted = true;
+            return &result;
+        }
 
-                    if (nextChar == '}')
-                        break;
-                }
-            }
+        auto& container = *containers.getLast();
 
-            return createFail ("Expected object member declaration, but found", &oldT);
+        if (auto* array = container.getArray())
+        {
+            array->add (var());
+            return &array->getReference (array->size() - 1);
         }
 
-        return Result::ok();
+        auto& properties = container.getDynamicObject()->getProperties();
+        properties.set (propertyID, var());
+        return properties.getVarPointer (propertyID);
     }
 
-    static Result parseArray (String::CharPointerType& t, var& result)
+    template <typename ValueType>
+    bool setValue (const ValueType& value)
     {
-        result = var (Array<var>());
-        auto* destArray = result.getArray();
-
-        for (;;)
+        if (containers.isEmpty() && requireObjectOrArray)
         {
-            t = t.findEndOfWhitespace();
-
-            auto oldT = t;
-            auto c = t.getAndAdvance();
-
-            if (c == ']')
-                break;
-
-            if (c == 0)
-                return createFail ("Unexpected end-of-input in array declaration");
-
-            t = oldT;
-            destArray->add (var());
-            auto r = parseAny (t, destArray->getReference (destArray->size() - 1));
-
-            if (r.failed())
-                return r;
-
-            t = t.findEndOfWhitespace();
-            oldT = t;
-
-            auto nextChar = t.getAndAdvance();
-
-            if (nextChar == ',')
-                continue;
-
-            if (nextChar == ']')
-                break;
+            error = "Expected '{' or '['";
+            return false;
+        }
 
-            return createFail ("Expected object array item, but found", &oldT);
+        if (auto* v = createValue())
+        {
+            *v = value;
+            return true;
         }
 
-        return Result::ok();
+        return false;
     }
+
+    JUCE_DECLARE_NON_COPYABLE (JSONVarBuilder)
 };
 
 //==============================================================================
@@ -477,27 +317,56 @@ var JSON::parse (const String& text)
 
 var JSON::fromString (StringRef text)
 {
-    var result;
+    JSONVarBuilder builder (false);
 
-    if (! JSONParser::parseAny (text.text, result))
-        result = var();
+   #if JUCE_STRING_UTF_TYPE == 8
+    auto r = JSONStreamParser::parse (text.text.getAddress(), text.text.sizeInBytes() - 1, builder);
+   #else
+    const String utf8 (text);
+    auto r = JSONStreamParser::parse (utf8.toRawUTF8(), utf8.getNumBytesAsUTF8(), builder);
+   #endif
 
-    return result;
+    if (builder.getResult (r).failed())
+        return {};
+
+    return builder.result;
 }
 
 var JSON::parse (InputStream& input)
 {
-    return parse (input.readEntireStreamAsString());
+    auto startPosition = input.getPosition();
+    JSONVarBuilder builder (true);
+
+    if (builder.getResult (JSONStreamParser::parse (input, builder)).wasOk())
+        return builder.result;
+
+    // If the stream wasn't UTF-8, fall back to letting the stream work out the encoding
+    if (! builder.hasStarted && input.setPosition (startPosition))
+        return parse (input.readEntireStreamAsString());
+
+    return {};
 }
 
 var JSON::parse (const File& file)
 {
-    return parse (file.loadFileAsString());
+    JSONVarBuilder builder (true);
+
+    if (builder.getResult (JSONStreamParser::parse (file, builder)).wasOk())
+        return builder.result;
+
+    // If the file wasn't UTF-8, fall back to letting the File class work out the encoding
+    if (! builder.hasStarted)
+        return parse (file.loadFileAsString());
+
+    return {};
 }
 
 Result JSON::parse (const String& text, var& result)
 {
-    return JSONParser::parseObjectOrArray (text.getCharPointer(), result);
+    JSONVarBuilder builder (true);
+    auto r = builder.parseText (text);
+    result = builder.result;
+    return r;
 }
 
 String JSON::toString (const var& data, const bool allOnOneLine, int maximumDecimalPlaces)
@@ -521,12 +390,25 @@ String JSON::escapeString (StringRef s)
 
 Result JSON::parseQuotedString (String::CharPointerType& t, var& result)
 {
-    auto quote = t.getAndAdvance();
-
-    if (quote == '"' || quote == '\'')
-        return JSONParser::parseString (quote, t, result);
-
-    return Result::fail ("Not a quoted string!");
+    String text;
+
+   #if JUCE_STRING_UTF_TYPE == 8
+    auto start = t.getAddress();
+    const char* pos = start;
+    auto r = JSONStreamParser::parseQuotedString (pos, t.findTerminatingNull().getAddress(), text);
+    t = String::CharPointerType (start + (pos - start));
+   #else
+    const String utf8 (t);
+    auto start = utf8.toRawUTF8();
+    auto pos = start;
+    auto r = JSONStreamParser::parseQuotedString (pos, start + utf8.getNumBytesAsUTF8(), text);
+    t += (int) CharPointer_UTF8 (start).lengthUpTo (CharPointer_UTF8 (pos));
+   #endif
+
+    if (r.wasOk())
+        result = text;
+
+    return r;
 }
 
 //==============================================================================
@@ -643,7 +525,177 @@ public:
             String parsedString (JSON::toString (parsed, oneLine));
             expect (asString.isNotEmpty() && parsedString == asString);
         }
+
+        beginTest ("Streaming parser");
+        {
+            EventRecorder recorder;
+            const String json ("{ \"a\": [1, -2, 3.5, -1e2, true, false, null, \"x\\ty\", \"\\ud83d\\ude00\"], \"\\u00e9\": {} }");
+
+            expect (JSONStreamParser::parse (json.toRawUTF8(), json.getNumBytesAsUTF8(), recorder).wasOk());
+            expectEquals (recorder.events, String ("{ key:a [ 1 -2 3.5 -100 true false null str:x\ty str:")
+                                             + String::charToString ((juce_wchar) 0x1f600)
+                                             + " ] key:" + String::charToString ((juce_wchar) 0xe9) + " { } }");
+
+            for (auto* bad : { "{ \"a\" 1 }", "[1, 2", "{ \"a\": tru }", "[ 12x ]", "[ \"abc ]", "" })
+            {
+                EventRecorder r;
+                expect (JSONStreamParser::parse (bad, strlen (bad), r).failed());
+            }
+
+            expect (JSON::fromString ("  \"abc\"  ") == var ("abc"));
+            expect (JSON::fromString ("-  42") == var (-42));
+            expect (JSON::parse ("123").isVoid());
+            expect (JSON::parse ("{ \"\": 1 }").isVoid());
+            expect (JSON::parse ("[1, 2, ]").size() == 2);
+        }
+
+        beginTest ("Malformed numbers");
+        {
+            for (auto* bad : { "[1.5.3]", "[1e5e5]", "[1e5.3]", "[1.5x]", "[1e]", "[1e+]", "[1+2]", "[1.2-3]", "[12e-]" })
+                expect (JSON::parse (bad).isVoid(), bad);
+
+            expect (JSON::parse ("[1.5e3]")[0] == var (1500.0));
+            expect (JSON::parse ("[1E-2]")[0] == var (0.01));
+            expect (JSON::parse ("[2e+2]")[0] == var (200.0));
+            expect (JSON::parse ("[ -1.25 , 3 ]")[1] == var (3));
+        }
+
+        beginTest ("Escape sequences");
+        {
+            const String eAcute (String::charToString ((juce_wchar) 0xe9));
+            const String euro (String::charToString ((juce_wchar) 0x20ac));
+
+            expect (JSON::parse ("[\"a\\\"b\\\\c\\/d\"]")[0] == var ("a\"b\\c/d"));
+            expect (JSON::parse ("[\"\\" + eAcute + "x\\" + euro + "\"]")[0] == var (eAcute + "x" + euro));
+            expect (JSON::parse ("[\"\\u00e9\\u20AC\"]")[0] == var (eAcute + euro));
+            expect (JSON::parse ("[\"\\ud83d\"]")[0] == var (String::charToString ((juce_wchar) 0xd83d)));
+
+            for (auto* bad : { "[\"\\u12\"]", "[\"\\u00zz\"]", "[\"\\u0000\"]", "[\"abc\\", "[\"abc" })
+                expect (JSON::parse (bad).isVoid(), bad);
+
+            const String js ("'it\\'s \\" + eAcute + "' + rest");
+            auto t = js.getCharPointer();
+            var parsed;
+            expect (JSON::parseQuotedString (t, parsed).wasOk());
+            expect (parsed == var ("it's " + eAcute));
+            expect (String (t) == " + rest");
+
+            auto noQuote = String ("abc").getCharPointer();
+            expect (JSON::parseQuotedString (noQuote, parsed).failed());
+
+            JSONStreamParser::Text text;
+            const char data[] = "abcdef";
+            text.start = CharPointer_UTF8 (data);
+            text.end   = CharPointer_UTF8 (data + 3);
+
+            expect (text == "abc");
+            expect (text != "ab");
+            expect (text != "abcd");
+            expect (text != "");
+        }
+
+        beginTest ("Streaming from an InputStream");
+        {
+            // This is long enough that strings will straddle the parser's read buffer
+            var v;
+
+            for (int i = 0; i < 5000; ++i)
+                v.append (createRandomWideCharString (r) + "\\\"" + String (i));
+
+            auto asString = JSON::toString (v);
+            MemoryInputStream in (asString.toRawUTF8(), asString.getNumBytesAsUTF8(), false);
+            auto parsed = JSON::parse (in);
+
+            expect (parsed.size() == v.size() && JSON::toString (parsed) == asString);
+
+            MemoryOutputStream utf16;
+            utf16.writeText (asString, true, true);
+            MemoryInputStream utf16In (utf16.getData(), utf16.getDataSize(), false);
+            expect (JSON::toString (JSON::parse (utf16In)) == asString);
+        }
+
+        beginTest ("Streaming writer");
+        {
+            for (int i = 100; --i >= 0;)
+            {
+                auto v = createRandomVar (r, 0);
+                auto oneLine = r.nextBool();
+
+                MemoryOutputStream out;
+
+                {
+                    JSONStreamWriter writer (out, oneLine);
+                    writeWithStreamWriter (writer, v);
+                }
+
+                expectEquals (out.toString(), JSON::toString (v, oneLine));
+
+                MemoryOutputStream out2;
+
+                {
+                    JSONStreamWriter writer (out2, oneLine);
+                    writer.startArray();
+                    writer.writeValue (v);
+                    writer.endArray();
+                }
+
+                expectEquals (out2.toString(), JSON::toString (var (Array<var> (&v, 1)), oneLine));
+            }
+        }
+    }
+
+    static void writeWithStreamWriter (JSONStreamWriter& writer, const var& v)
+    {
+        if (auto* array = v.getArray())
+        {
+            writer.startArray();
+
+            for (auto& item : *array)
+                writeWithStreamWriter (writer, item);
+
+            writer.endArray();
+        }
+        else if (auto* object = v.getDynamicObject())
+        {
+            writer.startObject();
+
+            for (auto& property : object->getProperties())
+            {
+                writer.writeKey (property.name.toString());
+                writeWithStreamWriter (writer, property.value);
+            }
+
+            writer.endObject();
+        }
+        else if (v.isString())  writer.writeString (v.toString());
+        else if (v.isInt())     writer.writeInt ((int) v);
+        else if (v.isInt64())   writer.writeInt ((int64) v);
+        else if (v.isDouble())  writer.writeDouble ((double) v);
+        else if (v.isBool())    writer.writeBool ((bool) v);
+        else                    writer.writeNull();
     }
+
+    struct EventRecorder  : public JSONStreamParser::Handler
+    {
+        bool startObject() override                                     { return add ("{"); }
+        bool endObject() override                                       { return add ("}"); }
+        bool startArray() override                                      { return add ("["); }
+        bool endArray() override                                        { return add ("]"); }
+        bool propertyName (const JSONStreamParser::Text& t) override    { return add ("key:" + t.toString()); }
+        bool stringValue (const JSONStreamParser::Text& t) override     { return add ("str:" + t.toString()); }
+        bool intValue (int64 value) override                            { return add (String (value)); }
+        bool doubleValue (double value) override                        { return add (String (value)); }
+        bool boolValue (bool value) override                            { return add (value ? "true" : "false"); }
+        bool nullValue() override                                       { return add ("null"); }
+
+        bool add (const String& event)
+        {
+            events << (events.isEmpty() ? "" : " ") << event;
+            return true;
+        }
+
+        String events;
+    };
 };
 
 static JSONTests JSONUnitTests;
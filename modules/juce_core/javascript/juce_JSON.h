@@ -31,7 +31,10 @@ namespace juce
     functions allow you to parse JSON into a var object, and to convert a var
     object to JSON-formatted text.
 
-    @see var
+    If you need to read or write documents without holding the whole thing in a
+    var, see the JSONStreamParser and JSONStreamWriter classes.
+
+    @see var, JSONStreamParser, JSONStreamWriter
 */
 class JUCE_API  JSON
 {
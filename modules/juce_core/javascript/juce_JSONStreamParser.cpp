@@ -0,0 +1,653 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct JSONStreamParser::Reader
+{
+    Reader (const char* data, size_t numBytes, Handler& h)
+        : handler (h), pos (data), end (data + numBytes)
+    {
+    }
+
+    Reader (InputStream& in, Handler& h)
+        : handler (h), stream (&in), streamBuffer ((size_t) streamBufferSize)
+    {
+        pos = end = streamBuffer;
+    }
+
+    Result parseDocument()
+    {
+        auto bomResult = skipByteOrderMark();
+
+        if (bomResult.failed())
+            return bomResult;
+
+        containers.ensureStorageAllocated (32);
+
+        bool expectingValue = true;
+
+        for (;;)
+        {
+            if (expectingValue)
+            {
+                skipWhitespace();
+                auto c = peek();
+
+                if (c == '{')
+                {
+                    ++pos;
+
+                    if (! handler.startObject())
+                        return createCancelledFail();
+
+                    containers.add (objectContainer);
+
+                    auto r = parseMemberName (expectingValue);
+
+                    if (r.failed())
+                        return r;
+                }
+                else if (c == '[')
+                {
+                    ++pos;
+
+                    if (! handler.startArray())
+                        return createCancelledFail();
+
+                    containers.add (arrayContainer);
+
+                    skipWhitespace();
+                    c = peek();
+
+                    if (c == ']')
+                    {
+                        ++pos;
+                        containers.removeLast();
+
+                        if (! handler.endArray())
+                            return createCancelledFail();
+
+                        expectingValue = false;
+                    }
+                    else if (c == 0)
+                    {
+                        return createFail ("Unexpected end-of-input in array declaration");
+                    }
+                }
+                else
+                {
+                    auto r = parseScalar();
+
+                    if (r.failed())
+                        return r;
+
+                    expectingValue = false;
+                }
+
+                continue;
+            }
+
+            if (containers.isEmpty())
+                return Result::ok();
+
+            skipWhitespace();
+            auto c = peek();
+
+            if (containers.getLast() == arrayContainer)
+            {
+                if (c == ']')
+                {
+                    ++pos;
+                    containers.removeLast();
+
+                    if (! handler.endArray())
+                        return createCancelledFail();
+                }
+                else if (c == ',')
+                {
+                    ++pos;
+                    skipWhitespace();
+                    c = peek();
+
+                    if (c == ']')
+                        continue;   // a trailing comma is allowed
+
+                    if (c == 0)
+                        return createFail ("Unexpected end-of-input in array declaration");
+
+                    expectingValue = true;
+                }
+                else
+                {
+                    return createFail ("Expected object array item, but found", true);
+                }
+            }
+            else
+            {
+                if (c == '}')
+                {
+                    ++pos;
+                    containers.removeLast();
+
+                    if (! handler.endObject())
+                        return createCancelledFail();
+                }
+                else if (c == ',')
+                {
+                    ++pos;
+                    auto r = parseMemberName (expectingValue);
+
+                    if (r.failed())
+                        return r;
+                }
+                else
+                {
+                    return createFail ("Expected object member declaration, but found", true);
+                }
+            }
+        }
+    }
+
+    Result parseQuotedString (String& result)
+    {
+        auto quoteChar = getAndAdvance();
+
+        if (quoteChar != '"' && quoteChar != '\'')
+            return Result::fail ("Not a quoted string!");
+
+        Text text;
+        auto r = parseString (quoteChar, text);
+
+        if (r.wasOk())
+            result = text.toString();
+
+        return r;
+    }
+
+    const char* getPosition() const noexcept    { return pos; }
+
+private:
+    //==============================================================================
+    Handler& handler;
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    InputStream* stream = nullptr;
+    HeapBlock<char> streamBuffer;
+    MemoryOutputStream scratch;
+    Array<uint8> containers;
+
+    enum { objectContainer, arrayContainer };
+    enum { streamBufferSize = 65536, maxNumberLength = 256 };
+
+    //==============================================================================
+    bool refill()
+    {
+        if (stream == nullptr)
+            return false;
+
+        auto numRead = stream->read (streamBuffer, (int) streamBufferSize);
+
+        if (numRead <= 0)
+            return false;
+
+        pos = streamBuffer;
+        end = pos + numRead;
+        return true;
+    }
+
+    // Returns 0 at the end of the input
+    char peek()
+    {
+        if (pos < end || refill())
+            return *pos;
+
+        return 0;
+    }
+
+    char getAndAdvance()
+    {
+        auto c = peek();
+
+        if (c != 0)
+            ++pos;
+
+        return c;
+    }
+
+    void skipWhitespace()
+    {
+        for (;;)
+        {
+            while (pos < end)
+            {
+                if (! CharacterFunctions::isWhitespace (*pos))
+                    return;
+
+                ++pos;
+            }
+
+            if (! refill())
+                return;
+        }
+    }
+
+    Result skipByteOrderMark()
+    {
+        if (peek() == 0)
+            return Result::ok();
+
+        auto numAvailable = (size_t) (end - pos);
+        auto bytes = reinterpret_cast<const uint8*> (pos);
+
+        if (numAvailable >= 2 && ((bytes[0] == 0xff && bytes[1] == 0xfe) || (bytes[0] == 0xfe && bytes[1] == 0xff)))
+            return Result::fail ("UTF-16 encoded JSON is not supported by the streaming parser");
+
+        if (numAvailable >= 3 && CharPointer_UTF8::isByteOrderMark (pos))
+            pos += 3;
+
+        return Result::ok();
+    }
+
+    //==============================================================================
+    Result parseMemberName (bool& expectingValue)
+    {
+        skipWhitespace();
+        auto c = peek();
+
+        if (c == '"')
+        {
+            ++pos;
+            Text name;
+            auto r = parseString ('"', name);
+
+            if (r.failed())
+                return r;
+
+            if (! handler.propertyName (name))
+                return createCancelledFail();
+
+            skipWhitespace();
+
+            if (peek() != ':')
+                return createFail ("Expected ':', but found", true);
+
+            ++pos;
+            expectingValue = true;
+            return Result::ok();
+        }
+
+        if (c == '}')
+        {
+            ++pos;
+            containers.removeLast();
+            expectingValue = false;
+            return handler.endObject() ? Result::ok() : createCancelledFail();
+        }
+
+        if (c == 0)
+            return createFail ("Unexpected end-of-input in object declaration");
+
+        return createFail ("Expected object member declaration, but found", true);
+    }
+
+    bool matchKeyword (const char* keyword)
+    {
+        for (++keyword; *keyword != 0; ++keyword)
+            if (getAndAdvance() != *keyword)
+                return false;
+
+        return true;
+    }
+
+    Result parseScalar()
+    {
+        auto c = peek();
+
+        switch (c)
+        {
+            case '"':
+            case '\'':
+            {
+                ++pos;
+                Text value;
+                auto r = parseString (c, value);
+
+                if (r.failed())
+                    return r;
+
+                return handler.stringValue (value) ? Result::ok() : createCancelledFail();
+            }
+
+            case '-':
+                ++pos;
+                skipWhitespace();
+
+                if (! CharacterFunctions::isDigit (peek()))
+                    break;
+
+                return parseNumber (true);
+
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                return parseNumber (false);
+
+            case 't':
+                ++pos;
+                if (! matchKeyword ("true"))   break;
+                return handler.boolValue (true) ? Result::ok() : createCancelledFail();
+
+            case 'f':
+                ++pos;
+                if (! matchKeyword ("false"))  break;
+                return handler.boolValue (false) ? Result::ok() : createCancelledFail();
+
+            case 'n':
+                ++pos;
+                if (! matchKeyword ("null"))   break;
+                return handler.nullValue() ? Result::ok() : createCancelledFail();
+
+            default:
+                break;
+        }
+
+        return createFail ("Syntax error", true);
+    }
+
+    Result parseNumber (bool isNegative)
+    {
+        char text[maxNumberLength + 1];
+        int length = 0;
+        int64 intValue = 0;
+        bool isDouble = false, hasDecimalPoint = false, hasExponent = false, needsExponentDigit = false;
+
+        for (;;)
+        {
+            auto c = peek();
+
+            if (CharacterFunctions::isDigit (c))
+            {
+                intValue = intValue * 10 + (c - '0');
+                needsExponentDigit = false;
+            }
+            else if (c == '.' && ! (hasDecimalPoint || hasExponent))
+            {
+                isDouble = hasDecimalPoint = true;
+            }
+            else if ((c == 'e' || c == 'E') && ! hasExponent)
+            {
+                isDouble = hasExponent = needsExponentDigit = true;
+            }
+            else if ((c == '-' || c == '+') && needsExponentDigit && (text[length - 1] == 'e' || text[length - 1] == 'E'))
+            {
+                // a sign is only allowed directly after the 'e'
+            }
+            else
+            {
+                if (needsExponentDigit
+                     || ! (c == 0 || c == ',' || c == '}' || c == ']' || CharacterFunctions::isWhitespace (c)))
+                    return createFail ("Syntax error in number", true);
+
+                break;
+            }
+
+            if (length == maxNumberLength)
+                return createFail ("Syntax error in number", true);
+
+            text[length++] = c;
+            ++pos;
+        }
+
+        if (isDouble)
+        {
+            text[length] = 0;
+            CharPointer_ASCII t (text);
+            auto value = CharacterFunctions::readDoubleValue (t);
+
+            return handler.doubleValue (isNegative ? -value : value) ? Result::ok()
+                                                                     : createCancelledFail();
+        }
+
+        return handler.intValue (isNegative ? -intValue : intValue) ? Result::ok()
+                                                                    : createCancelledFail();
+    }
+
+    //==============================================================================
+    Result parseString (char quoteChar, Text& result)
+    {
+        // Fast path: if there are no escape sequences, the string can be referenced in-place
+        for (auto p = pos; p < end; ++p)
+        {
+            auto c = *p;
+
+            if (c == quoteChar)
+            {
+                result.start = CharPointer_UTF8 (pos);
+                result.end   = CharPointer_UTF8 (p);
+                pos = p + 1;
+                return Result::ok();
+            }
+
+            if (c == '\\' || c == 0)
+            {
+                scratch.reset();
+                scratch.write (pos, (size_t) (p - pos));
+                pos = p;
+                return parseEscapedString (quoteChar, result);
+            }
+        }
+
+        scratch.reset();
+        scratch.write (pos, (size_t) (end - pos));
+        pos = end;
+        return parseEscapedString (quoteChar, result);
+    }
+
+    Result parseEscapedString (char quoteChar, Text& result)
+    {
+        juce_wchar pendingHighSurrogate = 0;
+
+        for (;;)
+        {
+            auto c = getAndAdvance();
+
+            if (c == quoteChar)
+                break;
+
+            if (c == 0)
+                return createFail ("Unexpected end-of-input in string constant");
+
+            if (c != '\\')
+            {
+                if (pendingHighSurrogate != 0)
+                {
+                    scratch.appendUTF8Char (pendingHighSurrogate);
+                    pendingHighSurrogate = 0;
+                }
+
+                scratch.writeByte (c);
+                continue;
+            }
+
+            auto escaped = (juce_wchar) (uint8) getAndAdvance();
+
+            if (escaped >= 0x80)
+            {
+                // An escaped non-ASCII character stands for itself, so its UTF-8 bytes are
+                // copied through as they are, the same as an unescaped one would be.
+                if (pendingHighSurrogate != 0)
+                {
+                    scratch.appendUTF8Char (pendingHighSurrogate);
+                    pendingHighSurrogate = 0;
+                }
+
+                scratch.writeByte ((char) escaped);
+                continue;
+            }
+
+            switch (escaped)
+            {
+                case 'a':  escaped = '\a'; break;
+                case 'b':  escaped = '\b'; break;
+                case 'f':  escaped = '\f'; break;
+                case 'n':  escaped = '\n'; break;
+                case 'r':  escaped = '\r'; break;
+                case 't':  escaped = '\t'; break;
+
+                case 'u':
+                {
+                    escaped = 0;
+
+                    for (int i = 4; --i >= 0;)
+                    {
+                        auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) getAndAdvance());
+
+                        if (digitValue < 0)
+                            return createFail ("Syntax error in unicode escape sequence");
+
+                        escaped = (juce_wchar) ((escaped << 4) + static_cast<juce_wchar> (digitValue));
+                    }
+
+                    if (pendingHighSurrogate != 0 && escaped >= 0xdc00 && escaped <= 0xdfff)
+                    {
+                        scratch.appendUTF8Char (0x10000 + ((pendingHighSurrogate - 0xd800) << 10) + (escaped - 0xdc00));
+                        pendingHighSurrogate = 0;
+                        continue;
+                    }
+
+                    break;
+                }
+
+                default:
+                    break;
+            }
+
+            if (escaped == 0)
+                return createFail ("Unexpected end-of-input in string constant");
+
+            if (pendingHighSurrogate != 0)
+            {
+                scratch.appendUTF8Char (pendingHighSurrogate);
+                pendingHighSurrogate = 0;
+            }
+
+            if (escaped >= 0xd800 && escaped <= 0xdbff)
+                pendingHighSurrogate = escaped;
+            else
+                scratch.appendUTF8Char (escaped);
+        }
+
+        if (pendingHighSurrogate != 0)
+            scratch.appendUTF8Char (pendingHighSurrogate);
+
+        auto data = static_cast<const char*> (scratch.getData());
+        result.start = CharPointer_UTF8 (data);
+        result.end   = CharPointer_UTF8 (data + scratch.getDataSize());
+        return Result::ok();
+    }
+
+    //==============================================================================
+    Result createFail (const char* message, bool showLocation = false)
+    {
+        String m (message);
+
+        if (showLocation)
+        {
+            peek();
+
+            auto p = pos;
+
+            for (int i = 0; i < 20 && p < end && *p != 0; ++i)
+            {
+                ++p;
+
+                while (p < end && (*p & 0xc0) == 0x80)
+                    ++p;
+            }
+
+            m << ": \"" << String (CharPointer_UTF8 (pos), CharPointer_UTF8 (p)) << '"';
+        }
+
+        return Result::fail (m);
+    }
+
+    static Result createCancelledFail()
+    {
+        return Result::fail ("JSON parsing was stopped by the handler");
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Reader)
+};
+
+//==============================================================================
+Result JSONStreamParser::parse (const void* utf8Data, size_t numBytes, Handler& handler)
+{
+    Reader reader (static_cast<const char*> (utf8Data), numBytes, handler);
+    return reader.parseDocument();
+}
+
+Result JSONStreamParser::parse (InputStream& input, Handler& handler)
+{
+    Reader reader (input, handler);
+    return reader.parseDocument();
+}
+
+Result JSONStreamParser::parseQuotedString (const char*& utf8Data, const char* dataEnd, String& result)
+{
+    struct NullHandler  : public Handler
+    {
+        bool startObject() override                 { return false; }
+        bool endObject() override                   { return false; }
+        bool startArray() override                  { return false; }
+        bool endArray() override                    { return false; }
+        bool propertyName (const Text&) override    { return false; }
+        bool stringValue (const Text&) override     { return false; }
+        bool intValue (int64) override              { return false; }
+        bool doubleValue (double) override          { return false; }
+        bool boolValue (bool) override              { return false; }
+        bool nullValue() override                   { return false; }
+    };
+
+    NullHandler handler;
+    Reader reader (utf8Data, (size_t) (dataEnd - utf8Data), handler);
+    auto r = reader.parseQuotedString (result);
+    utf8Data = reader.getPosition();
+    return r;
+}
+
+Result JSONStreamParser::parse (const File& file, Handler& handler)
+{
+    MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+    if (auto* data = mappedFile.getData())
+        return parse (data, mappedFile.getSize(), handler);
+
+    FileInputStream in (file);
+
+    if (in.openedOk())
+        return parse (in, handler);
+
+    return Result::fail ("Couldn't open " + file.getFullPathName());
+}
+
+} // namespace juce
@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An event-driven JSON parser, which reports the structure of a document to a
+    Handler object as it reads it, rather than building a var tree.
+
+    Because nothing needs to be kept in memory apart from the current nesting
+    depth, this can be used to read documents which are far too large to turn into
+    var objects, or to pull just a few values out of a big file without paying the
+    cost of building the rest of it. Documents can be parsed from a block of memory,
+    from an InputStream (which is read in chunks), or from a file (which is
+    memory-mapped).
+
+    Strings are handed to the handler as Text objects which point directly into the
+    source data wherever possible, so no allocation happens for them unless they
+    contain escape sequences or, when reading from a stream, straddle the end of a
+    chunk. This means that they're only valid for the duration of the callback - if
+    you need to keep one, call its toString() method.
+
+    The input is expected to be UTF-8 encoded (a byte-order-mark is allowed).
+
+    @code
+    struct ParameterCounter  : public JSONStreamParser::Handler
+    {
+        bool propertyName (const JSONStreamParser::Text& name) override
+        {
+            if (name == "parameterID")
+                ++numParameters;
+
+            return true;
+        }
+
+        int numParameters = 0;
+    };
+
+    ParameterCounter counter;
+    auto result = JSONStreamParser::parse (File ("session.json"), counter);
+    @endcode
+
+    @see JSON, JSONStreamWriter
+*/
+class JUCE_API  JSONStreamParser
+{
+public:
+    //==============================================================================
+    /** A reference to a piece of UTF-8 text that the parser has read.
+
+        This only remains valid for the duration of the Handler callback that it's
+        passed to.
+    */
+    using Text = UTF8TextRange;
+
+    //==============================================================================
+    /** Receives the callbacks that describe the structure of a JSON document.
+
+        Each callback returns true to continue parsing, or false to stop it, in
+        which case the parse method will return a failed result.
+    */
+    struct JUCE_API  Handler
+    {
+        /** Destructor. */
+        virtual ~Handler() {}
+
+        /** Called at the start of an object. */
+        virtual bool startObject() = 0;
+
+        /** Called at the end of an object. */
+        virtual bool endObject() = 0;
+
+        /** Called at the start of an array. */
+        virtual bool startArray() = 0;
+
+        /** Called at the end of an array. */
+        virtual bool endArray() = 0;
+
+        /** Called with the name of each property in an object, just before its value. */
+        virtual bool propertyName (const Text& name) = 0;
+
+        /** Called for a string value. */
+        virtual bool stringValue (const Text& value) = 0;
+
+        /** Called for a number which has no decimal point or exponent. */
+        virtual bool intValue (int64 value) = 0;
+
+        /** Called for a number with a decimal point or exponent. */
+        virtual bool doubleValue (double value) = 0;
+
+        /** Called for a true or false value. */
+        virtual bool boolValue (bool value) = 0;
+
+        /** Called for a null value. */
+        virtual bool nullValue() = 0;
+    };
+
+    //==============================================================================
+    /** Parses a block of UTF-8 text.
+
+        This reads a single JSON value (which is normally an object or array), and
+        ignores anything after it.
+    */
+    static Result parse (const void* utf8Data, size_t numBytes, Handler& handler);
+
+    /** Parses some text from a stream, reading it in chunks as it goes. */
+    static Result parse (InputStream& input, Handler& handler);
+
+    /** Parses a file, by memory-mapping it. */
+    static Result parse (const File& file, Handler& handler);
+
+private:
+    //==============================================================================
+    struct Reader;
+    friend class JSON;
+
+    static Result parseQuotedString (const char*& utf8Data, const char* dataEnd, String& result);
+
+    JSONStreamParser() JUCE_DELETED_FUNCTION;
+};
+
+} // namespace juce
@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONStreamWriter::JSONStreamWriter (OutputStream& output, bool oneLine, int decimalPlaces)
+    : out (output), allOnOneLine (oneLine), maximumDecimalPlaces (decimalPlaces)
+{
+    containers.ensureStorageAllocated (16);
+}
+
+JSONStreamWriter::~JSONStreamWriter()
+{
+    // Every object and array that you start must be ended!
+    jassert (containers.isEmpty() && ! expectingValueForKey);
+}
+
+//==============================================================================
+void JSONStreamWriter::writeIndent (int depth)
+{
+    JSONFormatter::writeSpaces (out, depth * JSONFormatter::indentSize);
+}
+
+void JSONStreamWriter::writeSeparator (Container& container)
+{
+    if (container.numItems++ > 0)
+    {
+        if (allOnOneLine)
+            out << ", ";
+        else
+            out << ',' << newLine;
+    }
+    else if (! allOnOneLine && ! container.isObject)
+    {
+        out << newLine;
+    }
+
+    if (! allOnOneLine)
+        writeIndent (containers.size());
+}
+
+void JSONStreamWriter::startValue()
+{
+    if (expectingValueForKey)
+    {
+        expectingValueForKey = false;
+        return;
+    }
+
+    if (! containers.isEmpty())
+    {
+        auto& container = containers.getReference (containers.size() - 1);
+
+        // Values inside an object must be preceded by a call to writeKey()!
+        jassert (! container.isObject);
+
+        writeSeparator (container);
+    }
+}
+
+//==============================================================================
+void JSONStreamWriter::startObject()
+{
+    startValue();
+    out << '{';
+
+    if (! allOnOneLine)
+        out << newLine;
+
+    containers.add ({ true, 0 });
+}
+
+void JSONStreamWriter::endObject()
+{
+    // This doesn't match a call to startObject()!
+    jassert (! containers.isEmpty() && containers.getLast().isObject && ! expectingValueForKey);
+
+    auto numItems = containers.getLast().numItems;
+    containers.removeLast();
+
+    if (! allOnOneLine)
+    {
+        if (numItems > 0)
+            out << newLine;
+
+        writeIndent (containers.size());
+    }
+
+    out << '}';
+}
+
+void JSONStreamWriter::startArray()
+{
+    startValue();
+    out << '[';
+    containers.add ({ false, 0 });
+}
+
+void JSONStreamWriter::endArray()
+{
+    // This doesn't match a call to startArray()!
+    jassert (! containers.isEmpty() && ! containers.getLast().isObject);
+
+    auto numItems = containers.getLast().numItems;
+    containers.removeLast();
+
+    if (numItems > 0 && ! allOnOneLine)
+    {
+        out << newLine;
+        writeIndent (containers.size());
+    }
+
+    out << ']';
+}
+
+void JSONStreamWriter::writeKey (StringRef name)
+{
+    // Keys can only be written inside an object, and each one must be followed by a value!
+    jassert (! containers.isEmpty() && containers.getLast().isObject && ! expectingValueForKey);
+
+    writeSeparator (containers.getReference (containers.size() - 1));
+
+    out << '"';
+    JSONFormatter::writeString (out, name.text);
+    out << "\": ";
+
+    expectingValueForKey = true;
+}
+
+//==============================================================================
+void JSONStreamWriter::writeString (StringRef value)
+{
+    startValue();
+    out << '"';
+    JSONFormatter::writeString (out, value.text);
+    out << '"';
+}
+
+void JSONStreamWriter::writeInt (int64 value)
+{
+    startValue();
+    out << value;
+}
+
+void JSONStreamWriter::writeDouble (double value)
+{
+    startValue();
+    out << String (value, maximumDecimalPlaces);
+}
+
+void JSONStreamWriter::writeBool (bool value)
+{
+    startValue();
+    out << (value ? "true" : "false");
+}
+
+void JSONStreamWriter::writeNull()
+{
+    startValue();
+    out << "null";
+}
+
+void JSONStreamWriter::writeValue (const var& value)
+{
+    startValue();
+    JSONFormatter::write (out, value, containers.size() * JSONFormatter::indentSize, allOnOneLine, maximumDecimalPlaces);
+}
+
+} // namespace juce
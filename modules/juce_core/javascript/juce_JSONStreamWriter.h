@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Writes JSON directly to an OutputStream, one element at a time.
+
+    This produces exactly the same text as JSON::writeToStream() would for the
+    equivalent var, but doesn't need the whole structure to be built in memory
+    first, so it's handy for serialising large amounts of data, or data that's
+    held in your own classes.
+
+    @code
+    FileOutputStream out (file);
+    JSONStreamWriter writer (out);
+
+    writer.startObject();
+    writer.writeKey ("name");
+    writer.writeString ("Piano");
+    writer.writeKey ("levels");
+    writer.startArray();
+
+    for (auto level : levels)
+        writer.writeDouble (level);
+
+    writer.endArray();
+    writer.endObject();
+    @endcode
+
+    Each startObject() or startArray() call must be matched by a corresponding
+    endObject() or endArray(), and each value inside an object must be preceded by
+    a call to writeKey().
+
+    @see JSON, JSONStreamParser
+*/
+class JUCE_API  JSONStreamWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer that will send its output to the given stream.
+
+        The stream must remain valid for the lifetime of this object. The layout
+        options have the same meaning as they do in JSON::toString().
+    */
+    JSONStreamWriter (OutputStream& output,
+                      bool allOnOneLine = false,
+                      int maximumDecimalPlaces = 20);
+
+    /** Destructor. */
+    ~JSONStreamWriter();
+
+    //==============================================================================
+    /** Begins an object. */
+    void startObject();
+
+    /** Ends the current object. */
+    void endObject();
+
+    /** Begins an array. */
+    void startArray();
+
+    /** Ends the current array. */
+    void endArray();
+
+    /** Writes the name of a property in the current object. This must be followed
+        by a value, object or array.
+    */
+    void writeKey (StringRef name);
+
+    //==============================================================================
+    /** Writes a string value. */
+    void writeString (StringRef value);
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating point value. */
+    void writeDouble (double value);
+
+    /** Writes a boolean value. */
+    void writeBool (bool value);
+
+    /** Writes a null value. */
+    void writeNull();
+
+    /** Writes a var, which may itself be an object or array. */
+    void writeValue (const var& value);
+
+    //==============================================================================
+    /** Returns the number of objects and arrays which have been started but not
+        yet ended.
+    */
+    int getDepth() const noexcept                   { return containers.size(); }
+
+private:
+    //==============================================================================
+    struct Container
+    {
+        bool isObject;
+        int numItems;
+    };
+
+    OutputStream& out;
+    const bool allOnOneLine;
+    const int maximumDecimalPlaces;
+    Array<Container> containers;
+    bool expectingValueForKey = false;
+
+    void startValue();
+    void writeSeparator (Container&);
+    void writeIndent (int depth);
+
+    JUCE_DECLARE_NON_COPYABLE (JSONStreamWriter)
+};
+
+} // namespace juce
@@ -81,13 +81,21 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     void execute (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        ScopedPointer<BlockStatement> (tb.parseStatementList())->perform (Scope (nullptr, this, this), nullptr);
+        ScopedPointer<BlockStatement> block (tb.parseStatementList());
+
+        Program program;
+        compileStatement (program, *block, false);
+        program.run (Scope (nullptr, this, this));
     }
 
     var evaluate (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        return ExpPtr (tb.parseExpression())->getResult (Scope (nullptr, this, this));
+        ExpPtr expression (tb.parseExpression());
+
+        Program program;
+        compileExpression (program, *expression);
+        return program.run (Scope (nullptr, this, this));
     }
 
     //==============================================================================
@@ -101,10 +109,35 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     static bool isFunction (const var& v) noexcept            { return dynamic_cast<FunctionObject*> (v.getObject()) != nullptr; }
     static bool isNumeric (const var& v) noexcept             { return v.isInt() || v.isDouble() || v.isInt64() || v.isBool(); }
     static bool isNumericOrUndefined (const var& v) noexcept  { return isNumeric (v) || v.isUndefined(); }
+    static bool isInteger (const var& v) noexcept             { return v.isInt64() || v.isInt(); }
     static int64 getOctalValue (const String& s)              { BigInteger b; b.parseString (s.initialSectionContainingOnly ("01234567"), 8); return b.toInt64(); }
     static Identifier getPrototypeIdentifier()                { static const Identifier i ("prototype"); return i; }
     static var* getPropertyPointer (DynamicObject* o, const Identifier& i) noexcept   { return o->getProperties().getVarPointer (i); }
 
+    // Looks up a property, first trying the slot in which it was found last time. A given
+    // expression usually sees objects with the same layout each time it runs, so this avoids
+    // searching through every property in the common case.
+    static var* getPropertyPointer (DynamicObject* o, const Identifier& i, int& cachedIndex) noexcept
+    {
+        auto& props = o->getProperties();
+
+        if (isPositiveAndBelow (cachedIndex, props.size()))
+        {
+            auto& item = props.begin()[cachedIndex];
+
+            if (item.name == i)
+                return &(item.value);
+        }
+
+        auto index = props.indexOf (i);
+
+        if (index < 0)
+            return nullptr;
+
+        cachedIndex = index;
+        return &(props.begin()[index].value);
+    }
+
     //==============================================================================
     struct CodeLocation
     {
@@ -137,11 +170,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         ReferenceCountedObjectPtr<RootObject> root;
         DynamicObject::Ptr scope;
 
-        var findFunctionCall (const CodeLocation& location, const var& targetObject, const Identifier& functionName) const
+        var findFunctionCall (const CodeLocation& location, const var& targetObject,
+                              const Identifier& functionName, int& cachedIndex) const
         {
             if (auto* o = targetObject.getDynamicObject())
             {
-                if (auto* prop = getPropertyPointer (o, functionName))
+                if (auto* prop = getPropertyPointer (o, functionName, cachedIndex))
                     return *prop;
 
                 for (auto* p = o->getProperty (getPrototypeIdentifier()).getDynamicObject(); p != nullptr;
@@ -157,35 +191,42 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             if (targetObject.isString())
-                if (auto* m = findRootClassProperty (StringClass::getClassName(), functionName))
+                if (auto* m = findRootClassProperty (StringClass::getClassName(), functionName, cachedIndex))
                     return *m;
 
             if (targetObject.isArray())
-                if (auto* m = findRootClassProperty (ArrayClass::getClassName(), functionName))
+                if (auto* m = findRootClassProperty (ArrayClass::getClassName(), functionName, cachedIndex))
                     return *m;
 
-            if (auto* m = findRootClassProperty (ObjectClass::getClassName(), functionName))
+            if (auto* m = findRootClassProperty (ObjectClass::getClassName(), functionName, cachedIndex))
                 return *m;
 
             location.throwError ("Unknown function '" + functionName.toString() + "'");
             return {};
         }
 
-        var* findRootClassProperty (const Identifier& className, const Identifier& propName) const
+        var* findRootClassProperty (const Identifier& className, const Identifier& propName, int& cachedIndex) const
         {
             if (auto* cls = root->getProperty (className).getDynamicObject())
-                return getPropertyPointer (cls, propName);
+                return getPropertyPointer (cls, propName, cachedIndex);
 
             return nullptr;
         }
 
-        var findSymbolInParentScopes (const Identifier& name) const
+        var* findSymbolInParentScopes (const Identifier& name) const
         {
             if (auto* v = getPropertyPointer (scope, name))
-                return *v;
+                return v;
 
-            return parent != nullptr ? parent->findSymbolInParentScopes (name)
-                                     : var::undefined();
+            return parent != nullptr ? parent->findSymbolInParentScopes (name) : nullptr;
+        }
+
+        var* findSymbolInParentScopes (const Identifier& name, int& cachedIndex) const
+        {
+            if (auto* v = getPropertyPointer (scope, name, cachedIndex))
+                return v;
+
+            return parent != nullptr ? parent->findSymbolInParentScopes (name) : nullptr;
         }
 
         bool findAndInvokeMethod (const Identifier& function, const var::NativeFunctionArgs& args, var& result) const
@@ -240,14 +281,55 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         }
     };
 
+    //==============================================================================
+    struct Statement;
+    struct Compiler;
+
+    struct Instruction
+    {
+        enum OpCode
+        {
+            pushConstant, pop, getName, setName, storeName, declareVar, getProperty, setProperty, getIndex, setIndex,
+            add, subtract, multiply, lessThan, lessThanOrEqual, greaterThan, greaterThanOrEqual, equals, notEquals, binaryOp,
+            logicalAnd, logicalOr, toBool, jump, jumpIfFalse, loop, checkTimeOut, pushScope, findMethod, call, prepareNew,
+            newObject, initProperty, makeArray, cannotAssign, returnValue, exit
+        };
+
+        // Where an operator finds one of its operands. Constants and variables can be
+        // read where they are, rather than being pushed onto the stack first.
+        struct Operand
+        {
+            enum Source { notUsed, fromStack, fromConstant, fromName };
+
+            Source source = notUsed;
+            int constantIndex = 0;
+            Identifier name;
+            mutable int cachedIndex = -1;
+        };
+
+        Instruction (OpCode o, int a, const Statement* n, const Identifier& i) noexcept : op (o), arg (a), node (n), name (i) {}
+
+        forcedinline int getNumStackOperands() const noexcept   { return (lhs.source == Operand::fromStack ? 1 : 0) + (rhs.source == Operand::fromStack ? 1 : 0); }
+
+        OpCode op;
+        int arg;                // a constant's index, a jump destination, or a number of values
+        const Statement* node;  // the statement that this was compiled from, which gives the location of any error
+        Identifier name;
+        mutable int cachedIndex = -1;
+
+        Operand lhs, rhs;
+        bool branchIfFalse = false;  // if set, a binary operator jumps to arg when its result is false, rather than pushing it
+        bool storesResult = false;   // if set, a binary operator stores its result in the variable called name
+    };
+
     //==============================================================================
     struct Statement
     {
         Statement (const CodeLocation& l) noexcept : location (l) {}
         virtual ~Statement() {}
 
-        enum ResultCode  { ok = 0, returnWasHit, breakWasHit, continueWasHit };
-        virtual ResultCode perform (const Scope&, var*) const  { return ok; }
+        // Emits the instructions that perform this statement, leaving the stack as it was.
+        virtual void compile (Compiler&) const {}
 
         CodeLocation location;
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Statement)
@@ -257,10 +339,32 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         Expression (const CodeLocation& l) noexcept : Statement (l) {}
 
-        virtual var getResult (const Scope&) const            { return var::undefined(); }
-        virtual void assign (const Scope&, const var&) const  { location.throwError ("Cannot assign to this expression!"); }
+        // Emits instructions that push the value of this expression.
+        virtual void compileValue (Compiler& c) const    { c.pushConstant (var::undefined(), this); }
+
+        // Emits instructions that store the value on top of the stack in this expression,
+        // leaving the value where it is.
+        virtual void compileAssign (Compiler& c) const   { c.emit (Instruction::cannotAssign, 0, this); }
+
+        // Emits instructions that jump if this expression is false, and returns the jump's index.
+        virtual int compileJumpIfFalse (Compiler& c) const
+        {
+            compileValue (c);
+            return c.emit (Instruction::jumpIfFalse, -1, this);
+        }
+
+        // Emits instructions that store the value of this expression in a variable.
+        virtual void compileStore (Compiler& c, const Identifier& variable) const
+        {
+            compileValue (c);
+            c.emit (Instruction::storeName, -1, this, 0, variable);
+        }
+
+        // True if evaluating this can't change any variables, so an operand that's to the left
+        // of it can still be read in place afterwards.
+        virtual bool isFreeOfSideEffects() const noexcept    { return false; }
 
-        ResultCode perform (const Scope& s, var*) const override  { getResult (s); return ok; }
+        void compile (Compiler& c) const override        { compileValue (c); c.emit (Instruction::pop, -1, this); }
     };
 
     typedef ScopedPointer<Expression> ExpPtr;
@@ -269,13 +373,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         BlockStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (Compiler& c) const override
         {
             for (auto* statement : statements)
-                if (auto r = statement->perform (s, returnedValue))
-                    return r;
-
-            return ok;
+                statement->compile (c);
         }
 
         OwnedArray<Statement> statements;
@@ -285,9 +386,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         IfStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (Compiler& c) const override
         {
-            return (condition->getResult(s) ? trueBranch : falseBranch)->perform (s, returnedValue);
+            auto skipTrueBranch = condition->compileJumpIfFalse (c);
+            trueBranch->compile (c);
+            auto skipFalseBranch = c.emit (Instruction::jump, 0, this);
+            c.setJumpTarget (skipTrueBranch);
+            falseBranch->compile (c);
+            c.setJumpTarget (skipFalseBranch);
         }
 
         ExpPtr condition;
@@ -298,10 +404,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         VarStatement (const CodeLocation& l) noexcept : Statement (l) {}
 
-        ResultCode perform (const Scope& s, var*) const override
+        void compile (Compiler& c) const override
         {
-            s.scope->setProperty (name, initialiser->getResult (s));
-            return ok;
+            initialiser->compileValue (c);
+            c.emit (Instruction::declareVar, -1, this, 0, name);
         }
 
         Identifier name;
@@ -312,25 +418,39 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         LoopStatement (const CodeLocation& l, bool isDo) noexcept : Statement (l), isDoLoop (isDo) {}
 
-        ResultCode perform (const Scope& s, var* returnedValue) const override
+        void compile (Compiler& c) const override
         {
-            initialiser->perform (s, nullptr);
-
-            while (isDoLoop || condition->getResult (s))
             {
-                s.checkTimeOut (location);
-                auto r = body->perform (s, returnedValue);
-
-                if (r == returnWasHit)   return r;
-                if (r == breakWasHit)    break;
+                // a break, continue or return in the initialiser just ends the initialiser
+                Compiler::JumpScope initialiserScope (c, true);
+                initialiser->compile (c);
+                initialiserScope.setTargets (c.getPosition(), c.getPosition());
+            }
 
-                iterator->perform (s, nullptr);
+            Compiler::JumpScope loopScope (c, false);
+            auto top = c.getPosition();
+            int exitJump;
 
-                if (isDoLoop && r != continueWasHit && ! condition->getResult (s))
-                    break;
+            if (isDoLoop)
+            {
+                body->compile (c);
+                iterator->compile (c);
+                exitJump = condition->compileJumpIfFalse (c);
+                c.emit (Instruction::loop, 0, this, top);
             }
+            else
+            {
+                exitJump = condition->compileJumpIfFalse (c);
+                body->compile (c);
+            }
+
+            // a do-loop skips its condition after a continue
+            auto continueTarget = c.getPosition();
+            iterator->compile (c);
+            c.emit (Instruction::loop, 0, this, top);
 
-            return ok;
+            c.setJumpTarget (exitJump);
+            loopScope.setTargets (c.getPosition(), continueTarget);
         }
 
         ScopedPointer<Statement> initialiser, iterator, body;
@@ -342,11 +462,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ReturnStatement (const CodeLocation& l, Expression* v) noexcept : Statement (l), returnValue (v) {}
 
-        ResultCode perform (const Scope& s, var* ret) const override
-        {
-            if (ret != nullptr)  *ret = returnValue->getResult (s);
-            return returnWasHit;
-        }
+        void compile (Compiler& c) const override   { c.compileReturn (*this, *returnValue); }
 
         ExpPtr returnValue;
     };
@@ -354,19 +470,20 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     struct BreakStatement  : public Statement
     {
         BreakStatement (const CodeLocation& l) noexcept : Statement (l) {}
-        ResultCode perform (const Scope&, var*) const override  { return breakWasHit; }
+        void compile (Compiler& c) const override   { c.compileJumpOutOfLoop (*this, true); }
     };
 
     struct ContinueStatement  : public Statement
     {
         ContinueStatement (const CodeLocation& l) noexcept : Statement (l) {}
-        ResultCode perform (const Scope&, var*) const override  { return continueWasHit; }
+        void compile (Compiler& c) const override   { c.compileJumpOutOfLoop (*this, false); }
     };
 
     struct LiteralValue  : public Expression
     {
         LiteralValue (const CodeLocation& l, const var& v) noexcept : Expression (l), value (v) {}
-        var getResult (const Scope&) const override   { return value; }
+        void compileValue (Compiler& c) const override   { c.pushConstant (value, this); }
+        bool isFreeOfSideEffects() const noexcept override   { return true; }
         var value;
     };
 
@@ -374,15 +491,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         UnqualifiedName (const CodeLocation& l, const Identifier& n) noexcept : Expression (l), name (n) {}
 
-        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name); }
-
-        void assign (const Scope& s, const var& newValue) const override
-        {
-            if (auto* v = getPropertyPointer (s.scope, name))
-                *v = newValue;
-            else
-                s.root->setProperty (name, newValue);
-        }
+        void compileValue (Compiler& c) const override    { c.emit (Instruction::getName, 1, this, 0, name); }
+        void compileAssign (Compiler& c) const override   { c.emit (Instruction::setName, 0, this, 0, name); }
+        bool isFreeOfSideEffects() const noexcept override    { return true; }
 
         Identifier name;
     };
@@ -391,32 +502,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         DotOperator (const CodeLocation& l, ExpPtr& p, const Identifier& c) noexcept : Expression (l), parent (p), child (c) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
-            auto p = parent->getResult (s);
-            static const Identifier lengthID ("length");
-
-            if (child == lengthID)
-            {
-                if (auto* array = p.getArray())   return array->size();
-                if (p.isString())                 return p.toString().length();
-            }
-
-            if (auto* o = p.getDynamicObject())
-                if (auto* v = getPropertyPointer (o, child))
-                    return *v;
-
-            return var::undefined();
+            c.emitWithOperands (Instruction::getProperty, 1, this, c.compileOperand (*parent, true), {}, child);
         }
 
-        void assign (const Scope& s, const var& newValue) const override
+        void compileAssign (Compiler& c) const override
         {
-            if (auto* o = parent->getResult (s).getDynamicObject())
-                o->setProperty (child, newValue);
-            else
-                Expression::assign (s, newValue);
+            c.emitWithOperands (Instruction::setProperty, 0, this, c.compileOperand (*parent, true), {}, child);
         }
 
+        bool isFreeOfSideEffects() const noexcept override   { return parent->isFreeOfSideEffects(); }
+
         ExpPtr parent;
         Identifier child;
     };
@@ -425,60 +522,65 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ArraySubscript (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override   { compileOperation (c, Instruction::getIndex, 1); }
+        void compileAssign (Compiler& c) const override  { compileOperation (c, Instruction::setIndex, 0); }
+
+        void compileOperation (Compiler& c, Instruction::OpCode op, int numResults) const
         {
-            auto arrayVar = object->getResult (s); // must stay alive for the scope of this method
-            auto key = index->getResult (s);
+            auto objectOperand = c.compileOperand (*object, index->isFreeOfSideEffects());
+            c.emitWithOperands (op, numResults, this, objectOperand, c.compileOperand (*index, true));
+        }
 
-            if (const auto* array = arrayVar.getArray())
-                if (key.isInt() || key.isInt64() || key.isDouble())
-                    return (*array) [static_cast<int> (key)];
+        bool isFreeOfSideEffects() const noexcept override   { return object->isFreeOfSideEffects() && index->isFreeOfSideEffects(); }
 
-            if (auto* o = arrayVar.getDynamicObject())
-                if (key.isString())
-                    if (auto* v = getPropertyPointer (o, Identifier (key)))
-                        return *v;
+        ExpPtr object, index;
+    };
 
-            return var::undefined();
-        }
+    struct BinaryOperatorBase  : public Expression
+    {
+        BinaryOperatorBase (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept
+            : Expression (l), lhs (a), rhs (b), operation (op) {}
 
-        void assign (const Scope& s, const var& newValue) const override
-        {
-            auto arrayVar = object->getResult (s); // must stay alive for the scope of this method
-            auto key = index->getResult (s);
+        // Returns the result of applying this operator to the values of its operands.
+        virtual var apply (const var& a, const var& b) const = 0;
 
-            if (auto* array = arrayVar.getArray())
-            {
-                if (key.isInt() || key.isInt64() || key.isDouble())
-                {
-                    const int i = key;
-                    while (array->size() < i)
-                        array->add (var::undefined());
+        void compileValue (Compiler& c) const override                                { compileOperation (c, false); }
+        int compileJumpIfFalse (Compiler& c) const override                           { return compileOperation (c, true); }
+        void compileStore (Compiler& c, const Identifier& variable) const override    { compileOperation (c, false, variable); }
 
-                    array->set (i, newValue);
-                    return;
-                }
-            }
+        int compileOperation (Compiler& c, bool jumpIfFalse, const Identifier& resultVariable = {}) const
+        {
+            // the left operand can only be read after the right one if the right one can't change it
+            auto lhsOperand = c.compileOperand (*lhs, rhs->isFreeOfSideEffects());
+            auto rhsOperand = c.compileOperand (*rhs, true);
+            auto storesResult = resultVariable.isValid();
 
-            if (auto* o = arrayVar.getDynamicObject())
-            {
-                if (key.isString())
-                {
-                    o->setProperty (Identifier (key), newValue);
-                    return;
-                }
-            }
+            auto index = c.emitWithOperands (getOpCode(), (jumpIfFalse || storesResult) ? 0 : 1, this,
+                                             lhsOperand, rhsOperand, resultVariable);
 
-            Expression::assign (s, newValue);
+            auto& instruction = c.program.code.getReference (index);
+            instruction.branchIfFalse = jumpIfFalse;
+            instruction.storesResult = storesResult;
+            return index;
         }
 
-        ExpPtr object, index;
-    };
+        bool isFreeOfSideEffects() const noexcept override   { return lhs->isFreeOfSideEffects() && rhs->isFreeOfSideEffects(); }
 
-    struct BinaryOperatorBase  : public Expression
-    {
-        BinaryOperatorBase (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept
-            : Expression (l), lhs (a), rhs (b), operation (op) {}
+        Instruction::OpCode getOpCode() const noexcept
+        {
+            // these have an instruction of their own that handles the common types directly
+            if (operation == TokenTypes::plus)                return Instruction::add;
+            if (operation == TokenTypes::minus)               return Instruction::subtract;
+            if (operation == TokenTypes::times)               return Instruction::multiply;
+            if (operation == TokenTypes::lessThan)            return Instruction::lessThan;
+            if (operation == TokenTypes::lessThanOrEqual)     return Instruction::lessThanOrEqual;
+            if (operation == TokenTypes::greaterThan)         return Instruction::greaterThan;
+            if (operation == TokenTypes::greaterThanOrEqual)  return Instruction::greaterThanOrEqual;
+            if (operation == TokenTypes::equals)              return Instruction::equals;
+            if (operation == TokenTypes::notEquals)           return Instruction::notEquals;
+
+            return Instruction::binaryOp;
+        }
 
         ExpPtr lhs, rhs;
         TokenType operation;
@@ -495,9 +597,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         virtual var getWithArrayOrObject (const var& a, const var&) const { return throwError (a.isArray() ? "Array" : "Object"); }
         virtual var getWithStrings (const String&, const String&) const   { return throwError ("String"); }
 
-        var getResult (const Scope& s) const override
+        var apply (const var& a, const var& b) const override
         {
-            var a (lhs->getResult (s)), b (rhs->getResult (s));
+            if (isInteger (a) && isInteger (b))    return getWithInts (a, b);
+            if (a.isDouble() && b.isDouble())      return getWithDoubles (a, b);
 
             if ((a.isUndefined() || a.isVoid()) && (b.isUndefined() || b.isVoid()))
                 return getWithUndefinedArg();
@@ -641,33 +744,72 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     struct LogicalAndOp  : public BinaryOperatorBase
     {
         LogicalAndOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalAnd) {}
-        var getResult (const Scope& s) const override       { return lhs->getResult (s) && rhs->getResult (s); }
+        var apply (const var& a, const var& b) const override                         { return a && b; }
+        int compileJumpIfFalse (Compiler& c) const override                           { return Expression::compileJumpIfFalse (c); }
+        void compileStore (Compiler& c, const Identifier& variable) const override    { Expression::compileStore (c, variable); }
+
+        void compileValue (Compiler& c) const override
+        {
+            lhs->compileValue (c);
+            auto shortCircuit = c.emit (Instruction::logicalAnd, -1, this);
+            rhs->compileValue (c);
+            c.emit (Instruction::toBool, 0, this);
+            c.setJumpTarget (shortCircuit);
+        }
     };
 
     struct LogicalOrOp  : public BinaryOperatorBase
     {
         LogicalOrOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalOr) {}
-        var getResult (const Scope& s) const override       { return lhs->getResult (s) || rhs->getResult (s); }
+        var apply (const var& a, const var& b) const override                         { return a || b; }
+        int compileJumpIfFalse (Compiler& c) const override                           { return Expression::compileJumpIfFalse (c); }
+        void compileStore (Compiler& c, const Identifier& variable) const override    { Expression::compileStore (c, variable); }
+
+        void compileValue (Compiler& c) const override
+        {
+            lhs->compileValue (c);
+            auto shortCircuit = c.emit (Instruction::logicalOr, -1, this);
+            rhs->compileValue (c);
+            c.emit (Instruction::toBool, 0, this);
+            c.setJumpTarget (shortCircuit);
+        }
     };
 
     struct TypeEqualsOp  : public BinaryOperatorBase
     {
         TypeEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeEquals) {}
-        var getResult (const Scope& s) const override       { return areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        var apply (const var& a, const var& b) const override   { return areTypeEqual (a, b); }
     };
 
     struct TypeNotEqualsOp  : public BinaryOperatorBase
     {
         TypeNotEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeNotEquals) {}
-        var getResult (const Scope& s) const override       { return ! areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        var apply (const var& a, const var& b) const override   { return ! areTypeEqual (a, b); }
     };
 
     struct ConditionalOp  : public Expression
     {
         ConditionalOp (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override              { return (condition->getResult (s) ? trueBranch : falseBranch)->getResult (s); }
-        void assign (const Scope& s, const var& v) const override  { (condition->getResult (s) ? trueBranch : falseBranch)->assign (s, v); }
+        void compileValue (Compiler& c) const override
+        {
+            auto skipTrueBranch = condition->compileJumpIfFalse (c);
+            trueBranch->compileValue (c);
+            auto skipFalseBranch = c.emit (Instruction::jump, -1, this);
+            c.setJumpTarget (skipTrueBranch);
+            falseBranch->compileValue (c);
+            c.setJumpTarget (skipFalseBranch);
+        }
+
+        void compileAssign (Compiler& c) const override
+        {
+            auto skipTrueBranch = condition->compileJumpIfFalse (c);
+            trueBranch->compileAssign (c);
+            auto skipFalseBranch = c.emit (Instruction::jump, 0, this);
+            c.setJumpTarget (skipTrueBranch);
+            falseBranch->compileAssign (c);
+            c.setJumpTarget (skipFalseBranch);
+        }
 
         ExpPtr condition, trueBranch, falseBranch;
     };
@@ -676,13 +818,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         Assignment (const CodeLocation& l, ExpPtr& dest, ExpPtr& source) noexcept : Expression (l), target (dest), newValue (source) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
-            auto value = newValue->getResult (s);
-            target->assign (s, value);
-            return value;
+            newValue->compileValue (c);
+            target->compileAssign (c);
         }
 
+        void compile (Compiler& c) const override   { c.compileAssignmentStatement (*this, *target, *newValue); }
+
         ExpPtr target, newValue;
     };
 
@@ -691,13 +834,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         SelfAssignment (const CodeLocation& l, Expression* dest, Expression* source) noexcept
             : Expression (l), target (dest), newValue (source) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
-            auto value = newValue->getResult (s);
-            target->assign (s, value);
-            return value;
+            newValue->compileValue (c);
+            target->compileAssign (c);
         }
 
+        void compile (Compiler& c) const override   { c.compileAssignmentStatement (*this, *target, *newValue); }
+
         Expression* target; // Careful! this pointer aliases a sub-term of newValue!
         ExpPtr newValue;
         TokenType op;
@@ -707,11 +851,20 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         PostAssignment (const CodeLocation& l, Expression* dest, Expression* source) noexcept : SelfAssignment (l, dest, source) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
-            auto oldValue = target->getResult (s);
-            target->assign (s, newValue->getResult (s));
-            return oldValue;
+            target->compileValue (c);
+            SelfAssignment::compileValue (c);
+            c.emit (Instruction::pop, -1, this);
+        }
+
+        void compile (Compiler& c) const override
+        {
+            // when the old value isn't needed, there's no point reading it unless that has side-effects
+            if (target->isFreeOfSideEffects())
+                SelfAssignment::compile (c);
+            else
+                Expression::compile (c);
         }
     };
 
@@ -719,28 +872,35 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         FunctionCall (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
+            // leaves the object that will be 'this', followed by the function, on the stack
             if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
             {
-                auto thisObject = dot->parent->getResult (s);
-                return invokeFunction (s, s.findFunctionCall (location, thisObject, dot->child), thisObject);
+                dot->parent->compileValue (c);
+                c.emit (Instruction::findMethod, 1, this, 0, dot->child);
+            }
+            else
+            {
+                c.emit (Instruction::pushScope, 1, this);
+                object->compileValue (c);
             }
 
-            auto function = object->getResult (s);
-            return invokeFunction (s, function, var (s.scope.get()));
+            compileCall (c);
         }
 
-        var invokeFunction (const Scope& s, const var& function, const var& thisObject) const
+        void compileCall (Compiler& c) const
         {
-            s.checkTimeOut (location);
-            Array<var> argVars;
+            c.emit (Instruction::checkTimeOut, 0, this);
 
             for (auto* a : arguments)
-                argVars.add (a->getResult (s));
+                a->compileValue (c);
 
-            const var::NativeFunctionArgs args (thisObject, argVars.begin(), argVars.size());
+            c.emit (Instruction::call, -1 - arguments.size(), this, arguments.size());
+        }
 
+        var invokeFunction (const Scope& s, const var& function, const var::NativeFunctionArgs& args) const
+        {
             if (var::NativeFunction nativeFunction = function.getNativeFunction())
                 return nativeFunction (args);
 
@@ -748,7 +908,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 return fo->invoke (s, args);
 
             if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
-                if (auto* o = thisObject.getDynamicObject())
+                if (auto* o = args.thisObject.getDynamicObject())
                     if (o->hasMethod (dot->child)) // allow an overridden DynamicObject::invokeMethod to accept a method call.
                         return o->invokeMethod (dot->child, args);
 
@@ -763,22 +923,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         NewOperator (const CodeLocation& l) noexcept : FunctionCall (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
-            var classOrFunc = object->getResult (s);
-            const bool isFunc = isFunction (classOrFunc);
-
-            if (! (isFunc || classOrFunc.getDynamicObject() != nullptr))
-                return var::undefined();
-
-            DynamicObject::Ptr newObject (new DynamicObject());
-
-            if (isFunc)
-                invokeFunction (s, classOrFunc, newObject.get());
-            else
-                newObject->setProperty (getPrototypeIdentifier(), classOrFunc);
-
-            return newObject.get();
+            // if the class turns out not to be a function, this jumps straight to the end
+            object->compileValue (c);
+            auto skipCall = c.emit (Instruction::prepareNew, 2, this);
+            compileCall (c);
+            c.emit (Instruction::pop, -1, this);
+            c.setJumpTarget (skipCall);
         }
     };
 
@@ -786,14 +938,15 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ObjectDeclaration (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
-            DynamicObject::Ptr newObject (new DynamicObject());
+            c.emit (Instruction::newObject, 1, this);
 
             for (int i = 0; i < names.size(); ++i)
-                newObject->setProperty (names.getUnchecked(i), initialisers.getUnchecked(i)->getResult (s));
-
-            return newObject.get();
+            {
+                initialisers.getUnchecked(i)->compileValue (c);
+                c.emit (Instruction::initProperty, -1, this, 0, names.getReference (i));
+            }
         }
 
         Array<Identifier> names;
@@ -804,19 +957,526 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         ArrayDeclaration (const CodeLocation& l) noexcept : Expression (l) {}
 
-        var getResult (const Scope& s) const override
+        void compileValue (Compiler& c) const override
         {
-            Array<var> a;
-
-            for (int i = 0; i < values.size(); ++i)
-                a.add (values.getUnchecked(i)->getResult (s));
+            for (auto* v : values)
+                v->compileValue (c);
 
-            return a;
+            c.emit (Instruction::makeArray, 1 - values.size(), this, values.size());
         }
 
         OwnedArray<Expression> values;
     };
 
+    //==============================================================================
+    /*  Scripts and functions are compiled into a flat list of instructions, which work
+        on a stack of values. Running these avoids the cost of walking the parse tree
+        with a virtual call per node, and the instructions that look up names and
+        properties keep the index at which they found them last time, so that the next
+        lookup can usually go straight to the right slot.
+    */
+    struct Program
+    {
+        var run (const Scope& s) const
+        {
+            Stack stack (stackSize);
+            auto* instructions = code.begin();
+            uint32 numIterations = 0;
+
+            for (int pc = 0;;)
+            {
+                auto& i = instructions[pc++];
+
+                switch (i.op)
+                {
+                    case Instruction::pushConstant:     stack.push (constants.getReference (i.arg)); break;
+                    case Instruction::pop:              stack.drop(); break;
+                    case Instruction::getName:          stack.push (getVariable (s, i.name, i.cachedIndex)); break;
+
+                    case Instruction::setName:
+                        if (auto* v = getPropertyPointer (s.scope, i.name, i.cachedIndex))
+                            *v = stack.top[-1];
+                        else
+                            s.root->setProperty (i.name, stack.top[-1]);
+
+                        break;
+
+                    case Instruction::storeName:        storeVariable (s, i, stack.pop()); break;
+
+                    case Instruction::declareVar:
+                        s.scope->setProperty (i.name, stack.top[-1]);
+                        stack.drop();
+                        break;
+
+                    case Instruction::getProperty:
+                        finishOp (i, stack, pc, s, getProperty (getLeftOperand (i, stack, s), i.name, i.cachedIndex));
+                        break;
+
+                    case Instruction::setProperty:
+                    {
+                        // the value being assigned is left underneath the operands
+                        auto numOperands = i.getNumStackOperands();
+
+                        if (auto* o = getLeftOperand (i, stack, s).getDynamicObject())
+                            o->setProperty (i.name, stack.top[-1 - numOperands]);
+                        else
+                            i.node->location.throwError ("Cannot assign to this expression!");
+
+                        stack.drop (numOperands);
+                        break;
+                    }
+
+                    case Instruction::getIndex:
+                        finishOp (i, stack, pc, s, getIndex (getLeftOperand (i, stack, s), getRightOperand (i, stack, s)));
+                        break;
+
+                    case Instruction::setIndex:
+                    {
+                        auto numOperands = i.getNumStackOperands();
+
+                        if (! setIndex (getLeftOperand (i, stack, s), getRightOperand (i, stack, s), stack.top[-1 - numOperands]))
+                            i.node->location.throwError ("Cannot assign to this expression!");
+
+                        stack.drop (numOperands);
+                        break;
+                    }
+
+                    case Instruction::add:                 applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a + b; }, [] (double a, double b) { return a + b; }); break;
+                    case Instruction::subtract:            applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a - b; }, [] (double a, double b) { return a - b; }); break;
+                    case Instruction::multiply:            applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a * b; }, [] (double a, double b) { return a * b; }); break;
+                    case Instruction::lessThan:            applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a < b; }, [] (double a, double b) { return a < b; }); break;
+                    case Instruction::lessThanOrEqual:     applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a <= b; }, [] (double a, double b) { return a <= b; }); break;
+                    case Instruction::greaterThan:         applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a > b; }, [] (double a, double b) { return a > b; }); break;
+                    case Instruction::greaterThanOrEqual:  applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a >= b; }, [] (double a, double b) { return a >= b; }); break;
+                    case Instruction::equals:              applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a == b; }, [] (double a, double b) { return a == b; }); break;
+                    case Instruction::notEquals:           applyOp (i, stack, pc, s, [] (int64 a, int64 b) { return a != b; }, [] (double a, double b) { return a != b; }); break;
+                    case Instruction::binaryOp:            applyOp (i, stack, pc, s); break;
+
+                    case Instruction::logicalAnd:
+                        if (stack.top[-1])  { stack.drop(); }
+                        else                { stack.top[-1] = false; pc = i.arg; }
+                        break;
+
+                    case Instruction::logicalOr:
+                        if (stack.top[-1])  { stack.top[-1] = true; pc = i.arg; }
+                        else                { stack.drop(); }
+                        break;
+
+                    case Instruction::toBool:           stack.top[-1] = (bool) stack.top[-1]; break;
+                    case Instruction::jump:             pc = i.arg; break;
+                    case Instruction::jumpIfFalse:      if (! stack.pop()) pc = i.arg; break;
+                    case Instruction::loop:
+                        // reading the clock takes longer than a simple iteration, so this only does it every so often
+                        if ((++numIterations & 15) == 0)
+                            s.checkTimeOut (i.node->location);
+
+                        pc = i.arg;
+                        break;
+
+                    case Instruction::checkTimeOut:     s.checkTimeOut (i.node->location); break;
+
+                    case Instruction::pushScope:        stack.push (var (s.scope.get())); break;
+                    case Instruction::findMethod:       stack.push (s.findFunctionCall (i.node->location, stack.top[-1], i.name, i.cachedIndex)); break;
+
+                    case Instruction::call:
+                    {
+                        // the stack holds the object that will be 'this', then the function, then the arguments
+                        auto* args = stack.top - i.arg;
+                        auto result = static_cast<const FunctionCall*> (i.node)->invokeFunction (s, args[-1],
+                                                                                                 var::NativeFunctionArgs (args[-2], args, i.arg));
+                        stack.drop (i.arg + 1);
+                        stack.top[-1] = std::move (result);
+                        break;
+                    }
+
+                    case Instruction::prepareNew:
+                    {
+                        auto classOrFunc = stack.pop();
+
+                        if (isFunction (classOrFunc))
+                        {
+                            // the new object is left underneath 'this' and the function, so it remains after the call
+                            var newObject (new DynamicObject());
+                            stack.push (newObject);
+                            stack.push (newObject);
+                            stack.push (classOrFunc);
+                            break;
+                        }
+
+                        if (classOrFunc.getDynamicObject() != nullptr)
+                        {
+                            DynamicObject::Ptr newObject (new DynamicObject());
+                            newObject->setProperty (getPrototypeIdentifier(), classOrFunc);
+                            stack.push (var (newObject.get()));
+                        }
+                        else
+                        {
+                            stack.push (var::undefined());
+                        }
+
+                        pc = i.arg;
+                        break;
+                    }
+
+                    case Instruction::newObject:        stack.push (var (new DynamicObject())); break;
+
+                    case Instruction::initProperty:
+                        stack.top[-2].getDynamicObject()->setProperty (i.name, stack.top[-1]);
+                        stack.drop();
+                        break;
+
+                    case Instruction::makeArray:
+                    {
+                        Array<var> items;
+                        items.ensureStorageAllocated (i.arg);
+
+                        for (auto* v = stack.top - i.arg; v < stack.top; ++v)
+                            items.add (std::move (*v));
+
+                        stack.drop (i.arg);
+                        stack.push (var (std::move (items)));
+                        break;
+                    }
+
+                    case Instruction::cannotAssign:     i.node->location.throwError ("Cannot assign to this expression!"); break;
+                    case Instruction::returnValue:      return stack.pop();
+                    case Instruction::exit:             return {};
+                    default:                            jassertfalse; return {};
+                }
+            }
+        }
+
+        Array<Instruction> code;
+        Array<var> constants;
+        int stackSize = 0;
+
+    private:
+        // The values that the instructions work on, which are only constructed while
+        // they're in use.
+        struct Stack
+        {
+            Stack (int size) : values ((size_t) size), top (values.get()) {}
+            ~Stack()                    { drop ((int) (top - values.get())); }
+
+            forcedinline void push (const var& v)    { new (top++) var (v); }
+            forcedinline void push (var&& v)         { new (top++) var (std::move (v)); }
+            forcedinline var pop()                   { var v (std::move (*--top)); top->~var(); return v; }
+            forcedinline void drop (int num = 1)     { while (--num >= 0) (--top)->~var(); }
+
+            HeapBlock<var> values;
+            var* top;
+
+            JUCE_DECLARE_NON_COPYABLE (Stack)
+        };
+
+        static const var& getVariable (const Scope& s, const Identifier& name, int& cachedIndex)
+        {
+            static const var undefined (var::undefined());
+            auto* v = s.findSymbolInParentScopes (name, cachedIndex);
+            return v != nullptr ? *v : undefined;
+        }
+
+        forcedinline const var& getOperand (const Instruction::Operand& operand, const Stack& stack, int depth, const Scope& s) const
+        {
+            switch (operand.source)
+            {
+                case Instruction::Operand::fromConstant:  return constants.getReference (operand.constantIndex);
+                case Instruction::Operand::fromName:      return getVariable (s, operand.name, operand.cachedIndex);
+                default:                                  return stack.top[-1 - depth];
+            }
+        }
+
+        forcedinline const var& getLeftOperand (const Instruction& i, const Stack& stack, const Scope& s) const
+        {
+            return getOperand (i.lhs, stack, i.rhs.source == Instruction::Operand::fromStack ? 1 : 0, s);
+        }
+
+        forcedinline const var& getRightOperand (const Instruction& i, const Stack& stack, const Scope& s) const
+        {
+            return getOperand (i.rhs, stack, 0, s);
+        }
+
+        void applyOp (const Instruction& i, Stack& stack, int& pc, const Scope& s) const
+        {
+            auto& b = getRightOperand (i, stack, s);
+            auto& a = getLeftOperand (i, stack, s);
+            finishOp (i, stack, pc, s, static_cast<const BinaryOperatorBase*> (i.node)->apply (a, b));
+        }
+
+        template <typename IntOp, typename DoubleOp>
+        forcedinline void applyOp (const Instruction& i, Stack& stack, int& pc, const Scope& s, IntOp intOp, DoubleOp doubleOp) const
+        {
+            auto& b = getRightOperand (i, stack, s);
+            auto& a = getLeftOperand (i, stack, s);
+
+            // the common cases, which would otherwise take the long way round through the operator
+            if (isInteger (a) && isInteger (b))       finishOp (i, stack, pc, s, intOp ((int64) a, (int64) b));
+            else if (a.isDouble() && b.isDouble())    finishOp (i, stack, pc, s, doubleOp ((double) a, (double) b));
+            else                                      finishOp (i, stack, pc, s, static_cast<const BinaryOperatorBase*> (i.node)->apply (a, b));
+        }
+
+        // Replaces the operands that were on the stack with the result, stores it in a variable, or
+        // uses it to decide whether to branch. A comparison that's branched on never becomes a var.
+        template <typename ResultType>
+        forcedinline static void finishOp (const Instruction& i, Stack& stack, int& pc, const Scope& s, ResultType result)
+        {
+            if (i.branchIfFalse)
+            {
+                stack.drop (i.getNumStackOperands());
+
+                if (! result)
+                    pc = i.arg;
+            }
+            else
+            {
+                finishOp (i, stack, pc, s, var (result));
+            }
+        }
+
+        forcedinline static void finishOp (const Instruction& i, Stack& stack, int& pc, const Scope& s, var&& result)
+        {
+            stack.drop (i.getNumStackOperands());
+
+            if (i.branchIfFalse)
+            {
+                if (! result)
+                    pc = i.arg;
+            }
+            else if (i.storesResult)
+            {
+                storeVariable (s, i, std::move (result));
+            }
+            else
+            {
+                stack.push (std::move (result));
+            }
+        }
+
+        static void storeVariable (const Scope& s, const Instruction& i, var&& value)
+        {
+            if (auto* v = getPropertyPointer (s.scope, i.name, i.cachedIndex))
+                *v = std::move (value);
+            else
+                s.root->setProperty (i.name, value);
+        }
+
+        static var getProperty (const var& object, const Identifier& name, int& cachedIndex)
+        {
+            static const Identifier lengthID ("length");
+
+            if (name == lengthID)
+            {
+                if (auto* array = object.getArray())   return array->size();
+                if (object.isString())                 return object.toString().length();
+            }
+
+            if (auto* o = object.getDynamicObject())
+                if (auto* v = getPropertyPointer (o, name, cachedIndex))
+                    return *v;
+
+            return var::undefined();
+        }
+
+        static var getIndex (const var& object, const var& key)
+        {
+            if (const auto* array = object.getArray())
+                if (key.isInt() || key.isInt64() || key.isDouble())
+                    return (*array) [static_cast<int> (key)];
+
+            if (auto* o = object.getDynamicObject())
+                if (key.isString())
+                    if (auto* v = getPropertyPointer (o, Identifier (key)))
+                        return *v;
+
+            return var::undefined();
+        }
+
+        static bool setIndex (const var& object, const var& key, const var& newValue)
+        {
+            if (auto* array = object.getArray())
+            {
+                if (key.isInt() || key.isInt64() || key.isDouble())
+                {
+                    const int i = key;
+                    while (array->size() < i)
+                        array->add (var::undefined());
+
+                    array->set (i, newValue);
+                    return true;
+                }
+            }
+
+            if (auto* o = object.getDynamicObject())
+            {
+                if (key.isString())
+                {
+                    o->setProperty (Identifier (key), newValue);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    //==============================================================================
+    struct Compiler
+    {
+        Compiler (Program& p, bool isFunction) noexcept : program (p), isFunctionBody (isFunction) {}
+
+        int emit (Instruction::OpCode op, int stackChange, const Statement* node, int arg = 0, const Identifier& name = {})
+        {
+            stackDepth += stackChange;
+            jassert (stackDepth >= 0);
+            program.stackSize = jmax (program.stackSize, stackDepth);
+            program.code.add (Instruction (op, arg, node, name));
+            return program.code.size() - 1;
+        }
+
+        void pushConstant (const var& value, const Statement* node)
+        {
+            program.constants.add (value);
+            emit (Instruction::pushConstant, 1, node, program.constants.size() - 1);
+        }
+
+        // Works out where an operator will find an operand, pushing it onto the stack if it
+        // can't be read in place.
+        Instruction::Operand compileOperand (const Expression& e, bool canBeReadLater)
+        {
+            Instruction::Operand operand;
+            operand.source = Instruction::Operand::fromStack;
+
+            if (auto* literal = dynamic_cast<const LiteralValue*> (&e))
+            {
+                operand.source = Instruction::Operand::fromConstant;
+                operand.constantIndex = program.constants.size();
+                program.constants.add (literal->value);
+            }
+            else if (auto* name = dynamic_cast<const UnqualifiedName*> (&e))
+            {
+                if (canBeReadLater)
+                {
+                    operand.source = Instruction::Operand::fromName;
+                    operand.name = name->name;
+                }
+                else
+                {
+                    e.compileValue (*this);
+                }
+            }
+            else
+            {
+                e.compileValue (*this);
+            }
+
+            return operand;
+        }
+
+        // Emits an instruction that takes its operands from wherever compileOperand() put them,
+        // and pushes the given number of results in place of any that were on the stack.
+        int emitWithOperands (Instruction::OpCode op, int numResults, const Statement* node,
+                              const Instruction::Operand& lhs, const Instruction::Operand& rhs, const Identifier& name = {})
+        {
+            auto index = emit (op, numResults, node, 0, name);
+            auto& instruction = program.code.getReference (index);
+            instruction.lhs = lhs;
+            instruction.rhs = rhs;
+            stackDepth -= instruction.getNumStackOperands();
+            return index;
+        }
+
+        // An assignment whose value isn't used can put the value straight into a variable.
+        void compileAssignmentStatement (const Statement& statement, const Expression& target, const Expression& newValue)
+        {
+            if (auto* name = dynamic_cast<const UnqualifiedName*> (&target))
+            {
+                newValue.compileStore (*this, name->name);
+            }
+            else
+            {
+                newValue.compileValue (*this);
+                target.compileAssign (*this);
+                emit (Instruction::pop, -1, &statement);
+            }
+        }
+
+        int getPosition() const noexcept                     { return program.code.size(); }
+        void setJumpTarget (int jump, int target) noexcept   { program.code.getReference (jump).arg = target; }
+        void setJumpTarget (int jump) noexcept               { setJumpTarget (jump, getPosition()); }
+
+        //==============================================================================
+        // A loop, or a for-loop initialiser, which collects the jumps that leave it until
+        // their destinations are known.
+        struct JumpScope
+        {
+            JumpScope (Compiler& c, bool isInitialiser) : compiler (c), catchesReturn (isInitialiser)  { compiler.jumpScopes.add (this); }
+            ~JumpScope()                                                                               { compiler.jumpScopes.removeLast(); }
+
+            void setTargets (int breakTarget, int continueTarget)
+            {
+                for (auto jump : breaks)     compiler.setJumpTarget (jump, breakTarget);
+                for (auto jump : continues)  compiler.setJumpTarget (jump, continueTarget);
+            }
+
+            Compiler& compiler;
+            const bool catchesReturn;
+            Array<int> breaks, continues;
+
+            JUCE_DECLARE_NON_COPYABLE (JumpScope)
+        };
+
+        void compileJumpOutOfLoop (const Statement& statement, bool isBreak)
+        {
+            if (auto* scope = jumpScopes.getLast())
+                (isBreak ? scope->breaks : scope->continues).add (emit (Instruction::jump, 0, &statement));
+            else
+                emit (Instruction::exit, 0, &statement); // outside a loop, this ends the function
+        }
+
+        void compileReturn (const Statement& statement, const Expression& value)
+        {
+            for (int i = jumpScopes.size(); --i >= 0;)
+            {
+                if (jumpScopes.getUnchecked (i)->catchesReturn)
+                {
+                    jumpScopes.getUnchecked (i)->breaks.add (emit (Instruction::jump, 0, &statement));
+                    return;
+                }
+            }
+
+            if (isFunctionBody)
+            {
+                value.compileValue (*this);
+                emit (Instruction::returnValue, -1, &statement);
+            }
+            else
+            {
+                emit (Instruction::exit, 0, &statement); // the value returned by a script is ignored
+            }
+        }
+
+        Program& program;
+        const bool isFunctionBody;
+        int stackDepth = 0;
+        Array<JumpScope*> jumpScopes;
+
+        JUCE_DECLARE_NON_COPYABLE (Compiler)
+    };
+
+    static void compileStatement (Program& program, const Statement& statement, bool isFunctionBody)
+    {
+        Compiler c (program, isFunctionBody);
+        statement.compile (c);
+        c.emit (Instruction::exit, 0, &statement);
+    }
+
+    static void compileExpression (Program& program, const Expression& expression)
+    {
+        Compiler c (program, false);
+        expression.compileValue (c);
+        c.emit (Instruction::returnValue, -1, &expression);
+    }
+
     //==============================================================================
     struct FunctionObject  : public DynamicObject
     {
@@ -846,14 +1506,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 functionRoot->setProperty (parameters.getReference(i),
                                            i < args.numArguments ? args.arguments[i] : var::undefined());
 
-            var result;
-            body->perform (Scope (&s, s.root, functionRoot), &result);
-            return result;
+            return program.run (Scope (&s, s.root, functionRoot));
         }
 
         String functionCode;
         Array<Identifier> parameters;
         ScopedPointer<Statement> body;
+        Program program;
     };
 
     //==============================================================================
@@ -1080,6 +1739,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             match (TokenTypes::closeParen);
             fo.body = parseBlock();
+            compileStatement (fo.program, *fo.body, true);
         }
 
         Expression* parseExpression()
@@ -1409,10 +2069,37 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return f.release();
         }
 
+        static bool isConstant (const Expression* e) noexcept
+        {
+            if (auto* l = dynamic_cast<const LiteralValue*> (e))
+                return ! (l->value.isObject() || l->value.isArray() || l->value.isMethod());
+
+            return false;
+        }
+
+        // Replaces an operator whose operands are both literals with its result. Anything
+        // that would throw an error is left alone, so that it still fails when it runs.
+        Expression* foldConstants (BinaryOperatorBase* op)
+        {
+            ExpPtr e (op);
+
+            if (isConstant (op->lhs) && isConstant (op->rhs))
+            {
+                try
+                {
+                    return new LiteralValue (op->location, op->apply (static_cast<LiteralValue*> (op->lhs.get())->value,
+                                                                      static_cast<LiteralValue*> (op->rhs.get())->value));
+                }
+                catch (String&) {}
+            }
+
+            return e.release();
+        }
+
         Expression* parseUnary()
         {
-            if (matchIf (TokenTypes::minus))       { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return new SubtractionOp   (location, a, b); }
-            if (matchIf (TokenTypes::logicalNot))  { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return new EqualsOp        (location, a, b); }
+            if (matchIf (TokenTypes::minus))       { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return foldConstants (new SubtractionOp (location, a, b)); }
+            if (matchIf (TokenTypes::logicalNot))  { ExpPtr a (new LiteralValue (location, (int) 0)), b (parseUnary()); return foldConstants (new EqualsOp      (location, a, b)); }
             if (matchIf (TokenTypes::plusplus))    return parsePreIncDec<AdditionOp>();
             if (matchIf (TokenTypes::minusminus))  return parsePreIncDec<SubtractionOp>();
             if (matchIf (TokenTypes::typeof_))     return parseTypeof();
@@ -1426,9 +2113,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::times))        { ExpPtr b (parseUnary()); a = new MultiplyOp (location, a, b); }
-                else if (matchIf (TokenTypes::divide))  { ExpPtr b (parseUnary()); a = new DivideOp   (location, a, b); }
-                else if (matchIf (TokenTypes::modulo))  { ExpPtr b (parseUnary()); a = new ModuloOp   (location, a, b); }
+                if (matchIf (TokenTypes::times))        { ExpPtr b (parseUnary()); a = foldConstants (new MultiplyOp (location, a, b)); }
+                else if (matchIf (TokenTypes::divide))  { ExpPtr b (parseUnary()); a = foldConstants (new DivideOp   (location, a, b)); }
+                else if (matchIf (TokenTypes::modulo))  { ExpPtr b (parseUnary()); a = foldConstants (new ModuloOp   (location, a, b)); }
                 else break;
             }
 
@@ -1441,8 +2128,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::plus))            { ExpPtr b (parseMultiplyDivide()); a = new AdditionOp    (location, a, b); }
-                else if (matchIf (TokenTypes::minus))      { ExpPtr b (parseMultiplyDivide()); a = new SubtractionOp (location, a, b); }
+                if (matchIf (TokenTypes::plus))            { ExpPtr b (parseMultiplyDivide()); a = foldConstants (new AdditionOp    (location, a, b)); }
+                else if (matchIf (TokenTypes::minus))      { ExpPtr b (parseMultiplyDivide()); a = foldConstants (new SubtractionOp (location, a, b)); }
                 else break;
             }
 
@@ -1455,9 +2142,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::leftShift))                { ExpPtr b (parseExpression()); a = new LeftShiftOp          (location, a, b); }
-                else if (matchIf (TokenTypes::rightShift))          { ExpPtr b (parseExpression()); a = new RightShiftOp         (location, a, b); }
-                else if (matchIf (TokenTypes::rightShiftUnsigned))  { ExpPtr b (parseExpression()); a = new RightShiftUnsignedOp (location, a, b); }
+                if (matchIf (TokenTypes::leftShift))                { ExpPtr b (parseExpression()); a = foldConstants (new LeftShiftOp          (location, a, b)); }
+                else if (matchIf (TokenTypes::rightShift))          { ExpPtr b (parseExpression()); a = foldConstants (new RightShiftOp         (location, a, b)); }
+                else if (matchIf (TokenTypes::rightShiftUnsigned))  { ExpPtr b (parseExpression()); a = foldConstants (new RightShiftUnsignedOp (location, a, b)); }
                 else break;
             }
 
@@ -1470,14 +2157,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::equals))                  { ExpPtr b (parseShiftOperator()); a = new EqualsOp             (location, a, b); }
-                else if (matchIf (TokenTypes::notEquals))          { ExpPtr b (parseShiftOperator()); a = new NotEqualsOp          (location, a, b); }
-                else if (matchIf (TokenTypes::typeEquals))         { ExpPtr b (parseShiftOperator()); a = new TypeEqualsOp         (location, a, b); }
-                else if (matchIf (TokenTypes::typeNotEquals))      { ExpPtr b (parseShiftOperator()); a = new TypeNotEqualsOp      (location, a, b); }
-                else if (matchIf (TokenTypes::lessThan))           { ExpPtr b (parseShiftOperator()); a = new LessThanOp           (location, a, b); }
-                else if (matchIf (TokenTypes::lessThanOrEqual))    { ExpPtr b (parseShiftOperator()); a = new LessThanOrEqualOp    (location, a, b); }
-                else if (matchIf (TokenTypes::greaterThan))        { ExpPtr b (parseShiftOperator()); a = new GreaterThanOp        (location, a, b); }
-                else if (matchIf (TokenTypes::greaterThanOrEqual)) { ExpPtr b (parseShiftOperator()); a = new GreaterThanOrEqualOp (location, a, b); }
+                if (matchIf (TokenTypes::equals))                  { ExpPtr b (parseShiftOperator()); a = foldConstants (new EqualsOp             (location, a, b)); }
+                else if (matchIf (TokenTypes::notEquals))          { ExpPtr b (parseShiftOperator()); a = foldConstants (new NotEqualsOp          (location, a, b)); }
+                else if (matchIf (TokenTypes::typeEquals))         { ExpPtr b (parseShiftOperator()); a = foldConstants (new TypeEqualsOp         (location, a, b)); }
+                else if (matchIf (TokenTypes::typeNotEquals))      { ExpPtr b (parseShiftOperator()); a = foldConstants (new TypeNotEqualsOp      (location, a, b)); }
+                else if (matchIf (TokenTypes::lessThan))           { ExpPtr b (parseShiftOperator()); a = foldConstants (new LessThanOp           (location, a, b)); }
+                else if (matchIf (TokenTypes::lessThanOrEqual))    { ExpPtr b (parseShiftOperator()); a = foldConstants (new LessThanOrEqualOp    (location, a, b)); }
+                else if (matchIf (TokenTypes::greaterThan))        { ExpPtr b (parseShiftOperator()); a = foldConstants (new GreaterThanOp        (location, a, b)); }
+                else if (matchIf (TokenTypes::greaterThanOrEqual)) { ExpPtr b (parseShiftOperator()); a = foldConstants (new GreaterThanOrEqualOp (location, a, b)); }
                 else break;
             }
 
@@ -1490,11 +2177,11 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             for (;;)
             {
-                if (matchIf (TokenTypes::logicalAnd))       { ExpPtr b (parseComparator()); a = new LogicalAndOp (location, a, b); }
-                else if (matchIf (TokenTypes::logicalOr))   { ExpPtr b (parseComparator()); a = new LogicalOrOp  (location, a, b); }
-                else if (matchIf (TokenTypes::bitwiseAnd))  { ExpPtr b (parseComparator()); a = new BitwiseAndOp (location, a, b); }
-                else if (matchIf (TokenTypes::bitwiseOr))   { ExpPtr b (parseComparator()); a = new BitwiseOrOp  (location, a, b); }
-                else if (matchIf (TokenTypes::bitwiseXor))  { ExpPtr b (parseComparator()); a = new BitwiseXorOp (location, a, b); }
+                if (matchIf (TokenTypes::logicalAnd))       { ExpPtr b (parseComparator()); a = foldConstants (new LogicalAndOp (location, a, b)); }
+                else if (matchIf (TokenTypes::logicalOr))   { ExpPtr b (parseComparator()); a = foldConstants (new LogicalOrOp  (location, a, b)); }
+                else if (matchIf (TokenTypes::bitwiseAnd))  { ExpPtr b (parseComparator()); a = foldConstants (new BitwiseAndOp (location, a, b)); }
+                else if (matchIf (TokenTypes::bitwiseOr))   { ExpPtr b (parseComparator()); a = foldConstants (new BitwiseOrOp  (location, a, b)); }
+                else if (matchIf (TokenTypes::bitwiseXor))  { ExpPtr b (parseComparator()); a = foldConstants (new BitwiseXorOp (location, a, b)); }
                 else break;
             }
 
@@ -1899,4 +2586,260 @@ const NamedValueSet& JavascriptEngine::getRootObjectProperties() const noexcept
  #pragma warning (pop)
 #endif
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JavascriptEngineTests  : public UnitTest
+{
+public:
+    JavascriptEngineTests() : UnitTest ("JavascriptEngine", "JavaScript") {}
+
+    // Describes a result in a way that distinguishes types and errors, leaving out
+    // the line and column of any error.
+    static String describe (const var& value, const Result& result)
+    {
+        if (result.failed())
+            return "error: " + result.getErrorMessage().fromFirstOccurrenceOf (" : ", false, false);
+
+        String type (value.isVoid() ? "void"
+                      : value.isUndefined() ? "undefined"
+                      : value.isBool() ? "bool"
+                      : value.isInt() ? "int"
+                      : value.isInt64() ? "int64"
+                      : value.isDouble() ? "double"
+                      : value.isString() ? "string" : "other");
+
+        return type + ": " + value.toString();
+    }
+
+    String evaluate (JavascriptEngine& engine, const String& code)
+    {
+        auto result = Result::ok();
+        auto value = engine.evaluate (code, &result);
+        return describe (value, result);
+    }
+
+    void checkFoldingMatchesRuntime (JavascriptEngine& engine, const String& operation, const String& lhs, const String& rhs)
+    {
+        // the literal version gets folded by the parser, but the one using variables can't be
+        auto folded = evaluate (engine, "(" + lhs + " " + operation + " " + rhs + ")");
+
+        expect (engine.execute ("var l = " + lhs + "; var r = " + rhs + ";").wasOk());
+        auto unfolded = evaluate (engine, "(l " + operation + " r)");
+
+        expectEquals (folded, unfolded, lhs + " " + operation + " " + rhs);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Constant folding gives the same results as run-time evaluation");
+        {
+            JavascriptEngine engine;
+
+            const char* operands[] = { "0", "1", "-3", "7", "2147483647", "0.5", "-2.25", "0.0",
+                                       "\"\"", "\"abc\"", "\"3\"", "\"10\"", "true", "false", "null" };
+
+            const char* operations[] = { "+", "-", "*", "/", "%", "<<", ">>", ">>>",
+                                         "==", "!=", "===", "!==", "<", "<=", ">", ">=",
+                                         "&&", "||", "&", "|", "^" };
+
+            for (auto* operation : operations)
+                for (auto* lhs : operands)
+                    for (auto* rhs : operands)
+                        checkFoldingMatchesRuntime (engine, operation, lhs, rhs);
+
+            for (auto* operand : operands)
+            {
+                expect (engine.execute (String ("var v = ") + operand + ";").wasOk());
+                expectEquals (evaluate (engine, String ("-(") + operand + ")"), evaluate (engine, "-v"));
+                expectEquals (evaluate (engine, String ("!(") + operand + ")"), evaluate (engine, "!v"));
+            }
+        }
+
+        beginTest ("Constant folding of nested expressions");
+        {
+            JavascriptEngine engine;
+
+            expectEquals (evaluate (engine, "1 + 2 * 3 - 8 / 4 + 7 % 3"), String ("double: 6"));
+            expectEquals (evaluate (engine, "\"x\" + 1 + 2"), String ("string: x12"));
+            expectEquals (evaluate (engine, "1 + 2 + \"x\""), String ("string: 3x"));
+            expectEquals (evaluate (engine, "(1 << 4) | 3 ^ 1"), String ("int64: 18"));
+            expectEquals (evaluate (engine, "-(-(5))"), String ("int64: 5"));
+            expectEquals (evaluate (engine, "!!\"abc\" == !0"), String ("bool: 1"));
+        }
+
+        beginTest ("Expressions that fail aren't folded");
+        {
+            JavascriptEngine engine;
+
+            // the error must happen when the expression runs, not when the script is parsed
+            expect (engine.execute ("var x = 1; if (false) x = \"a\" - \"b\"; x = 2;").wasOk());
+            expectEquals (evaluate (engine, "x"), String ("int64: 2"));
+
+            auto result = engine.execute ("var y = 1;\nvar z = \"a\" - \"b\";");
+            expect (result.failed());
+            expectEquals (result.getErrorMessage(), String ("Line 2, column 18 : '-' is not allowed on the String type"));
+            expectEquals (evaluate (engine, "y"), String ("int64: 1"));
+        }
+
+        beginTest ("Property caches follow changes to an object's layout");
+        {
+            JavascriptEngine engine;
+            DynamicObject::Ptr object (new DynamicObject());
+            object->setProperty ("a", 1);
+            object->setProperty ("b", 2);
+            object->setProperty ("c", 3);
+            engine.registerNativeObject ("obj", object.get());
+
+            expect (engine.execute ("function getC() { return obj.c; }").wasOk());
+            expectEquals (evaluate (engine, "getC()"), String ("int: 3"));
+
+            // moves c into a different slot
+            object->removeProperty ("a");
+            expectEquals (evaluate (engine, "getC()"), String ("int: 3"));
+
+            object->removeProperty ("c");
+            expectEquals (evaluate (engine, "getC()"), String ("undefined: undefined"));
+
+            object->setProperty ("c", "new");
+            expectEquals (evaluate (engine, "getC()"), String ("string: new"));
+
+            object->setProperty ("c", 4.5);
+            expectEquals (evaluate (engine, "getC()"), String ("double: 4.5"));
+
+            expect (engine.execute ("function getX (o) { return o.x; }"
+                                    "var objs = [ { x: 1 }, { a: 0, x: 2 }, { a: 0, b: 0, x: 3 }, { y: 4 } ];"
+                                    "var s = \"\";"
+                                    "for (var i = 0; i < 8; ++i) s += getX (objs[i % 4]) + \",\";").wasOk());
+
+            expectEquals (evaluate (engine, "s"), String ("string: 1,2,3,undefined,1,2,3,undefined,"));
+
+            expect (engine.execute ("objs[0].x = 10; objs[1].x = 20; objs[1].a = 5;"
+                                    "s = \"\"; for (var i = 0; i < 4; ++i) s += getX (objs[i % 4]) + \",\";").wasOk());
+
+            expectEquals (evaluate (engine, "s"), String ("string: 10,20,3,undefined,"));
+        }
+
+        beginTest ("Method caches follow replaced methods and different target types");
+        {
+            JavascriptEngine engine;
+
+            expect (engine.execute ("var o = { m: function() { return 1; } };"
+                                    "function callM() { return o.m(); }"
+                                    "var first = callM();"
+                                    "o.m = function() { return 2; };"
+                                    "var second = callM();").wasOk());
+
+            expectEquals (evaluate (engine, "first * 10 + second"), String ("int64: 12"));
+
+            expect (engine.execute ("function find (x) { return x.indexOf (\"b\"); }"
+                                    "var custom = { indexOf: function (v) { return 42; } };"
+                                    "var results = [];"
+                                    "for (var i = 0; i < 2; ++i) { results.push (find (\"abc\")); results.push (find ([\"a\", \"b\"])); results.push (find (custom)); }").wasOk());
+
+            expectEquals (evaluate (engine, "results.join (\",\")"), String ("string: 1,1,42,1,1,42"));
+        }
+
+        beginTest ("Name caches follow changes to a function's local scope");
+        {
+            JavascriptEngine engine;
+
+            expect (engine.execute ("function f (c) { if (c) { var a = 1; var b = 2; } else { var b = 3; var a = 4; } return a * 10 + b; }"
+                                    "var s = \"\"; for (var i = 0; i < 4; ++i) s += f (i % 2 == 0) + \",\";").wasOk());
+
+            expectEquals (evaluate (engine, "s"), String ("string: 12,43,12,43,"));
+
+            // the same name is local on some calls, and found in the root scope on others
+            expect (engine.execute ("var g = 5; function h (useLocal) { if (useLocal) { var g = 7; } return g; }"
+                                    "s = \"\"; for (var i = 0; i < 4; ++i) s += h (i % 2 == 0) + \",\";").wasOk());
+
+            expectEquals (evaluate (engine, "s"), String ("string: 7,5,7,5,"));
+
+            // assignments go through the cache too
+            expect (engine.execute ("function k (first) { if (first) { var p = 1; var q = 2; } else { var q = 2; var p = 1; } p = 9; return p * 10 + q; }"
+                                    "s = \"\"; for (var i = 0; i < 4; ++i) s += k (i % 2 == 0) + \",\";").wasOk());
+
+            expectEquals (evaluate (engine, "s"), String ("string: 92,92,92,92,"));
+        }
+
+        beginTest ("Operands are evaluated from left to right");
+        {
+            JavascriptEngine engine;
+
+            expect (engine.execute ("var a = [1, 2, 3, 4]; var i = 0; a[i++] = a[i++] + 10;"
+                                    "var s = 1; s = s + (s = 10);"
+                                    "var o = { x: 1 }; var n = o.x + (o = { x: 7 }).x;"
+                                    "var p = { x: 1 }; var q = { x: 5 }; var r = p; r.x = (r = q).x + 1;"
+                                    "var t = 0; for (var k = 0; k < 10; ++k) { if (k == 5) continue; if (k == 8) break; t += k; }").wasOk());
+
+            expectEquals (evaluate (engine, "a.join (\",\") + \" \" + i"), String ("string: 1,11,3,4 2"));
+            expectEquals (evaluate (engine, "s"), String ("int64: 11"));
+            expectEquals (evaluate (engine, "n"), String ("int64: 8"));
+            expectEquals (evaluate (engine, "p.x * 10 + q.x"), String ("int64: 16"));
+            expectEquals (evaluate (engine, "t"), String ("int64: 23"));
+        }
+    }
+};
+
+static JavascriptEngineTests javascriptEngineTests;
+
+//==============================================================================
+class JavascriptEngineBenchmarks  : public UnitTest
+{
+public:
+    JavascriptEngineBenchmarks() : UnitTest ("JavascriptEngine benchmarks", "Benchmarks") {}
+
+    void runTest() override
+    {
+        beginTest ("Script timings");
+
+        struct Script { const char* name; const char* code; const char* expectedResult; };
+
+        const Script scripts[] =
+        {
+            { "arithmetic loop",    "var total = 0; for (var i = 0; i < 300000; ++i) { total = total + i * 2 - (i % 7) + 3 * 4; } result = total;",
+                                    "90002400003" },
+            { "recursive calls",    "function fib (n) { if (n < 2) return n; return fib (n - 1) + fib (n - 2); } result = fib (21);",
+                                    "10946" },
+            { "object properties",  "var o = { x: 1, y: 2, z: 3, name: \"a\", gain: 0.5 }; var s = 0;"
+                                    "for (var i = 0; i < 100000; ++i) { o.x = o.x + 1; s += o.y * o.z + o.gain; } result = s;",
+                                    "650000" },
+            { "array access",       "var a = []; for (var i = 0; i < 2000; ++i) a.push (i); var s = 0;"
+                                    "for (var k = 0; k < 50; ++k) for (var i = 0; i < a.length; ++i) s += a[i]; result = s;",
+                                    "99950000" },
+            { "math calls",         "var s = 0; for (var i = 0; i < 50000; ++i) s += Math.max (i % 10, 3) * Math.abs (i - 25000); result = s;",
+                                    "3187500000" },
+            { "string building",    "var s = \"\"; for (var i = 0; i < 5000; ++i) s = s + \"x\" + i; result = s.length;",
+                                    "23890" },
+            { "automation",         "var tracks = []; for (var i = 0; i < 64; ++i) tracks.push ({ name: \"Track \" + i, gain: 1.0, pan: 0.0, muted: i % 4 == 0 });"
+                                    "function applyFade (t, amount) { if (! t.muted) { t.gain = t.gain * amount; t.pan = Math.range (t.pan + 0.01, -1.0, 1.0); } return t.muted ? 0 : 1; }"
+                                    "var sum = 0; for (var step = 0; step < 500; ++step) for (var i = 0; i < tracks.length; ++i) sum += applyFade (tracks[i], 0.999); result = sum;",
+                                    "24000" }
+        };
+
+        double totalMs = 0;
+
+        for (auto& script : scripts)
+        {
+            JavascriptEngine engine;
+            engine.maximumExecutionTime = RelativeTime::seconds (60);
+
+            auto startTime = Time::getMillisecondCounterHiRes();
+            auto result = engine.execute (script.code);
+            auto elapsedMs = Time::getMillisecondCounterHiRes() - startTime;
+            totalMs += elapsedMs;
+
+            expect (result.wasOk(), result.getErrorMessage());
+            expectEquals (engine.evaluate ("result").toString(), String (script.expectedResult));
+            logMessage (String (script.name).paddedRight (' ', 20) + String (elapsedMs, 1) + " ms");
+        }
+
+        logMessage (String ("total").paddedRight (' ', 20) + String (totalMs, 1) + " ms");
+    }
+};
+
+static JavascriptEngineBenchmarks javascriptEngineBenchmarks;
+
+#endif
+
 } // namespace juce
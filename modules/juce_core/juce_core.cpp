@@ -78,21 +78,29 @@
   #include <stdio.h>
   #include <langinfo.h>
   #include <ifaddrs.h>
-  #include <sys/resource.h>
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
 
   #if JUCE_USE_CURL
    #include <curl/curl.h>
   #endif
+
+  #if JUCE_USE_IO_URING
+   #include <sys/syscall.h>
+   #include <linux/io_uring.h>
+  #endif
  #endif
 
  #include <pwd.h>
  #include <fcntl.h>
  #include <netdb.h>
+ #include <poll.h>
  #include <arpa/inet.h>
  #include <netinet/tcp.h>
  #include <sys/time.h>
  #include <net/if.h>
  #include <sys/ioctl.h>
+ #include <sys/resource.h>
 
  #if ! JUCE_ANDROID
   #include <execinfo.h>
@@ -128,7 +136,12 @@
 #include "files/juce_FileOutputStream.cpp"
 #include "files/juce_FileSearchPath.cpp"
 #include "files/juce_TemporaryFile.cpp"
+#include "files/juce_AsyncFileIO.cpp"
+#include "files/juce_AsyncFileInputStream.cpp"
+#include "files/juce_AsyncFileOutputStream.cpp"
 #include "javascript/juce_JSON.cpp"
+#include "javascript/juce_JSONStreamParser.cpp"
+#include "javascript/juce_JSONStreamWriter.cpp"
 #include "javascript/juce_Javascript.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "logging/juce_FileLogger.cpp"
@@ -137,6 +150,8 @@
 #include "maths/juce_Expression.cpp"
 #include "maths/juce_Random.cpp"
 #include "memory/juce_MemoryBlock.cpp"
+#include "memory/juce_FixedSizeMemoryPool.cpp"
+#include "memory/juce_MemoryArena.cpp"
 #include "misc/juce_RuntimePermissions.cpp"
 #include "misc/juce_Result.cpp"
 #include "misc/juce_Uuid.cpp"
@@ -144,6 +159,7 @@
 #include "network/juce_MACAddress.cpp"
 #include "network/juce_NamedPipe.cpp"
 #include "network/juce_Socket.cpp"
+#include "network/juce_SocketReactor.cpp"
 #include "network/juce_IPAddress.cpp"
 #include "streams/juce_BufferedInputStream.cpp"
 #include "streams/juce_FileInputSource.cpp"
@@ -161,6 +177,7 @@
 #include "text/juce_StringPairArray.cpp"
 #include "text/juce_StringPool.cpp"
 #include "text/juce_TextDiff.cpp"
+#include "text/juce_UTF8TextRange.cpp"
 #include "text/juce_Base64.cpp"
 #include "threads/juce_ReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
@@ -172,6 +189,7 @@
 #include "unit_tests/juce_UnitTest.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlPullParser.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
@@ -210,6 +228,8 @@
 #endif
 #include "native/juce_linux_SystemStats.cpp"
 #include "native/juce_linux_Threads.cpp"
+#include "native/juce_linux_AsyncFileIO.cpp"
+#include "native/juce_linux_SocketReactor.cpp"
 
 //==============================================================================
 #elif JUCE_ANDROID
@@ -231,6 +251,7 @@
 //==============================================================================
 #if JUCE_UNIT_TESTS
 #include "containers/juce_HashMap_test.cpp"
+#include "containers/juce_FlatHashMap_test.cpp"
 #endif
 
 //==============================================================================
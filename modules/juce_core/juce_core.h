@@ -141,6 +141,15 @@
  #define JUCE_USE_CURL 0
 #endif
 
+/** Config: JUCE_USE_IO_URING
+    Enables the io_uring backend of the AsyncFileIO class (Linux only). This needs a kernel
+    that is version 5.6 or later at run-time, but if it's older, or io_uring has been
+    disabled, AsyncFileIO will silently fall back to using a thread pool instead.
+*/
+#ifndef JUCE_USE_IO_URING
+ #define JUCE_USE_IO_URING 0
+#endif
+
 
 /** Config: JUCE_CATCH_UNHANDLED_EXCEPTIONS
     If enabled, this will add some exception-catching code to forward unhandled exceptions
@@ -215,6 +224,7 @@ namespace juce
 
 #include "text/juce_String.h"
 #include "text/juce_StringRef.h"
+#include "text/juce_UTF8TextRange.h"
 #include "logging/juce_Logger.h"
 #include "memory/juce_LeakedObjectDetector.h"
 #include "memory/juce_ContainerDeletePolicy.h"
@@ -225,6 +235,8 @@ namespace juce
 #include "memory/juce_OptionalScopedPointer.h"
 #include "memory/juce_Singleton.h"
 #include "memory/juce_WeakReference.h"
+#include "memory/juce_FixedSizeMemoryPool.h"
+#include "memory/juce_MemoryArena.h"
 #include "threads/juce_ScopedLock.h"
 #include "threads/juce_CriticalSection.h"
 #include "maths/juce_Range.h"
@@ -243,6 +255,7 @@ namespace juce
 #include "containers/juce_AbstractFifo.h"
 #include "text/juce_NewLine.h"
 #include "text/juce_StringPool.h"
+#include "text/juce_StringArena.h"
 #include "text/juce_Identifier.h"
 #include "text/juce_StringArray.h"
 #include "text/juce_StringPairArray.h"
@@ -254,6 +267,7 @@ namespace juce
 #include "containers/juce_NamedValueSet.h"
 #include "containers/juce_DynamicObject.h"
 #include "containers/juce_HashMap.h"
+#include "containers/juce_FlatHashMap.h"
 #include "time/juce_RelativeTime.h"
 #include "time/juce_Time.h"
 #include "streams/juce_InputStream.h"
@@ -272,9 +286,14 @@ namespace juce
 #include "files/juce_TemporaryFile.h"
 #include "files/juce_FileFilter.h"
 #include "files/juce_WildcardFileFilter.h"
+#include "files/juce_AsyncFileIO.h"
+#include "files/juce_AsyncFileInputStream.h"
+#include "files/juce_AsyncFileOutputStream.h"
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSON.h"
+#include "javascript/juce_JSONStreamParser.h"
+#include "javascript/juce_JSONStreamWriter.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
@@ -300,6 +319,7 @@ namespace juce
 #include "network/juce_MACAddress.h"
 #include "network/juce_NamedPipe.h"
 #include "network/juce_Socket.h"
+#include "network/juce_SocketReactor.h"
 #include "network/juce_URL.h"
 #include "network/juce_WebInputStream.h"
 #include "system/juce_SystemStats.h"
@@ -307,6 +327,7 @@ namespace juce
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlPullParser.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+FixedSizeMemoryPool::FixedSizeMemoryPool (size_t blockSizeBytes, int numBlocksToAllocate)
+    : blockSize ((jmax ((size_t) 1, blockSizeBytes) + 15) & ~(size_t) 15),
+      numBlocks (jmax (0, numBlocksToAllocate)),
+      storage (blockSize * (size_t) numBlocks),
+      nextFreeBlock ((size_t) numBlocks, true)
+{
+    // the blocks start off linked together in order
+    for (int i = 0; i < numBlocks - 1; ++i)
+        nextFreeBlock[i] = i + 2;
+
+    freeListHead = numBlocks > 0 ? 1 : 0;
+}
+
+FixedSizeMemoryPool::~FixedSizeMemoryPool()
+{
+    // Deleting a pool while some of its blocks are still being used will end badly!
+    jassert (getNumBlocksInUse() == 0);
+}
+
+int FixedSizeMemoryPool::getNumBlocksInUse() const noexcept
+{
+    auto numFree = 0;
+
+    for (auto index = (int) (uint32) freeListHead.get(); index != 0; index = nextFreeBlock[index - 1].get())
+        ++numFree;
+
+    return numBlocks - numFree;
+}
+
+void* FixedSizeMemoryPool::allocate()
+{
+    for (;;)
+    {
+        auto oldHead = freeListHead.get();
+        auto index = (int) (uint32) oldHead;
+
+        if (index == 0)
+        {
+            ++numHeapAllocations;
+            return std::malloc (blockSize);
+        }
+
+        auto newHead = (((oldHead >> 32) + 1) << 32) | (uint32) nextFreeBlock[index - 1].get();
+
+        if (freeListHead.compareAndSetBool (newHead, oldHead))
+            return storage + blockSize * (size_t) (index - 1);
+    }
+}
+
+void FixedSizeMemoryPool::deallocate (void* block) noexcept
+{
+    if (! containsBlock (block))
+    {
+        std::free (block);
+        return;
+    }
+
+    auto index = (int) ((size_t) (static_cast<char*> (block) - storage.getData()) / blockSize) + 1;
+
+    for (;;)
+    {
+        auto oldHead = freeListHead.get();
+        nextFreeBlock[index - 1] = (int) (uint32) oldHead;
+
+        if (freeListHead.compareAndSetBool ((((oldHead >> 32) + 1) << 32) | (uint32) index, oldHead))
+            return;
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct FixedSizeMemoryPoolTests  : public UnitTest
+{
+    FixedSizeMemoryPoolTests()  : UnitTest ("FixedSizeMemoryPool", "Memory") {}
+
+    struct Worker  : public Thread
+    {
+        Worker (FixedSizeMemoryPool& p, int seed)  : Thread ("pool test"), pool (p), random (seed) {}
+
+        void run() override
+        {
+            Array<uint32*> blocks;
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                if (blocks.size() < 20 && (blocks.isEmpty() || random.nextBool()))
+                {
+                    auto* b = static_cast<uint32*> (pool.allocate());
+                    b[0] = (uint32) (pointer_sized_int) b;
+                    blocks.add (b);
+                }
+                else
+                {
+                    auto* b = blocks.removeAndReturn (random.nextInt (blocks.size()));
+
+                    if (b[0] != (uint32) (pointer_sized_int) b)
+                        ++numCorruptions;
+
+                    pool.deallocate (b);
+                }
+            }
+
+            for (auto* b : blocks)
+                pool.deallocate (b);
+        }
+
+        FixedSizeMemoryPool& pool;
+        Random random;
+        int numCorruptions = 0;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Single thread");
+
+        {
+            FixedSizeMemoryPool pool (20, 3);
+            expectEquals ((int) pool.getBlockSize(), 32);
+
+            void* blocks[4];
+
+            for (auto& b : blocks)
+                b = pool.allocate();
+
+            expect (pool.containsBlock (blocks[0]) && pool.containsBlock (blocks[1]) && pool.containsBlock (blocks[2]));
+            expect (! pool.containsBlock (blocks[3]));
+            expect (blocks[0] != blocks[1] && blocks[1] != blocks[2] && blocks[0] != blocks[2]);
+            expectEquals (pool.getNumBlocksInUse(), 3);
+            expectEquals (pool.getNumHeapAllocations(), 1);
+
+            for (auto& b : blocks)
+                pool.deallocate (b);
+
+            expectEquals (pool.getNumBlocksInUse(), 0);
+        }
+
+        beginTest ("Multiple threads");
+
+        {
+            FixedSizeMemoryPool pool (16, 50);
+            OwnedArray<Worker> workers;
+
+            for (int i = 0; i < 4; ++i)
+                workers.add (new Worker (pool, getRandom().nextInt()));
+
+            for (auto* w : workers)
+                w->startThread();
+
+            for (auto* w : workers)
+            {
+                w->waitForThreadToExit (-1);
+                expectEquals (w->numCorruptions, 0);
+            }
+
+            expectEquals (pool.getNumBlocksInUse(), 0);
+        }
+
+        beginTest ("ObjectPool");
+
+        {
+            ObjectPool<String> strings (10);
+            auto* s = strings.create ("xyz");
+            expectEquals (*s, String ("xyz"));
+            expect (strings.getMemoryPool().containsBlock (s));
+            strings.destroy (s);
+            expectEquals (strings.getMemoryPool().getNumBlocksInUse(), 0);
+        }
+    }
+};
+
+static FixedSizeMemoryPoolTests fixedSizeMemoryPoolTests;
+
+#endif
+
+} // namespace juce
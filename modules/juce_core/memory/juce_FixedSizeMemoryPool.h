@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A thread-safe pool of equally-sized blocks of memory.
+
+    All of the blocks are allocated up-front in one piece, and allocate() and deallocate()
+    just pop and push them on a lock-free list, so any number of threads can use the same
+    pool without blocking each other or touching the system allocator. If the pool runs out,
+    allocate() falls back to the heap, and deallocate() will recognise and free these blocks
+    too, so callers never have to check which kind of block they were given.
+
+    This is useful for small objects which are created and deleted at a high rate by
+    different threads, such as messages. To hold objects of one type, see ObjectPool.
+
+    @see ObjectPool, MemoryArena
+*/
+class JUCE_API  FixedSizeMemoryPool
+{
+public:
+    //==============================================================================
+    /** Creates a pool.
+
+        @param blockSizeBytes   the size of each block, which will be rounded up so that
+                                every block is suitably aligned for any type
+        @param numBlocks        the number of blocks to allocate
+    */
+    FixedSizeMemoryPool (size_t blockSizeBytes, int numBlocks);
+
+    /** Destructor.
+        All the blocks must have been returned to the pool before it is deleted.
+    */
+    ~FixedSizeMemoryPool();
+
+    //==============================================================================
+    /** Returns a block of memory of at least getBlockSize() bytes.
+        This is lock-free unless the pool is empty, in which case the block comes from the heap.
+    */
+    void* allocate();
+
+    /** Returns a block that was obtained from allocate().
+        This can be called on any thread, regardless of which one allocated the block.
+    */
+    void deallocate (void* block) noexcept;
+
+    /** Returns true if this block belongs to the pool, rather than having come from the heap. */
+    bool containsBlock (const void* block) const noexcept
+    {
+        return block >= storage.getData() && block < storage.getData() + blockSize * (size_t) numBlocks;
+    }
+
+    //==============================================================================
+    /** Returns the size of each block. */
+    size_t getBlockSize() const noexcept                { return blockSize; }
+
+    /** Returns the number of blocks that the pool holds. */
+    int getCapacity() const noexcept                    { return numBlocks; }
+
+    /** Returns the number of the pool's blocks that are currently allocated.
+        This has to walk the list of free blocks, so it's slow, and the result is only accurate
+        if no other threads are using the pool at the same time.
+    */
+    int getNumBlocksInUse() const noexcept;
+
+    /** Returns the number of times that allocate() has had to use the heap. */
+    int getNumHeapAllocations() const noexcept          { return numHeapAllocations.get(); }
+
+private:
+    //==============================================================================
+    const size_t blockSize;
+    const int numBlocks;
+    HeapBlock<char> storage;
+    HeapBlock<Atomic<int>> nextFreeBlock;
+
+    // The low 32 bits hold the index + 1 of the first free block (or 0 if there isn't one), and the
+    // high bits are a counter which changes on every update, to avoid the ABA problem.
+    Atomic<uint64> freeListHead;
+    Atomic<int> numHeapAllocations;
+
+    JUCE_DECLARE_NON_COPYABLE (FixedSizeMemoryPool)
+};
+
+//==============================================================================
+/**
+    A thread-safe pool of objects of a particular type.
+
+    This uses a FixedSizeMemoryPool to provide the memory for objects which are created
+    with create() and deleted with destroy(), e.g.
+    @code
+    ObjectPool<Voice> voicePool (128);
+
+    auto* v = voicePool.create (noteNumber, velocity);
+    ...
+    voicePool.destroy (v);
+    @endcode
+
+    @see FixedSizeMemoryPool
+*/
+template <class ObjectType>
+class ObjectPool
+{
+public:
+    /** Creates a pool with space for the given number of objects. */
+    explicit ObjectPool (int capacity)  : pool (sizeof (ObjectType), capacity) {}
+
+    /** Creates an object, passing the arguments to its constructor. */
+    template <typename... Args>
+    ObjectType* create (Args&&... args)
+    {
+        return new (pool.allocate()) ObjectType (std::forward<Args> (args)...);
+    }
+
+    /** Deletes an object that was returned by create(). */
+    void destroy (ObjectType* object) noexcept
+    {
+        if (object != nullptr)
+        {
+            object->~ObjectType();
+            pool.deallocate (object);
+        }
+    }
+
+    /** Returns the underlying memory pool. */
+    FixedSizeMemoryPool& getMemoryPool() noexcept       { return pool; }
+
+private:
+    FixedSizeMemoryPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE (ObjectPool)
+};
+
+} // namespace juce
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct MemoryArena::Chunk
+{
+    Chunk* next;
+    size_t size;
+
+    // the chunk's data follows this header, which is padded to keep it aligned
+    enum { headerSize = 32 };
+
+    char* getData() noexcept        { return reinterpret_cast<char*> (this) + headerSize; }
+
+    static Chunk* create (size_t size)
+    {
+        auto* c = static_cast<Chunk*> (std::malloc (headerSize + size));
+        jassert (c != nullptr); // out of memory!
+
+        c->next = nullptr;
+        c->size = size;
+        return c;
+    }
+};
+
+MemoryArena::MemoryArena (size_t chunkSizeBytes)  : chunkSize (jmax ((size_t) 64, chunkSizeBytes))
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+    for (auto* c = firstChunk; c != nullptr;)
+    {
+        auto* next = c->next;
+        std::free (c);
+        c = next;
+    }
+}
+
+bool MemoryArena::allocateFromCurrentChunk (size_t numBytes, size_t alignment, void*& result) noexcept
+{
+    if (currentChunk == nullptr)
+        return false;
+
+    auto* data = currentChunk->getData();
+    auto misalignment = (size_t) (pointer_sized_int) (data + currentOffset) & (alignment - 1);
+    auto start = currentOffset + (misalignment != 0 ? alignment - misalignment : 0);
+
+    if (start + numBytes > currentChunk->size)
+        return false;
+
+    result = data + start;
+    currentOffset = start + numBytes;
+    numBytesUsed += numBytes;
+    return true;
+}
+
+void* MemoryArena::allocate (size_t numBytes, size_t alignment)
+{
+    jassert (alignment > 0 && (alignment & (alignment - 1)) == 0); // must be a power of two!
+
+    void* result = nullptr;
+
+    if (allocateFromCurrentChunk (numBytes, alignment, result))
+        return result;
+
+    // Any chunks that remain from before a reset() get used in turn..
+    while (currentChunk != nullptr && currentChunk->next != nullptr)
+    {
+        currentChunk = currentChunk->next;
+        currentOffset = 0;
+
+        if (allocateFromCurrentChunk (numBytes, alignment, result))
+            return result;
+    }
+
+    auto* newChunk = Chunk::create (jmax (chunkSize, numBytes + alignment));
+    ++numChunks;
+
+    if (currentChunk != nullptr)
+        currentChunk->next = newChunk;
+    else
+        firstChunk = newChunk;
+
+    currentChunk = newChunk;
+    currentOffset = 0;
+
+    allocateFromCurrentChunk (numBytes, alignment, result);
+    jassert (result != nullptr);
+    return result;
+}
+
+void MemoryArena::reset() noexcept
+{
+    currentChunk = firstChunk;
+    currentOffset = 0;
+    numBytesUsed = 0;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MemoryArenaTests  : public UnitTest
+{
+    MemoryArenaTests()  : UnitTest ("MemoryArena", "Memory") {}
+
+    void runTest() override
+    {
+        beginTest ("Allocation");
+
+        MemoryArena arena (256);
+        Random r = getRandom();
+
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            Array<std::pair<uint8*, size_t>> blocks;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto size = (size_t) r.nextInt (i % 50 == 0 ? 1000 : 40);
+                size_t alignment = (size_t) 1 << r.nextInt (6);
+                auto* b = static_cast<uint8*> (arena.allocate (size, alignment));
+
+                expect (((pointer_sized_int) b & (pointer_sized_int) (alignment - 1)) == 0);
+                memset (b, (int) (uint8) i, size);
+                blocks.add ({ b, size });
+            }
+
+            for (int i = 0; i < blocks.size(); ++i)
+                for (size_t j = 0; j < blocks[i].second; ++j)
+                    if (blocks[i].first[j] != (uint8) i)
+                        expect (false);
+
+            auto numChunks = arena.getNumChunks();
+            arena.reset();
+            expectEquals ((int) arena.getNumBytesUsed(), 0);
+
+            if (pass > 0)
+                expectEquals (arena.getNumChunks(), numChunks);
+        }
+
+        beginTest ("Objects and containers");
+
+        {
+            struct Point3  { Point3 (float x, float y, float z) : a (x), b (y), c (z) {}  float a, b, c; };
+
+            auto* p = arena.create<Point3> (1.0f, 2.0f, 3.0f);
+            expectEquals (p->c, 3.0f);
+
+            std::vector<int, MemoryArena::Allocator<int>> v (arena);
+
+            for (int i = 0; i < 1000; ++i)
+                v.push_back (i);
+
+            expectEquals (v[999], 999);
+            expect (arena.getNumBytesUsed() > 1000 * sizeof (int));
+        }
+    }
+};
+
+static MemoryArenaTests memoryArenaTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A simple "bump" allocator, which hands out pieces of a few large chunks of memory.
+
+    Allocating just moves a pointer along the current chunk, and nothing is freed
+    individually - instead, reset() makes all of the memory available again in one go,
+    keeping the chunks so that once the arena has grown to its working size, it won't need
+    to allocate anything from the system again.
+
+    This makes it a good way of building temporary structures which are all thrown away
+    together, e.g. once per audio block or per parsed document. It isn't thread-safe, so
+    each thread should use its own arena.
+
+    Objects that are created with create() won't have their destructors called, so they
+    must be trivially destructible. The Allocator class lets standard containers use an
+    arena.
+
+    @see FixedSizeMemoryPool, StringArena
+*/
+class JUCE_API  MemoryArena
+{
+public:
+    //==============================================================================
+    /** Creates an arena.
+        @param chunkSizeBytes   the size of the chunks of memory that it allocates. Requests
+                                that are bigger than this get a chunk of their own.
+    */
+    explicit MemoryArena (size_t chunkSizeBytes = 16384);
+
+    /** Destructor. This frees all of the memory that the arena has allocated. */
+    ~MemoryArena();
+
+    //==============================================================================
+    /** Returns a block of memory, which stays valid until reset() is called or the arena
+        is deleted. The alignment must be a power of two.
+    */
+    void* allocate (size_t numBytes, size_t alignment = 16);
+
+    /** Creates an object in the arena, passing the arguments to its constructor. */
+    template <typename ObjectType, typename... Args>
+    ObjectType* create (Args&&... args)
+    {
+        static_assert (std::is_trivially_destructible<ObjectType>::value,
+                       "The arena never calls destructors, so it can only hold trivially destructible types");
+
+        return new (allocate (sizeof (ObjectType), alignof (ObjectType))) ObjectType (std::forward<Args> (args)...);
+    }
+
+    /** Makes all of the memory available for re-use, without freeing it.
+        Anything that was allocated before this is called must no longer be used.
+    */
+    void reset() noexcept;
+
+    /** Returns the number of bytes that have been handed out since the last reset(). */
+    size_t getNumBytesUsed() const noexcept             { return numBytesUsed; }
+
+    /** Returns the number of chunks that have been allocated from the system. */
+    int getNumChunks() const noexcept                   { return numChunks; }
+
+    //==============================================================================
+    /** An allocator which lets standard library containers take their memory from an arena.
+        Memory that they free isn't re-used until the arena is reset.
+    */
+    template <typename Type>
+    struct Allocator
+    {
+        typedef Type value_type;
+
+        Allocator (MemoryArena& a) noexcept  : arena (&a) {}
+
+        template <typename OtherType>
+        Allocator (const Allocator<OtherType>& other) noexcept  : arena (other.arena) {}
+
+        Type* allocate (size_t num)                     { return static_cast<Type*> (arena->allocate (num * sizeof (Type), alignof (Type))); }
+        void deallocate (Type*, size_t) noexcept        {}
+
+        template <typename OtherType>
+        bool operator== (const Allocator<OtherType>& other) const noexcept  { return arena == other.arena; }
+
+        template <typename OtherType>
+        bool operator!= (const Allocator<OtherType>& other) const noexcept  { return arena != other.arena; }
+
+        MemoryArena* arena;
+    };
+
+private:
+    //==============================================================================
+    struct Chunk;
+
+    Chunk* firstChunk = nullptr;
+    Chunk* currentChunk = nullptr;
+    size_t currentOffset = 0, numBytesUsed = 0;
+    const size_t chunkSize;
+    int numChunks = 0;
+
+    bool allocateFromCurrentChunk (size_t numBytes, size_t alignment, void*& result) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryArena)
+};
+
+} // namespace juce
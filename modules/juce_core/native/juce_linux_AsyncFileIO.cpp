@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_USE_IO_URING
+
+//==============================================================================
+/*  An AsyncFileIO backend that talks to the kernel's io_uring interface directly with
+    system calls, so that it doesn't need liburing.
+
+    Requests are written into the submission ring by whichever thread calls submit(),
+    and a single thread waits for their completions and invokes the callbacks. Requests
+    beyond the number that the ring can hold wait in a queue until earlier ones finish.
+*/
+struct AsyncFileIO::IoUringBackend  : public AsyncFileIO::Backend,
+                                      private Thread
+{
+    IoUringBackend (int maxRequestsInFlight)
+        : Thread ("AsyncFileIO"),
+          maxInFlight (maxRequestsInFlight)
+    {
+        io_uring_params params;
+        zerostruct (params);
+
+        // one extra entry is reserved for the message that stops the completion thread
+        ringFD = (int) syscall (__NR_io_uring_setup, (unsigned) maxRequestsInFlight + 1, &params);
+
+        if (ringFD < 0)
+            return;
+
+        if (mapRings (params) && supportsReadAndWrite())
+        {
+            startThread();
+        }
+        else
+        {
+            unmapRings();
+            ::close (ringFD);
+            ringFD = -1;
+        }
+    }
+
+    ~IoUringBackend()
+    {
+        if (ringFD >= 0)
+        {
+            signalThreadShouldExit();
+
+            {
+                const ScopedLock sl (submissionLock);
+
+                if (auto* sqe = getNextSubmissionEntry())
+                {
+                    sqe->opcode = IORING_OP_NOP;
+                    sqe->user_data = 0;
+                    enterRing (1);
+                }
+            }
+
+            stopThread (-1);
+            unmapRings();
+            ::close (ringFD);
+        }
+    }
+
+    bool isValid() const noexcept           { return ringFD >= 0; }
+    bool isIoUring() const noexcept override { return true; }
+
+    void start (const Array<Request*>& requests) override
+    {
+        const ScopedLock sl (submissionLock);
+        waitingRequests.addArray (requests);
+        submitWaitingRequests();
+    }
+
+private:
+    //==============================================================================
+    int ringFD = -1;
+    const int maxInFlight;
+    int numInFlight = 0;
+
+    void* submissionRing = nullptr;
+    void* completionRing = nullptr;
+    size_t submissionRingSize = 0, completionRingSize = 0, submissionEntriesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0, sqNumEntries = 0;
+    io_uring_sqe* sqEntries = nullptr;
+
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqEntries = nullptr;
+
+    CriticalSection submissionLock;
+    Array<Request*> waitingRequests;
+
+    //==============================================================================
+    static void* mapRegion (int fd, size_t size, off_t offset) noexcept
+    {
+        auto* m = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return m != MAP_FAILED ? m : nullptr;
+    }
+
+    template <typename Type>
+    static Type* getPointer (void* ring, uint32 offset) noexcept
+    {
+        return reinterpret_cast<Type*> (static_cast<char*> (ring) + offset);
+    }
+
+    bool mapRings (const io_uring_params& params)
+    {
+        submissionRingSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+        completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof (io_uring_cqe);
+        submissionEntriesSize = params.sq_entries * sizeof (io_uring_sqe);
+
+        const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (singleMapping)
+            submissionRingSize = completionRingSize = jmax (submissionRingSize, completionRingSize);
+
+        submissionRing = mapRegion (ringFD, submissionRingSize, IORING_OFF_SQ_RING);
+
+        if (submissionRing == nullptr)
+            return false;
+
+        completionRing = singleMapping ? submissionRing
+                                       : mapRegion (ringFD, completionRingSize, IORING_OFF_CQ_RING);
+
+        if (completionRing == nullptr)
+            return false;
+
+        auto* entries = mapRegion (ringFD, submissionEntriesSize, IORING_OFF_SQES);
+
+        if (entries == nullptr)
+            return false;
+
+        sqEntries    = static_cast<io_uring_sqe*> (entries);
+        sqHead       = getPointer<unsigned> (submissionRing, params.sq_off.head);
+        sqTail       = getPointer<unsigned> (submissionRing, params.sq_off.tail);
+        sqArray      = getPointer<unsigned> (submissionRing, params.sq_off.array);
+        sqMask       = *getPointer<unsigned> (submissionRing, params.sq_off.ring_mask);
+        sqNumEntries = params.sq_entries;
+
+        cqHead    = getPointer<unsigned> (completionRing, params.cq_off.head);
+        cqTail    = getPointer<unsigned> (completionRing, params.cq_off.tail);
+        cqMask    = *getPointer<unsigned> (completionRing, params.cq_off.ring_mask);
+        cqEntries = getPointer<io_uring_cqe> (completionRing, params.cq_off.cqes);
+
+        return true;
+    }
+
+    void unmapRings()
+    {
+        if (sqEntries != nullptr)
+            munmap (sqEntries, submissionEntriesSize);
+
+        if (completionRing != nullptr && completionRing != submissionRing)
+            munmap (completionRing, completionRingSize);
+
+        if (submissionRing != nullptr)
+            munmap (submissionRing, submissionRingSize);
+
+        sqEntries = nullptr;
+        submissionRing = completionRing = nullptr;
+    }
+
+    // The plain READ and WRITE operations arrived in kernel 5.6, along with the probe
+    bool supportsReadAndWrite() const
+    {
+        const unsigned numOps = 256;
+        HeapBlock<char> probeData (sizeof (io_uring_probe) + numOps * sizeof (io_uring_probe_op), true);
+        auto* probe = reinterpret_cast<io_uring_probe*> (probeData.getData());
+
+        if (syscall (__NR_io_uring_register, ringFD, IORING_REGISTER_PROBE, probe, numOps) < 0)
+            return false;
+
+        auto isSupported = [probe] (int op)
+        {
+            return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+        };
+
+        return isSupported (IORING_OP_READ) && isSupported (IORING_OP_WRITE);
+    }
+
+    //==============================================================================
+    io_uring_sqe* getNextSubmissionEntry() noexcept
+    {
+        auto tail = *sqTail;
+
+        if (tail - __atomic_load_n (sqHead, __ATOMIC_ACQUIRE) >= sqNumEntries)
+            return nullptr;
+
+        auto index = tail & sqMask;
+        auto* sqe = sqEntries + index;
+        zerostruct (*sqe);
+        sqArray[index] = index;
+        __atomic_store_n (sqTail, tail + 1, __ATOMIC_RELEASE);
+        return sqe;
+    }
+
+    void enterRing (unsigned numToSubmit)
+    {
+        while (numToSubmit > 0)
+        {
+            auto result = syscall (__NR_io_uring_enter, ringFD, numToSubmit, 0, 0, nullptr, 0);
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                // the entries are still in the ring, so the next call will pick them up
+                jassert (errno == EAGAIN || errno == EBUSY);
+                return;
+            }
+
+            numToSubmit -= (unsigned) result;
+
+            if (result == 0)
+                return;
+        }
+    }
+
+    // must be called with the submissionLock held
+    void submitWaitingRequests()
+    {
+        unsigned numAdded = 0;
+        int numTaken = 0;
+
+        while (numTaken < waitingRequests.size() && numInFlight < maxInFlight)
+        {
+            auto* sqe = getNextSubmissionEntry();
+
+            if (sqe == nullptr)
+                break;
+
+            auto* r = waitingRequests.getUnchecked (numTaken++);
+
+            // io_uring can only transfer up to 2GB in one request
+            jassert (r->numBytes <= 0x7fffffff);
+
+            sqe->opcode = r->isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe->fd = (int) (pointer_sized_int) r->file.fileHandle;
+            sqe->off = (uint64) r->position;
+            sqe->addr = (uint64) (pointer_sized_int) r->buffer;
+            sqe->len = (uint32) r->numBytes;
+            sqe->user_data = (uint64) (pointer_sized_int) r;
+
+            ++numAdded;
+            ++numInFlight;
+        }
+
+        waitingRequests.removeRange (0, numTaken);
+
+        if (numAdded > 0)
+            enterRing (numAdded);
+    }
+
+    //==============================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (syscall (__NR_io_uring_enter, ringFD, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0
+                 && errno != EINTR)
+            {
+                jassertfalse;
+                wait (1);
+            }
+
+            handleCompletions();
+        }
+    }
+
+    void handleCompletions()
+    {
+        auto head = *cqHead;
+
+        for (;;)
+        {
+            auto tail = __atomic_load_n (cqTail, __ATOMIC_ACQUIRE);
+
+            if (head == tail)
+                break;
+
+            int numFinished = 0;
+
+            while (head != tail)
+            {
+                auto& cqe = cqEntries[head & cqMask];
+                auto* r = reinterpret_cast<Request*> ((pointer_sized_int) cqe.user_data);
+                auto result = (int64) cqe.res;
+
+                __atomic_store_n (cqHead, ++head, __ATOMIC_RELEASE);
+
+                if (r != nullptr)
+                {
+                    ++numFinished;
+
+                    // a short read can just mean that the kernel gave up part-way, so finish it off here
+                    if (result > 0 && (size_t) result < r->numBytes && ! r->file.isUsingDirectIO())
+                        result = finishPartialTransfer (*r, result);
+
+                    requestFinished (r, result);
+                }
+            }
+
+            const ScopedLock sl (submissionLock);
+            numInFlight -= numFinished;
+            submitWaitingRequests();
+        }
+    }
+
+    static int64 finishPartialTransfer (Request& r, int64 numDone)
+    {
+        Request remainder (r.file, r.position + numDone, static_cast<char*> (r.buffer) + numDone,
+                           r.numBytes - (size_t) numDone, r.isWrite, {});
+
+        auto result = remainder.perform();
+        return result < 0 ? numDone : numDone + result;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (IoUringBackend)
+};
+
+AsyncFileIO::Backend* AsyncFileIO::createNativeBackend (int maxRequestsInFlight)
+{
+    ScopedPointer<IoUringBackend> b (new IoUringBackend (maxRequestsInFlight));
+    return b->isValid() ? b.release() : nullptr;
+}
+
+#endif
+
+} // namespace juce
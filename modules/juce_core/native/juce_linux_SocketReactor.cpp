@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/*  Uses epoll to watch the sockets. Every thread waits on the same epoll instance, and
+    the sockets are registered with EPOLLONESHOT, so that the kernel only wakes one of
+    the threads for each event, and won't report that socket again until it's rearmed.
+*/
+struct SocketReactor::EpollPoller  : public SocketReactor::Poller
+{
+    EpollPoller()
+    {
+        epollFD = epoll_create1 (EPOLL_CLOEXEC);
+        wakeupFD = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        if (epollFD >= 0 && wakeupFD >= 0)
+        {
+            // the wakeup event is level-triggered and never read, so once it has been
+            // signalled, every thread that waits will return immediately
+            struct epoll_event event;
+            zerostruct (event);
+            event.events = EPOLLIN;
+            event.data.u64 = 0;
+
+            if (epoll_ctl (epollFD, EPOLL_CTL_ADD, wakeupFD, &event) == 0)
+                return;
+        }
+
+        closeHandles();
+    }
+
+    ~EpollPoller()
+    {
+        closeHandles();
+    }
+
+    bool isValid() const noexcept   { return epollFD >= 0; }
+
+    bool add (int handle, int64 id) override
+    {
+        auto event = createEvent (id);
+        return epoll_ctl (epollFD, EPOLL_CTL_ADD, handle, &event) == 0;
+    }
+
+    void rearm (int handle, int64 id) override
+    {
+        auto event = createEvent (id);
+        epoll_ctl (epollFD, EPOLL_CTL_MOD, handle, &event);
+    }
+
+    void remove (int handle) override
+    {
+        epoll_ctl (epollFD, EPOLL_CTL_DEL, handle, nullptr);
+    }
+
+    int waitForEvents (int64* ids, int maxIds) override
+    {
+        struct epoll_event events[32];
+        auto numEvents = epoll_wait (epollFD, events, jmin (maxIds, (int) numElementsInArray (events)), -1);
+        int numIds = 0;
+
+        for (int i = 0; i < numEvents; ++i)
+            if (events[i].data.u64 != 0)
+                ids[numIds++] = (int64) events[i].data.u64;
+
+        return numIds;
+    }
+
+    void wakeAllThreads() override
+    {
+        uint64 value = 1;
+        auto ignored = ::write (wakeupFD, &value, sizeof (value));
+        ignoreUnused (ignored);
+    }
+
+private:
+    int epollFD = -1, wakeupFD = -1;
+
+    static struct epoll_event createEvent (int64 id) noexcept
+    {
+        struct epoll_event event;
+        zerostruct (event);
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.u64 = (uint64) id;
+        return event;
+    }
+
+    void closeHandles()
+    {
+        if (wakeupFD >= 0)  ::close (wakeupFD);
+        if (epollFD >= 0)   ::close (epollFD);
+
+        wakeupFD = epollFD = -1;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (EpollPoller)
+};
+
+SocketReactor::Poller* SocketReactor::createNativePoller()
+{
+    ScopedPointer<EpollPoller> poller (new EpollPoller());
+    return poller->isValid() ? poller.release() : nullptr;
+}
+
+} // namespace juce
@@ -585,6 +585,50 @@ Result FileOutputStream::truncate()
     return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) currentPosition));
 }
 
+//==============================================================================
+void AsyncFileIO::OpenFile::openHandle (bool forWriting)
+{
+    auto flags = (forWriting ? (O_RDWR | O_CREAT) : O_RDONLY) | O_CLOEXEC;
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    if (directIO)
+        flags |= O_DIRECT;
+   #endif
+
+    auto f = open (file.getFullPathName().toUTF8(), flags, 00644);
+
+    if (f != -1)
+    {
+        fileHandle = fdToVoidPointer (f);
+
+       #if JUCE_MAC || JUCE_IOS
+        if (directIO)
+            fcntl (f, F_NOCACHE, 1);
+       #endif
+    }
+    else
+    {
+        status = getResultForErrno();
+    }
+}
+
+void AsyncFileIO::OpenFile::closeHandle()
+{
+    close (getFD (fileHandle));
+}
+
+int64 AsyncFileIO::OpenFile::readAt (int64 position, void* destBuffer, size_t numBytes)
+{
+    auto result = pread (getFD (fileHandle), destBuffer, numBytes, (off_t) position);
+    return result >= 0 ? (int64) result : (int64) -errno;
+}
+
+int64 AsyncFileIO::OpenFile::writeAt (int64 position, const void* sourceData, size_t numBytes)
+{
+    auto result = pwrite (getFD (fileHandle), sourceData, numBytes, (off_t) position);
+    return result >= 0 ? (int64) result : (int64) -errno;
+}
+
 //==============================================================================
 String SystemStats::getEnvironmentVariable (const String& name, const String& defaultValue)
 {
@@ -595,7 +639,7 @@ String SystemStats::getEnvironmentVariable (const String& name, const String& de
 }
 
 //==============================================================================
-void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive)
+void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive, bool preloadPages)
 {
     jassert (mode == readOnly || mode == readWrite);
 
@@ -610,15 +654,26 @@ void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exc
 
     if (fileHandle != -1)
     {
+        auto flags = exclusive ? MAP_PRIVATE : MAP_SHARED;
+
+       #if JUCE_LINUX || JUCE_ANDROID
+        if (preloadPages)
+            flags |= MAP_POPULATE;
+       #endif
+
         void* m = mmap (0, (size_t) range.getLength(),
                         mode == readWrite ? (PROT_READ | PROT_WRITE) : PROT_READ,
-                        exclusive ? MAP_PRIVATE : MAP_SHARED, fileHandle,
-                        (off_t) range.getStart());
+                        flags, fileHandle, (off_t) range.getStart());
 
         if (m != MAP_FAILED)
         {
             address = m;
             madvise (m, (size_t) range.getLength(), MADV_SEQUENTIAL);
+
+           #if ! (JUCE_LINUX || JUCE_ANDROID)
+            if (preloadPages)
+                prefetch (range);
+           #endif
         }
         else
         {
@@ -636,6 +691,58 @@ MemoryMappedFile::~MemoryMappedFile()
         close (fileHandle);
 }
 
+bool MemoryMappedFile::setAccessPattern (AccessPattern pattern) noexcept
+{
+    if (address == nullptr)
+        return false;
+
+    auto advice = pattern == sequentialAccess ? MADV_SEQUENTIAL
+                                              : (pattern == randomAccess ? MADV_RANDOM : MADV_NORMAL);
+
+    return madvise (address, (size_t) range.getLength(), advice) == 0;
+}
+
+bool MemoryMappedFile::prefetch (Range<int64> fileRange) const noexcept
+{
+    auto pages = getPageRangeWithinMapping (fileRange);
+
+    return ! pages.isEmpty()
+            && madvise (addBytesToPointer (address, pages.getStart()), pages.getLength(), MADV_WILLNEED) == 0;
+}
+
+bool MemoryMappedFile::lockInMemory (Range<int64> fileRange) noexcept
+{
+    auto pages = getPageRangeWithinMapping (fileRange);
+    return ! pages.isEmpty() && mlock (addBytesToPointer (address, pages.getStart()), pages.getLength()) == 0;
+}
+
+bool MemoryMappedFile::unlockFromMemory (Range<int64> fileRange) noexcept
+{
+    auto pages = getPageRangeWithinMapping (fileRange);
+    return ! pages.isEmpty() && munlock (addBytesToPointer (address, pages.getStart()), pages.getLength()) == 0;
+}
+
+MemoryMappedFile::PageFaultCounts MemoryMappedFile::getPageFaultCounts (bool forCallingThreadOnly) noexcept
+{
+   #ifdef RUSAGE_THREAD
+    auto who = forCallingThreadOnly ? RUSAGE_THREAD : RUSAGE_SELF;
+   #else
+    ignoreUnused (forCallingThreadOnly);
+    auto who = RUSAGE_SELF;
+   #endif
+
+    PageFaultCounts counts;
+    struct rusage usage;
+
+    if (getrusage (who, &usage) == 0)
+    {
+        counts.numMajorFaults = (int64) usage.ru_majflt;
+        counts.numFaults = (int64) usage.ru_minflt + counts.numMajorFaults;
+    }
+
+    return counts;
+}
+
 //==============================================================================
 File juce_getExecutableFile();
 File juce_getExecutableFile()
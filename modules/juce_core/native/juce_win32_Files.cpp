@@ -344,7 +344,57 @@ Result FileOutputStream::truncate()
 }
 
 //==============================================================================
-void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive)
+void AsyncFileIO::OpenFile::openHandle (bool forWriting)
+{
+    HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(),
+                           forWriting ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                           forWriting ? FILE_SHARE_READ : (FILE_SHARE_READ | FILE_SHARE_WRITE), 0,
+                           forWriting ? OPEN_ALWAYS : OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | (directIO ? (FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH) : 0), 0);
+
+    if (h != INVALID_HANDLE_VALUE)
+        fileHandle = (void*) h;
+    else
+        status = WindowsFileHelpers::getResultForLastError();
+}
+
+void AsyncFileIO::OpenFile::closeHandle()
+{
+    CloseHandle ((HANDLE) fileHandle);
+}
+
+int64 AsyncFileIO::OpenFile::readAt (int64 position, void* destBuffer, size_t numBytes)
+{
+    OVERLAPPED overlapped;
+    zerostruct (overlapped);
+    overlapped.Offset = (DWORD) position;
+    overlapped.OffsetHigh = (DWORD) (position >> 32);
+
+    DWORD actualNum = 0;
+
+    if (! ReadFile ((HANDLE) fileHandle, destBuffer, (DWORD) numBytes, &actualNum, &overlapped))
+        return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+
+    return (int64) actualNum;
+}
+
+int64 AsyncFileIO::OpenFile::writeAt (int64 position, const void* sourceData, size_t numBytes)
+{
+    OVERLAPPED overlapped;
+    zerostruct (overlapped);
+    overlapped.Offset = (DWORD) position;
+    overlapped.OffsetHigh = (DWORD) (position >> 32);
+
+    DWORD actualNum = 0;
+
+    if (! WriteFile ((HANDLE) fileHandle, sourceData, (DWORD) numBytes, &actualNum, &overlapped))
+        return -1;
+
+    return (int64) actualNum;
+}
+
+//==============================================================================
+void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive, bool preloadPages)
 {
     jassert (mode == readOnly || mode == readWrite);
 
@@ -384,6 +434,8 @@ void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exc
 
             if (address == nullptr)
                 range = Range<int64>();
+            else if (preloadPages)
+                prefetch (range);
 
             CloseHandle (mappingHandle);
         }
@@ -399,6 +451,67 @@ MemoryMappedFile::~MemoryMappedFile()
         CloseHandle ((HANDLE) fileHandle);
 }
 
+bool MemoryMappedFile::setAccessPattern (AccessPattern) noexcept
+{
+    return false;
+}
+
+bool MemoryMappedFile::prefetch (Range<int64> fileRange) const noexcept
+{
+    // PrefetchVirtualMemory is only available from Windows 8 onwards
+    struct MemoryRangeEntry  { void* address; SIZE_T numBytes; };
+    typedef BOOL (WINAPI* PrefetchVirtualMemoryFn) (HANDLE, ULONG_PTR, MemoryRangeEntry*, ULONG);
+
+    static auto prefetchVirtualMemory
+        = (PrefetchVirtualMemoryFn) GetProcAddress (GetModuleHandleA ("kernel32"), "PrefetchVirtualMemory");
+
+    auto pages = getPageRangeWithinMapping (fileRange);
+
+    if (prefetchVirtualMemory == nullptr || pages.isEmpty())
+        return false;
+
+    MemoryRangeEntry entry = { addBytesToPointer (address, pages.getStart()), (SIZE_T) pages.getLength() };
+    return prefetchVirtualMemory (GetCurrentProcess(), 1, &entry, 0) != FALSE;
+}
+
+bool MemoryMappedFile::lockInMemory (Range<int64> fileRange) noexcept
+{
+    auto pages = getPageRangeWithinMapping (fileRange);
+    return ! pages.isEmpty() && VirtualLock (addBytesToPointer (address, pages.getStart()), (SIZE_T) pages.getLength());
+}
+
+bool MemoryMappedFile::unlockFromMemory (Range<int64> fileRange) noexcept
+{
+    auto pages = getPageRangeWithinMapping (fileRange);
+    return ! pages.isEmpty() && VirtualUnlock (addBytesToPointer (address, pages.getStart()), (SIZE_T) pages.getLength());
+}
+
+MemoryMappedFile::PageFaultCounts MemoryMappedFile::getPageFaultCounts (bool) noexcept
+{
+    // Avoids linking to psapi.lib - K32GetProcessMemoryInfo is in kernel32 from Windows 7 onwards
+    struct ProcessMemoryCounters
+    {
+        DWORD cb, pageFaultCount;
+        SIZE_T peakWorkingSetSize, workingSetSize, quotaPeakPagedPoolUsage, quotaPagedPoolUsage,
+               quotaPeakNonPagedPoolUsage, quotaNonPagedPoolUsage, pagefileUsage, peakPagefileUsage;
+    };
+
+    typedef BOOL (WINAPI* GetProcessMemoryInfoFn) (HANDLE, ProcessMemoryCounters*, DWORD);
+
+    static auto getProcessMemoryInfo
+        = (GetProcessMemoryInfoFn) GetProcAddress (GetModuleHandleA ("kernel32"), "K32GetProcessMemoryInfo");
+
+    PageFaultCounts counts;
+    ProcessMemoryCounters info;
+    zerostruct (info);
+    info.cb = sizeof (info);
+
+    if (getProcessMemoryInfo != nullptr && getProcessMemoryInfo (GetCurrentProcess(), &info, sizeof (info)))
+        counts.numFaults = (int64) info.pageFaultCount;
+
+    return counts;
+}
+
 //==============================================================================
 int64 File::getSize() const
 {
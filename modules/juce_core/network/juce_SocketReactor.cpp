@@ -0,0 +1,468 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+struct SocketReactor::Entry  : public ReferenceCountedObject
+{
+    Entry (StreamingSocket& s, Listener& l, int64 entryId)
+        : socket (s), listener (l), id (entryId), handle (s.getRawSocketHandle())
+    {}
+
+    StreamingSocket& socket;
+    Listener& listener;
+    const int64 id;
+    const int handle;
+    Thread::ThreadID callingThread = nullptr;
+    bool removed = false;
+    WaitableEvent callbackFinished;
+
+    typedef ReferenceCountedObjectPtr<Entry> Ptr;
+};
+
+//==============================================================================
+/*  Waits for sockets to become readable.
+
+    Each socket that is reported by waitForEvents() is disarmed, so that no other
+    thread will be told about it until rearm() is called.
+*/
+struct SocketReactor::Poller
+{
+    virtual ~Poller() {}
+
+    virtual bool add (int handle, int64 id) = 0;
+    virtual void rearm (int handle, int64 id) = 0;
+    virtual void remove (int handle) = 0;
+    virtual int waitForEvents (int64* ids, int maxIds) = 0;
+    virtual void wakeAllThreads() = 0;
+};
+
+//==============================================================================
+/*  A portable poller, which calls poll() on all the armed sockets.
+
+    Only one thread polls at a time, while the others handle the sockets that it has
+    found. When a socket is added or rearmed, a datagram is sent to a socket which is
+    also being polled, so that the polling thread wakes up and includes it.
+*/
+struct SocketReactor::PollPoller  : public SocketReactor::Poller
+{
+    PollPoller()
+    {
+        if (wakeupSocket.bindToPort (0, "127.0.0.1"))
+            wakeupPort = wakeupSocket.getBoundPort();
+    }
+
+   #if JUCE_WINDOWS
+    typedef WSAPOLLFD PollFD;
+    static int pollSockets (PollFD* fds, int num, int timeoutMs)   { return WSAPoll (fds, (ULONG) num, timeoutMs); }
+   #else
+    typedef struct pollfd PollFD;
+    static int pollSockets (PollFD* fds, int num, int timeoutMs)   { return ::poll (fds, (nfds_t) num, timeoutMs); }
+   #endif
+
+    struct Socket
+    {
+        int handle;
+        int64 id;
+        bool armed;
+    };
+
+    bool add (int handle, int64 id) override
+    {
+        const ScopedLock sl (lock);
+        sockets.add ({ handle, id, true });
+        wakeUpLocked();
+        return true;
+    }
+
+    void rearm (int handle, int64) override
+    {
+        const ScopedLock sl (lock);
+
+        for (auto& s : sockets)
+            if (s.handle == handle)
+                s.armed = true;
+
+        wakeUpLocked();
+    }
+
+    void remove (int handle) override
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = sockets.size(); --i >= 0;)
+            if (sockets.getReference (i).handle == handle)
+                sockets.remove (i);
+    }
+
+    int waitForEvents (int64* ids, int maxIds) override
+    {
+        const ScopedLock pl (pollLock);
+        fds.clearQuick();
+        indexes.clearQuick();
+
+        {
+            const ScopedLock sl (lock);
+
+            if (wakeupPort > 0)
+            {
+                PollFD fd;
+                zerostruct (fd);
+                fd.fd = (decltype (fd.fd)) wakeupSocket.getRawSocketHandle();
+                fd.events = POLLIN;
+                fds.add (fd);
+                indexes.add (-1);
+            }
+
+            for (int i = 0; i < sockets.size(); ++i)
+            {
+                auto& s = sockets.getReference (i);
+
+                if (s.armed)
+                {
+                    PollFD fd;
+                    zerostruct (fd);
+                    fd.fd = (decltype (fd.fd)) s.handle;
+                    fd.events = POLLIN;
+                    fds.add (fd);
+                    indexes.add (i);
+                }
+            }
+        }
+
+        auto numFDs = fds.size();
+
+        if (numFDs == 0)
+        {
+            Thread::sleep (pollInterval);
+            return 0;
+        }
+
+        isPolling = true;
+        auto numReady = pollSockets (fds.getRawDataPointer(), numFDs, pollInterval);
+        isPolling = false;
+
+        if (numReady <= 0)
+            return 0;
+
+        if (wakeupPort > 0 && fds.getReference (0).revents != 0)
+        {
+            char buffer[64];
+
+            while (wakeupSocket.read (buffer, sizeof (buffer), false) > 0)
+            {}
+        }
+
+        const ScopedLock sl (lock);
+        int numEvents = 0;
+
+        for (int i = 0; i < numFDs && numEvents < maxIds; ++i)
+        {
+            if (fds[i].revents == 0)
+                continue;
+
+            // (sockets may have been removed while polling, so the handle is checked too)
+            auto index = indexes.getUnchecked (i);
+
+            if (isPositiveAndBelow (index, sockets.size()))
+            {
+                auto& s = sockets.getReference (index);
+
+                if (s.handle == (int) fds.getReference (i).fd && s.armed)
+                {
+                    s.armed = false;
+                    ids[numEvents++] = s.id;
+                }
+            }
+        }
+
+        return numEvents;
+    }
+
+    void wakeAllThreads() override
+    {
+        const ScopedLock sl (lock);
+        wakeUpLocked();
+    }
+
+    void wakeUpLocked()
+    {
+        if (wakeupPort > 0 && isPolling)
+            wakeupSocket.write ("127.0.0.1", wakeupPort, "", 1);
+    }
+
+    enum { pollInterval = 100 };
+
+    Array<Socket> sockets;
+    CriticalSection lock;
+    DatagramSocket wakeupSocket;
+    int wakeupPort = 0;
+    CriticalSection pollLock;
+    Array<PollFD> fds;
+    Array<int> indexes;
+    volatile bool isPolling = false;
+};
+
+#if ! JUCE_LINUX
+SocketReactor::Poller* SocketReactor::createNativePoller()   { return nullptr; }
+#endif
+
+//==============================================================================
+struct SocketReactor::ReactorThread  : public Thread
+{
+    ReactorThread (SocketReactor& r)  : Thread ("JUCE socket reactor"), owner (r) {}
+
+    void run() override     { owner.handleEvents (*this); }
+
+    SocketReactor& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (ReactorThread)
+};
+
+//==============================================================================
+SocketReactor::SocketReactor (int numThreads)
+{
+    poller = createNativePoller();
+
+    if (poller == nullptr)
+        poller = new PollPoller();
+
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+    {
+        auto* t = threads.add (new ReactorThread (*this));
+        t->startThread();
+    }
+}
+
+SocketReactor::~SocketReactor()
+{
+    // all sockets should be removed before the reactor is deleted!
+    jassert (getNumSockets() == 0);
+
+    stopThreads();
+}
+
+void SocketReactor::stopThreads()
+{
+    for (auto* t : threads)
+        t->signalThreadShouldExit();
+
+    poller->wakeAllThreads();
+
+    for (auto* t : threads)
+        t->stopThread (4000);
+
+    threads.clear();
+}
+
+//==============================================================================
+bool SocketReactor::addSocket (StreamingSocket& socket, Listener& listener)
+{
+    if (! socket.isConnected() || socket.getRawSocketHandle() < 0)
+        return false;
+
+    const ScopedLock sl (lock);
+    Entry::Ptr entry (new Entry (socket, listener, nextId++));
+    entries.set (entry->id, entry);
+
+    if (poller->add (entry->handle, entry->id))
+        return true;
+
+    entries.remove (entry->id);
+    return false;
+}
+
+void SocketReactor::removeSocket (StreamingSocket& socket)
+{
+    Entry::Ptr entry;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (HashMap<int64, Entry::Ptr>::Iterator i (entries); i.next();)
+        {
+            if (&(i.getValue()->socket) == &socket)
+            {
+                entry = i.getValue();
+                break;
+            }
+        }
+
+        if (entry == nullptr)
+            return;
+
+        entries.remove (entry->id);
+        entry->removed = true;
+        poller->remove (entry->handle);
+
+        if (entry->callingThread == nullptr || entry->callingThread == Thread::getCurrentThreadId())
+            return;
+    }
+
+    entry->callbackFinished.wait();
+}
+
+int SocketReactor::getNumSockets() const
+{
+    const ScopedLock sl (lock);
+    return entries.size();
+}
+
+//==============================================================================
+void SocketReactor::handleEvents (Thread& thread)
+{
+    const int maxEvents = 32;
+    int64 ids[maxEvents];
+
+    while (! thread.threadShouldExit())
+    {
+        auto numEvents = poller->waitForEvents (ids, maxEvents);
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            Entry::Ptr entry;
+
+            {
+                const ScopedLock sl (lock);
+                entry = entries[ids[i]];
+
+                if (entry == nullptr)
+                    continue;
+
+                entry->callingThread = Thread::getCurrentThreadId();
+            }
+
+            entry->listener.socketReadyForReading (entry->socket);
+
+            const ScopedLock sl (lock);
+            entry->callingThread = nullptr;
+
+            if (entry->removed)
+                entry->callbackFinished.signal();
+            else
+                poller->rearm (entry->handle, entry->id);
+        }
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SocketReactorTests  : public UnitTest
+{
+public:
+    SocketReactorTests() : UnitTest ("SocketReactor", "Networking") {}
+
+    struct Counter  : public SocketReactor::Listener
+    {
+        void socketReadyForReading (StreamingSocket& socket) override
+        {
+            char buffer[256];
+            auto numRead = socket.read (buffer, sizeof (buffer), false);
+
+            if (numRead > 0)
+                numBytes += numRead;
+            else
+                closed = true;
+        }
+
+        Atomic<int> numBytes;
+        volatile bool closed = false;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Reading from many sockets");
+
+        StreamingSocket listener;
+        expect (listener.createListener (0, "127.0.0.1"));
+
+        const int numSockets = 20;
+        OwnedArray<StreamingSocket> clients, servers;
+        OwnedArray<Counter> counters;
+        SocketReactor reactor (3);
+
+        expectEquals (reactor.getNumThreads(), 3);
+
+        for (int i = 0; i < numSockets; ++i)
+        {
+            auto* client = clients.add (new StreamingSocket());
+            expect (client->connect ("127.0.0.1", listener.getBoundPort(), 1000));
+
+            auto* server = servers.add (listener.waitForNextConnection());
+            expect (server != nullptr);
+
+            if (server != nullptr)
+                expect (reactor.addSocket (*server, *counters.add (new Counter())));
+        }
+
+        expectEquals (reactor.getNumSockets(), numSockets);
+
+        for (int round = 0; round < 10; ++round)
+            for (int i = 0; i < numSockets; ++i)
+                clients.getUnchecked (i)->write ("0123456789", i + 1);
+
+        auto waitFor = [] (std::function<bool()> condition)
+        {
+            for (int i = 0; i < 500 && ! condition(); ++i)
+                Thread::sleep (10);
+        };
+
+        waitFor ([&]
+        {
+            for (int i = 0; i < numSockets; ++i)
+                if (counters.getUnchecked (i)->numBytes.get() != 10 * (i + 1))
+                    return false;
+
+            return true;
+        });
+
+        for (int i = 0; i < numSockets; ++i)
+            expectEquals (counters.getUnchecked (i)->numBytes.get(), 10 * (i + 1));
+
+        beginTest ("Noticing closed sockets");
+
+        clients.getUnchecked (0)->close();
+        waitFor ([&] { return counters.getUnchecked (0)->closed; });
+        expect (counters.getUnchecked (0)->closed);
+
+        beginTest ("Removing sockets");
+
+        for (auto* server : servers)
+            reactor.removeSocket (*server);
+
+        expectEquals (reactor.getNumSockets(), 0);
+
+        clients.getUnchecked (1)->write ("x", 1);
+        Thread::sleep (50);
+        expectEquals (counters.getUnchecked (1)->numBytes.get(), 20);
+    }
+};
+
+static SocketReactorTests socketReactorTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Watches a set of StreamingSockets and calls a listener whenever one of them has
+    data waiting to be read, using a small, fixed pool of threads.
+
+    This lets a program service hundreds of connections without needing a thread for
+    each one. On Linux the sockets are watched with epoll; on other platforms, poll()
+    is used instead.
+
+    Each socket is only ever handled by one thread at a time: while its listener is being
+    called, it won't be reported again, so the listener doesn't need to worry about being
+    re-entered for the same socket. The listener should read what it needs without
+    blocking for long, because other sockets may be waiting for the same thread.
+
+    @see StreamingSocket, InterprocessConnection::setSocketReactor
+*/
+class JUCE_API  SocketReactor
+{
+public:
+    //==============================================================================
+    /** Creates a reactor and starts its threads. */
+    explicit SocketReactor (int numThreads = 2);
+
+    /** Destructor.
+        All the sockets must have been removed before the reactor is deleted.
+    */
+    ~SocketReactor();
+
+    //==============================================================================
+    /** Receives callbacks from a SocketReactor. */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called on one of the reactor's threads when the socket has data waiting, or
+            when the other end has closed it (in which case a read will return 0).
+        */
+        virtual void socketReadyForReading (StreamingSocket& socket) = 0;
+    };
+
+    //==============================================================================
+    /** Starts watching a connected socket.
+        The socket and listener must stay alive until removeSocket() has been called.
+        @returns false if the socket couldn't be added
+    */
+    bool addSocket (StreamingSocket& socket, Listener& listener);
+
+    /** Stops watching a socket.
+
+        If the socket's listener is currently being called on another thread, this will
+        wait for it to return, so that after this method, the listener is guaranteed not
+        to be in use. It's safe to call this from inside the socket's own callback.
+    */
+    void removeSocket (StreamingSocket& socket);
+
+    /** Returns the number of sockets being watched. */
+    int getNumSockets() const;
+
+    /** Returns the number of threads that the reactor is using. */
+    int getNumThreads() const noexcept              { return threads.size(); }
+
+private:
+    //==============================================================================
+    struct Entry;
+    struct Poller;
+    struct PollPoller;
+    struct EpollPoller;
+    struct ReactorThread;
+
+    friend struct ContainerDeletePolicy<Poller>;
+    ScopedPointer<Poller> poller;
+    OwnedArray<Thread> threads;
+    HashMap<int64, ReferenceCountedObjectPtr<Entry>> entries;
+    CriticalSection lock;
+    int64 nextId = 1;
+
+    static Poller* createNativePoller();
+    void handleEvents (Thread&);
+    void stopThreads();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SocketReactor)
+};
+
+} // namespace juce
@@ -52,11 +52,12 @@ static inline CharPointer_wchar_t castToCharPointer_wchar_t (const void* t) noex
 struct EmptyString
 {
     int refCount;
+    int arenaBlockOffset;
     size_t allocatedBytes;
     String::CharPointerType::CharType text;
 };
 
-static const EmptyString emptyString = { 0x3fffffff, sizeof (String::CharPointerType::CharType), 0 };
+static const EmptyString emptyString = { 0x3fffffff, 0, sizeof (String::CharPointerType::CharType), 0 };
 
 //==============================================================================
 class StringHolder
@@ -73,6 +74,7 @@ public:
         numBytes = (numBytes + 3) & ~(size_t) 3;
         auto s = reinterpret_cast<StringHolder*> (new char [sizeof (StringHolder) - sizeof (CharType) + numBytes]);
         s->refCount.value = 0;
+        s->arenaBlockOffset = 0;
         s->allocatedNumBytes = numBytes;
         return CharPointerType (s->text);
     }
@@ -163,8 +165,15 @@ public:
     static inline void release (StringHolder* const b) noexcept
     {
         if (b != (StringHolder*) &emptyString)
+        {
             if (--(b->refCount) == -1)
-                delete[] reinterpret_cast<char*> (b);
+            {
+                if (b->arenaBlockOffset != 0)
+                    StringArena::releaseBlock (reinterpret_cast<StringArena::Block*> (reinterpret_cast<char*> (b) - b->arenaBlockOffset));
+                else
+                    delete[] reinterpret_cast<char*> (b);
+            }
+        }
     }
 
     static void release (const CharPointerType text) noexcept
@@ -206,6 +215,7 @@ public:
 
     //==============================================================================
     Atomic<int> refCount;
+    int arenaBlockOffset; // if this lives in a StringArena block, this is its offset from the start of the block
     size_t allocatedNumBytes;
     CharType text[1];
 
@@ -235,6 +245,89 @@ private:
     }
 };
 
+//==============================================================================
+struct StringArena::Block
+{
+    Atomic<int> numReferences;
+};
+
+StringArena::StringArena (size_t blockSizeBytes)
+    : blockSize (jlimit ((size_t) 1024, (size_t) 0x10000000, blockSizeBytes))
+{
+    static_assert (sizeof (Block) <= blockHeaderSize, "The block header is too small");
+}
+
+StringArena::~StringArena()
+{
+    releaseCurrentBlock();
+}
+
+String StringArena::createString (StringRef text)
+{
+    return createString (text.text, text.text.findTerminatingNull());
+}
+
+String StringArena::createString (String::CharPointerType start, String::CharPointerType end)
+{
+    String s;
+
+    if (start.getAddress() != nullptr && ! start.isEmpty())
+    {
+        auto numBytes = (size_t) (reinterpret_cast<const char*> (end.getAddress())
+                                   - reinterpret_cast<const char*> (start.getAddress()));
+        s.text = allocate (numBytes + sizeof (String::CharPointerType::CharType));
+        memcpy (s.text.getAddress(), start.getAddress(), numBytes);
+        s.text.getAddress()[numBytes / sizeof (String::CharPointerType::CharType)] = 0;
+    }
+
+    return s;
+}
+
+String::CharPointerType StringArena::allocate (size_t numBytes)
+{
+    numBytes = (numBytes + 3) & ~(size_t) 3;
+    auto totalSize = (sizeof (StringHolder) - sizeof (StringHolder::CharType) + numBytes + 7) & ~(size_t) 7;
+
+    if (totalSize > blockSize / 4)
+        return StringHolder::createUninitialisedBytes (numBytes);
+
+    if (currentBlock == nullptr || position + totalSize > blockSize)
+    {
+        releaseCurrentBlock();
+        currentBlock = new (new char [blockSize]) Block();
+        currentBlock->numReferences = 1; // (the arena's own reference)
+        position = blockHeaderSize;
+        ++numBlocksAllocated;
+    }
+
+    auto* s = reinterpret_cast<StringHolder*> (reinterpret_cast<char*> (currentBlock) + position);
+    s->refCount.value = 0;
+    s->arenaBlockOffset = (int) position;
+    s->allocatedNumBytes = numBytes;
+
+    position += totalSize;
+    ++(currentBlock->numReferences);
+    return String::CharPointerType (s->text);
+}
+
+void StringArena::releaseCurrentBlock() noexcept
+{
+    if (currentBlock != nullptr)
+    {
+        releaseBlock (currentBlock);
+        currentBlock = nullptr;
+    }
+}
+
+void StringArena::releaseBlock (Block* b) noexcept
+{
+    if (--(b->numReferences) == 0)
+    {
+        b->~Block();
+        delete[] reinterpret_cast<char*> (b);
+    }
+}
+
 #if JUCE_ALLOW_STATIC_NULL_VARIABLES
 const String String::empty;
 #endif
@@ -2670,6 +2763,42 @@ public:
             expect (! v2.equals (v4));
             expect (! v4.equals (v2));
         }
+
+        {
+            beginTest ("StringArena");
+
+            StringArray strings;
+            String modified, large;
+
+            {
+                StringArena arena (1024);
+
+                for (int i = 0; i < 200; ++i)
+                    strings.add (arena.createString ("item " + String (i)));
+
+                expect (arena.getNumBlocksAllocated() > 1);
+                expect (arena.createString (String()).isEmpty());
+                expect (arena.createString (StringRef()).isEmpty());
+
+                String text ("abcdef");
+                expectEquals (arena.createString (text.getCharPointer() + 1, text.getCharPointer() + 4), String ("bcd"));
+
+                modified = arena.createString ("x");
+                large = arena.createString (String::repeatedString ("z", 2000));
+            }
+
+            for (int i = 0; i < strings.size(); ++i)
+                expectEquals (strings[i], "item " + String (i));
+
+            strings.removeRange (0, 150);
+            expectEquals (strings[0], String ("item 150"));
+
+            String copy (modified);
+            modified << "yz";
+            expectEquals (modified, String ("xyz"));
+            expectEquals (copy, String ("x"));
+            expectEquals (large.length(), 2000);
+        }
     }
 };
 
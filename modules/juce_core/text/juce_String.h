@@ -1277,6 +1277,8 @@ private:
 
     template <typename Type>
     static String createHex (Type n)  { return createHex (static_cast<typename TypeHelpers::UnsignedTypeWithSize<sizeof (n)>::type> (n)); }
+
+    friend class StringArena;
 };
 
 //==============================================================================
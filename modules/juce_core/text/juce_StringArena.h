@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A StringArena hands out Strings whose storage is carved from large shared blocks,
+    rather than each one needing its own heap allocation.
+
+    This is useful when a parser or loader is creating a great many short strings in one
+    go. Each block is allocated once and then filled up, so creating a string only costs
+    a bump of a pointer, and freeing it only costs a decrement of the block's reference
+    count.
+
+    The Strings that an arena creates are normal Strings in every other respect. They can
+    be copied, modified, passed between threads, and can safely outlive the arena itself.
+    A block is freed when the arena has moved on from it and the last string that lives
+    in it has been deleted, so bear in mind that keeping just one of those strings alive
+    will also keep the rest of its block in memory.
+
+    An arena isn't thread-safe, so only one thread should be creating strings with it at
+    any one time. Strings that are too large to sit comfortably in a block are simply
+    allocated on the heap in the usual way.
+
+    @see StringPool
+*/
+class JUCE_API  StringArena
+{
+public:
+    //==============================================================================
+    /** Creates an arena which will allocate blocks of (roughly) the given size. */
+    explicit StringArena (size_t blockSizeBytes = 16384);
+
+    /** Destructor.
+        Any strings that were created by the arena will remain valid.
+    */
+    ~StringArena();
+
+    //==============================================================================
+    /** Returns a String containing a copy of the given text. */
+    String createString (StringRef text);
+
+    /** Returns a String containing a copy of the text between two pointers. */
+    String createString (String::CharPointerType start, String::CharPointerType end);
+
+    //==============================================================================
+    /** Returns the number of blocks that this arena has allocated so far. */
+    int getNumBlocksAllocated() const noexcept          { return numBlocksAllocated; }
+
+private:
+    //==============================================================================
+    struct Block;
+    enum { blockHeaderSize = 16 };
+
+    Block* currentBlock = nullptr;
+    size_t blockSize, position = 0;
+    int numBlocksAllocated = 0;
+
+    String::CharPointerType allocate (size_t numBytes);
+    void releaseCurrentBlock() noexcept;
+    static void releaseBlock (Block*) noexcept;
+
+    friend class StringHolder;
+    JUCE_DECLARE_NON_COPYABLE (StringArena)
+};
+
+} // namespace juce
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+bool UTF8TextRange::operator== (StringRef other) const noexcept
+{
+   #if JUCE_STRING_UTF_TYPE == 8
+    auto s = start.getAddress();
+    auto o = other.text.getAddress();
+
+    for (auto numBytes = getNumBytes(); numBytes > 0; --numBytes)
+        if (*o == 0 || *s++ != *o++)
+            return false;
+
+    return *o == 0;
+   #else
+    auto s = start;
+    auto o = other.text;
+
+    while (s.getAddress() < end.getAddress())
+        if (s.getAndAdvance() != o.getAndAdvance())
+            return false;
+
+    return o.isEmpty();
+   #endif
+}
+
+} // namespace juce
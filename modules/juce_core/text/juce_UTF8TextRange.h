@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A reference to a range of UTF-8 text inside a buffer that belongs to someone else.
+
+    The streaming parsers hand these out so that they don't have to copy each piece of
+    text into a String. The text isn't null-terminated, and it's only valid for as long
+    as the buffer it points into.
+
+    @see XmlPullParser, JSONStreamParser, StringRef
+*/
+struct JUCE_API  UTF8TextRange
+{
+    /** The start of the text. */
+    CharPointer_UTF8 start { nullptr };
+
+    /** The end of the text. Note that the text isn't null-terminated. */
+    CharPointer_UTF8 end { nullptr };
+
+    /** Returns the number of bytes in the text. */
+    size_t getNumBytes() const noexcept                 { return (size_t) (end.getAddress() - start.getAddress()); }
+
+    /** Returns true if the text is empty. */
+    bool isEmpty() const noexcept                       { return start.getAddress() == end.getAddress(); }
+
+    /** Creates a String containing a copy of the text. */
+    String toString() const                             { return String (start, end); }
+
+    /** Compares the text with a string. */
+    bool operator== (StringRef other) const noexcept;
+
+    /** Compares the text with a string. */
+    bool operator!= (StringRef other) const noexcept    { return ! operator== (other); }
+};
+
+} // namespace juce
@@ -58,7 +58,10 @@ namespace juce
     }
     @endcode
 
-    @see XmlElement
+    For very large documents, or if you only need a small part of one, have a look
+    at XmlPullParser, which can read a document without building the whole tree.
+
+    @see XmlElement, XmlPullParser
 */
 class JUCE_API  XmlDocument
 {
@@ -0,0 +1,927 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+XmlPullParser::XmlPullParser (const String& documentText)
+    : originalText (documentText)
+{
+    data = originalText.toRawUTF8();
+    dataSize = originalText.getNumBytesAsUTF8();
+}
+
+XmlPullParser::XmlPullParser (const void* utf8Data, size_t numBytes)
+    : data (static_cast<const char*> (utf8Data)), dataSize (numBytes)
+{
+}
+
+XmlPullParser::XmlPullParser (InputStream& input)
+{
+    initialiseStream (input);
+}
+
+XmlPullParser::XmlPullParser (const File& file)
+    : mappedFile (new MemoryMappedFile (file, MemoryMappedFile::readOnly))
+{
+    if (auto* mappedData = mappedFile->getData())
+    {
+        data = static_cast<const char*> (mappedData);
+        dataSize = mappedFile->getSize();
+    }
+    else
+    {
+        mappedFile = nullptr;
+        ownedStream = file.createInputStream();
+
+        if (ownedStream != nullptr)
+            initialiseStream (*ownedStream);
+    }
+}
+
+XmlPullParser::~XmlPullParser() {}
+
+void XmlPullParser::initialiseStream (InputStream& input)
+{
+    stream = &input;
+    streamBufferSize = 65536;
+    streamBuffer.malloc (streamBufferSize);
+    data = streamBuffer;
+}
+
+void XmlPullParser::setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+//==============================================================================
+bool XmlPullParser::readMore()
+{
+    if (stream == nullptr)
+        return false;
+
+    if (dataSize == streamBufferSize)
+    {
+        streamBufferSize *= 2;
+        streamBuffer.realloc (streamBufferSize);
+        data = streamBuffer;
+    }
+
+    auto numRead = stream->read (streamBuffer + dataSize, (int) (streamBufferSize - dataSize));
+
+    if (numRead <= 0)
+        return false;
+
+    dataSize += (size_t) numRead;
+    return true;
+}
+
+// Returns 0 at the end of the input. When reading from a stream this may need to
+// read more data, which can move the buffer, so positions are always held as indexes.
+char XmlPullParser::charAt (size_t index)
+{
+    while (index >= dataSize)
+        if (! readMore())
+            return 0;
+
+    return data[index];
+}
+
+bool XmlPullParser::matches (size_t index, const char* text, bool ignoreCase)
+{
+    for (; *text != 0; ++text, ++index)
+    {
+        auto c = charAt (index);
+
+        if (c != *text && ! (ignoreCase && CharacterFunctions::toLowerCase ((juce_wchar) (uint8) c) == (juce_wchar) *text))
+            return false;
+    }
+
+    return true;
+}
+
+bool XmlPullParser::skipPast (size_t index, const char* terminator)
+{
+    for (;; ++index)
+    {
+        auto c = charAt (index);
+
+        if (c == 0)
+            return false;
+
+        if (c == *terminator && matches (index, terminator))
+        {
+            position = index + strlen (terminator);
+            return true;
+        }
+    }
+}
+
+void XmlPullParser::skipWhitespace()
+{
+    while (CharacterFunctions::isWhitespace (charAt (position)))
+        ++position;
+}
+
+void XmlPullParser::discardConsumedInput()
+{
+    // Only shuffle the buffer along once a decent amount of it has been used, so that the
+    // cost of moving the unread part is spread over all the events that came before it
+    if (stream != nullptr && position >= streamBufferSize / 2)
+    {
+        memmove (streamBuffer, streamBuffer + position, dataSize - position);
+        dataSize -= position;
+        position = 0;
+    }
+}
+
+static inline bool isXmlNameByte (char c) noexcept
+{
+    return (uint8) c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) (uint8) c);
+}
+
+XmlPullParser::EventType XmlPullParser::fail (const String& message)
+{
+    lastError = message;
+    return currentEvent = parseError;
+}
+
+//==============================================================================
+XmlPullParser::EventType XmlPullParser::next()
+{
+    if (currentEvent == endOfDocument || currentEvent == parseError)
+        return currentEvent;
+
+    if (emptyElementPending)
+    {
+        emptyElementPending = false;
+        attributes.clearQuick();
+        --depth;
+        return currentEvent = endElement;
+    }
+
+    if (currentEvent == endElement && depth == 0)
+        return currentEvent = endOfDocument;
+
+    if (currentEvent == startOfDocument)
+    {
+        auto b0 = (uint8) charAt (0), b1 = (uint8) charAt (1);
+
+        if ((b0 == 0xff && b1 == 0xfe) || (b0 == 0xfe && b1 == 0xff))
+            return fail ("UTF-16 encoded XML is not supported");
+
+        if (b0 == 0xef && b1 == 0xbb && (uint8) charAt (2) == 0xbf)
+            position = 3;
+    }
+
+    discardConsumedInput();
+    decoded.reset();
+    attributes.clearQuick();
+
+    for (;;)
+    {
+        auto c = charAt (position);
+
+        if (c == '<')
+        {
+            auto c1 = charAt (position + 1);
+
+            if (c1 == '/')
+                return depth > 0 ? parseEndTag() : fail ("unmatched tags");
+
+            if (c1 == '?')
+            {
+                if (! skipPast (position + 2, "?>"))
+                    return fail ("malformed header");
+
+                continue;
+            }
+
+            if (c1 == '!')
+            {
+                if (matches (position, "<!--"))
+                {
+                    if (! skipPast (position + 4, "-->"))
+                        return fail ("unterminated comment");
+
+                    continue;
+                }
+
+                if (depth > 0 && matches (position, "<![CDATA["))
+                    return parseCData();
+
+                if (depth == 0 && ! hasReadDocumentElement && matches (position, "<!DOCTYPE"))
+                {
+                    if (! skipDoctype())
+                        return fail ("malformed DTD");
+
+                    continue;
+                }
+            }
+
+            return parseStartTag();
+        }
+
+        if (c == 0)
+            return fail (depth > 0 ? "unmatched tags" : "not enough input");
+
+        if (depth == 0)
+        {
+            if (! CharacterFunctions::isWhitespace (c))
+                return fail ("expected an element");
+
+            ++position;
+            continue;
+        }
+
+        if (parseText())
+            return currentEvent;
+    }
+}
+
+XmlPullParser::EventType XmlPullParser::parseStartTag()
+{
+    auto p = position + 1;
+
+    // allow for a gap after the '<'
+    while (CharacterFunctions::isWhitespace (charAt (p)))
+        ++p;
+
+    auto nameStart = p;
+
+    while (isXmlNameByte (charAt (p)))
+        ++p;
+
+    if (p == nameStart)
+        return fail ("tag name missing");
+
+    tagName = { nameStart, p, false };
+    position = p;
+
+    for (;;)
+    {
+        skipWhitespace();
+        auto c = charAt (position);
+
+        if (c == '>')
+        {
+            ++position;
+            break;
+        }
+
+        if (c == '/' && charAt (position + 1) == '>')
+        {
+            position += 2;
+            emptyElementPending = true;
+            break;
+        }
+
+        if (! isXmlNameByte (c))
+        {
+            if (c == 0)
+                return fail ("unmatched tags");
+
+            return fail ("illegal character found in " + getTagName().toString()
+                           + ": '" + String::charToString ((juce_wchar) (uint8) c) + "'");
+        }
+
+        Attribute att;
+        att.name.start = position;
+        att.name.isDecoded = false;
+
+        while (isXmlNameByte (charAt (position)))
+            ++position;
+
+        att.name.end = position;
+        skipWhitespace();
+
+        if (charAt (position) != '=')
+            return fail ("expected '=' after attribute '" + getText (att.name).toString() + "'");
+
+        ++position;
+        skipWhitespace();
+
+        auto quote = charAt (position);
+
+        if (quote != '"' && quote != '\'')
+            return fail ("expected a quoted value for attribute '" + getText (att.name).toString() + "'");
+
+        auto valueStart = ++position;
+
+        for (;;)
+        {
+            auto v = charAt (position);
+
+            if (v == quote)
+            {
+                att.value = { valueStart, position++, false };
+                break;
+            }
+
+            if (v == 0)
+                return fail ("unmatched quotes");
+
+            if (v == '&')
+            {
+                auto decodedStart = decoded.getDataSize();
+                decoded.write (data + valueStart, position - valueStart);
+
+                for (;;)
+                {
+                    v = charAt (position);
+
+                    if (v == quote)
+                        break;
+
+                    if (v == 0)
+                        return fail ("unmatched quotes");
+
+                    if (v == '&')
+                    {
+                        readEntity();
+                    }
+                    else
+                    {
+                        decoded.writeByte (v);
+                        ++position;
+                    }
+                }
+
+                att.value = { decodedStart, decoded.getDataSize(), true };
+                ++position;
+                break;
+            }
+
+            ++position;
+        }
+
+        attributes.add (att);
+    }
+
+    if (depth == 0)
+        hasReadDocumentElement = true;
+
+    ++depth;
+    return currentEvent = startElement;
+}
+
+XmlPullParser::EventType XmlPullParser::parseEndTag()
+{
+    auto p = position + 2;
+    auto nameStart = p;
+
+    while (isXmlNameByte (charAt (p)))
+        ++p;
+
+    tagName = { nameStart, p, false };
+
+    for (;; ++p)
+    {
+        auto c = charAt (p);
+
+        if (c == '>')
+            break;
+
+        if (c == 0)
+            return fail ("unmatched tags");
+    }
+
+    position = p + 1;
+    --depth;
+    return currentEvent = endElement;
+}
+
+XmlPullParser::EventType XmlPullParser::parseCData()
+{
+    auto start = position + 9;
+
+    for (auto i = start;; ++i)
+    {
+        auto c = charAt (i);
+
+        if (c == 0)
+            return fail ("unterminated CDATA section");
+
+        if (c == ']' && matches (i, "]]>"))
+        {
+            textRange = { start, i, false };
+            position = i + 3;
+            return currentEvent = text;
+        }
+    }
+}
+
+bool XmlPullParser::parseText()
+{
+    auto start = position;
+    bool hasContent = false, needsDecoding = false;
+
+    for (;; ++position)
+    {
+        auto c = charAt (position);
+
+        if (c == '<')
+        {
+            // a comment in the middle of some text gets removed, rather than splitting it
+            needsDecoding = matches (position, "<!--");
+            break;
+        }
+
+        if (c == '&' || c == '\r')
+        {
+            needsDecoding = true;
+            break;
+        }
+
+        if (c == 0)
+        {
+            fail ("unmatched tags");
+            return true;
+        }
+
+        if (! CharacterFunctions::isWhitespace (c))
+            hasContent = true;
+    }
+
+    if (needsDecoding)
+    {
+        auto decodedStart = decoded.getDataSize();
+        decoded.write (data + start, position - start);
+
+        for (;;)
+        {
+            auto c = charAt (position);
+
+            if (c == '<')
+            {
+                if (! matches (position, "<!--"))
+                    break;
+
+                if (! skipPast (position + 4, "-->"))
+                {
+                    fail ("unterminated comment");
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (c == 0)
+            {
+                fail ("unmatched tags");
+                return true;
+            }
+
+            if (c == '&')
+            {
+                auto entityStart = decoded.getDataSize();
+                readEntity();
+
+                for (auto i = entityStart; i < decoded.getDataSize() && ! hasContent; ++i)
+                    hasContent = ! CharacterFunctions::isWhitespace (static_cast<const char*> (decoded.getData())[i]);
+
+                continue;
+            }
+
+            if (c == '\r')
+            {
+                c = '\n';
+
+                if (charAt (position + 1) == '\n')
+                    ++position;
+            }
+
+            decoded.writeByte (c);
+            ++position;
+
+            if (! CharacterFunctions::isWhitespace (c))
+                hasContent = true;
+        }
+
+        textRange = { decodedStart, decoded.getDataSize(), true };
+    }
+    else
+    {
+        textRange = { start, position, false };
+    }
+
+    if (! hasContent && ignoreEmptyTextElements)
+    {
+        decoded.reset();
+        return false;
+    }
+
+    currentEvent = text;
+    return true;
+}
+
+void XmlPullParser::readEntity()
+{
+    // skip over the ampersand
+    ++position;
+
+    static const struct { const char* name; char value; } standardEntities[] =
+    {
+        { "amp;", '&' }, { "quot;", '"' }, { "apos;", '\'' }, { "lt;", '<' }, { "gt;", '>' }
+    };
+
+    for (auto& entity : standardEntities)
+    {
+        if (matches (position, entity.name, true))
+        {
+            decoded.writeByte (entity.value);
+            position += strlen (entity.name);
+            return;
+        }
+    }
+
+    if (charAt (position) == '#')
+    {
+        juce_wchar charCode = 0;
+        auto c = charAt (++position);
+
+        if (c == 'x' || c == 'X')
+        {
+            ++position;
+
+            for (int numChars = 0; (c = charAt (position)) != ';'; ++position)
+            {
+                auto hexValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) c);
+
+                if (hexValue < 0 || ++numChars > 8)
+                {
+                    lastError = "illegal escape sequence";
+                    break;
+                }
+
+                charCode = (charCode << 4) | (juce_wchar) hexValue;
+            }
+        }
+        else if (c >= '0' && c <= '9')
+        {
+            for (int numChars = 0; (c = charAt (position)) != ';'; ++position)
+            {
+                if (c < '0' || c > '9' || ++numChars > 12)
+                {
+                    lastError = "illegal escape sequence";
+                    break;
+                }
+
+                charCode = charCode * 10 + (juce_wchar) (c - '0');
+            }
+        }
+        else
+        {
+            lastError = "illegal escape sequence";
+            decoded.writeByte ('&');
+            return;
+        }
+
+        if (charAt (position) == ';')
+            ++position;
+
+        if (charCode != 0)
+            decoded.appendUTF8Char (charCode);
+
+        return;
+    }
+
+    // Entities defined in a DTD aren't supported, so these are left as they are
+    lastError = "unknown entity";
+    decoded.writeByte ('&');
+}
+
+bool XmlPullParser::skipDoctype()
+{
+    auto i = position + 9;
+
+    for (int n = 1; n > 0; ++i)
+    {
+        auto c = charAt (i);
+
+        if (c == 0)
+            return false;
+
+        if (c == '<')
+            ++n;
+        else if (c == '>')
+            --n;
+    }
+
+    position = i;
+    return true;
+}
+
+//==============================================================================
+XmlPullParser::Text XmlPullParser::getText (Range range) const noexcept
+{
+    auto base = range.isDecoded ? static_cast<const char*> (decoded.getData()) : data;
+
+    Text t;
+    t.start = CharPointer_UTF8 (base + range.start);
+    t.end   = CharPointer_UTF8 (base + range.end);
+    return t;
+}
+
+XmlPullParser::Text XmlPullParser::getTagName() const noexcept
+{
+    if (currentEvent == startElement || currentEvent == endElement)
+        return getText (tagName);
+
+    return {};
+}
+
+bool XmlPullParser::hasTagName (StringRef possibleTagName) const noexcept
+{
+    return (currentEvent == startElement || currentEvent == endElement)
+             && getText (tagName) == possibleTagName;
+}
+
+XmlPullParser::Text XmlPullParser::getAttributeName (int index) const noexcept
+{
+    if (isPositiveAndBelow (index, attributes.size()))
+        return getText (attributes.getReference (index).name);
+
+    return {};
+}
+
+XmlPullParser::Text XmlPullParser::getAttributeValue (int index) const noexcept
+{
+    if (isPositiveAndBelow (index, attributes.size()))
+        return getText (attributes.getReference (index).value);
+
+    return {};
+}
+
+bool XmlPullParser::hasAttribute (StringRef attributeName) const noexcept
+{
+    for (auto& att : attributes)
+        if (getText (att.name) == attributeName)
+            return true;
+
+    return false;
+}
+
+XmlPullParser::Text XmlPullParser::getAttributeValue (StringRef attributeName) const noexcept
+{
+    for (auto& att : attributes)
+        if (getText (att.name) == attributeName)
+            return getText (att.value);
+
+    return {};
+}
+
+XmlPullParser::Text XmlPullParser::getText() const noexcept
+{
+    if (currentEvent == text)
+        return getText (textRange);
+
+    return {};
+}
+
+//==============================================================================
+XmlElement* XmlPullParser::createElementForCurrentTag() const
+{
+    auto* e = new XmlElement (getTagName().toString());
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (e->attributes);
+
+    for (auto& att : attributes)
+        attributeAppender.append (new XmlElement::XmlAttributeNode (Identifier (getText (att.name).toString()),
+                                                                    getText (att.value).toString()));
+
+    return e;
+}
+
+XmlElement* XmlPullParser::readElement()
+{
+    // This can only be used when the parser is positioned at the start of an element!
+    jassert (currentEvent == startElement);
+
+    if (currentEvent != startElement)
+        return nullptr;
+
+    ScopedPointer<XmlElement> result (createElementForCurrentTag());
+
+    // For each open element, this holds the place where its next child should be linked in
+    Array<LinkedListPointer<XmlElement>*> insertPoints;
+    insertPoints.add (&(result->firstChildElement));
+
+    while (! insertPoints.isEmpty())
+    {
+        XmlElement* newElement = nullptr;
+
+        switch (next())
+        {
+            case startElement:  newElement = createElementForCurrentTag(); break;
+            case text:          newElement = XmlElement::createTextElement (getText().toString()); break;
+            case endElement:    insertPoints.removeLast(); continue;
+            default:            return nullptr;
+        }
+
+        auto& insertPoint = insertPoints.getReference (insertPoints.size() - 1);
+        *insertPoint = newElement;
+        insertPoint = &(newElement->nextListItem);
+
+        if (currentEvent == startElement)
+            insertPoints.add (&(newElement->firstChildElement));
+    }
+
+    return result.release();
+}
+
+bool XmlPullParser::skipElement()
+{
+    // This can only be used when the parser is positioned at the start of an element!
+    jassert (currentEvent == startElement);
+
+    if (currentEvent != startElement)
+        return false;
+
+    auto elementDepth = depth;
+
+    for (;;)
+    {
+        auto e = next();
+
+        if (e == parseError || e == endOfDocument)
+            return false;
+
+        if (e == endElement && depth < elementDepth)
+            return true;
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlPullParserTests  : public UnitTest
+{
+public:
+    XmlPullParserTests() : UnitTest ("XmlPullParser", "XML") {}
+
+    static String createRandomText (Random& r)
+    {
+        static const char* const fragments[] = { "abc", " ", "<", ">", "&", "\"", "'", "\n", "x y", "\xc3\xa9", "123" };
+
+        String s;
+
+        for (int i = r.nextInt (6); --i >= 0;)
+            s << String (CharPointer_UTF8 (fragments [r.nextInt (numElementsInArray (fragments))]));
+
+        return s;
+    }
+
+    static XmlElement* createRandomElement (Random& r, int depth)
+    {
+        auto* e = new XmlElement ("element" + String (r.nextInt (5)));
+
+        for (int i = r.nextInt (4); --i >= 0;)
+            e->setAttribute ("attribute" + String (i), createRandomText (r));
+
+        if (depth < 4)
+        {
+            for (int i = r.nextInt (5); --i >= 0;)
+            {
+                if (r.nextInt (3) == 0)
+                    e->addTextElement ("text " + createRandomText (r));
+                else
+                    e->addChildElement (createRandomElement (r, depth + 1));
+            }
+        }
+
+        return e;
+    }
+
+    void expectSameAsXmlDocument (XmlPullParser& parser, const String& text)
+    {
+        ScopedPointer<XmlElement> expected (XmlDocument::parse (text));
+        expect (parser.next() == XmlPullParser::startElement);
+
+        ScopedPointer<XmlElement> parsed (parser.readElement());
+        expect (expected != nullptr && parsed != nullptr);
+
+        if (expected != nullptr && parsed != nullptr)
+            expectEquals (parsed->createDocument ({}), expected->createDocument ({}));
+
+        expect (parser.next() == XmlPullParser::endOfDocument);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Events");
+        {
+            XmlPullParser parser ("<?xml version=\"1.0\"?>\n<!DOCTYPE foo>\n<!-- comment -->"
+                                  "<root a=\"1\" b='x &amp; y'>\n  <empty/>text&lt;1&#x41;<!-- c -->2"
+                                  "<![CDATA[<raw>]]><skip><a><b/></a></skip><last c=\"3\"></last></root> trailing");
+
+            expect (parser.next() == XmlPullParser::startElement);
+            expect (parser.hasTagName ("root") && parser.getDepth() == 1);
+            expectEquals (parser.getNumAttributes(), 2);
+            expect (parser.getAttributeName (0) == "a" && parser.getAttributeValue (0) == "1");
+            expect (parser.getAttributeValue ("b") == "x & y");
+            expect (! parser.hasAttribute ("c") && parser.getAttributeValue ("c").isEmpty());
+
+            expect (parser.next() == XmlPullParser::startElement && parser.hasTagName ("empty"));
+            expect (parser.next() == XmlPullParser::endElement && parser.hasTagName ("empty"));
+
+            expect (parser.next() == XmlPullParser::text);
+            expect (parser.getText() == "text<1A2");
+            expect (parser.next() == XmlPullParser::text);
+            expect (parser.getText() == "<raw>");
+
+            expect (parser.next() == XmlPullParser::startElement && parser.hasTagName ("skip"));
+            expect (parser.skipElement());
+            expect (parser.getEventType() == XmlPullParser::endElement && parser.getDepth() == 1);
+
+            expect (parser.next() == XmlPullParser::startElement && parser.getAttributeValue ("c") == "3");
+            expect (parser.next() == XmlPullParser::endElement && parser.hasTagName ("last"));
+            expect (parser.next() == XmlPullParser::endElement && parser.hasTagName ("root"));
+            expect (parser.next() == XmlPullParser::endOfDocument);
+            expect (parser.next() == XmlPullParser::endOfDocument);
+            expect (parser.getLastParseError().isEmpty());
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto* bad : { "", "   ", "<a>", "<a><b></a>", "<a b></a>", "<a b=\"1></a>", "<a>text", "text", "<>", "<a><!-- </a>" })
+            {
+                XmlPullParser parser (bad);
+
+                while (parser.next() != XmlPullParser::endOfDocument && parser.getEventType() != XmlPullParser::parseError)
+                {}
+
+                expect (parser.getEventType() == XmlPullParser::parseError, bad);
+                expect (parser.getLastParseError().isNotEmpty());
+            }
+        }
+
+        beginTest ("Comparison with XmlDocument");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                ScopedPointer<XmlElement> xml (createRandomElement (r, 0));
+                auto text = xml->createDocument ({}, r.nextBool());
+
+                XmlPullParser parser (text);
+                expectSameAsXmlDocument (parser, text);
+            }
+        }
+
+        beginTest ("Streams and files");
+        {
+            auto r = getRandom();
+            XmlElement root ("root");
+
+            // Make this big enough that tokens will straddle the stream's read buffer
+            for (int i = 0; i < 1000; ++i)
+                root.addChildElement (createRandomElement (r, 0));
+
+            auto text = root.createDocument ({});
+            MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+            XmlPullParser streamParser (in);
+            expectSameAsXmlDocument (streamParser, text);
+
+            TemporaryFile tempFile;
+            tempFile.getFile().replaceWithText (text);
+            XmlPullParser fileParser (tempFile.getFile());
+            expectSameAsXmlDocument (fileParser, text);
+
+            int numElements = 0;
+            XmlPullParser counter (tempFile.getFile());
+
+            while (counter.next() != XmlPullParser::endOfDocument)
+                if (counter.getEventType() == XmlPullParser::startElement && counter.getDepth() == 2)
+                    ++numElements;
+
+            expectEquals (numElements, 1000);
+        }
+    }
+};
+
+static XmlPullParserTests xmlPullParserTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A forward-only XML reader, which steps through a document one element or
+    block of text at a time, rather than building an XmlElement tree.
+
+    This is useful when you need to process documents that are too large to hold
+    in memory as XmlElement objects, or when you only need a small part of a big
+    document. The input can be a block of memory, an InputStream, or a file (which
+    will be memory-mapped), and can be arbitrarily large.
+
+    Tag names, attributes and text are returned as Text objects which refer directly
+    to the source data wherever possible, so reading a document doesn't allocate
+    any memory unless values contain entities that need expanding. A Text object is
+    only valid until the next call to next().
+
+    When you find an element that you do want to keep, you can call readElement()
+    to create an XmlElement for it and all of its children, or call skipElement()
+    to move quickly past a subtree that you're not interested in.
+
+    @code
+    XmlPullParser parser (File ("session.xml"));
+
+    while (parser.next() == XmlPullParser::startElement)
+    {
+        if (parser.hasTagName ("PLUGIN") && parser.getAttributeValue ("name") == "Reverb")
+        {
+            ScopedPointer<XmlElement> plugin (parser.readElement());
+            ...
+        }
+    }
+    @endcode
+
+    The parser expects UTF-8 input. Unlike XmlDocument it doesn't load DTDs, so
+    entities other than the standard XML ones are left unexpanded.
+
+    @see XmlDocument, XmlElement
+*/
+class JUCE_API  XmlPullParser
+{
+public:
+    //==============================================================================
+    /** Creates a parser to read the given text. */
+    explicit XmlPullParser (const String& documentText);
+
+    /** Creates a parser to read a block of UTF-8 data.
+        The data isn't copied, so must remain valid for the lifetime of the parser.
+    */
+    XmlPullParser (const void* utf8Data, size_t numBytes);
+
+    /** Creates a parser which will read from a stream.
+        The stream is read in chunks as needed, and must remain valid for the lifetime
+        of the parser.
+    */
+    explicit XmlPullParser (InputStream& input);
+
+    /** Creates a parser to read a file, which will be memory-mapped if possible. */
+    explicit XmlPullParser (const File& file);
+
+    /** Destructor. */
+    ~XmlPullParser();
+
+    //==============================================================================
+    /** The types of event that next() can return. */
+    enum EventType
+    {
+        startOfDocument,    /**< The parser hasn't read anything yet. */
+        startElement,       /**< An opening tag. The tag name and attributes are available. */
+        endElement,         /**< A closing tag. For an empty tag, this follows straight after its startElement. */
+        text,               /**< A block of text or a CDATA section inside an element. */
+        endOfDocument,      /**< The outer document element has been closed. */
+        parseError          /**< The document is malformed - getLastParseError() will describe the problem. */
+    };
+
+    /** Moves to the next event in the document, and returns its type.
+        Once the parser has reached endOfDocument or parseError, it'll stay there.
+    */
+    EventType next();
+
+    /** Returns the type of the current event. */
+    EventType getEventType() const noexcept                 { return currentEvent; }
+
+    /** Returns the number of elements which are currently open.
+        After the startElement event for the outer document element, this will be 1.
+    */
+    int getDepth() const noexcept                           { return depth; }
+
+    //==============================================================================
+    /** A reference to a piece of UTF-8 text in the document.
+        This is only valid until the next time the parser is moved on.
+    */
+    using Text = UTF8TextRange;
+
+    //==============================================================================
+    /** Returns the tag name of the current startElement or endElement event. */
+    Text getTagName() const noexcept;
+
+    /** Returns true if the current element's tag name matches the given string. */
+    bool hasTagName (StringRef possibleTagName) const noexcept;
+
+    /** Returns the number of attributes in the current startElement event. */
+    int getNumAttributes() const noexcept                   { return attributes.size(); }
+
+    /** Returns the name of one of the current element's attributes. */
+    Text getAttributeName (int attributeIndex) const noexcept;
+
+    /** Returns the value of one of the current element's attributes, with any entities expanded. */
+    Text getAttributeValue (int attributeIndex) const noexcept;
+
+    /** Returns true if the current element has an attribute with the given name. */
+    bool hasAttribute (StringRef attributeName) const noexcept;
+
+    /** Returns the value of the named attribute, or an empty Text if there isn't one. */
+    Text getAttributeValue (StringRef attributeName) const noexcept;
+
+    /** Returns the content of the current text event, with any entities expanded. */
+    Text getText() const noexcept;
+
+    //==============================================================================
+    /** Creates an XmlElement containing the current element and all of its children.
+
+        This must be called when the current event is a startElement. Afterwards, the
+        parser will be positioned at the element's endElement event.
+
+        @returns    a new XmlElement which the caller will need to delete, or null if there
+                    was a parse error
+    */
+    XmlElement* readElement();
+
+    /** Moves past all of the current element's children, leaving the parser positioned
+        at its endElement event.
+
+        This must be called when the current event is a startElement.
+        @returns false if there was a parse error
+    */
+    bool skipElement();
+
+    //==============================================================================
+    /** Returns the last parsing error, or an empty string if there hasn't been one. */
+    const String& getLastParseError() const noexcept        { return lastError; }
+
+    /** Sets whether text which contains only whitespace should be skipped.
+        As with XmlDocument, this is true by default.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+private:
+    //==============================================================================
+    struct Range
+    {
+        size_t start, end;
+        bool isDecoded;
+    };
+
+    struct Attribute
+    {
+        Range name, value;
+    };
+
+    String originalText;
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    ScopedPointer<InputStream> ownedStream;
+    InputStream* stream = nullptr;
+    HeapBlock<char> streamBuffer;
+    size_t streamBufferSize = 0;
+    const char* data = nullptr;
+    size_t dataSize = 0, position = 0;
+    MemoryOutputStream decoded;
+
+    EventType currentEvent = startOfDocument;
+    Range tagName { 0, 0, false }, textRange { 0, 0, false };
+    Array<Attribute> attributes;
+    int depth = 0;
+    bool hasReadDocumentElement = false, emptyElementPending = false, ignoreEmptyTextElements = true;
+    String lastError;
+
+    void initialiseStream (InputStream&);
+    bool readMore();
+    char charAt (size_t index);
+    bool matches (size_t index, const char* text, bool ignoreCase = false);
+    bool skipPast (size_t index, const char* terminator);
+    void skipWhitespace();
+    void discardConsumedInput();
+    Text getText (Range) const noexcept;
+    EventType fail (const String&);
+    EventType parseStartTag();
+    EventType parseEndTag();
+    EventType parseCData();
+    bool parseText();
+    void readEntity();
+    bool skipDoctype();
+    XmlElement* createElementForCurrentTag() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlPullParser)
+};
+
+} // namespace juce
@@ -196,7 +196,8 @@ GZIPDecompressorInputStream::GZIPDecompressorInputStream (InputStream* source, b
     originalSourcePos (source->getPosition()),
     currentPos (0),
     buffer ((size_t) GZIPDecompressHelper::gzipDecompBufferSize),
-    helper (new GZIPDecompressHelper (f))
+    helper (new GZIPDecompressHelper (f)),
+    memorySource (dynamic_cast<MemoryInputStream*> (source))
 {
 }
 
@@ -209,7 +210,8 @@ GZIPDecompressorInputStream::GZIPDecompressorInputStream (InputStream& source)
     originalSourcePos (source.getPosition()),
     currentPos (0),
     buffer ((size_t) GZIPDecompressHelper::gzipDecompBufferSize),
-    helper (new GZIPDecompressHelper (zlibFormat))
+    helper (new GZIPDecompressHelper (zlibFormat)),
+    memorySource (dynamic_cast<MemoryInputStream*> (&source))
 {
 }
 
@@ -246,6 +248,22 @@ int GZIPDecompressorInputStream::read (void* destBuffer, int howMany)
 
                 if (helper->needsInput())
                 {
+                    if (memorySource != nullptr)
+                    {
+                        // The source is already in memory, so let zlib read it directly
+                        // rather than copying it through our buffer first.
+                        auto sourcePos = (size_t) memorySource->getPosition();
+                        auto numAvailable = jmin (memorySource->getDataSize() - sourcePos, (size_t) 0x40000000);
+
+                        if (numAvailable > 0)
+                        {
+                            helper->setInput (const_cast<uint8*> (static_cast<const uint8*> (memorySource->getData())) + sourcePos,
+                                              numAvailable);
+                            memorySource->setPosition ((int64) (sourcePos + numAvailable));
+                            continue;
+                        }
+                    }
+
                     activeBufferSize = sourceStream->read (buffer, (int) GZIPDecompressHelper::gzipDecompBufferSize);
 
                     if (activeBufferSize > 0)
@@ -31,6 +31,9 @@ namespace juce
          can increase the performance enormously by passing it through a
          BufferedInputStream, so that it has to read larger blocks less often.
 
+    If the source is a MemoryInputStream, the compressed data is decoded directly from
+    its memory, without being copied into an intermediate buffer.
+
     @see GZIPCompressorOutputStream
 */
 class JUCE_API  GZIPDecompressorInputStream  : public InputStream
@@ -90,6 +93,7 @@ private:
     class GZIPDecompressHelper;
     friend struct ContainerDeletePolicy<GZIPDecompressHelper>;
     ScopedPointer<GZIPDecompressHelper> helper;
+    MemoryInputStream* memorySource;
 
    #if JUCE_CATCH_DEPRECATED_CODE_MISUSE
     // The arguments to this method have changed! Please pass a Format enum instead of the old dontWrap bool.
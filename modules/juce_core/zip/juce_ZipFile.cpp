@@ -128,7 +128,7 @@ struct ZipFile::ZipInputStream  : public InputStream
         else
         {
            #if JUCE_DEBUG
-            zf.streamCounter.numOpenStreams++;
+            ++zf.streamCounter.numOpenStreams;
            #endif
         }
 
@@ -148,7 +148,7 @@ struct ZipFile::ZipInputStream  : public InputStream
     {
        #if JUCE_DEBUG
         if (inputStream != nullptr && inputStream == file.inputStream)
-            file.streamCounter.numOpenStreams--;
+            --file.streamCounter.numOpenStreams;
        #endif
     }
 
@@ -233,6 +233,22 @@ ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file))
     init();
 }
 
+ZipFile::ZipFile (const File& file, bool useMemoryMapping)
+{
+    if (useMemoryMapping)
+    {
+        mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readOnly);
+
+        if (mappedFile->getData() == nullptr || mappedFile->getSize() == 0)
+            mappedFile = nullptr;
+    }
+
+    if (mappedFile == nullptr)
+        inputSource = new FileInputSource (file);
+
+    init();
+}
+
 ZipFile::ZipFile (InputSource* source)  : inputSource (source)
 {
     init();
@@ -251,7 +267,7 @@ ZipFile::OpenStreamCounter::~OpenStreamCounter()
        Streams can't be kept open after the file is deleted because they need to share the input
        stream that is managed by the ZipFile object.
     */
-    jassert (numOpenStreams == 0);
+    jassert (numOpenStreams.get() == 0);
 }
 #endif
 
@@ -294,6 +310,9 @@ InputStream* ZipFile::createStreamForEntry (const int index)
 
     if (auto* zei = entries[index])
     {
+        if (mappedFile != nullptr)
+            return createMappedStreamForEntry (*zei);
+
         stream = new ZipInputStream (*this, *zei);
 
         if (zei->isCompressed)
@@ -319,6 +338,34 @@ InputStream* ZipFile::createStreamForEntry (const ZipEntry& entry)
     return nullptr;
 }
 
+InputStream* ZipFile::createMappedStreamForEntry (const ZipEntryHolder& zei) const
+{
+    auto* data = static_cast<const char*> (mappedFile->getData());
+    auto size = (int64) mappedFile->getSize();
+
+    if (zei.streamOffset < 0 || zei.streamOffset + 30 > size
+         || ByteOrder::littleEndianInt (data + zei.streamOffset) != 0x04034b50)
+        return nullptr;
+
+    auto* header = data + zei.streamOffset;
+    auto dataStart = zei.streamOffset + 30 + ByteOrder::littleEndianShort (header + 26)
+                                           + ByteOrder::littleEndianShort (header + 28);
+
+    if (dataStart > size)
+        return nullptr;
+
+    auto* stream = new MemoryInputStream (data + dataStart,
+                                          (size_t) jmin (zei.compressedSize, size - dataStart), false);
+
+    if (! zei.isCompressed)
+        return stream;
+
+    return new BufferedInputStream (new GZIPDecompressorInputStream (stream, true,
+                                                                     GZIPDecompressorInputStream::deflateFormat,
+                                                                     zei.entry.uncompressedSize),
+                                    32768, true);
+}
+
 void ZipFile::sortEntriesByFilename()
 {
     ZipEntryHolder::FileNameComparator sorter;
@@ -336,6 +383,11 @@ void ZipFile::init()
         in = inputSource->createInputStream();
         toDelete = in;
     }
+    else if (mappedFile != nullptr)
+    {
+        in = new MemoryInputStream (mappedFile->getData(), mappedFile->getSize(), false);
+        toDelete = in;
+    }
 
     if (in != nullptr)
     {
@@ -375,6 +427,20 @@ void ZipFile::init()
     }
 }
 
+static String getPathToUncompressTo (const String& entryFilename)
+{
+   #if JUCE_WINDOWS
+    return entryFilename;
+   #else
+    return entryFilename.replaceCharacter ('\\', '/');
+   #endif
+}
+
+static bool isDirectoryEntryPath (const String& entryPath) noexcept
+{
+    return entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\');
+}
+
 Result ZipFile::uncompressTo (const File& targetDirectory,
                               const bool shouldOverwriteFiles)
 {
@@ -392,19 +458,14 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
 {
     auto* zei = entries.getUnchecked (index);
-
-   #if JUCE_WINDOWS
-    auto entryPath = zei->entry.filename;
-   #else
-    auto entryPath = zei->entry.filename.replaceCharacter ('\\', '/');
-   #endif
+    auto entryPath = getPathToUncompressTo (zei->entry.filename);
 
     if (entryPath.isEmpty())
         return Result::ok();
 
     auto targetFile = targetDirectory.getChildFile (entryPath);
 
-    if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
+    if (isDirectoryEntryPath (entryPath))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
     ScopedPointer<InputStream> in (createStreamForEntry (index));
@@ -440,6 +501,123 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool sh
     return Result::ok();
 }
 
+Result ZipFile::uncompressTo (const File& targetDirectory, const bool shouldOverwriteFiles,
+                              ThreadPool& threadPool, double* const progress)
+{
+    // Folders are created first, on this thread, so that the jobs never race to create
+    // the same ones. If several entries share a name, only the first goes to the pool, and
+    // the others are done afterwards in their original order, as they would be serially.
+    Array<int> entriesToExpand, duplicateEntries;
+    HashMap<String, int> targetPaths;
+    int numEntriesToProcess = entries.size();
+    Result folderResult (Result::ok());
+    int64 totalBytes = 0;
+
+    for (int i = 0; i < numEntriesToProcess; ++i)
+    {
+        auto entryPath = getPathToUncompressTo (entries.getUnchecked (i)->entry.filename);
+
+        if (entryPath.isEmpty())
+            continue;
+
+        auto targetFile = targetDirectory.getChildFile (entryPath);
+
+        if (isDirectoryEntryPath (entryPath))
+        {
+            folderResult = targetFile.createDirectory();
+
+            if (folderResult.failed())
+                numEntriesToProcess = i;
+
+            continue;
+        }
+
+        targetFile.getParentDirectory().createDirectory();
+
+        auto key = File::areFileNamesCaseSensitive() ? targetFile.getFullPathName()
+                                                     : targetFile.getFullPathName().toLowerCase();
+
+        if (targetPaths.contains (key))
+        {
+            duplicateEntries.add (i);
+        }
+        else
+        {
+            targetPaths.set (key, i);
+            entriesToExpand.add (i);
+        }
+
+        totalBytes += entries.getUnchecked (i)->entry.uncompressedSize;
+    }
+
+    // The jobs each hold a reference to this, because the last one to finish may
+    // still be signalling the event after this method has seen the count reach zero.
+    struct SharedState  : public ReferenceCountedObject
+    {
+        Array<Result> results;
+        Atomic<int> numJobsRemaining, hasFailed;
+        Atomic<int64> bytesDone;
+        WaitableEvent jobFinished;
+    };
+
+    ReferenceCountedObjectPtr<SharedState> state (new SharedState());
+    state->results.insertMultiple (0, Result::ok(), numEntriesToProcess);
+    state->numJobsRemaining = entriesToExpand.size();
+
+    for (auto index : entriesToExpand)
+    {
+        threadPool.addJob ([this, index, state, targetDirectory, shouldOverwriteFiles]
+        {
+            if (state->hasFailed.get() == 0)
+            {
+                auto result = uncompressEntry (index, targetDirectory, shouldOverwriteFiles);
+
+                if (result.failed())
+                {
+                    state->results.getReference (index) = result;
+                    state->hasFailed = 1;
+                }
+
+                state->bytesDone += entries.getUnchecked (index)->entry.uncompressedSize;
+            }
+
+            --state->numJobsRemaining;
+            state->jobFinished.signal();
+        });
+    }
+
+    while (state->numJobsRemaining.get() > 0)
+    {
+        state->jobFinished.wait (100);
+
+        if (progress != nullptr && totalBytes > 0)
+            *progress = (double) state->bytesDone.get() / (double) totalBytes;
+    }
+
+    for (auto index : duplicateEntries)
+    {
+        if (index >= numEntriesToProcess || state->hasFailed.get() != 0)
+            break;
+
+        auto result = uncompressEntry (index, targetDirectory, shouldOverwriteFiles);
+
+        if (result.failed())
+        {
+            state->results.getReference (index) = result;
+            state->hasFailed = 1;
+        }
+    }
+
+    if (progress != nullptr)
+        *progress = 1.0;
+
+    for (auto& r : state->results)
+        if (r.failed())
+            return r;
+
+    return folderResult;
+}
+
 
 //==============================================================================
 struct ZipFile::Builder::Item
@@ -451,22 +629,38 @@ struct ZipFile::Builder::Item
 
     bool writeData (OutputStream& target, const int64 overallStartPosition)
     {
-        MemoryOutputStream compressedData ((size_t) file.getSize());
+        return compressData() && writeCompressedData (target, overallStartPosition);
+    }
+
+    // This is the part of writeData() that doesn't touch the target stream, so it can be
+    // run on other threads.
+    bool compressData()
+    {
+        compressedData.ensureSize ((size_t) file.getSize());
 
-        if (compressionLevel > 0)
-        {
-            GZIPCompressorOutputStream compressor (&compressedData, compressionLevel, false,
-                                                   GZIPCompressorOutputStream::windowBitsRaw);
-            if (! writeSource (compressor))
-                return false;
-        }
-        else
         {
-            if (! writeSource (compressedData))
-                return false;
+            MemoryOutputStream out (compressedData, false);
+
+            if (compressionLevel > 0)
+            {
+                GZIPCompressorOutputStream compressor (&out, compressionLevel, false,
+                                                       GZIPCompressorOutputStream::windowBitsRaw);
+                if (! writeSource (compressor))
+                    return false;
+            }
+            else
+            {
+                if (! writeSource (out))
+                    return false;
+            }
         }
 
-        compressedSize = (int64) compressedData.getDataSize();
+        compressedSize = (int64) compressedData.getSize();
+        return true;
+    }
+
+    bool writeCompressedData (OutputStream& target, const int64 overallStartPosition)
+    {
         headerStart = target.getPosition() - overallStartPosition;
 
         target.writeInt (0x04034b50);
@@ -474,6 +668,7 @@ struct ZipFile::Builder::Item
         target << storedPathname
                << compressedData;
 
+        compressedData.reset();
         return true;
     }
 
@@ -497,6 +692,7 @@ private:
     ScopedPointer<InputStream> stream;
     String storedPathname;
     Time fileTime;
+    MemoryBlock compressedData;
     int64 compressedSize = 0, uncompressedSize = 0, headerStart = 0;
     int compressionLevel = 0;
     unsigned long checksum = 0;
@@ -585,6 +781,74 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
             return false;
     }
 
+    if (! writeDirectory (target, fileStart))
+        return false;
+
+    if (progress != nullptr)
+        *progress = 1.0;
+
+    return true;
+}
+
+struct ZipFile::Builder::CompressionJob  : public ThreadPoolJob
+{
+    CompressionJob (Item& i)  : ThreadPoolJob ("Zip compression"), item (i) {}
+
+    JobStatus runJob() override
+    {
+        succeeded = item.compressData();
+        return jobHasFinished;
+    }
+
+    Item& item;
+    bool succeeded = false;
+};
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, ThreadPool& threadPool) const
+{
+    auto fileStart = target.getPosition();
+    auto maxItemsInMemory = jmax (2, threadPool.getNumThreads() * 2);
+    OwnedArray<CompressionJob> jobs;
+    bool ok = true;
+
+    for (int i = 0; i < items.size(); ++i)
+    {
+        while (jobs.size() < items.size() && jobs.size() < i + maxItemsInMemory)
+        {
+            auto* job = jobs.add (new CompressionJob (*items.getUnchecked (jobs.size())));
+            threadPool.addJob (job, false);
+        }
+
+        if (progress != nullptr)
+            *progress = (i + 0.5) / items.size();
+
+        auto* job = jobs.getUnchecked (i);
+        threadPool.waitForJobToFinish (job, -1);
+
+        if (! (job->succeeded && items.getUnchecked (i)->writeCompressedData (target, fileStart)))
+        {
+            ok = false;
+            break;
+        }
+
+        jobs.set (i, nullptr);
+    }
+
+    for (auto* job : jobs)
+        if (job != nullptr)
+            threadPool.removeJob (job, true, -1);
+
+    if (! (ok && writeDirectory (target, fileStart)))
+        return false;
+
+    if (progress != nullptr)
+        *progress = 1.0;
+
+    return true;
+}
+
+bool ZipFile::Builder::writeDirectory (OutputStream& target, int64 fileStart) const
+{
     auto directoryStart = target.getPosition();
 
     for (auto* item : items)
@@ -602,10 +866,136 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
     target.writeInt ((int) (directoryStart - fileStart));
     target.writeShort (0);
 
-    if (progress != nullptr)
-        *progress = 1.0;
-
     return true;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ZipFileTests  : public UnitTest
+{
+    ZipFileTests()   : UnitTest ("ZipFile", "Compression") {}
+
+    static void addEntries (ZipFile::Builder& builder, const Array<MemoryBlock>& contents)
+    {
+        for (int i = 0; i < contents.size(); ++i)
+            builder.addEntry (new MemoryInputStream (contents.getReference (i), false), i % 10,
+                              "folder" + String (i % 3) + "/item" + String (i) + ".bin", Time (2017, 5, 3, 12, 30));
+    }
+
+    void runTest() override
+    {
+        Random rng = getRandom();
+        Array<MemoryBlock> contents;
+
+        for (int i = 0; i < 40; ++i)
+        {
+            MemoryBlock data ((size_t) rng.nextInt (20000));
+
+            for (int k = 0; k < (int) data.getSize(); ++k)
+                data[k] = (char) (i % 2 == 0 ? rng.nextInt (255) : 'a' + rng.nextInt (4));
+
+            contents.add (data);
+        }
+
+        ThreadPool pool (3);
+
+        beginTest ("Builder");
+
+        MemoryOutputStream serialZip, parallelZip;
+
+        {
+            ZipFile::Builder builder;
+            addEntries (builder, contents);
+            expect (builder.writeToStream (serialZip, nullptr));
+        }
+
+        {
+            ZipFile::Builder builder;
+            addEntries (builder, contents);
+            double progress = 0;
+            expect (builder.writeToStream (parallelZip, &progress, pool));
+            expectEquals (progress, 1.0);
+        }
+
+        expect (serialZip.getMemoryBlock() == parallelZip.getMemoryBlock());
+
+        MemoryInputStream zipStream (parallelZip.getData(), parallelZip.getDataSize(), false);
+        ZipFile zip (zipStream);
+        expectEquals (zip.getNumEntries(), contents.size());
+
+        for (int i = 0; i < zip.getNumEntries(); ++i)
+        {
+            ScopedPointer<InputStream> in (zip.createStreamForEntry (i));
+            MemoryBlock data;
+
+            if (in != nullptr)
+                in->readIntoMemoryBlock (data);
+
+            expect (data == contents.getReference (i));
+        }
+
+        beginTest ("Parallel uncompressing");
+
+        auto folder = File::createTempFile ("zip");
+        File zipFile (folder.getSiblingFile (folder.getFileName() + ".zip"));
+        zipFile.replaceWithData (parallelZip.getData(), parallelZip.getDataSize());
+
+        {
+            ZipFile fileZip (zipFile);
+            double progress = 0;
+            expect (fileZip.uncompressTo (folder, true, pool, &progress).wasOk());
+            expectEquals (progress, 1.0);
+        }
+
+        for (int i = 0; i < contents.size(); ++i)
+        {
+            MemoryBlock data;
+            folder.getChildFile ("folder" + String (i % 3)).getChildFile ("item" + String (i) + ".bin").loadFileAsData (data);
+            expect (data == contents.getReference (i));
+        }
+
+        expect (zip.uncompressTo (folder, false, pool).wasOk());
+
+        beginTest ("Memory-mapped reading");
+
+        {
+            ZipFile mappedZip (zipFile, true);
+            expectEquals (mappedZip.getNumEntries(), contents.size());
+
+            Atomic<int> numMatches;
+            WaitableEvent finished;
+
+            for (int i = 0; i < mappedZip.getNumEntries(); ++i)
+            {
+                pool.addJob ([&mappedZip, &contents, &numMatches, &finished, i]
+                {
+                    ScopedPointer<InputStream> in (mappedZip.createStreamForEntry (i));
+                    MemoryBlock data;
+
+                    if (in != nullptr)
+                        in->readIntoMemoryBlock (data);
+
+                    if (data == contents.getReference (i))
+                        ++numMatches;
+
+                    finished.signal();
+                });
+            }
+
+            while (pool.getNumJobs() > 0)
+                finished.wait (10);
+
+            expectEquals (numMatches.get(), contents.size());
+        }
+
+        folder.deleteRecursively();
+        zipFile.deleteFile();
+    }
+};
+
+static ZipFileTests zipFileTests;
+
+#endif
+
 } // namespace juce
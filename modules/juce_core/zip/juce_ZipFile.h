@@ -36,6 +36,19 @@ public:
     /** Creates a ZipFile to read a specific file. */
     explicit ZipFile (const File& file);
 
+    /** Creates a ZipFile to read a specific file, optionally by memory-mapping it.
+
+        When the file is memory-mapped, the streams returned by createStreamForEntry() read
+        straight from the mapped data: uncompressed entries are returned as MemoryInputStreams
+        that point into it, and compressed ones are inflated directly from it. This avoids
+        any seeking or copying through a file stream, and any locking, so it's a good choice
+        when a lot of entries need to be read, or when they're read from many threads at once.
+
+        The file must not be modified while the ZipFile exists. If the file can't be mapped,
+        this falls back to reading it in the normal way.
+    */
+    ZipFile (const File& file, bool useMemoryMapping);
+
     //==============================================================================
     /** Creates a ZipFile for a given stream.
 
@@ -168,6 +181,30 @@ public:
                             const File& targetDirectory,
                             bool shouldOverwriteFiles = true);
 
+    /** Uncompresses all of the files in the zip file, using a ThreadPool to expand
+        several entries at once.
+
+        This does the same job as the other uncompressTo() method, but the entries are
+        decompressed and written by the pool's threads while the calling thread waits for
+        them to finish. Any folders are created up-front by the calling thread.
+
+        The entries can only be read concurrently if the ZipFile was created from a File or
+        an InputSource. If it shares a single InputStream, the reads will be serialised, but
+        the decompression can still happen in parallel.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param threadPool           the pool whose threads should do the work
+        @param progress             if this is non-null, the calling thread will update it with an
+                                    approximate progress status between 0 and 1.0
+        @returns success if the file is successfully unzipped, or if more than one entry
+                 fails, the error for the one that comes first in the archive
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         bool shouldOverwriteFiles,
+                         ThreadPool& threadPool,
+                         double* progress = nullptr);
+
 
     //==============================================================================
     /** Used to create a new zip file.
@@ -216,12 +253,27 @@ public:
         */
         bool writeToStream (OutputStream& target, double* progress) const;
 
+        /** Generates the zip file, using a ThreadPool to compress several items at once.
+
+            The items are compressed into memory by the pool's threads, and then written to
+            the stream in order by the calling thread, so the result is identical to that of
+            the other writeToStream() method. To limit the amount of memory needed, only a
+            few more items than the pool has threads will be held in memory at any time.
+
+            If the progress parameter is non-null, it will be updated with an approximate
+            progress status between 0 and 1.0
+        */
+        bool writeToStream (OutputStream& target, double* progress, ThreadPool& threadPool) const;
+
         //==============================================================================
     private:
         struct Item;
+        struct CompressionJob;
         friend struct ContainerDeletePolicy<Item>;
         OwnedArray<Item> items;
 
+        bool writeDirectory (OutputStream&, int64 fileStart) const;
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Builder)
     };
 
@@ -235,6 +287,7 @@ private:
     InputStream* inputStream = nullptr;
     ScopedPointer<InputStream> streamToDelete;
     ScopedPointer<InputSource> inputSource;
+    ScopedPointer<MemoryMappedFile> mappedFile;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
@@ -242,13 +295,14 @@ private:
         OpenStreamCounter() {}
         ~OpenStreamCounter();
 
-        int numOpenStreams = 0;
+        Atomic<int> numOpenStreams;
     };
 
     OpenStreamCounter streamCounter;
    #endif
 
     void init();
+    InputStream* createMappedStreamForEntry (const ZipEntryHolder&) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
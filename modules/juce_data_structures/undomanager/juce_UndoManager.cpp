@@ -67,6 +67,313 @@ struct UndoManager::ActionSet
     Time time;
 };
 
+//==============================================================================
+/*  In compact history mode, each run of ValueTree actions in a transaction is stored as a
+    Block. While the block is still being added to, its records live in the shared log; when
+    it's finished, they're copied into a page of memory that's shared with the blocks around
+    it, and later they may be moved out to the temporary file. Blocks count towards the
+    UndoManager's size limit wherever they're kept, so the limit still decides how much
+    history there is.
+*/
+struct UndoManager::CompactHistory
+{
+    CompactHistory (int64 maxBytes) noexcept  : maxBytesInMemory (maxBytes) {}
+
+    ~CompactHistory()
+    {
+        // all the blocks should have been deleted before this
+        jassert (bytesInMemory == 0 && bytesOnDisk == 0);
+    }
+
+    enum { pageSize = 65536 };
+
+    struct Page
+    {
+        Page() : arena (pageSize) {}
+
+        MemoryArena arena;
+        int numBlocks = 0;
+    };
+
+    struct Block  : public UndoableAction
+    {
+        Block (CompactHistory& h) noexcept  : owner (h) {}
+        ~Block()                        { owner.blockDeleted (*this); }
+
+        bool perform() override         { return owner.apply (*this, false); }
+        bool undo() override            { return owner.apply (*this, true); }
+        int getSizeInUnits() override   { return (int) (sizeof (*this) + size); }
+
+        bool isOnDisk() const noexcept  { return filePosition >= 0; }
+
+        CompactHistory& owner;
+        Array<ValueTree> roots;
+        const void* data = nullptr;
+        size_t size = 0;
+        Page* page = nullptr;
+        int64 filePosition = -1;
+
+        // neighbours in the list of blocks on disk, which is kept in the order they were written
+        Block* previousOnDisk = nullptr;
+        Block* nextOnDisk = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE (Block)
+    };
+
+    bool store (ActionSet& set, const UndoableAction& action, int& totalUnitsStored)
+    {
+        if (! ValueTree::CompactUndoLog::canStore (action))
+            return false;
+
+        auto* block = openBlock;
+
+        if (block != nullptr && set.actions.getLast() == block)
+        {
+            totalUnitsStored -= block->getSizeInUnits();
+        }
+        else
+        {
+            finishOpenBlock();
+            block = openBlock = new Block (*this);
+            set.actions.add (block);
+        }
+
+        log.append (action, block->roots);
+
+        bytesInMemory += (int64) log.getDataSize() - (int64) block->size;
+        block->size = log.getDataSize();
+        totalUnitsStored += block->getSizeInUnits();
+        return true;
+    }
+
+    void finishOpenBlock()
+    {
+        if (auto* b = openBlock)
+        {
+            openBlock = nullptr;
+            b->roots.minimiseStorageOverheads();
+
+            if (b->size > 0)
+            {
+                auto* page = pages.getLast();
+
+                if (page == nullptr || page->arena.getNumBytesUsed() + b->size > (size_t) pageSize)
+                    page = pages.add (new Page());
+
+                auto* dest = page->arena.allocate (b->size, 1);
+                memcpy (dest, log.getData(), b->size);
+                b->data = dest;
+                b->page = page;
+                ++(page->numBlocks);
+            }
+
+            log.reset();
+        }
+    }
+
+    bool apply (const Block& b, bool isUndo)
+    {
+        if (&b == openBlock)
+            return ValueTree::CompactUndoLog::apply (log.getData(), log.getDataSize(), isUndo, b.roots);
+
+        if (! b.isOnDisk())
+            return ValueTree::CompactUndoLog::apply (b.data, b.size, isUndo, b.roots);
+
+        MemoryBlock data;
+        return readFromDisk (b.filePosition, b.size, data)
+                && ValueTree::CompactUndoLog::apply (data.getData(), data.getSize(), isUndo, b.roots);
+    }
+
+    void blockDeleted (Block& b)
+    {
+        if (&b == openBlock)
+        {
+            openBlock = nullptr;
+            log.reset();
+            bytesInMemory -= (int64) b.size;
+        }
+        else if (b.isOnDisk())
+        {
+            (b.previousOnDisk != nullptr ? b.previousOnDisk->nextOnDisk : oldestOnDisk) = b.nextOnDisk;
+            (b.nextOnDisk != nullptr ? b.nextOnDisk->previousOnDisk : newestOnDisk) = b.previousOnDisk;
+            releaseDiskSpace (b.size);
+        }
+        else
+        {
+            bytesInMemory -= (int64) b.size;
+            releasePageSpace (b);
+        }
+    }
+
+    void releasePageSpace (Block& b)
+    {
+        if (auto* page = b.page)
+        {
+            if (--(page->numBlocks) == 0)
+            {
+                if (page == pages.getLast())
+                    page->arena.reset();
+                else
+                    pages.removeObject (page);
+            }
+
+            b.page = nullptr;
+            b.data = nullptr;
+        }
+    }
+
+    //==============================================================================
+    void moveOldBlocksToDisk (const OwnedArray<ActionSet>& sets)
+    {
+        if (maxBytesInMemory <= 0 || bytesInMemory <= maxBytesInMemory)
+            return;
+
+        // Going down to half the limit means that the history only needs to be scanned
+        // once for every maxBytesInMemory / 2 bytes of new changes.
+        auto targetSize = maxBytesInMemory / 2;
+
+        for (auto* set : sets)
+        {
+            for (auto* action : set->actions)
+            {
+                if (bytesInMemory <= targetSize)
+                    return;
+
+                auto* b = dynamic_cast<Block*> (action);
+
+                if (b == nullptr || b == openBlock || b->isOnDisk() || b->size == 0)
+                    continue;
+
+                int64 position;
+
+                if (! writeToDisk (b->data, b->size, position))
+                    return;
+
+                bytesInMemory -= (int64) b->size;
+                bytesOnDisk += (int64) b->size;
+                releasePageSpace (*b);
+                b->filePosition = position;
+
+                b->previousOnDisk = newestOnDisk;
+                (newestOnDisk != nullptr ? newestOnDisk->nextOnDisk : oldestOnDisk) = b;
+                newestOnDisk = b;
+            }
+        }
+    }
+
+    /*  Deleted blocks leave holes in the file, so when more than half of it is unused, the
+        blocks that are left get copied into a new one. The oldest transactions are the
+        ones that get dropped, so this is usually a matter of chopping off the start.
+    */
+    void compactDiskFileIfNeeded()
+    {
+        if (stream == nullptr)
+            return;
+
+        auto fileSize = stream->getPosition();
+
+        if (fileSize < (int64) pageSize || bytesOnDisk > fileSize / 2)
+            return;
+
+        ScopedPointer<TemporaryFile> newTempFile (new TemporaryFile (".undo"));
+        ScopedPointer<FileOutputStream> newStream (new FileOutputStream (newTempFile->getFile()));
+
+        if (newStream->failedToOpen())
+            return;
+
+        Array<int64> newPositions;
+
+        {
+            stream->flush();
+            FileInputStream in (tempFile->getFile());
+            MemoryBlock data;
+
+            if (in.failedToOpen())
+                return;
+
+            for (auto* b = oldestOnDisk; b != nullptr; b = b->nextOnDisk)
+            {
+                newPositions.add (newStream->getPosition());
+                data.reset();
+
+                // if anything goes wrong, just carry on using the old file
+                if (! (in.setPosition (b->filePosition)
+                        && in.readIntoMemoryBlock (data, (ssize_t) b->size) == b->size
+                        && newStream->write (data.getData(), data.getSize())))
+                    return;
+            }
+        }
+
+        int i = 0;
+
+        for (auto* b = oldestOnDisk; b != nullptr; b = b->nextOnDisk)
+            b->filePosition = newPositions.getUnchecked (i++);
+
+        stream = newStream;
+        tempFile = newTempFile;
+    }
+
+    bool writeToDisk (const void* data, size_t size, int64& position)
+    {
+        if (stream == nullptr)
+        {
+            tempFile = new TemporaryFile (".undo");
+            stream = new FileOutputStream (tempFile->getFile());
+
+            if (stream->failedToOpen())
+            {
+                stream = nullptr;
+                tempFile = nullptr;
+                return false;
+            }
+        }
+
+        auto start = stream->getPosition();
+
+        if (! stream->write (data, size))
+            return false;
+
+        position = start;
+        return true;
+    }
+
+    bool readFromDisk (int64 position, size_t size, MemoryBlock& data)
+    {
+        if (stream == nullptr)
+            return false;
+
+        stream->flush();
+        FileInputStream in (tempFile->getFile());
+
+        return in.openedOk()
+                && in.setPosition (position)
+                && in.readIntoMemoryBlock (data, (ssize_t) size) == size;
+    }
+
+    void releaseDiskSpace (size_t size)
+    {
+        bytesOnDisk -= (int64) size;
+
+        if (bytesOnDisk == 0)
+        {
+            stream = nullptr;
+            tempFile = nullptr;
+        }
+    }
+
+    //==============================================================================
+    ValueTree::CompactUndoLog log;
+    Block* openBlock = nullptr;
+    Block* oldestOnDisk = nullptr;
+    Block* newestOnDisk = nullptr;
+    OwnedArray<Page> pages;
+    int64 maxBytesInMemory, bytesInMemory = 0, bytesOnDisk = 0;
+    ScopedPointer<TemporaryFile> tempFile;
+    ScopedPointer<FileOutputStream> stream;
+
+    JUCE_DECLARE_NON_COPYABLE (CompactHistory)
+};
+
 //==============================================================================
 UndoManager::UndoManager (const int maxNumberOfUnitsToKeep,
                           const int minimumTransactions)
@@ -81,6 +388,8 @@ UndoManager::UndoManager (const int maxNumberOfUnitsToKeep,
 
 UndoManager::~UndoManager()
 {
+    stashedFutureTransactions.clear();
+    transactions.clear();
 }
 
 //==============================================================================
@@ -154,12 +463,27 @@ bool UndoManager::perform (UndoableAction* const newAction)
                 ++nextIndex;
             }
 
-            totalUnitsStored += action->getSizeInUnits();
-            actionSet->actions.add (action.release());
+            if (compactHistory != nullptr && compactHistory->store (*actionSet, *action, totalUnitsStored))
+            {
+                action = nullptr;
+            }
+            else
+            {
+                totalUnitsStored += action->getSizeInUnits();
+                actionSet->actions.add (action.release());
+            }
+
             newTransaction = false;
 
             moveFutureTransactionsToStash();
             dropOldTransactionsIfTooLarge();
+
+            if (compactHistory != nullptr)
+            {
+                compactHistory->moveOldBlocksToDisk (transactions);
+                compactHistory->compactDiskFileIfNeeded();
+            }
+
             sendChangeMessage();
             return true;
         }
@@ -256,12 +580,15 @@ bool UndoManager::undo()
     if (const ActionSet* const s = getCurrentSet())
     {
         const ScopedValueSetter<bool> setter (reentrancyCheck, true);
+        auto startTime = Time::getMillisecondCounterHiRes();
 
         if (s->undo())
             --nextIndex;
         else
             clearUndoHistory();
 
+        lastUndoMilliseconds = Time::getMillisecondCounterHiRes() - startTime;
+
         beginNewTransaction();
         sendChangeMessage();
         return true;
@@ -275,12 +602,15 @@ bool UndoManager::redo()
     if (const ActionSet* const s = getNextSet())
     {
         const ScopedValueSetter<bool> setter (reentrancyCheck, true);
+        auto startTime = Time::getMillisecondCounterHiRes();
 
         if (s->perform())
             ++nextIndex;
         else
             clearUndoHistory();
 
+        lastRedoMilliseconds = Time::getMillisecondCounterHiRes() - startTime;
+
         beginNewTransaction();
         sendChangeMessage();
         return true;
@@ -349,4 +679,206 @@ int UndoManager::getNumActionsInCurrentTransaction() const
     return 0;
 }
 
+//==============================================================================
+void UndoManager::setCompactHistoryMode (bool shouldStoreCompactly, int64 maxBytesInMemory)
+{
+    if (shouldStoreCompactly != (compactHistory != nullptr))
+    {
+        stashedFutureTransactions.clear();
+        clearUndoHistory();
+        compactHistory = shouldStoreCompactly ? new CompactHistory (maxBytesInMemory) : nullptr;
+    }
+    else if (compactHistory != nullptr)
+    {
+        compactHistory->maxBytesInMemory = maxBytesInMemory;
+        compactHistory->moveOldBlocksToDisk (transactions);
+    }
+}
+
+UndoManager::Statistics UndoManager::getStatistics() const
+{
+    Statistics stats;
+    stats.numTransactions = transactions.size();
+    stats.lastUndoMilliseconds = lastUndoMilliseconds;
+    stats.lastRedoMilliseconds = lastRedoMilliseconds;
+
+    if (compactHistory != nullptr)
+    {
+        stats.numCompactBytesInMemory = compactHistory->bytesInMemory;
+        stats.numCompactBytesOnDisk = compactHistory->bytesOnDisk;
+        stats.temporaryFileSize = compactHistory->stream != nullptr ? compactHistory->stream->getPosition() : 0;
+        stats.numMergedPropertyChanges = compactHistory->log.numMergedChanges;
+    }
+
+    return stats;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class UndoManagerTests  : public UnitTest
+{
+public:
+    UndoManagerTests() : UnitTest ("UndoManager", "Undo") {}
+
+    static void makeChanges (ValueTree& root, Random r, UndoManager& um)
+    {
+        for (int i = 0; i < 40; ++i)
+        {
+            if (r.nextInt (4) == 0)
+                um.beginNewTransaction();
+
+            auto parent = root;
+
+            while (parent.getNumChildren() > 0 && r.nextBool())
+                parent = parent.getChild (r.nextInt (parent.getNumChildren()));
+
+            const Identifier name (String::charToString ((juce_wchar) ('a' + r.nextInt (3))));
+
+            switch (r.nextInt (6))
+            {
+                case 0:   parent.addChild (ValueTree ("node").setProperty ("x", i, nullptr), r.nextInt (parent.getNumChildren() + 1), &um); break;
+                case 1:   parent.removeChild (r.nextInt (jmax (1, parent.getNumChildren())), &um); break;
+                case 2:   if (parent.getNumChildren() > 1) parent.moveChild (0, parent.getNumChildren() - 1, &um); break;
+                case 3:   parent.removeProperty (name, &um); break;
+                default:  parent.setProperty (name, r.nextInt (4), &um); break;
+            }
+        }
+    }
+
+    void expectHistoryMatches (UndoManager& um, ValueTree& tree, const Array<ValueTree>& states)
+    {
+        auto numTransactions = um.getStatistics().numTransactions;
+
+        // a failed undo would clear the history rather than getting all the way back
+        for (int i = 0; i < numTransactions; ++i)
+        {
+            expect (tree.isEquivalentTo (states[states.size() - 1 - i]));
+            expect (um.canUndo() && um.undo());
+        }
+
+        expect (tree.isEquivalentTo (states[states.size() - 1 - numTransactions]));
+
+        while (um.canRedo())
+            expect (um.redo());
+
+        expect (tree.isEquivalentTo (states.getLast()));
+    }
+
+    void runTest() override
+    {
+        beginTest ("Compact history");
+
+        for (int run = 0; run < 20; ++run)
+        {
+            ValueTree normalTree ("root"), compactTree ("root");
+            UndoManager normalUndo, compactUndo (1000000, 1000);
+            compactUndo.setCompactHistoryMode (true, 64);
+
+            makeChanges (normalTree, Random (run), normalUndo);
+            makeChanges (compactTree, Random (run), compactUndo);
+            expect (compactTree.isEquivalentTo (normalTree));
+
+            while (normalUndo.canUndo())
+            {
+                expect (compactUndo.undo());
+                normalUndo.undo();
+                expect (compactTree.isEquivalentTo (normalTree));
+            }
+
+            expect (! compactUndo.canUndo());
+
+            while (normalUndo.canRedo())
+            {
+                expect (compactUndo.redo());
+                normalUndo.redo();
+                expect (compactTree.isEquivalentTo (normalTree));
+            }
+        }
+
+        {
+            ValueTree tree ("root");
+            tree.setProperty ("x", -1000, nullptr).setProperty ("y", -1000, nullptr);
+            UndoManager um (1000000, 1000);
+            um.setCompactHistoryMode (true, 100);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                um.beginNewTransaction();
+
+                for (int j = 0; j < 100; ++j)
+                {
+                    tree.setProperty ("x", i * 100 + j, &um);
+                    tree.setProperty ("y", -j, &um);
+                }
+            }
+
+            auto stats = um.getStatistics();
+            expectEquals (stats.numTransactions, 20);
+            expectEquals (stats.numMergedPropertyChanges, 20 * 198);
+            expect (stats.numCompactBytesOnDisk > 0);
+            expect (stats.numCompactBytesInMemory <= 100);
+
+            while (um.canUndo())
+                expect (um.undo());
+
+            expect ((int) tree["x"] == -1000 && (int) tree["y"] == -1000);
+
+            while (um.canRedo())
+                expect (um.redo());
+
+            expect ((int) tree["x"] == 1999 && (int) tree["y"] == -99);
+
+            um.clearUndoHistory();
+            stats = um.getStatistics();
+            expect (stats.numCompactBytesInMemory == 0 && stats.numCompactBytesOnDisk == 0);
+            expectEquals (stats.temporaryFileSize, (int64) 0);
+        }
+
+        beginTest ("Compact history on disk is limited and compacted");
+        {
+            ValueTree tree ("root");
+            UndoManager um (20000, 1);
+            um.setCompactHistoryMode (true, 1000);
+            Array<ValueTree> states;
+            int64 lastFileSize = 0;
+            int numCompactions = 0;
+
+            for (int i = 0; i < 300; ++i)
+            {
+                um.beginNewTransaction();
+
+                for (int j = 0; j < 20; ++j)
+                    tree.setProperty (Identifier ("p" + String (j)), String::repeatedString ("x", 20) + String (i), &um);
+
+                states.add (tree.createCopy());
+
+                auto stats = um.getStatistics();
+                expect (stats.temporaryFileSize < 65536 || stats.temporaryFileSize <= 2 * stats.numCompactBytesOnDisk);
+                expect (stats.numCompactBytesInMemory + stats.numCompactBytesOnDisk <= 20000);
+                expect (um.getNumberOfUnitsTakenUpByStoredCommands() <= 20000);
+
+                // check that the blocks can still be read straight after they've been moved
+                if (stats.temporaryFileSize < lastFileSize)
+                {
+                    ++numCompactions;
+                    expect (stats.numCompactBytesOnDisk > 0);
+                    expectHistoryMatches (um, tree, states);
+                }
+
+                lastFileSize = stats.temporaryFileSize;
+            }
+
+            // without compacting, the file would have grown to hold every transaction
+            expect (numCompactions > 0);
+            expect (um.getStatistics().numTransactions < 100);
+            expectHistoryMatches (um, tree, states);
+        }
+    }
+};
+
+static UndoManagerTests undoManagerTests;
+
+#endif
+
 } // namespace juce
@@ -225,15 +225,64 @@ public:
     */
     bool redo();
 
+    //==============================================================================
+    /** Makes the UndoManager store ValueTree changes in a compact, serialised form.
+
+        When this is enabled, the actions that ValueTree creates aren't kept as separate
+        objects: all the ValueTree changes made in a transaction are encoded into a single
+        block of memory, and repeated changes to the same property within a transaction
+        are merged into one. Other kinds of UndoableAction are stored as normal. Note that
+        getActionsInCurrentTransaction() will return these blocks rather than the original
+        actions.
+
+        If maxBytesInMemory is greater than zero, then whenever the blocks held in memory
+        add up to more than this, the ones belonging to older transactions are moved out to
+        a temporary file, and are read back from there if they're needed by undo() or redo().
+        Blocks that are on disk still count towards the maxNumberOfUnitsToKeep limit, and the
+        file is rewritten from time to time so that it doesn't keep growing as the oldest
+        transactions are dropped.
+
+        Because the encoded changes refer to the trees by position rather than keeping the
+        objects themselves, you should only use this mode if every change to these trees goes
+        through this UndoManager. And when an undo puts back a child that had been removed,
+        it'll be a new copy of the original object, so any ValueTree that still refers to the
+        old one won't be attached to the restored tree.
+
+        Turning the mode on or off clears the undo history.
+        @see getStatistics
+    */
+    void setCompactHistoryMode (bool shouldStoreCompactly, int64 maxBytesInMemory = 0);
+
+    /** Some figures describing the memory used by the undo history, and how long undo and redo take.
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        int numTransactions = 0;
+        int64 numCompactBytesInMemory = 0;      /**< The size of the compact blocks that are held in memory. */
+        int64 numCompactBytesOnDisk = 0;        /**< The size of the compact blocks that have been moved out to disk. */
+        int64 temporaryFileSize = 0;            /**< The size of the temporary file, which includes any gaps left by deleted blocks. */
+        int numMergedPropertyChanges = 0;       /**< How many property changes were absorbed by merging them with an earlier one. */
+        double lastUndoMilliseconds = 0;        /**< The time taken by the most recent call to undo(). */
+        double lastRedoMilliseconds = 0;        /**< The time taken by the most recent call to redo(). */
+    };
+
+    /** Returns the current statistics.
+        @see setCompactHistoryMode
+    */
+    Statistics getStatistics() const;
 
 private:
     //==============================================================================
     struct ActionSet;
+    struct CompactHistory;
     friend struct ContainerDeletePolicy<ActionSet>;
+    ScopedPointer<CompactHistory> compactHistory;
     OwnedArray<ActionSet> transactions, stashedFutureTransactions;
     String newTransactionName;
     int totalUnitsStored, maxNumUnitsToKeep, minimumTransactionsToKeep, nextIndex;
     bool newTransaction, reentrancyCheck;
+    double lastUndoMilliseconds = 0, lastRedoMilliseconds = 0;
     ActionSet* getCurrentSet() const noexcept;
     ActionSet* getNextSet() const noexcept;
     void moveFutureTransactionsToStash();
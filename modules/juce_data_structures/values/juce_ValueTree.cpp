@@ -27,17 +27,332 @@
 namespace juce
 {
 
+//==============================================================================
+/*  The compact binary format that's written by ValueTree::writeCompactBinary() is:
+
+        a zero byte followed by "VTC1"
+        an identifier table: varint count, then for each one, a varint size and its UTF-8 bytes
+        the nodes, with each node's children written before the node itself:
+            varint type, varint numProperties,
+            for each property: varint name, a ValueKind byte, and the value
+            varint numChildren, then for each child, the varint distance back
+            from the start of this list to the start of the child
+        a little-endian uint64 holding the offset of the root node
+
+    Types and property names are stored as indexes into the identifier table, and
+    all the fixed-size values are little-endian.
+
+    The leading zero byte means that this can never be confused with the format written
+    by ValueTree::writeToStream(), which starts with the tree's type name - the only
+    stream that starts with an empty name is the one for an invalid tree.
+*/
+struct CompactValueTreeData  : public ReferenceCountedObject
+{
+    typedef ReferenceCountedObjectPtr<CompactValueTreeData> Ptr;
+
+    CompactValueTreeData (const void* sourceData, size_t sourceSize)
+        : ownedData (sourceData, sourceSize)
+    {
+        data = static_cast<const uint8*> (ownedData.getData());
+        size = ownedData.getSize();
+    }
+
+    CompactValueTreeData (MemoryMappedFile* file)
+        : mappedFile (file)
+    {
+        data = static_cast<const uint8*> (mappedFile->getData());
+        size = mappedFile->getSize();
+    }
+
+    enum { magicSize = 5 };
+
+    static const char* getMagic() noexcept   { return "\0VTC1"; }
+
+    static bool isCompactData (const void* d, size_t numBytes) noexcept
+    {
+        return numBytes > magicSize + 9 && memcmp (d, getMagic(), magicSize) == 0;
+    }
+
+    bool parseHeader()
+    {
+        if (! isCompactData (data, size))
+            return false;
+
+        Reader r (*this, magicSize);
+        auto numIdentifiers = r.readVarInt();
+
+        if (numIdentifiers > size)
+            return false;
+
+        identifiers.ensureStorageAllocated ((int) numIdentifiers);
+
+        for (uint64 i = 0; i < numIdentifiers; ++i)
+        {
+            auto numBytes = r.readVarInt();
+            auto* utf8 = r.skip (numBytes);
+
+            if (utf8 == nullptr || numBytes == 0)
+                return false;
+
+            identifiers.add (Identifier (String::fromUTF8 ((const char*) utf8, (int) numBytes)));
+        }
+
+        rootOffset = ByteOrder::littleEndianInt64 (data + size - 8);
+        return ! r.failed && rootOffset < size - 8;
+    }
+
+    //==============================================================================
+    enum ValueKind
+    {
+        kindVoid = 0,
+        kindInt,
+        kindTrue,
+        kindFalse,
+        kindDouble,
+        kindString,
+        kindInt64,
+        kindStreamedVar
+    };
+
+    struct Reader
+    {
+        Reader (const CompactValueTreeData& d, uint64 startOffset) noexcept
+            : data (d.data), size (d.size - 8), pos (startOffset)
+        {
+            failed = pos >= size;
+        }
+
+        Reader (const uint8* d, size_t numBytes, uint64 startOffset) noexcept
+            : data (d), size (numBytes), pos (startOffset)
+        {
+            failed = pos > size;
+        }
+
+        uint64 readVarInt() noexcept
+        {
+            uint64 result = 0;
+
+            for (int shift = 0; shift < 64 && pos < size; shift += 7)
+            {
+                auto byte = data[pos++];
+                result |= (uint64) (byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                    return result;
+            }
+
+            failed = true;
+            return 0;
+        }
+
+        const uint8* skip (uint64 numBytes) noexcept
+        {
+            if (failed || numBytes > size - pos)
+            {
+                failed = true;
+                return nullptr;
+            }
+
+            auto* d = data + pos;
+            pos += numBytes;
+            return d;
+        }
+
+        const uint8* data;
+        uint64 size, pos;
+        bool failed;
+    };
+
+    bool readType (Reader& r, Identifier& type) const
+    {
+        auto index = r.readVarInt();
+
+        if (r.failed || index >= (uint64) identifiers.size())
+            return false;
+
+        type = identifiers.getReference ((int) index);
+        return true;
+    }
+
+    bool readProperties (Reader& r, NamedValueSet& properties) const
+    {
+        auto numProperties = r.readVarInt();
+
+        for (uint64 i = 0; i < numProperties && ! r.failed; ++i)
+        {
+            Identifier name;
+            var value;
+
+            if (! (readType (r, name) && readValue (r, value)))
+                return false;
+
+            properties.set (name, value);
+        }
+
+        return ! r.failed;
+    }
+
+    static bool readValue (Reader& r, var& value)
+    {
+        auto* kind = r.skip (1);
+
+        if (kind == nullptr)
+            return false;
+
+        switch (*kind)
+        {
+            case kindVoid:      value = var(); return true;
+            case kindTrue:      value = true;  return true;
+            case kindFalse:     value = false; return true;
+
+            case kindInt:
+                if (auto* d = r.skip (4))
+                {
+                    value = (int) ByteOrder::littleEndianInt (d);
+                    return true;
+                }
+
+                return false;
+
+            case kindInt64:
+                if (auto* d = r.skip (8))
+                {
+                    value = (int64) ByteOrder::littleEndianInt64 (d);
+                    return true;
+                }
+
+                return false;
+
+            case kindDouble:
+                if (auto* d = r.skip (8))
+                {
+                    auto bits = ByteOrder::littleEndianInt64 (d);
+                    double v;
+                    memcpy (&v, &bits, sizeof (v));
+                    value = v;
+                    return true;
+                }
+
+                return false;
+
+            case kindString:
+            {
+                auto numBytes = r.readVarInt();
+
+                if (auto* d = r.skip (numBytes))
+                {
+                    value = String::fromUTF8 ((const char*) d, (int) numBytes);
+                    return true;
+                }
+
+                return false;
+            }
+
+            case kindStreamedVar:
+            {
+                auto numBytes = r.readVarInt();
+
+                if (auto* d = r.skip (numBytes))
+                {
+                    MemoryInputStream in (d, (size_t) numBytes, false);
+                    value = var::readFromStream (in);
+                    return true;
+                }
+
+                return false;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    //==============================================================================
+    static void writeVarInt (OutputStream& output, uint64 value)
+    {
+        uint8 buffer[10];
+        int numBytes = 0;
+
+        do
+        {
+            auto byte = (uint8) (value & 0x7f);
+            value >>= 7;
+            buffer[numBytes++] = (uint8) (value != 0 ? (byte | 0x80) : byte);
+        }
+        while (value != 0);
+
+        output.write (buffer, (size_t) numBytes);
+    }
+
+    static void writeValue (OutputStream& output, const var& value)
+    {
+        if (value.isVoid())
+        {
+            output.writeByte ((char) kindVoid);
+        }
+        else if (value.isBool())
+        {
+            output.writeByte ((char) (static_cast<bool> (value) ? kindTrue : kindFalse));
+        }
+        else if (value.isInt())
+        {
+            output.writeByte ((char) kindInt);
+            output.writeInt (static_cast<int> (value));
+        }
+        else if (value.isInt64())
+        {
+            output.writeByte ((char) kindInt64);
+            output.writeInt64 (static_cast<int64> (value));
+        }
+        else if (value.isDouble())
+        {
+            output.writeByte ((char) kindDouble);
+            output.writeDouble (static_cast<double> (value));
+        }
+        else if (value.isString())
+        {
+            auto s = value.toString();
+            auto numBytes = s.getNumBytesAsUTF8();
+
+            output.writeByte ((char) kindString);
+            writeVarInt (output, (uint64) numBytes);
+            output.write (s.toRawUTF8(), numBytes);
+        }
+        else
+        {
+            MemoryOutputStream mo;
+            value.writeToStream (mo);
+
+            output.writeByte ((char) kindStreamedVar);
+            writeVarInt (output, (uint64) mo.getDataSize());
+            output << mo;
+        }
+    }
+
+    //==============================================================================
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    MemoryBlock ownedData;
+    const uint8* data = nullptr;
+    size_t size = 0;
+    Array<Identifier> identifiers;
+    uint64 rootOffset = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (CompactValueTreeData)
+};
+
+//==============================================================================
 class ValueTree::SharedObject  : public ReferenceCountedObject
 {
 public:
     typedef ReferenceCountedObjectPtr<SharedObject> Ptr;
+    struct NotificationBatch;
 
-    explicit SharedObject (const Identifier& t) noexcept  : type (t)
+    explicit SharedObject (const Identifier& t) noexcept  : type (t), children (*this)
     {
     }
 
     SharedObject (const SharedObject& other)
-        : ReferenceCountedObject(), type (other.type), properties (other.properties)
+        : ReferenceCountedObject(), type (other.type), properties (other.properties), children (*this)
     {
         for (int i = 0; i < other.children.size(); ++i)
         {
@@ -51,11 +366,14 @@ public:
     {
         jassert (parent == nullptr); // this should never happen unless something isn't obeying the ref-counting!
 
-        for (int i = children.size(); --i >= 0;)
+        // (any children that were never loaded don't need to be told about this)
+        auto& loadedChildren = children.array;
+
+        for (int i = loadedChildren.size(); --i >= 0;)
         {
-            const Ptr c (children.getObjectPointerUnchecked(i));
+            const Ptr c (loadedChildren.getObjectPointerUnchecked(i));
             c->parent = nullptr;
-            children.remove (i);
+            loadedChildren.remove (i);
             c->sendParentChangeMessage();
         }
     }
@@ -97,6 +415,9 @@ public:
 
     void sendPropertyChangeMessage (const Identifier& property, ValueTree::Listener* listenerToExclude = nullptr)
     {
+        if (auto* batch = getActiveBatch())
+            return batch->addPropertyChange (*this, property, listenerToExclude);
+
         ValueTree tree (this);
 
         callListenersForAllParents ([&] (ListenerList<Listener>& list) { list.callExcluding (listenerToExclude, &ValueTree::Listener::valueTreePropertyChanged, tree, property); });
@@ -104,33 +425,154 @@ public:
 
     void sendChildAddedMessage (ValueTree child)
     {
+        if (auto* batch = getActiveBatch())
+            return batch->add (*this, ValueTree::Change::childAdded, child, 0, 0, true);
+
         ValueTree tree (this);
         callListenersForAllParents ([&] (ListenerList<Listener>& list) { list.call (&ValueTree::Listener::valueTreeChildAdded, tree, child); });
     }
 
     void sendChildRemovedMessage (ValueTree child, int index)
     {
+        if (auto* batch = getActiveBatch())
+            return batch->add (*this, ValueTree::Change::childRemoved, child, index, 0, true);
+
         ValueTree tree (this);
         callListenersForAllParents ([=, &tree, &child] (ListenerList<Listener>& list) { list.call (&ValueTree::Listener::valueTreeChildRemoved, tree, child, index); });
     }
 
     void sendChildOrderChangedMessage (int oldIndex, int newIndex)
     {
+        if (auto* batch = getActiveBatch())
+            return batch->add (*this, ValueTree::Change::childOrderChanged, {}, oldIndex, newIndex, true);
+
         ValueTree tree (this);
         callListenersForAllParents ([=, &tree] (ListenerList<Listener>& list) { list.call (&ValueTree::Listener::valueTreeChildOrderChanged, tree, oldIndex, newIndex); });
     }
 
-    void sendParentChangeMessage()
+    void sendParentChangeMessage (NotificationBatch* batch = nullptr)
     {
-        ValueTree tree (this);
+        if (batch == nullptr)
+            batch = getActiveBatch();
+
+        auto& loadedChildren = children.array;
 
-        for (int j = children.size(); --j >= 0;)
-            if (auto* child = children.getObjectPointer (j))
-                child->sendParentChangeMessage();
+        for (int j = loadedChildren.size(); --j >= 0;)
+            if (auto* child = loadedChildren.getObjectPointer (j))
+                child->sendParentChangeMessage (batch);
 
+        if (batch != nullptr)
+            return batch->add (*this, ValueTree::Change::parentChanged, {}, 0, 0, false);
+
+        ValueTree tree (this);
         callListeners ([&] (ListenerList<Listener>& list) { list.call (&ValueTree::Listener::valueTreeParentChanged, tree); });
     }
 
+    //==============================================================================
+    /** Collects the notifications for a tree while a ScopedNotificationBatch is active on it. */
+    struct NotificationBatch
+    {
+        void add (const SharedObject& source, ValueTree::Change::Type type, const ValueTree& child,
+                  int oldIndex, int newIndex, bool includeParents,
+                  const Identifier& property = {}, ValueTree::Listener* excludedListener = nullptr)
+        {
+            for (auto* t = &source; t != nullptr; t = includeParents ? t->parent : nullptr)
+            {
+                if (t->valueTreesWithListeners.size() > 0)
+                {
+                    ValueTree::Change c;
+                    c.type = type;
+                    c.tree = ValueTree (const_cast<SharedObject*> (&source));
+                    c.child = child;
+                    c.property = property;
+                    c.oldIndex = oldIndex;
+                    c.newIndex = newIndex;
+                    c.excludedListener = excludedListener;
+
+                    getRecipient (*t).changes.add (c);
+                }
+            }
+        }
+
+        void addPropertyChange (const SharedObject& source, const Identifier& property, ValueTree::Listener* excludedListener)
+        {
+            const ChangedProperty key { &source, property, excludedListener };
+
+            if (! changedProperties.contains (key))
+            {
+                changedProperties.set (key, true);
+                add (source, ValueTree::Change::propertyChanged, {}, 0, 0, true, property, excludedListener);
+            }
+        }
+
+        void deliver()
+        {
+            for (auto* r : recipients)
+            {
+                ValueTree tree (r->object);
+                r->object->callListeners ([&] (ListenerList<Listener>& list) { list.call (&ValueTree::Listener::valueTreeChangesBatched, tree, r->changes); });
+            }
+        }
+
+        int depth = 0;
+
+    private:
+        struct Recipient
+        {
+            Ptr object;
+            Array<ValueTree::Change> changes;
+        };
+
+        struct ChangedProperty
+        {
+            const SharedObject* object;
+            Identifier name;
+            ValueTree::Listener* excludedListener;
+
+            bool operator== (const ChangedProperty& other) const noexcept
+            {
+                return object == other.object && name == other.name && excludedListener == other.excludedListener;
+            }
+        };
+
+        struct ChangedPropertyHash
+        {
+            static int generateHash (const ChangedProperty& p, int upperLimit) noexcept
+            {
+                return DefaultHashFunctions::generateHash ((uint64) (pointer_sized_uint) p.object * 31
+                                                             + (uint64) (pointer_sized_uint) p.name.getCharPointer().getAddress(),
+                                                           upperLimit);
+            }
+        };
+
+        OwnedArray<Recipient> recipients;
+        HashMap<const SharedObject*, int> recipientIndexes;
+        HashMap<ChangedProperty, bool, ChangedPropertyHash> changedProperties;
+
+        Recipient& getRecipient (const SharedObject& object)
+        {
+            if (recipientIndexes.contains (&object))
+                return *recipients.getUnchecked (recipientIndexes[&object]);
+
+            recipientIndexes.set (&object, recipients.size());
+
+            auto* r = recipients.add (new Recipient());
+            r->object = const_cast<SharedObject*> (&object);
+            return *r;
+        }
+    };
+
+    NotificationBatch* getActiveBatch() const noexcept
+    {
+        NotificationBatch* outermost = nullptr;
+
+        for (auto* t = this; t != nullptr; t = t->parent)
+            if (t->batch != nullptr)
+                outermost = t->batch;
+
+        return outermost;
+    }
+
     void setProperty (const Identifier& name, const var& newValue, UndoManager* const undoManager,
                       ValueTree::Listener* listenerToExclude = nullptr)
     {
@@ -295,7 +737,7 @@ public:
                 children.remove (childIndex);
                 child->parent = nullptr;
                 sendChildRemovedMessage (ValueTree (child), childIndex);
-                child->sendParentChangeMessage();
+                child->sendParentChangeMessage (getActiveBatch());
             }
             else
             {
@@ -408,172 +850,717 @@ public:
         }
     }
 
-    //==============================================================================
-    struct SetPropertyAction  : public UndoableAction
+    //==============================================================================
+    struct SetPropertyAction  : public UndoableAction
+    {
+        SetPropertyAction (SharedObject* const so, const Identifier& propertyName,
+                           const var& newVal, const var& oldVal, bool isAdding, bool isDeleting,
+                           ValueTree::Listener* listenerToExclude = nullptr)
+            : target (so), name (propertyName), newValue (newVal), oldValue (oldVal),
+              isAddingNewProperty (isAdding), isDeletingProperty (isDeleting),
+              excludeListener (listenerToExclude)
+        {
+        }
+
+        bool perform() override
+        {
+            jassert (! (isAddingNewProperty && target->hasProperty (name)));
+
+            if (isDeletingProperty)
+                target->removeProperty (name, nullptr);
+            else
+                target->setProperty (name, newValue, nullptr, excludeListener);
+
+            return true;
+        }
+
+        bool undo() override
+        {
+            if (isAddingNewProperty)
+                target->removeProperty (name, nullptr);
+            else
+                target->setProperty (name, oldValue, nullptr);
+
+            return true;
+        }
+
+        int getSizeInUnits() override
+        {
+            return (int) sizeof (*this); //xxx should be more accurate
+        }
+
+        UndoableAction* createCoalescedAction (UndoableAction* nextAction) override
+        {
+            if (! (isAddingNewProperty || isDeletingProperty))
+            {
+                if (SetPropertyAction* const next = dynamic_cast<SetPropertyAction*> (nextAction))
+                    if (next->target == target && next->name == name
+                          && ! (next->isAddingNewProperty || next->isDeletingProperty))
+                        return new SetPropertyAction (target, name, next->newValue, oldValue, false, false);
+            }
+
+            return nullptr;
+        }
+
+    private:
+        const Ptr target;
+        const Identifier name;
+        const var newValue;
+        var oldValue;
+        const bool isAddingNewProperty : 1, isDeletingProperty : 1;
+        ValueTree::Listener* excludeListener;
+
+        friend struct ValueTree::CompactUndoLog;
+        JUCE_DECLARE_NON_COPYABLE (SetPropertyAction)
+    };
+
+    //==============================================================================
+    struct AddOrRemoveChildAction  : public UndoableAction
+    {
+        AddOrRemoveChildAction (SharedObject* parentObject, int index, SharedObject* newChild)
+            : target (parentObject),
+              child (newChild != nullptr ? newChild : parentObject->children.getObjectPointer (index)),
+              childIndex (index),
+              isDeleting (newChild == nullptr)
+        {
+            jassert (child != nullptr);
+        }
+
+        bool perform() override
+        {
+            if (isDeleting)
+                target->removeChild (childIndex, nullptr);
+            else
+                target->addChild (child, childIndex, nullptr);
+
+            return true;
+        }
+
+        bool undo() override
+        {
+            if (isDeleting)
+            {
+                target->addChild (child, childIndex, nullptr);
+            }
+            else
+            {
+                // If you hit this, it seems that your object's state is getting confused - probably
+                // because you've interleaved some undoable and non-undoable operations?
+                jassert (childIndex < target->children.size());
+                target->removeChild (childIndex, nullptr);
+            }
+
+            return true;
+        }
+
+        int getSizeInUnits() override
+        {
+            return (int) sizeof (*this); //xxx should be more accurate
+        }
+
+    private:
+        const Ptr target, child;
+        const int childIndex;
+        const bool isDeleting;
+
+        friend struct ValueTree::CompactUndoLog;
+        JUCE_DECLARE_NON_COPYABLE (AddOrRemoveChildAction)
+    };
+
+    //==============================================================================
+    struct MoveChildAction  : public UndoableAction
+    {
+        MoveChildAction (SharedObject* parentObject, int fromIndex, int toIndex) noexcept
+            : parent (parentObject), startIndex (fromIndex), endIndex (toIndex)
+        {
+        }
+
+        bool perform() override
+        {
+            parent->moveChild (startIndex, endIndex, nullptr);
+            return true;
+        }
+
+        bool undo() override
+        {
+            parent->moveChild (endIndex, startIndex, nullptr);
+            return true;
+        }
+
+        int getSizeInUnits() override
+        {
+            return (int) sizeof (*this); //xxx should be more accurate
+        }
+
+        UndoableAction* createCoalescedAction (UndoableAction* nextAction) override
+        {
+            if (auto* next = dynamic_cast<MoveChildAction*> (nextAction))
+                if (next->parent == parent && next->startIndex == endIndex)
+                    return new MoveChildAction (parent, startIndex, next->endIndex);
+
+            return nullptr;
+        }
+
+    private:
+        const Ptr parent;
+        const int startIndex, endIndex;
+
+        friend struct ValueTree::CompactUndoLog;
+        JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
+    };
+
+    //==============================================================================
+    static void writeCompactBinary (OutputStream& output, const SharedObject& root)
+    {
+        Array<Identifier> identifiers;
+        HashMap<const void*, int> identifierIndexes;
+        root.collectIdentifiers (identifiers, identifierIndexes);
+
+        auto streamStart = output.getPosition();
+        output.write (CompactValueTreeData::getMagic(), CompactValueTreeData::magicSize);
+        CompactValueTreeData::writeVarInt (output, (uint64) identifiers.size());
+
+        for (auto& i : identifiers)
+        {
+            auto& name = i.toString();
+            auto numBytes = name.getNumBytesAsUTF8();
+            CompactValueTreeData::writeVarInt (output, (uint64) numBytes);
+            output.write (name.toRawUTF8(), numBytes);
+        }
+
+        auto rootOffset = root.writeCompactNode (output, streamStart, identifierIndexes);
+        output.writeInt64 ((int64) rootOffset);
+    }
+
+    static ValueTree loadCompactBinary (CompactValueTreeData* data)
+    {
+        CompactValueTreeData::Ptr source (data);
+
+        if (source->parseHeader())
+            if (auto* root = createFromCompactNode (*source, source->rootOffset))
+                return ValueTree (root);
+
+        jassertfalse; // trying to read corrupted data!
+        return {};
+    }
+
+    /** A node that was read from compact data doesn't create its children until they're first needed. */
+    struct ChildList
+    {
+        ChildList (SharedObject& o) noexcept  : owner (o) {}
+
+        ReferenceCountedArray<SharedObject>& get() const
+        {
+            if (owner.lazySource != nullptr)
+                owner.loadLazyChildren();
+
+            return array;
+        }
+
+        int size() const                                        { return get().size(); }
+        SharedObject* getObjectPointer (int index) const        { return get().getObjectPointer (index); }
+        SharedObject* getObjectPointerUnchecked (int index) const { return get().getObjectPointerUnchecked (index); }
+        int indexOf (const SharedObject* o) const               { return get().indexOf (o); }
+        SharedObject** begin() const                            { return get().begin(); }
+        SharedObject** end() const                              { return get().end(); }
+        void add (SharedObject* o)                              { get().add (o); }
+        void insert (int index, SharedObject* o)                { get().insert (index, o); }
+        void remove (int index)                                 { get().remove (index); }
+        void move (int currentIndex, int newIndex)              { get().move (currentIndex, newIndex); }
+        void ensureStorageAllocated (int numElements)           { get().ensureStorageAllocated (numElements); }
+
+        SharedObject& owner;
+        mutable ReferenceCountedArray<SharedObject> array;
+
+        JUCE_DECLARE_NON_COPYABLE (ChildList)
+    };
+
+    //==============================================================================
+    const Identifier type;
+    NamedValueSet properties;
+    ChildList children;
+    SortedSet<ValueTree*> valueTreesWithListeners;
+    SharedObject* parent = nullptr;
+    ScopedPointer<NotificationBatch> batch;
+
+private:
+    CompactValueTreeData::Ptr lazySource;
+    uint64 lazyChildListOffset = 0;
+
+    void collectIdentifiers (Array<Identifier>& identifiers, HashMap<const void*, int>& indexes) const
+    {
+        auto addIdentifier = [&] (const Identifier& i)
+        {
+            auto key = static_cast<const void*> (i.getCharPointer().getAddress());
+
+            if (! indexes.contains (key))
+            {
+                indexes.set (key, identifiers.size());
+                identifiers.add (i);
+            }
+        };
+
+        addIdentifier (type);
+
+        for (int i = 0; i < properties.size(); ++i)
+            addIdentifier (properties.getName (i));
+
+        for (auto* c : children)
+            c->collectIdentifiers (identifiers, indexes);
+    }
+
+    uint64 writeCompactNode (OutputStream& output, int64 streamStart, const HashMap<const void*, int>& identifierIndexes) const
+    {
+        Array<uint64> childOffsets;
+        childOffsets.ensureStorageAllocated (children.size());
+
+        for (auto* c : children)
+            childOffsets.add (c->writeCompactNode (output, streamStart, identifierIndexes));
+
+        auto getIndex = [&] (const Identifier& i) { return (uint64) identifierIndexes [i.getCharPointer().getAddress()]; };
+        auto nodeOffset = (uint64) (output.getPosition() - streamStart);
+
+        CompactValueTreeData::writeVarInt (output, getIndex (type));
+        CompactValueTreeData::writeVarInt (output, (uint64) properties.size());
+
+        for (int i = 0; i < properties.size(); ++i)
+        {
+            CompactValueTreeData::writeVarInt (output, getIndex (properties.getName (i)));
+            CompactValueTreeData::writeValue (output, properties.getValueAt (i));
+        }
+
+        auto childListOffset = (uint64) (output.getPosition() - streamStart);
+        CompactValueTreeData::writeVarInt (output, (uint64) childOffsets.size());
+
+        for (auto offset : childOffsets)
+            CompactValueTreeData::writeVarInt (output, childListOffset - offset);
+
+        return nodeOffset;
+    }
+
+    static SharedObject* createFromCompactNode (CompactValueTreeData& source, uint64 offset)
+    {
+        CompactValueTreeData::Reader r (source, offset);
+        Identifier nodeType;
+
+        if (! source.readType (r, nodeType))
+            return nullptr;
+
+        ScopedPointer<SharedObject> o (new SharedObject (nodeType));
+
+        if (! source.readProperties (r, o->properties))
+            return nullptr;
+
+        auto childListOffset = r.pos;
+        auto numChildren = r.readVarInt();
+
+        if (r.failed)
+            return nullptr;
+
+        if (numChildren > 0)
+        {
+            o->lazySource = &source;
+            o->lazyChildListOffset = childListOffset;
+        }
+
+        return o.release();
+    }
+
+    void loadLazyChildren()
+    {
+        CompactValueTreeData::Ptr source (lazySource);
+        lazySource = nullptr;
+
+        CompactValueTreeData::Reader r (*source, lazyChildListOffset);
+        auto numChildren = r.readVarInt();
+        children.array.ensureStorageAllocated ((int) jmin (numChildren, (uint64) 65536));
+
+        for (uint64 i = 0; i < numChildren; ++i)
+        {
+            auto distance = r.readVarInt();
+
+            // (the children always come before their parent, so this can't recurse)
+            if (r.failed || distance == 0 || distance > lazyChildListOffset)
+            {
+                jassertfalse; // trying to read corrupted data!
+                break;
+            }
+
+            auto* child = createFromCompactNode (*source, lazyChildListOffset - distance);
+
+            if (child == nullptr)
+            {
+                jassertfalse; // trying to read corrupted data!
+                break;
+            }
+
+            child->parent = this;
+            children.array.add (child);
+        }
+    }
+
+    SharedObject& operator= (const SharedObject&);
+    JUCE_LEAK_DETECTOR (SharedObject)
+};
+
+//==============================================================================
+/*  Encodes ValueTree undo actions into a flat block of bytes, for UndoManager's compact
+    history mode, so that a whole transaction can be stored as a single allocation rather
+    than as a list of UndoableAction objects.
+
+    Each record is a varint size followed by the record type, the target tree (as an index
+    into a table of root trees, then a path of child indexes) and the details of the change,
+    so a record doesn't keep any of the objects it refers to alive. A change to the value of
+    an existing property is merged with an earlier change to the same property, as long as
+    nothing has been added or removed in between.
+*/
+struct ValueTree::CompactUndoLog
+{
+    CompactUndoLog() {}
+
+    static bool canStore (const UndoableAction& action) noexcept
+    {
+        return dynamic_cast<const SharedObject::SetPropertyAction*> (&action) != nullptr
+            || dynamic_cast<const SharedObject::AddOrRemoveChildAction*> (&action) != nullptr
+            || dynamic_cast<const SharedObject::MoveChildAction*> (&action) != nullptr;
+    }
+
+    /** Adds a record for an action that has just been performed. The roots array must be
+        the same one each time until reset() is called.
+    */
+    void append (const UndoableAction& action, Array<ValueTree>& roots)
+    {
+        record.reset();
+
+        if (auto* p = dynamic_cast<const SharedObject::SetPropertyAction*> (&action))
+        {
+            record.writeByte ((char) propertyRecord);
+            writeTarget (*p->target, roots);
+            writeString (record, p->name.toString());
+
+            if (p->isAddingNewProperty || p->isDeletingProperty)
+            {
+                // these change the order of the properties, so nothing can be merged across them
+                mergeableRecords.clearQuick();
+                writePropertyValues (! p->isAddingNewProperty, p->oldValue, ! p->isDeletingProperty, p->newValue);
+                addRecord (0);
+                return;
+            }
+
+            auto keySize = record.getDataSize();
+
+            for (int i = mergeableRecords.size(); --i >= 0;)
+            {
+                auto m = mergeableRecords.getUnchecked (i);
+
+                if (m.keySize == keySize && memcmp (getRecordBody (m), record.getData(), keySize) == 0)
+                {
+                    CompactValueTreeData::Reader r ((const uint8*) getRecordBody (m), m.end - m.bodyStart, keySize + 1);
+                    var oldValue;
+                    CompactValueTreeData::readValue (r, oldValue);
+
+                    removeRecord (i);
+                    ++numMergedChanges;
+
+                    if (oldValue.equalsWithSameType (p->newValue))
+                        return;  // the changes cancel each other out
+
+                    writePropertyValues (true, oldValue, true, p->newValue);
+                    addRecord (keySize);
+                    return;
+                }
+            }
+
+            writePropertyValues (true, p->oldValue, true, p->newValue);
+            addRecord (keySize);
+            return;
+        }
+
+        if (auto* c = dynamic_cast<const SharedObject::AddOrRemoveChildAction*> (&action))
+        {
+            record.writeByte ((char) (c->isDeleting ? removeChildRecord : addChildRecord));
+            writeTarget (*c->target, roots);
+            CompactValueTreeData::writeVarInt (record, (uint64) c->childIndex);
+            c->child->writeToStream (record);
+        }
+        else if (auto* mv = dynamic_cast<const SharedObject::MoveChildAction*> (&action))
+        {
+            record.writeByte ((char) moveChildRecord);
+            writeTarget (*mv->parent, roots);
+            CompactValueTreeData::writeVarInt (record, (uint64) mv->startIndex);
+            CompactValueTreeData::writeVarInt (record, (uint64) mv->endIndex);
+        }
+        else
+        {
+            jassertfalse; // check canStore() before calling this!
+            return;
+        }
+
+        mergeableRecords.clearQuick();
+        lastTarget = nullptr;
+        addRecord (0);
+    }
+
+    const void* getData() const noexcept    { return data.getData(); }
+    size_t getDataSize() const noexcept     { return dataSize; }
+
+    /** Clears the log so that it can be used for a new block. */
+    void reset()
+    {
+        dataSize = 0;
+        mergeableRecords.clearQuick();
+        lastTarget = nullptr;
+    }
+
+    /** Replays the records in a block, or reverts them in reverse order. */
+    static bool apply (const void* blockData, size_t blockSize, bool isUndo, const Array<ValueTree>& roots)
+    {
+        auto* d = static_cast<const uint8*> (blockData);
+        Array<uint64> recordStarts;
+        CompactValueTreeData::Reader r (d, blockSize, 0);
+
+        while (r.pos < r.size)
+        {
+            auto size = r.readVarInt();
+            recordStarts.add (r.pos);
+
+            if (size == 0 || r.skip (size) == nullptr)
+                return false;
+        }
+
+        for (int i = 0; i < recordStarts.size(); ++i)
+        {
+            CompactValueTreeData::Reader record (d, blockSize, recordStarts.getUnchecked (isUndo ? recordStarts.size() - 1 - i : i));
+
+            if (! applyRecord (record, isUndo, roots))
+                return false;
+        }
+
+        return true;
+    }
+
+    int numMergedChanges = 0;
+
+private:
+    enum RecordType
+    {
+        propertyRecord = 1,
+        addChildRecord,
+        removeChildRecord,
+        moveChildRecord
+    };
+
+    struct MergeableRecord
+    {
+        size_t start, bodyStart, end, keySize;
+    };
+
+    MemoryBlock data;
+    size_t dataSize = 0;
+    MemoryOutputStream record;
+    Array<MergeableRecord> mergeableRecords;
+    SharedObject* lastTarget = nullptr;
+    MemoryBlock lastTargetPath;
+
+    const char* getRecordBody (const MergeableRecord& m) const noexcept
+    {
+        return static_cast<const char*> (data.getData()) + m.bodyStart;
+    }
+
+    static void writeString (OutputStream& out, const String& s)
+    {
+        auto numBytes = s.getNumBytesAsUTF8();
+        CompactValueTreeData::writeVarInt (out, (uint64) numBytes);
+        out.write (s.toRawUTF8(), numBytes);
+    }
+
+    void writeTarget (SharedObject& target, Array<ValueTree>& roots)
+    {
+        // Finding the path means searching each parent's child list, so the last one is
+        // remembered until the structure changes.
+        if (&target != lastTarget)
+        {
+            Array<int> path;
+            auto* root = &target;
+
+            for (; root->parent != nullptr; root = root->parent)
+                path.insert (0, root->parent->children.indexOf (root));
+
+            int rootIndex = 0;
+
+            while (rootIndex < roots.size() && roots.getReference (rootIndex).object.get() != root)
+                ++rootIndex;
+
+            if (rootIndex == roots.size())
+                roots.add (ValueTree (root));
+
+            MemoryOutputStream encoded (lastTargetPath, false);
+            CompactValueTreeData::writeVarInt (encoded, (uint64) rootIndex);
+            CompactValueTreeData::writeVarInt (encoded, (uint64) path.size());
+
+            for (auto index : path)
+                CompactValueTreeData::writeVarInt (encoded, (uint64) index);
+
+            encoded.flush();
+            lastTarget = &target;
+        }
+
+        record.write (lastTargetPath.getData(), lastTargetPath.getSize());
+    }
+
+    void writePropertyValues (bool hasOldValue, const var& oldValue, bool hasNewValue, const var& newValue)
     {
-        SetPropertyAction (SharedObject* const so, const Identifier& propertyName,
-                           const var& newVal, const var& oldVal, bool isAdding, bool isDeleting,
-                           ValueTree::Listener* listenerToExclude = nullptr)
-            : target (so), name (propertyName), newValue (newVal), oldValue (oldVal),
-              isAddingNewProperty (isAdding), isDeletingProperty (isDeleting),
-              excludeListener (listenerToExclude)
-        {
-        }
+        record.writeByte ((char) ((hasOldValue ? 1 : 0) | (hasNewValue ? 2 : 0)));
 
-        bool perform() override
-        {
-            jassert (! (isAddingNewProperty && target->hasProperty (name)));
+        if (hasOldValue)  CompactValueTreeData::writeValue (record, oldValue);
+        if (hasNewValue)  CompactValueTreeData::writeValue (record, newValue);
+    }
 
-            if (isDeletingProperty)
-                target->removeProperty (name, nullptr);
-            else
-                target->setProperty (name, newValue, nullptr, excludeListener);
+    void addRecord (size_t keySize)
+    {
+        auto bodySize = record.getDataSize();
+        auto needed = dataSize + bodySize + 10;
 
-            return true;
-        }
+        if (needed > data.getSize())
+            data.setSize (jmax ((size_t) 256, needed + needed / 2));
 
-        bool undo() override
-        {
-            if (isAddingNewProperty)
-                target->removeProperty (name, nullptr);
-            else
-                target->setProperty (name, oldValue, nullptr);
+        MergeableRecord m;
+        m.start = dataSize;
 
-            return true;
-        }
+        MemoryOutputStream header (static_cast<char*> (data.getData()) + dataSize, 10);
+        CompactValueTreeData::writeVarInt (header, (uint64) bodySize);
 
-        int getSizeInUnits() override
-        {
-            return (int) sizeof (*this); //xxx should be more accurate
-        }
+        m.bodyStart = dataSize + header.getDataSize();
+        m.end = m.bodyStart + bodySize;
+        m.keySize = keySize;
 
-        UndoableAction* createCoalescedAction (UndoableAction* nextAction) override
+        data.copyFrom (record.getData(), (int) m.bodyStart, bodySize);
+        dataSize = m.end;
+
+        if (keySize > 0)
+            mergeableRecords.add (m);
+    }
+
+    void removeRecord (int mergeableIndex)
+    {
+        auto removed = mergeableRecords.getUnchecked (mergeableIndex);
+        auto size = removed.end - removed.start;
+        auto* d = static_cast<char*> (data.getData());
+
+        memmove (d + removed.start, d + removed.end, dataSize - removed.end);
+        dataSize -= size;
+        mergeableRecords.remove (mergeableIndex);
+
+        for (auto& m : mergeableRecords)
         {
-            if (! (isAddingNewProperty || isDeletingProperty))
+            if (m.start > removed.start)
             {
-                if (SetPropertyAction* const next = dynamic_cast<SetPropertyAction*> (nextAction))
-                    if (next->target == target && next->name == name
-                          && ! (next->isAddingNewProperty || next->isDeletingProperty))
-                        return new SetPropertyAction (target, name, next->newValue, oldValue, false, false);
+                m.start -= size;
+                m.bodyStart -= size;
+                m.end -= size;
             }
-
-            return nullptr;
         }
+    }
 
-    private:
-        const Ptr target;
-        const Identifier name;
-        const var newValue;
-        var oldValue;
-        const bool isAddingNewProperty : 1, isDeletingProperty : 1;
-        ValueTree::Listener* excludeListener;
+    static SharedObject* readTarget (CompactValueTreeData::Reader& r, const Array<ValueTree>& roots)
+    {
+        auto rootIndex = r.readVarInt();
 
-        JUCE_DECLARE_NON_COPYABLE (SetPropertyAction)
-    };
+        if (r.failed || rootIndex >= (uint64) roots.size())
+            return nullptr;
 
-    //==============================================================================
-    struct AddOrRemoveChildAction  : public UndoableAction
-    {
-        AddOrRemoveChildAction (SharedObject* parentObject, int index, SharedObject* newChild)
-            : target (parentObject),
-              child (newChild != nullptr ? newChild : parentObject->children.getObjectPointer (index)),
-              childIndex (index),
-              isDeleting (newChild == nullptr)
-        {
-            jassert (child != nullptr);
-        }
+        auto* o = roots.getReference ((int) rootIndex).object.get();
 
-        bool perform() override
+        for (auto depth = r.readVarInt(); depth > 0 && ! r.failed; --depth)
         {
-            if (isDeleting)
-                target->removeChild (childIndex, nullptr);
-            else
-                target->addChild (child, childIndex, nullptr);
+            auto index = r.readVarInt();
 
-            return true;
+            if (index >= (uint64) o->children.size())
+                return nullptr;
+
+            o = o->children.getObjectPointerUnchecked ((int) index);
         }
 
-        bool undo() override
+        return r.failed ? nullptr : o;
+    }
+
+    static bool applyRecord (CompactValueTreeData::Reader& r, bool isUndo, const Array<ValueTree>& roots)
+    {
+        auto* type = r.skip (1);
+        auto* target = readTarget (r, roots);
+
+        if (type == nullptr || target == nullptr)
+            return false;
+
+        switch (*type)
         {
-            if (isDeleting)
-            {
-                target->addChild (child, childIndex, nullptr);
-            }
-            else
+            case propertyRecord:
             {
-                // If you hit this, it seems that your object's state is getting confused - probably
-                // because you've interleaved some undoable and non-undoable operations?
-                jassert (childIndex < target->children.size());
-                target->removeChild (childIndex, nullptr);
-            }
+                auto numBytes = r.readVarInt();
+                auto* name = r.skip (numBytes);
+                auto* flags = r.skip (1);
+                var oldValue, newValue;
 
-            return true;
-        }
+                if (name == nullptr || flags == nullptr
+                     || ((*flags & 1) != 0 && ! CompactValueTreeData::readValue (r, oldValue))
+                     || ((*flags & 2) != 0 && ! CompactValueTreeData::readValue (r, newValue)))
+                    return false;
 
-        int getSizeInUnits() override
-        {
-            return (int) sizeof (*this); //xxx should be more accurate
-        }
+                const Identifier propertyName (String::fromUTF8 ((const char*) name, (int) numBytes));
 
-    private:
-        const Ptr target, child;
-        const int childIndex;
-        const bool isDeleting;
+                if ((*flags & (isUndo ? 1 : 2)) != 0)
+                    target->setProperty (propertyName, isUndo ? oldValue : newValue, nullptr);
+                else
+                    target->removeProperty (propertyName, nullptr);
 
-        JUCE_DECLARE_NON_COPYABLE (AddOrRemoveChildAction)
-    };
+                return true;
+            }
 
-    //==============================================================================
-    struct MoveChildAction  : public UndoableAction
-    {
-        MoveChildAction (SharedObject* parentObject, int fromIndex, int toIndex) noexcept
-            : parent (parentObject), startIndex (fromIndex), endIndex (toIndex)
-        {
-        }
+            case addChildRecord:
+            case removeChildRecord:
+            {
+                auto index = (int) r.readVarInt();
 
-        bool perform() override
-        {
-            parent->moveChild (startIndex, endIndex, nullptr);
-            return true;
-        }
+                if ((*type == addChildRecord) == isUndo)
+                {
+                    if (r.failed || ! isPositiveAndBelow (index, target->children.size()))
+                        return false;
 
-        bool undo() override
-        {
-            parent->moveChild (endIndex, startIndex, nullptr);
-            return true;
-        }
+                    target->removeChild (index, nullptr);
+                    return true;
+                }
 
-        int getSizeInUnits() override
-        {
-            return (int) sizeof (*this); //xxx should be more accurate
-        }
+                MemoryInputStream in (r.data + r.pos, (size_t) (r.size - r.pos), false);
+                auto child = readFromStream (in);
 
-        UndoableAction* createCoalescedAction (UndoableAction* nextAction) override
-        {
-            if (auto* next = dynamic_cast<MoveChildAction*> (nextAction))
-                if (next->parent == parent && next->startIndex == endIndex)
-                    return new MoveChildAction (parent, startIndex, next->endIndex);
+                if (r.failed || ! child.isValid())
+                    return false;
 
-            return nullptr;
-        }
+                target->addChild (child.object, index, nullptr);
+                return true;
+            }
 
-    private:
-        const Ptr parent;
-        const int startIndex, endIndex;
+            case moveChildRecord:
+            {
+                auto startIndex = (int) r.readVarInt();
+                auto endIndex   = (int) r.readVarInt();
 
-        JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
-    };
+                if (isUndo)
+                    std::swap (startIndex, endIndex);
 
-    //==============================================================================
-    const Identifier type;
-    NamedValueSet properties;
-    ReferenceCountedArray<SharedObject> children;
-    SortedSet<ValueTree*> valueTreesWithListeners;
-    SharedObject* parent = nullptr;
+                if (r.failed || ! isPositiveAndBelow (startIndex, target->children.size()))
+                    return false;
 
-private:
-    SharedObject& operator= (const SharedObject&);
-    JUCE_LEAK_DETECTOR (SharedObject)
+                target->moveChild (startIndex, endIndex, nullptr);
+                return true;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CompactUndoLog)
 };
 
 //==============================================================================
@@ -1042,6 +2029,9 @@ ValueTree ValueTree::readFromStream (InputStream& input)
 
 ValueTree ValueTree::readFromData (const void* const data, const size_t numBytes)
 {
+    if (CompactValueTreeData::isCompactData (data, numBytes))
+        return readCompactBinary (data, numBytes);
+
     MemoryInputStream in (data, numBytes, false);
     return readFromStream (in);
 }
@@ -1053,8 +2043,78 @@ ValueTree ValueTree::readFromGZIPData (const void* const data, const size_t numB
     return readFromStream (gzipStream);
 }
 
+void ValueTree::writeCompactBinary (OutputStream& output) const
+{
+    if (object != nullptr)
+        SharedObject::writeCompactBinary (output, *object);
+}
+
+ValueTree ValueTree::readCompactBinary (const void* data, size_t numBytes)
+{
+    return SharedObject::loadCompactBinary (new CompactValueTreeData (data, numBytes));
+}
+
+ValueTree ValueTree::loadCompactBinaryFile (const File& file)
+{
+    ScopedPointer<MemoryMappedFile> mappedFile (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+
+    if (mappedFile->getData() == nullptr)
+        return {};
+
+    mappedFile->setAccessPattern (MemoryMappedFile::randomAccess);
+    return SharedObject::loadCompactBinary (new CompactValueTreeData (mappedFile.release()));
+}
+
+//==============================================================================
+ValueTree::ScopedNotificationBatch::ScopedNotificationBatch (const ValueTree& treeToBatch)  : tree (treeToBatch)
+{
+    if (auto* o = tree.object.get())
+    {
+        if (o->batch == nullptr)
+            o->batch = new SharedObject::NotificationBatch();
+
+        ++(o->batch->depth);
+    }
+}
+
+ValueTree::ScopedNotificationBatch::~ScopedNotificationBatch()
+{
+    if (auto* o = tree.object.get())
+    {
+        if (--(o->batch->depth) == 0)
+        {
+            // detach it first, so that any changes made by the listeners are delivered normally
+            ScopedPointer<SharedObject::NotificationBatch> finishedBatch (o->batch.release());
+            finishedBatch->deliver();
+        }
+    }
+}
+
+//==============================================================================
 void ValueTree::Listener::valueTreeRedirected (ValueTree&) {}
 
+void ValueTree::Listener::valueTreeChangesBatched (ValueTree&, const Array<Change>& changes)
+{
+    for (auto& c : changes)
+    {
+        if (c.excludedListener == this)
+            continue;
+
+        auto tree = c.tree;
+        auto child = c.child;
+
+        switch (c.type)
+        {
+            case Change::propertyChanged:       valueTreePropertyChanged (tree, c.property); break;
+            case Change::childAdded:            valueTreeChildAdded (tree, child); break;
+            case Change::childRemoved:          valueTreeChildRemoved (tree, child, c.oldIndex); break;
+            case Change::childOrderChanged:     valueTreeChildOrderChanged (tree, c.oldIndex, c.newIndex); break;
+            case Change::parentChanged:         valueTreeParentChanged (tree); break;
+            default:                            jassertfalse; break;
+        }
+    }
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -1142,7 +2202,130 @@ public:
             ValueTree v4 = v2.createCopy();
             expect (v1.isEquivalentTo (v4));
         }
+
+        beginTest ("Compact binary format");
+        {
+            for (int i = 10; --i >= 0;)
+            {
+                ValueTree v1 (createRandomTree (nullptr, 0, r));
+                v1.setProperty ("int64", (int64) 0x123456789abcdefLL, nullptr);
+                v1.setProperty ("array", Array<var> { 1, "two", 3.0 }, nullptr);
+
+                MemoryOutputStream mo;
+                v1.writeCompactBinary (mo);
+
+                expect (v1.isEquivalentTo (ValueTree::readCompactBinary (mo.getData(), mo.getDataSize())));
+                expect (v1.isEquivalentTo (ValueTree::readFromData (mo.getData(), mo.getDataSize())));
+            }
+
+            ValueTree v1 (createRandomTree (nullptr, 0, r));
+            v1.addChild (ValueTree ("child"), -1, nullptr);
+
+            TemporaryFile tempFile;
+
+            {
+                FileOutputStream out (tempFile.getFile());
+                v1.writeCompactBinary (out);
+            }
+
+            auto v2 = ValueTree::loadCompactBinaryFile (tempFile.getFile());
+            expect (v1.isEquivalentTo (v2));
+
+            auto lastChild = v2.getChild (v2.getNumChildren() - 1);
+            expect (lastChild.hasType ("child") && lastChild.getParent() == v2);
+
+            expect (! ValueTree::loadCompactBinaryFile (tempFile.getFile().getSiblingFile ("nonexistent")).isValid());
+        }
+
+        beginTest ("Old-format data is never mistaken for the compact format");
+        {
+            for (auto type : { "VTC1", "VTC1Preset", "VTC12345678901234" })
+            {
+                ValueTree v1 (type);
+                v1.setProperty ("name", "value", nullptr);
+                v1.addChild (ValueTree ("child"), -1, nullptr);
+
+                MemoryOutputStream mo;
+                v1.writeToStream (mo);
+
+                expect (v1.isEquivalentTo (ValueTree::readFromData (mo.getData(), mo.getDataSize())));
+            }
+
+            MemoryOutputStream mo;
+            ValueTree().writeToStream (mo);
+            expect (! ValueTree::readFromData (mo.getData(), mo.getDataSize()).isValid());
+        }
+
+        beginTest ("Notification batching");
+        {
+            UndoManager undoManager;
+            ValueTree root ("root"), child ("child");
+            root.addChild (child, -1, nullptr);
+
+            CountingListener replaying;
+            BatchListener batched;
+            root.addListener (&replaying);
+            root.addListener (&batched);
+
+            {
+                ValueTree::ScopedNotificationBatch batch (root);
+
+                for (int i = 0; i < 3; ++i)
+                    child.setProperty ("a", i, &undoManager);
+
+                root.setProperty ("b", 1, nullptr);
+
+                ValueTree temp ("temp");
+                root.addChild (temp, -1, &undoManager);
+                root.removeChild (temp, &undoManager);
+
+                expectEquals (replaying.numPropertyChanges + replaying.numChildChanges, 0);
+                expectEquals (batched.numBatches, 0);
+            }
+
+            expectEquals (batched.numBatches, 1);
+            expectEquals (batched.numChanges, 4);
+            expectEquals (replaying.numPropertyChanges, 2);
+            expectEquals (replaying.numChildChanges, 2);
+
+            {
+                ValueTree::ScopedNotificationBatch outer (root);
+                ValueTree::ScopedNotificationBatch inner (child);
+
+                while (undoManager.canUndo())
+                    undoManager.undo();
+            }
+
+            expectEquals (batched.numBatches, 2);
+            expect (! child.hasProperty ("a"));
+
+            child.setProperty ("c", 1, nullptr);
+            expectEquals (batched.numBatches, 2);
+            expectEquals (replaying.numPropertyChanges, 4);
+        }
     }
+
+    struct CountingListener  : public ValueTree::Listener
+    {
+        void valueTreePropertyChanged (ValueTree&, const Identifier&) override     { ++numPropertyChanges; }
+        void valueTreeChildAdded (ValueTree&, ValueTree&) override                 { ++numChildChanges; }
+        void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override          { ++numChildChanges; }
+        void valueTreeChildOrderChanged (ValueTree&, int, int) override            { ++numChildChanges; }
+        void valueTreeParentChanged (ValueTree&) override                          {}
+
+        int numPropertyChanges = 0, numChildChanges = 0;
+    };
+
+    struct BatchListener  : public CountingListener
+    {
+        void valueTreeChangesBatched (ValueTree&, const Array<ValueTree::Change>& changes) override
+        {
+            ++numBatches;
+            numChanges += changes.size();
+        }
+
+        int numBatches = 0, numChanges = 0;
+    };
 };
 
 static ValueTreeTests valueTreeTests;
@@ -387,7 +387,7 @@ public:
     /** Reloads a tree from a stream that was written with writeToStream(). */
     static ValueTree readFromStream (InputStream& input);
 
-    /** Reloads a tree from a data block that was written with writeToStream(). */
+    /** Reloads a tree from a data block that was written with writeToStream() or writeCompactBinary(). */
     static ValueTree readFromData (const void* data, size_t numBytes);
 
     /** Reloads a tree from a data block that was written with writeToStream() and
@@ -396,6 +396,39 @@ public:
     static ValueTree readFromGZIPData (const void* data, size_t numBytes);
 
     //==============================================================================
+    /** Stores this tree (and all its children) in a compact binary format.
+
+        Compared to writeToStream(), this format stores each type and property name only
+        once, and indexes each node's children by their position in the data, so that a
+        tree can be loaded lazily with readCompactBinary() or loadCompactBinaryFile().
+        readFromData() will also recognise it.
+    */
+    void writeCompactBinary (OutputStream& output) const;
+
+    /** Loads a tree from a data block that was written with writeCompactBinary().
+
+        The data is copied, and only the top-level node is created straight away - each
+        node's children are created from the data the first time they're accessed, so
+        opening even a very large tree is quick and cheap if you only look at part of it.
+    */
+    static ValueTree readCompactBinary (const void* data, size_t numBytes);
+
+    /** Loads a tree from a file that was written with writeCompactBinary().
+
+        The file is memory-mapped rather than read, and, as with readCompactBinary(),
+        the nodes are only created when they're first accessed. The file stays mapped
+        until every node in the tree that still has children to load has been deleted,
+        so it mustn't be modified while the tree is in use.
+
+        Returns an invalid tree if the file can't be opened or doesn't contain a valid tree.
+    */
+    static ValueTree loadCompactBinaryFile (const File& file);
+
+    //==============================================================================
+    class Listener;
+    class ScopedNotificationBatch;
+    struct Change;
+
     /** Listener class for events that happen to a ValueTree.
 
         To get events from a ValueTree, make your class implement this interface, and use
@@ -465,6 +498,17 @@ public:
             will be made.
         */
         virtual void valueTreeRedirected (ValueTree& treeWhichHasBeenChanged);
+
+        /** This method is called when a ScopedNotificationBatch ends, with all the changes that
+            it recorded for the tree to which this listener is registered (and its sub-trees).
+
+            The default implementation simply replays the changes by calling the other listener
+            methods in turn. Override it if you'd rather handle a bulk update in one go, e.g. by
+            doing a single relayout instead of one for each change.
+
+            @see ScopedNotificationBatch
+        */
+        virtual void valueTreeChangesBatched (ValueTree& treeWithListener, const Array<Change>& changes);
     };
 
     /** Adds a listener to receive callbacks when this node is changed.
@@ -551,6 +595,9 @@ private:
     JUCE_PUBLIC_IN_DLL_BUILD (class SharedObject)
     friend class SharedObject;
 
+    struct CompactUndoLog;
+    friend class UndoManager;
+
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
 
@@ -575,4 +622,67 @@ private:
     explicit ValueTree (SharedObject*) noexcept;
 };
 
+//==============================================================================
+/** Describes one change that was recorded while a ScopedNotificationBatch was active.
+    @see ValueTree::ScopedNotificationBatch, ValueTree::Listener::valueTreeChangesBatched
+*/
+struct ValueTree::Change
+{
+    enum Type
+    {
+        propertyChanged,
+        childAdded,
+        childRemoved,
+        childOrderChanged,
+        parentChanged
+    };
+
+    Type type;
+    ValueTree tree;                 /**< The tree whose property, children or parent changed. */
+    ValueTree child;                /**< For childAdded and childRemoved, the child in question. */
+    Identifier property;            /**< For propertyChanged, the property's name. */
+    int oldIndex, newIndex;         /**< For childRemoved, oldIndex is the index it was removed from.
+                                         For childOrderChanged, these are the indexes it moved between. */
+    Listener* excludedListener;     /**< A listener that was asked not to hear about this change, or nullptr. */
+};
+
+//==============================================================================
+/** Defers and coalesces the listener callbacks for a tree and its sub-trees.
+
+    While one of these objects exists, any listener callbacks that would be made because
+    of changes to the tree (or any of its sub-trees, at any depth) are recorded instead.
+    When the batch is destroyed, each listener that would have been called receives a single
+    Listener::valueTreeChangesBatched() callback containing everything that happened.
+
+    Repeated changes to the same property of the same tree are only reported once, so this
+    is handy for wrapping a bulk update such as loading a preset or pasting a lot of data.
+    Child additions, removals and reorders are reported in the order in which they happened.
+
+    Batches can be nested, in which case nothing is delivered until the outermost one ends.
+    Changes that are made via an UndoManager are batched too, so you can also wrap calls
+    to UndoManager::undo() or redo() in one of these.
+
+    @code
+    {
+        ValueTree::ScopedNotificationBatch batch (presetTree);
+        presetTree.copyPropertiesFrom (newPreset, &undoManager);
+        ...
+    }   // listeners are called here
+    @endcode
+*/
+class JUCE_API  ValueTree::ScopedNotificationBatch
+{
+public:
+    /** Starts batching the notifications for the given tree. */
+    explicit ScopedNotificationBatch (const ValueTree& treeToBatch);
+
+    /** Ends the batch, delivering the notifications if this is the outermost one. */
+    ~ScopedNotificationBatch();
+
+private:
+    ValueTree tree;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedNotificationBatch)
+};
+
 } // namespace juce
@@ -36,7 +36,10 @@ namespace ValueTreeSynchroniserHelpers
         childAdded       = 3,
         childRemoved     = 4,
         childMoved       = 5,
-        propertyRemoved  = 6
+        propertyRemoved  = 6,
+        batch            = 7,
+        compressed       = 8,
+        deltaSync        = 9
     };
 
     static void getValueTreePath (ValueTree v, const ValueTree& topLevelTree, Array<int>& path)
@@ -53,6 +56,12 @@ namespace ValueTreeSynchroniserHelpers
         }
     }
 
+    static void getPathFromRoot (const ValueTree& v, const ValueTree& topLevelTree, Array<int>& path)
+    {
+        getValueTreePath (v, topLevelTree, path);
+        std::reverse (path.begin(), path.end());
+    }
+
     static void writeHeader (MemoryOutputStream& stream, ChangeType type)
     {
         stream.writeByte ((char) type);
@@ -72,6 +81,116 @@ namespace ValueTreeSynchroniserHelpers
             stream.writeCompressedInt (path.getUnchecked(i));
     }
 
+    static void writeHeader (MemoryOutputStream& stream, ChangeType type, const Array<int>& pathFromRoot)
+    {
+        writeHeader (stream, type);
+        stream.writeCompressedInt (pathFromRoot.size());
+
+        for (auto index : pathFromRoot)
+            stream.writeCompressedInt (index);
+    }
+
+    static void writeSubMessage (MemoryOutputStream& stream, const MemoryOutputStream& subMessage)
+    {
+        stream.writeCompressedInt ((int) subMessage.getDataSize());
+        stream << subMessage;
+    }
+
+    static void writePropertyChange (MemoryOutputStream& stream, const ValueTree& v, const Identifier& property,
+                                     const Array<int>& pathFromRoot)
+    {
+        if (auto* value = v.getPropertyPointer (property))
+        {
+            writeHeader (stream, propertyChanged, pathFromRoot);
+            stream.writeString (property.toString());
+            value->writeToStream (stream);
+        }
+        else
+        {
+            writeHeader (stream, propertyRemoved, pathFromRoot);
+            stream.writeString (property.toString());
+        }
+    }
+
+    /*  Writes the changes needed to turn the base tree into the current one. Children are
+        matched up by index, and any whose type differs are replaced outright.
+    */
+    static int writeDifferences (MemoryOutputStream& stream, const ValueTree& base, const ValueTree& current,
+                                 Array<int>& pathFromRoot)
+    {
+        int numChanges = 0;
+
+        auto addChange = [&] (ChangeType type, const Identifier& property, int index, const ValueTree* child)
+        {
+            MemoryOutputStream m;
+
+            if (type == propertyChanged || type == propertyRemoved)
+            {
+                writePropertyChange (m, current, property, pathFromRoot);
+            }
+            else
+            {
+                writeHeader (m, type, pathFromRoot);
+                m.writeCompressedInt (index);
+
+                if (child != nullptr)
+                    child->writeToStream (m);
+            }
+
+            writeSubMessage (stream, m);
+            ++numChanges;
+        };
+
+        for (int i = 0; i < current.getNumProperties(); ++i)
+        {
+            auto name = current.getPropertyName (i);
+            auto* oldValue = base.getPropertyPointer (name);
+
+            if (oldValue == nullptr || ! oldValue->equalsWithSameType (*current.getPropertyPointer (name)))
+                addChange (propertyChanged, name, 0, nullptr);
+        }
+
+        for (int i = 0; i < base.getNumProperties(); ++i)
+        {
+            auto name = base.getPropertyName (i);
+
+            if (! current.hasProperty (name))
+                addChange (propertyRemoved, name, 0, nullptr);
+        }
+
+        auto numBaseChildren = base.getNumChildren();
+        auto numCurrentChildren = current.getNumChildren();
+
+        for (int i = 0; i < jmin (numBaseChildren, numCurrentChildren); ++i)
+        {
+            auto baseChild = base.getChild (i);
+            auto currentChild = current.getChild (i);
+
+            if (baseChild.hasType (currentChild.getType()))
+            {
+                pathFromRoot.add (i);
+                numChanges += writeDifferences (stream, baseChild, currentChild, pathFromRoot);
+                pathFromRoot.removeLast();
+            }
+            else
+            {
+                addChange (childRemoved, {}, i, nullptr);
+                addChange (childAdded, {}, i, &currentChild);
+            }
+        }
+
+        for (int i = numBaseChildren; --i >= numCurrentChildren;)
+            addChange (childRemoved, {}, i, nullptr);
+
+        for (int i = numBaseChildren; i < numCurrentChildren; ++i)
+        {
+            auto currentChild = current.getChild (i);
+            addChange (childAdded, {}, i, &currentChild);
+        }
+
+        return numChanges;
+    }
+
     static ValueTree readSubTreeLocation (MemoryInputStream& input, ValueTree v)
     {
         const int numLevels = input.readCompressedInt();
@@ -93,6 +212,21 @@ namespace ValueTreeSynchroniserHelpers
     }
 }
 
+//==============================================================================
+struct ValueTreeSynchroniser::PendingChange
+{
+    MemoryBlock data;           // the encoded change, or for a property change, just the tree's path
+    ValueTree tree;
+    Identifier property;        // (only set for a property change, whose value is read when it's sent)
+};
+
+struct ValueTreeSynchroniser::SentSync
+{
+    int syncID, baseSyncID;
+    MemoryBlock message;        // (applied to the acknowledged state if this sync gets acknowledged)
+};
+
+//==============================================================================
 ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)  : valueTree (tree)
 {
     valueTree.addListener (this);
@@ -105,31 +239,264 @@ ValueTreeSynchroniser::~ValueTreeSynchroniser()
 
 void ValueTreeSynchroniser::sendFullSyncCallback()
 {
+    // (anything that was waiting to be sent will be included in this)
+    pendingChanges.clear();
+    pendingPropertyChanges.clear();
+
     MemoryOutputStream m;
     writeHeader (m, ValueTreeSynchroniserHelpers::fullSync);
     valueTree.writeToStream (m);
-    stateChanged (m.getData(), m.getDataSize());
+
+    ++statistics.numFullSyncs;
+    sendChange (m, 1);
 }
 
-void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Identifier& property)
+int ValueTreeSynchroniser::sendDeltaSyncCallback()
 {
+    pendingChanges.clear();
+    pendingPropertyChanges.clear();
+
+    auto syncID = ++lastSyncID;
+    auto baseSyncID = acknowledgedSyncID;
+
+    MemoryOutputStream changes;
+    int numChanges;
+
+    if (baseSyncID != 0)
+    {
+        Array<int> path;
+        numChanges = ValueTreeSynchroniserHelpers::writeDifferences (changes, acknowledgedState, valueTree, path);
+        ++statistics.numDeltaSyncs;
+    }
+    else
+    {
+        MemoryOutputStream full;
+        writeHeader (full, ValueTreeSynchroniserHelpers::fullSync);
+        valueTree.writeToStream (full);
+
+        ValueTreeSynchroniserHelpers::writeSubMessage (changes, full);
+        numChanges = 1;
+        ++statistics.numFullSyncs;
+    }
+
     MemoryOutputStream m;
+    writeHeader (m, ValueTreeSynchroniserHelpers::deltaSync);
+    m.writeCompressedInt (syncID);
+    m.writeCompressedInt (baseSyncID);
+    m.writeCompressedInt (numChanges);
+    m << changes;
+
+    // Rather than keeping a copy of the tree for each sync, just the message is kept, and
+    // it's replayed onto the acknowledged state if the receiver acknowledges it
+    auto* sent = unacknowledgedSyncs.add (new SentSync());
+    sent->syncID = syncID;
+    sent->baseSyncID = baseSyncID;
+    sent->message = m.getMemoryBlock();
+
+    while (unacknowledgedSyncs.size() > 8)
+        unacknowledgedSyncs.remove (0);
+
+    sendChange (m, numChanges);
+    return syncID;
+}
 
-    if (auto* value = vt.getPropertyPointer (property))
+void ValueTreeSynchroniser::acknowledgeSync (int syncID)
+{
+    if (syncID > 0 && syncID <= acknowledgedSyncID)
+        return;
+
+    for (auto* sent : unacknowledgedSyncs)
     {
-        ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::propertyChanged, vt);
-        m.writeString (property.toString());
-        value->writeToStream (m);
+        if (sent->syncID == syncID)
+        {
+            int appliedSyncID = acknowledgedSyncID;
+
+            if (sent->baseSyncID == acknowledgedSyncID
+                 && applyChange (acknowledgedState, sent->message.getData(), sent->message.getSize(),
+                                 nullptr, appliedSyncID))
+            {
+                acknowledgedSyncID = syncID;
+
+                // Anything sent before this was acknowledged was encoded against the old
+                // state, so the receiver will reject it, and it'll never be acknowledged
+                unacknowledgedSyncs.clear();
+                return;
+            }
+
+            break;
+        }
+    }
+
+    // The receiver is in a state that we no longer know about, so start again from a full sync
+    acknowledgedState = ValueTree();
+    acknowledgedSyncID = 0;
+    unacknowledgedSyncs.clear();
+}
+
+//==============================================================================
+void ValueTreeSynchroniser::setBatchInterval (int milliseconds)
+{
+    batchIntervalMs = jmax (0, milliseconds);
+
+    if (batchIntervalMs == 0)
+        flushPendingChanges();
+}
+
+void ValueTreeSynchroniser::setCompressionThreshold (int minimumMessageSizeToCompress)
+{
+    compressionThreshold = jmax (0, minimumMessageSizeToCompress);
+}
+
+void ValueTreeSynchroniser::flushPendingChanges()
+{
+    stopTimer();
+
+    auto numChanges = pendingChanges.size();
+
+    if (numChanges == 0)
+        return;
+
+    auto writePending = [] (MemoryOutputStream& m, const PendingChange& c)
+    {
+        if (c.property.isNull())
+        {
+            m << c.data;
+        }
+        else
+        {
+            Array<int> path;
+            MemoryInputStream pathData (c.data, false);
+
+            while (! pathData.isExhausted())
+                path.add (pathData.readCompressedInt());
+
+            ValueTreeSynchroniserHelpers::writePropertyChange (m, c.tree, c.property, path);
+        }
+    };
+
+    MemoryOutputStream m;
+
+    if (numChanges == 1)
+    {
+        writePending (m, *pendingChanges.getFirst());
     }
     else
     {
-        ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::propertyRemoved, vt);
-        m.writeString (property.toString());
+        writeHeader (m, ValueTreeSynchroniserHelpers::batch);
+        m.writeCompressedInt (numChanges);
+
+        for (auto* c : pendingChanges)
+        {
+            MemoryOutputStream sub;
+            writePending (sub, *c);
+            ValueTreeSynchroniserHelpers::writeSubMessage (m, sub);
+        }
+    }
+
+    pendingChanges.clear();
+    pendingPropertyChanges.clear();
+    sendChange (m, numChanges);
+}
+
+void ValueTreeSynchroniser::timerCallback()
+{
+    flushPendingChanges();
+}
+
+void ValueTreeSynchroniser::queueChange (MemoryOutputStream& m)
+{
+    if (batchIntervalMs > 0 || isCollectingBatch)
+    {
+        // the paths of any property changes after this may be different, so they can't
+        // be coalesced with the ones before it
+        pendingPropertyChanges.clear();
+
+        auto* c = pendingChanges.add (new PendingChange());
+        c->data = m.getMemoryBlock();
+
+        if (batchIntervalMs > 0 && ! isTimerRunning())
+            startTimer (batchIntervalMs);
+    }
+    else
+    {
+        sendChange (m, 1);
+    }
+}
+
+void ValueTreeSynchroniser::sendChange (MemoryOutputStream& m, int numChanges)
+{
+    auto size = (int64) m.getDataSize();
+
+    ++statistics.numMessagesSent;
+    statistics.numChangesSent += numChanges;
+    statistics.numUncompressedBytes += size;
+
+    if (compressionThreshold > 0 && size >= compressionThreshold)
+    {
+        MemoryOutputStream compressed;
+        writeHeader (compressed, ValueTreeSynchroniserHelpers::compressed);
+        compressed.writeCompressedInt ((int) size);
+
+        {
+            GZIPCompressorOutputStream zipper (&compressed);
+            zipper.write (m.getData(), m.getDataSize());
+        }
+
+        if ((int64) compressed.getDataSize() < size)
+        {
+            statistics.numBytesSent += (int64) compressed.getDataSize();
+            stateChanged (compressed.getData(), compressed.getDataSize());
+            return;
+        }
     }
 
+    statistics.numBytesSent += size;
     stateChanged (m.getData(), m.getDataSize());
 }
 
+//==============================================================================
+void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Identifier& property)
+{
+    Array<int> path;
+    ValueTreeSynchroniserHelpers::getPathFromRoot (vt, valueTree, path);
+
+    if (batchIntervalMs > 0 || isCollectingBatch)
+    {
+        auto key = property.toString();
+
+        for (auto index : path)
+            key << '/' << index;
+
+        if (pendingPropertyChanges.contains (key))
+        {
+            ++statistics.numChangesCoalesced;
+            return;
+        }
+
+        pendingPropertyChanges.set (key, pendingChanges.size());
+
+        auto* c = pendingChanges.add (new PendingChange());
+        c->tree = vt;
+        c->property = property;
+
+        {
+            MemoryOutputStream pathData (c->data, false);
+
+            for (auto index : path)
+                pathData.writeCompressedInt (index);
+        }
+
+        if (batchIntervalMs > 0 && ! isTimerRunning())
+            startTimer (batchIntervalMs);
+
+        return;
+    }
+
+    MemoryOutputStream m;
+    ValueTreeSynchroniserHelpers::writePropertyChange (m, vt, property, path);
+    sendChange (m, 1);
+}
+
 void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTree& childTree)
 {
     const int index = parentTree.indexOf (childTree);
@@ -139,7 +506,7 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childAdded, parentTree);
     m.writeCompressedInt (index);
     childTree.writeToStream (m);
-    stateChanged (m.getData(), m.getDataSize());
+    queueChange (m);
 }
 
 void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueTree&, int oldIndex)
@@ -147,7 +514,7 @@ void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueT
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childRemoved, parentTree);
     m.writeCompressedInt (oldIndex);
-    stateChanged (m.getData(), m.getDataSize());
+    queueChange (m);
 }
 
 void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex)
@@ -156,17 +523,104 @@ void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int o
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childMoved, parent);
     m.writeCompressedInt (oldIndex);
     m.writeCompressedInt (newIndex);
-    stateChanged (m.getData(), m.getDataSize());
+    queueChange (m);
 }
 
 void ValueTreeSynchroniser::valueTreeParentChanged (ValueTree&)  {} // (No action needed here)
 
+void ValueTreeSynchroniser::valueTreeChangesBatched (ValueTree&, const Array<ValueTree::Change>& changes)
+{
+    // By the time a batch is delivered, the paths of any children that were added, removed
+    // or moved during it can no longer be worked out, so in that case the whole tree is resent
+    for (auto& c : changes)
+        if (c.type != ValueTree::Change::propertyChanged && c.type != ValueTree::Change::parentChanged)
+            return sendFullSyncCallback();
+
+    {
+        const ScopedValueSetter<bool> svs (isCollectingBatch, true);
+
+        for (auto& c : changes)
+        {
+            if (c.type == ValueTree::Change::propertyChanged)
+            {
+                auto tree = c.tree;
+                valueTreePropertyChanged (tree, c.property);
+            }
+        }
+    }
+
+    if (batchIntervalMs == 0)
+        flushPendingChanges();
+}
+
+//==============================================================================
 bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size_t dataSize, UndoManager* undoManager)
+{
+    int syncID = 0;
+    return applyChange (root, data, dataSize, undoManager, syncID);
+}
+
+bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size_t dataSize,
+                                         UndoManager* undoManager, int& syncIDToAcknowledge)
 {
     MemoryInputStream input (data, dataSize, false);
 
     const ValueTreeSynchroniserHelpers::ChangeType type = (ValueTreeSynchroniserHelpers::ChangeType) input.readByte();
 
+    if (type == ValueTreeSynchroniserHelpers::compressed)
+    {
+        auto uncompressedSize = input.readCompressedInt();
+
+        if (uncompressedSize <= 0)
+            return false;
+
+        MemoryBlock uncompressed;
+        GZIPDecompressorInputStream unzipper (input);
+
+        if (unzipper.readIntoMemoryBlock (uncompressed, uncompressedSize) != (size_t) uncompressedSize)
+            return false;
+
+        return applyChange (root, uncompressed.getData(), uncompressed.getSize(), undoManager, syncIDToAcknowledge);
+    }
+
+    if (type == ValueTreeSynchroniserHelpers::batch || type == ValueTreeSynchroniserHelpers::deltaSync)
+    {
+        int syncID = 0;
+
+        if (type == ValueTreeSynchroniserHelpers::deltaSync)
+        {
+            syncID = input.readCompressedInt();
+            auto baseSyncID = input.readCompressedInt();
+
+            // A delta that was encoded against a different state from the one that the target
+            // is in can't be applied, so it's ignored, leaving the target untouched
+            if (baseSyncID != 0 && baseSyncID != syncIDToAcknowledge)
+                return false;
+        }
+
+        auto numChanges = input.readCompressedInt();
+        bool ok = true;
+
+        for (int i = 0; i < numChanges; ++i)
+        {
+            auto size = input.readCompressedInt();
+
+            if (size <= 0 || size > input.getNumBytesRemaining())
+                return false;
+
+            int unused;
+            ok = applyChange (root, static_cast<const char*> (data) + input.getPosition(), (size_t) size, undoManager, unused) && ok;
+            input.skipNextBytes (size);
+        }
+
+        // If only some of a delta could be applied, the target isn't in any state that the
+        // sender knows about, so it has to go back to asking for the whole tree
+        if (syncID != 0)
+            syncIDToAcknowledge = ok ? syncID : 0;
+
+        return ok;
+    }
+
     if (type == ValueTreeSynchroniserHelpers::fullSync)
     {
         root = ValueTree::readFromStream (input);
@@ -239,4 +693,215 @@ bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size
     return false;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeSynchroniserTests  : public UnitTest
+{
+public:
+    ValueTreeSynchroniserTests() : UnitTest ("ValueTreeSynchroniser", "Values") {}
+
+    struct Mirror  : public ValueTreeSynchroniser
+    {
+        Mirror (const ValueTree& source)  : ValueTreeSynchroniser (source) {}
+
+        void stateChanged (const void* data, size_t size) override
+        {
+            ++numMessages;
+
+            if (holdMessages)
+                heldMessages.add (MemoryBlock (data, size));
+            else
+                allApplied = applyChange (target, data, size, nullptr, lastSyncID) && allApplied;
+        }
+
+        // Applies the held messages in order, returning how many of them were accepted
+        int deliverHeldMessages()
+        {
+            int numAccepted = 0;
+
+            for (auto& m : heldMessages)
+                if (applyChange (target, m.getData(), m.getSize(), nullptr, lastSyncID))
+                    ++numAccepted;
+
+            heldMessages.clear();
+            return numAccepted;
+        }
+
+        ValueTree target;
+        Array<MemoryBlock> heldMessages;
+        int numMessages = 0, lastSyncID = 0;
+        bool allApplied = true, holdMessages = false;
+    };
+
+    static void makeChanges (ValueTree& v, Random& r)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            auto node = v.getNumChildren() > 0 ? v.getChild (r.nextInt (v.getNumChildren())) : v;
+
+            switch (r.nextInt (5))
+            {
+                case 0:  v.addChild (ValueTree ("node"), r.nextInt (v.getNumChildren() + 1), nullptr); break;
+                case 1:  if (v.getNumChildren() > 1) v.removeChild (r.nextInt (v.getNumChildren()), nullptr); break;
+                case 2:  if (v.getNumChildren() > 1) v.moveChild (0, v.getNumChildren() - 1, nullptr); break;
+                case 3:  node.removeProperty ("value", nullptr); break;
+                default: node.setProperty ("value", r.nextInt (100), nullptr); break;
+            }
+        }
+    }
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        beginTest ("Immediate changes");
+        {
+            ValueTree source ("root");
+            Mirror mirror (source);
+            mirror.sendFullSyncCallback();
+            makeChanges (source, r);
+
+            expect (mirror.allApplied);
+            expect (source.isEquivalentTo (mirror.target));
+            expectEquals ((int) mirror.getStatistics().numMessagesSent, mirror.numMessages);
+        }
+
+        beginTest ("Batching and compression");
+        {
+            ValueTree source ("root");
+            Mirror mirror (source);
+            mirror.sendFullSyncCallback();
+            mirror.setBatchInterval (60000);
+            mirror.setCompressionThreshold (64);
+
+            for (int i = 0; i < 100; ++i)
+                source.setProperty ("value", i, nullptr);
+
+            makeChanges (source, r);
+            expectEquals (mirror.numMessages, 1);
+
+            mirror.flushPendingChanges();
+            expectEquals (mirror.numMessages, 2);
+            expect (mirror.allApplied);
+            expect (source.isEquivalentTo (mirror.target));
+
+            auto stats = mirror.getStatistics();
+            expect (stats.numChangesCoalesced >= 99);
+            expect (stats.numBytesSent <= stats.numUncompressedBytes);
+        }
+
+        beginTest ("Delta syncs");
+        {
+            ValueTree source ("root");
+            Mirror mirror (source);
+            mirror.setBatchInterval (60000); // (so that only the syncs get sent)
+
+            for (int i = 0; i < 4; ++i)
+            {
+                makeChanges (source, r);
+                auto syncID = mirror.sendDeltaSyncCallback();
+
+                expectEquals (mirror.lastSyncID, syncID);
+                mirror.acknowledgeSync (syncID);
+
+                expect (mirror.allApplied);
+                expect (source.isEquivalentTo (mirror.target));
+            }
+
+            auto stats = mirror.getStatistics();
+            expectEquals ((int) stats.numFullSyncs, 1);
+            expectEquals ((int) stats.numDeltaSyncs, 3);
+        }
+
+        beginTest ("Overlapping delta syncs");
+        {
+            ValueTree source ("root");
+            Mirror mirror (source);
+            mirror.setBatchInterval (60000);
+            mirror.acknowledgeSync (mirror.sendDeltaSyncCallback());
+            expect (source.isEquivalentTo (mirror.target));
+
+            // Several syncs in flight before any of them is acknowledged: only the first can
+            // be applied, and the others must be rejected rather than applied to the wrong state
+            mirror.holdMessages = true;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                makeChanges (source, r);
+                mirror.sendDeltaSyncCallback();
+            }
+
+            auto afterFirst = mirror.lastSyncID + 1;
+            expectEquals (mirror.deliverHeldMessages(), 1);
+            expectEquals (mirror.lastSyncID, afterFirst);
+
+            // the receiver acknowledges the state that it's in, and the next sync catches it up
+            mirror.holdMessages = false;
+            mirror.acknowledgeSync (mirror.lastSyncID);
+            mirror.sendDeltaSyncCallback();
+            mirror.acknowledgeSync (mirror.lastSyncID);
+
+            expect (mirror.allApplied);
+            expect (source.isEquivalentTo (mirror.target));
+            expectEquals ((int) mirror.getStatistics().numFullSyncs, 1);
+
+            // If the receiver is somewhere that the sender has forgotten about, it falls back
+            // to sending the whole tree
+            mirror.holdMessages = true;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                makeChanges (source, r);
+                mirror.sendDeltaSyncCallback();
+            }
+
+            mirror.heldMessages.removeRange (1, 100);
+            expectEquals (mirror.deliverHeldMessages(), 1);
+
+            mirror.holdMessages = false;
+            mirror.acknowledgeSync (mirror.lastSyncID);
+            mirror.sendDeltaSyncCallback();
+
+            expect (source.isEquivalentTo (mirror.target));
+            expectEquals ((int) mirror.getStatistics().numFullSyncs, 2);
+        }
+
+        beginTest ("A delta that can only be partly applied asks for the whole tree");
+        {
+            ValueTree source ("root");
+
+            for (int i = 0; i < 3; ++i)
+                source.addChild (ValueTree ("node"), -1, nullptr);
+
+            Mirror mirror (source);
+            mirror.setBatchInterval (60000);
+            mirror.acknowledgeSync (mirror.sendDeltaSyncCallback());
+            expect (source.isEquivalentTo (mirror.target));
+
+            // the target drifts, so that only the change to the root's property can be applied
+            mirror.target.removeAllChildren (nullptr);
+            source.setProperty ("value", 1, nullptr);
+            source.getChild (2).setProperty ("value", 2, nullptr);
+
+            mirror.sendDeltaSyncCallback();
+            expect (! mirror.allApplied);
+            expectEquals (mirror.lastSyncID, 0);
+            expect (mirror.target["value"] == var (1));
+
+            mirror.allApplied = true;
+            mirror.acknowledgeSync (mirror.lastSyncID);
+            mirror.acknowledgeSync (mirror.sendDeltaSyncCallback());
+
+            expect (mirror.allApplied);
+            expect (source.isEquivalentTo (mirror.target));
+            expectEquals ((int) mirror.getStatistics().numFullSyncs, 2);
+        }
+    }
+};
+
+static ValueTreeSynchroniserTests valueTreeSynchroniserTests;
+
+#endif
+
 } // namespace juce
@@ -40,8 +40,17 @@ namespace juce
     and implement the stateChanged() method to transmit the encoded change (maybe
     via a network or other means) to a remote destination, where it can be
     applied to a target tree.
+
+    By default, every change is sent as soon as it happens. If the tree changes
+    faster than your transport can cope with, setBatchInterval() will make it collect
+    the changes and send them as a single message, with repeated changes to the same
+    property only being sent once, and setCompressionThreshold() will GZIP any
+    messages that are large enough to benefit. To bring a remote tree back up to date,
+    sendDeltaSyncCallback() will send just the differences from the last state that the
+    remote end acknowledged, rather than the whole tree.
 */
-class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener
+class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener,
+                                         private Timer
 {
 public:
     /** Creates a ValueTreeSynchroniser that watches the given tree.
@@ -79,11 +88,110 @@ public:
                              const void* encodedChangeData, size_t encodedChangeDataSize,
                              UndoManager* undoManager);
 
+    /** Applies an encoded change to the given destination tree, keeping track of which
+        sync sent by sendDeltaSyncCallback() the tree is in.
+
+        syncIDToAcknowledge should start out as 0, and be kept for as long as the target tree
+        is: a delta sync is only applied if it was encoded against the sync that it holds, and
+        if so, it's updated to the ID of the new sync. A delta which was encoded against some
+        other state is ignored, and false is returned, leaving the tree and the ID unchanged.
+        If a delta can only be partly applied (e.g. because the target has drifted away from
+        the sender's tree), false is returned and the ID is reset to 0, which will make the
+        sender's next sync contain the whole tree. Other kinds of change leave the ID alone.
+
+        After each delta sync, pass syncIDToAcknowledge back to the sender's acknowledgeSync()
+        method (whether or not it was applied), so that it knows what state the target tree is in.
+    */
+    static bool applyChange (ValueTree& target,
+                             const void* encodedChangeData, size_t encodedChangeDataSize,
+                             UndoManager* undoManager, int& syncIDToAcknowledge);
+
     /** Returns the root ValueTree that is being observed. */
     const ValueTree& getRoot() noexcept       { return valueTree; }
 
+    //==============================================================================
+    /** Makes the synchroniser collect changes and send them together.
+
+        If the interval is greater than zero, changes are queued and sent as a single
+        stateChanged() message at most this often (so for a UI you'd typically use one
+        frame's worth of milliseconds). While changes are queued, repeated changes to the
+        same property of the same tree are coalesced, so only the latest value is sent.
+        If the interval is zero (the default), every change is sent immediately.
+
+        The timer runs on the message thread, so the changes must be made there too.
+        @see flushPendingChanges
+    */
+    void setBatchInterval (int milliseconds);
+
+    /** Immediately sends any changes that have been queued by setBatchInterval(). */
+    void flushPendingChanges();
+
+    /** Makes the synchroniser GZIP-compress any message at least this many bytes long.
+        A message is only sent compressed if that makes it smaller. Zero (the default)
+        disables compression.
+    */
+    void setCompressionThreshold (int minimumMessageSizeToCompress);
+
+    //==============================================================================
+    /** Sends a message containing just the differences between the current state and the
+        last state that was acknowledged with acknowledgeSync().
+
+        If nothing has been acknowledged yet, this sends the entire tree, like
+        sendFullSyncCallback(). The message contains the ID of the sync it was encoded
+        against, and applyChange() will ignore it unless the target is in that state, so if
+        several syncs are sent before one is acknowledged, only the first of them is applied,
+        and the rest wait for the next sync after the acknowledgement. This is intended for a
+        remote tree that is only kept up to date by sync messages (e.g. mirroring at a fixed
+        rate), or for one that is rejoining after it stopped receiving changes.
+
+        @returns the ID of the sync, which the receiver will get from applyChange()
+    */
+    int sendDeltaSyncCallback();
+
+    /** Tells the synchroniser that a target tree is in the state sent by the sync with the
+        given ID, so that later calls to sendDeltaSyncCallback() can be encoded relative to it.
+
+        If the ID is 0, or isn't one that the synchroniser knows about (e.g. because too many
+        syncs were sent without being acknowledged), the next sync will send the whole tree.
+    */
+    void acknowledgeSync (int syncID);
+
+    //==============================================================================
+    /** Counters describing the traffic that has been sent. */
+    struct Statistics
+    {
+        int64 numMessagesSent = 0;          /**< The number of stateChanged() callbacks that were made. */
+        int64 numBytesSent = 0;             /**< The total size of the data passed to stateChanged(). */
+        int64 numUncompressedBytes = 0;     /**< What numBytesSent would have been without compression. */
+        int64 numChangesSent = 0;           /**< The number of individual changes contained in those messages. */
+        int64 numChangesCoalesced = 0;      /**< Property changes that were dropped because a later one replaced them. */
+        int64 numFullSyncs = 0;             /**< The number of full syncs sent, including delta syncs that had to send everything. */
+        int64 numDeltaSyncs = 0;            /**< The number of delta syncs that sent only the differences. */
+    };
+
+    /** Returns the traffic counters, so that the cost of syncing can be measured. */
+    Statistics getStatistics() const noexcept           { return statistics; }
+
+    /** Sets all the traffic counters back to zero. */
+    void resetStatistics() noexcept                     { statistics = {}; }
+
 private:
+    struct PendingChange;
+    struct SentSync;
+
     ValueTree valueTree;
+    OwnedArray<PendingChange> pendingChanges;
+    HashMap<String, int> pendingPropertyChanges;
+    OwnedArray<SentSync> unacknowledgedSyncs;
+    ValueTree acknowledgedState;
+    int batchIntervalMs = 0, compressionThreshold = 0, lastSyncID = 0, acknowledgedSyncID = 0;
+    bool isCollectingBatch = false;
+    Statistics statistics;
+
+    void queueChange (MemoryOutputStream&);
+    void sendChange (MemoryOutputStream&, int numChanges);
+    void valueTreeChangesBatched (ValueTree&, const Array<ValueTree::Change>&) override;
+    void timerCallback() override;
 
     void valueTreePropertyChanged (ValueTree&, const Identifier&) override;
     void valueTreeChildAdded (ValueTree&, ValueTree&) override;
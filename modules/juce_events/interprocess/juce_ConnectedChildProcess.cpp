@@ -28,6 +28,7 @@ enum { magicMastSlaveConnectionHeader = 0x712baf04 };
 static const char* startMessage = "__ipc_st";
 static const char* killMessage  = "__ipc_k_";
 static const char* pingMessage  = "__ipc_p_";
+static const char* sharedMemoryMessage = "__ipc_sm";
 enum { specialMessageSize = 8, defaultTimeoutMs = 8000 };
 
 static String getCommandLinePrefix (const String& commandLineUniqueID)
@@ -130,6 +131,8 @@ ChildProcessMaster::~ChildProcessMaster()
         connection->disconnect();
         connection = nullptr;
     }
+
+    sharedMemoryChannel = nullptr;
 }
 
 void ChildProcessMaster::handleConnectionLost() {}
@@ -143,9 +146,48 @@ bool ChildProcessMaster::sendMessageToSlave (const MemoryBlock& mb)
     return false;
 }
 
+bool ChildProcessMaster::openSharedMemoryChannel (int ringSizeInBytes)
+{
+    // this can only be used when the connection is active!
+    jassert (connection != nullptr);
+
+    // only one channel can be opened for each slave, because other threads may be using it!
+    jassert (sharedMemoryChannel == nullptr);
+
+    if (connection == nullptr || sharedMemoryChannel != nullptr)
+        return false;
+
+   #if JUCE_LINUX
+    // /dev/shm is a RAM-backed filesystem, so the pages never need to be written to disk
+    File folder ("/dev/shm");
+
+    if (! folder.isDirectory())
+   #endif
+        folder = File::getSpecialLocation (File::tempDirectory);
+
+    auto file = folder.getChildFile ("juce_ipc_" + String::toHexString (Random().nextInt64()));
+    ScopedPointer<SharedMemoryChannel> channel (new SharedMemoryChannel (file, ringSizeInBytes));
+
+    if (channel->isValid())
+    {
+        MemoryOutputStream message;
+        message.write (sharedMemoryMessage, specialMessageSize);
+        message << file.getFullPathName();
+
+        if (sendMessageToSlave (message.getMemoryBlock()))
+        {
+            sharedMemoryChannel = channel.release();
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool ChildProcessMaster::launchSlaveProcess (const File& executable, const String& commandLineUniqueID, int timeoutMs, int streamFlags)
 {
     connection = nullptr;
+    sharedMemoryChannel = nullptr;
     jassert (childProcess.kill());
 
     const String pipeName ("p" + String::toHexString (Random().nextInt64()));
@@ -218,6 +260,31 @@ private:
                 return;
             }
         }
+        else if (m.getSize() > specialMessageSize
+                  && memcmp (m.getData(), sharedMemoryMessage, specialMessageSize) == 0)
+        {
+            auto path = String::fromUTF8 (static_cast<const char*> (m.getData()) + specialMessageSize,
+                                          (int) m.getSize() - specialMessageSize);
+
+            // the master only opens one channel, and once other threads may have
+            // started using it, it mustn't be replaced
+            if (owner.sharedMemoryChannel.get() != nullptr)
+            {
+                jassertfalse;
+                return;
+            }
+
+            ScopedPointer<SharedMemoryChannel> channel (new SharedMemoryChannel (File (path)));
+
+            if (channel->isValid())
+            {
+                auto* c = channel.release();
+                owner.sharedMemoryChannel = c;
+                owner.handleSharedMemoryChannelOpened (*c);
+            }
+
+            return;
+        }
 
         owner.handleMessageFromMaster (m);
     }
@@ -227,10 +294,17 @@ private:
 
 //==============================================================================
 ChildProcessSlave::ChildProcessSlave() {}
-ChildProcessSlave::~ChildProcessSlave() {}
+
+ChildProcessSlave::~ChildProcessSlave()
+{
+    // (the connection's thread is stopped first, so it can't be opening a channel)
+    connection = nullptr;
+    delete sharedMemoryChannel.get();
+}
 
 void ChildProcessSlave::handleConnectionMade() {}
 void ChildProcessSlave::handleConnectionLost() {}
+void ChildProcessSlave::handleSharedMemoryChannelOpened (SharedMemoryChannel&) {}
 
 bool ChildProcessSlave::sendMessageToMaster (const MemoryBlock& mb)
 {
@@ -100,7 +100,25 @@ public:
     */
     bool sendMessageToMaster (const MemoryBlock&);
 
+    //==============================================================================
+    /** This will be called when the master has called openSharedMemoryChannel(), and
+        the channel has been opened by this process.
+        The call will probably be made on a background thread.
+    */
+    virtual void handleSharedMemoryChannelOpened (SharedMemoryChannel&);
+
+    /** Returns the channel that the master opened with openSharedMemoryChannel(),
+        or nullptr if it hasn't done so.
+
+        This can be called from any thread. Once the channel has been opened, it stays
+        the same until this object is deleted, so any threads that use it must have
+        finished with it before then.
+    */
+    SharedMemoryChannel* getSharedMemoryChannel() const noexcept    { return sharedMemoryChannel.get(); }
+
 private:
+    Atomic<SharedMemoryChannel*> sharedMemoryChannel;
+
     struct Connection;
     friend struct Connection;
     friend struct ContainerDeletePolicy<Connection>;
@@ -175,8 +193,33 @@ public:
     */
     bool sendMessageToSlave (const MemoryBlock&);
 
+    //==============================================================================
+    /** Creates a SharedMemoryChannel and tells the slave process to open it.
+
+        The channel carries data between the processes through shared memory, which is
+        much faster than sending messages through the pipe that connects them, so it's
+        suitable for things like exchanging audio buffers on every block. The pipe is still
+        used for control messages and for checking that the slave is still alive.
+
+        Anything written to the channel before the slave opens it will wait in its ring,
+        and ChildProcessSlave::handleSharedMemoryChannelOpened() will be called when the
+        slave is ready.
+
+        Only one channel can be opened for each slave process, so this will fail if it's
+        called again. The channel belongs to this object, and is deleted when the slave is
+        relaunched or this object is deleted, so any threads that use it must have stopped
+        using it before then.
+
+        @returns true if the channel was created and the slave was told about it.
+    */
+    bool openSharedMemoryChannel (int ringSizeInBytes = 1024 * 1024);
+
+    /** Returns the channel created by openSharedMemoryChannel(), or nullptr if there isn't one. */
+    SharedMemoryChannel* getSharedMemoryChannel() const noexcept    { return sharedMemoryChannel; }
+
 private:
     ChildProcess childProcess;
+    ScopedPointer<SharedMemoryChannel> sharedMemoryChannel;
 
     struct Connection;
     friend struct Connection;
@@ -32,6 +32,15 @@ struct InterprocessConnection::ConnectionThread  : public Thread
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConnectionThread)
 };
 
+struct InterprocessConnection::ReactorListener  : public SocketReactor::Listener
+{
+    ReactorListener (InterprocessConnection& c)  : owner (c) {}
+    void socketReadyForReading (StreamingSocket&) override     { owner.handleSocketReadyForReading(); }
+
+    InterprocessConnection& owner;
+    JUCE_DECLARE_NON_COPYABLE (ReactorListener)
+};
+
 //==============================================================================
 InterprocessConnection::InterprocessConnection (bool callbacksOnMessageThread, uint32 magicMessageHeaderNumber)
     : useMessageThread (callbacksOnMessageThread),
@@ -46,6 +55,7 @@ InterprocessConnection::~InterprocessConnection()
     disconnect();
     masterReference.clear();
     thread = nullptr;
+    reactorListener = nullptr;
 }
 
 //==============================================================================
@@ -61,7 +71,7 @@ bool InterprocessConnection::connectToSocket (const String& hostName,
     if (socket->connect (hostName, portNumber, timeOutMillisecs))
     {
         connectionMadeInt();
-        thread->startThread();
+        startReading();
         return true;
     }
 
@@ -103,8 +113,17 @@ bool InterprocessConnection::createPipe (const String& pipeName, const int timeo
     return false;
 }
 
+void InterprocessConnection::setSocketReactor (SocketReactor* reactorToUse)
+{
+    // the reactor must be set before the connection is made
+    jassert (! isConnected());
+
+    reactor = reactorToUse;
+}
+
 void InterprocessConnection::disconnect()
 {
+    stopReading();
     thread->signalThreadShouldExit();
 
     {
@@ -131,7 +150,7 @@ bool InterprocessConnection::isConnected() const
 
     return ((socket != nullptr && socket->isConnected())
               || (pipe != nullptr && pipe->isOpen()))
-            && thread->isThreadRunning();
+            && (thread->isThreadRunning() || isRegisteredWithReactor);
 }
 
 String InterprocessConnection::getConnectedHostName() const
@@ -155,11 +174,16 @@ bool InterprocessConnection::sendMessage (const MemoryBlock& message)
     uint32 messageHeader[2] = { ByteOrder::swapIfBigEndian (magicMessageHeader),
                                 ByteOrder::swapIfBigEndian ((uint32) message.getSize()) };
 
-    MemoryBlock messageData (sizeof (messageHeader) + message.getSize());
-    messageData.copyFrom (messageHeader, 0, sizeof (messageHeader));
-    messageData.copyFrom (message.getData(), sizeof (messageHeader), message.getSize());
+    // the header and message are sent with a single write, using a buffer that is kept
+    // between messages rather than allocated for each one
+    const ScopedLock sl (pipeAndSocketLock);
+    auto totalSize = sizeof (messageHeader) + message.getSize();
+
+    sendBuffer.ensureSize (totalSize);
+    sendBuffer.copyFrom (messageHeader, 0, sizeof (messageHeader));
+    sendBuffer.copyFrom (message.getData(), sizeof (messageHeader), message.getSize());
 
-    return writeData (messageData.getData(), (int) messageData.getSize()) == (int) messageData.getSize();
+    return writeData (sendBuffer.getData(), (int) totalSize) == (int) totalSize;
 }
 
 int InterprocessConnection::writeData (void* data, int dataSize)
@@ -181,7 +205,7 @@ void InterprocessConnection::initialiseWithSocket (StreamingSocket* newSocket)
     jassert (socket == nullptr && pipe == nullptr);
     socket = newSocket;
     connectionMadeInt();
-    thread->startThread();
+    startReading();
 }
 
 void InterprocessConnection::initialiseWithPipe (NamedPipe* newPipe)
@@ -282,7 +306,7 @@ bool InterprocessConnection::readNextMessageInt()
 
         if (bytesInMessage > 0)
         {
-            MemoryBlock messageData ((size_t) bytesInMessage, true);
+            messageData.setSize ((size_t) bytesInMessage);
             int bytesRead = 0;
 
             while (bytesInMessage > 0)
@@ -303,6 +327,9 @@ bool InterprocessConnection::readNextMessageInt()
                 bytesInMessage -= bytesIn;
             }
 
+            if (bytesInMessage > 0)
+                zeromem (addBytesToPointer (messageData.getData(), bytesRead), (size_t) bytesInMessage);
+
             if (bytesRead >= 0)
                 deliverDataInt (messageData);
         }
@@ -319,6 +346,120 @@ bool InterprocessConnection::readNextMessageInt()
     return true;
 }
 
+//==============================================================================
+void InterprocessConnection::startReading()
+{
+    if (reactor != nullptr && socket != nullptr)
+    {
+        numBytesReceived = 0;
+
+        if (reactorListener == nullptr)
+            reactorListener = new ReactorListener (*this);
+
+        isRegisteredWithReactor = reactor->addSocket (*socket, *reactorListener);
+
+        if (isRegisteredWithReactor)
+            return;
+    }
+
+    thread->startThread();
+}
+
+void InterprocessConnection::stopReading()
+{
+    StreamingSocket* registeredSocket = nullptr;
+
+    {
+        const ScopedLock sl (pipeAndSocketLock);
+
+        if (isRegisteredWithReactor)
+        {
+            registeredSocket = socket;
+            isRegisteredWithReactor = false;
+        }
+    }
+
+    // (this waits for any callback that's in progress on another of the reactor's threads)
+    if (registeredSocket != nullptr)
+        reactor->removeSocket (*registeredSocket);
+
+    // ..and this waits for a callback which has already removed itself from the reactor
+    const ScopedLock sl (reactorCallbackLock);
+}
+
+void InterprocessConnection::handleSocketReadyForReading()
+{
+    const ScopedLock sl (reactorCallbackLock);
+
+    if (socket == nullptr)
+        return;
+
+    // The data is read into a buffer that's kept for the lifetime of the connection, and as
+    // many messages as have arrived are delivered from it, so that small messages only need
+    // one read between them, and nothing is allocated unless a message is larger than any
+    // that came before.
+    const size_t headerSize = 2 * sizeof (uint32);
+
+    if (receiveBuffer.getSize() == 0)
+        receiveBuffer.setSize (65536);
+
+    if (numBytesReceived >= headerSize)
+    {
+        auto bytesInMessage = (size_t) ByteOrder::swapIfBigEndian (static_cast<const uint32*> (receiveBuffer.getData())[1]);
+        receiveBuffer.ensureSize (headerSize + bytesInMessage);
+    }
+
+    auto bytesIn = socket->read (addBytesToPointer (receiveBuffer.getData(), numBytesReceived),
+                                 (int) (receiveBuffer.getSize() - numBytesReceived), false);
+
+    if (bytesIn <= 0)
+    {
+        stopReading();
+        deletePipeAndSocket();
+        connectionLostInt();
+        return;
+    }
+
+    numBytesReceived += (size_t) bytesIn;
+    size_t pos = 0;
+
+    while (numBytesReceived - pos >= headerSize)
+    {
+        uint32 messageHeader[2];
+        memcpy (messageHeader, addBytesToPointer (receiveBuffer.getData(), pos), headerSize);
+
+        if (ByteOrder::swapIfBigEndian (messageHeader[0]) != magicMessageHeader)
+        {
+            pos += headerSize;
+            continue;
+        }
+
+        auto bytesInMessage = (size_t) ByteOrder::swapIfBigEndian (messageHeader[1]);
+
+        if (numBytesReceived - pos - headerSize < bytesInMessage)
+            break;
+
+        if (bytesInMessage > 0)
+        {
+            messageData.setSize (bytesInMessage);
+            messageData.copyFrom (addBytesToPointer (receiveBuffer.getData(), pos + headerSize), 0, bytesInMessage);
+            deliverDataInt (messageData);
+
+            // the callback may have disconnected us
+            if (socket == nullptr)
+                return;
+        }
+
+        pos += headerSize + bytesInMessage;
+    }
+
+    if (pos > 0)
+    {
+        numBytesReceived -= pos;
+        memmove (receiveBuffer.getData(), addBytesToPointer (receiveBuffer.getData(), pos), numBytesReceived);
+    }
+}
+
 void InterprocessConnection::runThread()
 {
     while (! thread->threadShouldExit())
@@ -359,4 +500,155 @@ void InterprocessConnection::runThread()
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class InterprocessConnectionTests  : public UnitTest
+{
+public:
+    InterprocessConnectionTests() : UnitTest ("InterprocessConnection", "Interprocess") {}
+
+    struct Receiver  : public InterprocessConnection
+    {
+        Receiver()  : InterprocessConnection (false, magic) {}
+        ~Receiver()  { disconnect(); }
+
+        void connectionMade() override {}
+        void connectionLost() override      { lost = 1; }
+
+        void messageReceived (const MemoryBlock& message) override
+        {
+            {
+                const ScopedLock sl (lock);
+                messages.add (message);
+            }
+
+            if (isText (message, "disconnect"))
+                disconnect();
+        }
+
+        int getNumMessages() const          { const ScopedLock sl (lock); return messages.size(); }
+        MemoryBlock getMessage (int i) const    { const ScopedLock sl (lock); return messages[i]; }
+
+        CriticalSection lock;
+        Array<MemoryBlock> messages;
+        Atomic<int> lost;
+    };
+
+    enum { magic = 0x12345678 };
+
+    static MemoryBlock encode (const MemoryBlock& message)
+    {
+        MemoryOutputStream out;
+        out.writeInt (magic);
+        out.writeInt ((int) message.getSize());
+        out << message;
+        return out.getMemoryBlock();
+    }
+
+    static MemoryBlock encode (const char* text)      { return encode (MemoryBlock (text, strlen (text))); }
+
+    static bool isText (const MemoryBlock& message, const char* text)
+    {
+        return message == MemoryBlock (text, strlen (text));
+    }
+
+    template <typename Condition>
+    static bool waitFor (Condition condition)
+    {
+        for (int i = 0; i < 500 && ! condition(); ++i)
+            Thread::sleep (10);
+
+        return condition();
+    }
+
+    static bool write (StreamingSocket& socket, const MemoryBlock& data, size_t start, size_t numBytes)
+    {
+        return socket.write (addBytesToPointer (data.getData(), start), (int) numBytes) == (int) numBytes;
+    }
+
+    void runTest() override
+    {
+        SocketReactor reactor (2);
+        StreamingSocket listener;
+        expect (listener.createListener (0, "127.0.0.1"));
+
+        Receiver receiver;
+        receiver.setSocketReactor (&reactor);
+        expect (receiver.connectToSocket ("127.0.0.1", listener.getBoundPort(), 1000));
+        expect (receiver.isConnected());
+
+        ScopedPointer<StreamingSocket> sender (listener.waitForNextConnection());
+        expect (sender != nullptr);
+
+        if (sender == nullptr)
+            return;
+
+        beginTest ("Messages that arrive a piece at a time");
+        {
+            auto first = encode ("first"), second = encode ("second");
+
+            // a header split in the middle, then its message split from the header
+            expect (write (*sender, first, 0, 3));
+            Thread::sleep (50);
+            expect (write (*sender, first, 3, 5));
+            Thread::sleep (50);
+            expect (write (*sender, first, 8, first.getSize() - 8));
+
+            // ..and a message that arrives along with the start of the next one
+            MemoryBlock both (second);
+            both.append (first.getData(), 6);
+            expect (write (*sender, both, 0, both.getSize()));
+            Thread::sleep (50);
+            expect (write (*sender, first, 6, first.getSize() - 6));
+
+            expect (waitFor ([&] { return receiver.getNumMessages() == 3; }));
+            expect (isText (receiver.getMessage (0), "first"));
+            expect (isText (receiver.getMessage (1), "second"));
+            expect (isText (receiver.getMessage (2), "first"));
+        }
+
+        beginTest ("Messages larger than the receive buffer");
+        {
+            Random r = getRandom();
+            MemoryBlock large (300000);
+
+            for (size_t i = 0; i < large.getSize(); ++i)
+                large[(int) i] = (char) r.nextInt (256);
+
+            MemoryBlock data (encode (large));
+            data.append (encode ("after").getData(), encode ("after").getSize());
+            expect (write (*sender, data, 0, data.getSize()));
+
+            expect (waitFor ([&] { return receiver.getNumMessages() == 5; }));
+            expect (receiver.getMessage (3) == large);
+            expect (isText (receiver.getMessage (4), "after"));
+        }
+
+        beginTest ("Disconnecting from inside messageReceived()");
+        {
+            // the second message has already arrived, but mustn't be delivered
+            MemoryBlock data (encode ("disconnect"));
+            data.append (encode ("ignored").getData(), encode ("ignored").getSize());
+            expect (write (*sender, data, 0, data.getSize()));
+
+            expect (waitFor ([&] { return receiver.lost.get() != 0; }));
+            expect (! receiver.isConnected());
+
+            Thread::sleep (50);
+            expectEquals (receiver.getNumMessages(), 6);
+            expect (isText (receiver.getMessage (5), "disconnect"));
+
+            // (closing with unread data may reset the connection rather than shutting it down)
+            char buffer[16];
+            expect (sender->read (buffer, sizeof (buffer), true) <= 0);
+            expectEquals (reactor.getNumSockets(), 0);
+        }
+    }
+};
+
+static InterprocessConnectionTests interprocessConnectionTests;
+
+#endif
+
 } // namespace juce
@@ -115,6 +115,21 @@ public:
     */
     bool createPipe (const String& pipeName, int pipeReceiveMessageTimeoutMs, bool mustNotExist = false);
 
+    /** Makes this connection use a shared SocketReactor instead of its own thread.
+
+        Normally each connection has a thread which waits for incoming messages. When a
+        reactor is set, a socket connection is instead watched by the reactor, and its
+        messages are read by the reactor's threads as they arrive, so many connections can
+        share a few threads. This must be called before the connection is made, and the
+        reactor must outlive the connection. Pipe connections always use their own thread.
+
+        If callbacksOnMessageThread is false, the callbacks will be made on one of the
+        reactor's threads, so they shouldn't block for long.
+
+        @see InterprocessConnectionServer::setSocketReactor
+    */
+    void setSocketReactor (SocketReactor* reactorToUse);
+
     /** Disconnects and closes any currently-open sockets or pipes. */
     void disconnect();
 
@@ -183,6 +198,11 @@ private:
     const bool useMessageThread;
     const uint32 magicMessageHeader;
     int pipeReceiveMessageTimeout = -1;
+    SocketReactor* reactor = nullptr;
+    bool isRegisteredWithReactor = false;
+    MemoryBlock messageData, sendBuffer, receiveBuffer;
+    size_t numBytesReceived = 0;
+    CriticalSection reactorCallbackLock;
 
     friend class InterprocessConnectionServer;
     void initialiseWithSocket (StreamingSocket*);
@@ -192,11 +212,19 @@ private:
     void connectionLostInt();
     void deliverDataInt (const MemoryBlock&);
     bool readNextMessageInt();
+    void startReading();
+    void stopReading();
+    void handleSocketReadyForReading();
 
     struct ConnectionThread;
     friend struct ConnectionThread;
     friend struct ContainerDeletePolicy<ConnectionThread>;
     ScopedPointer<ConnectionThread> thread;
+
+    struct ReactorListener;
+    friend struct ReactorListener;
+    friend struct ContainerDeletePolicy<ReactorListener>;
+    ScopedPointer<ReactorListener> reactorListener;
     void runThread();
     int writeData (void*, int);
 
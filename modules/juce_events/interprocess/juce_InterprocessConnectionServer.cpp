@@ -66,6 +66,11 @@ int InterprocessConnectionServer::getBoundPort() const noexcept
     return (socket == nullptr) ? -1 : socket->getBoundPort();
 }
 
+void InterprocessConnectionServer::setSocketReactor (SocketReactor* reactorForConnections) noexcept
+{
+    connectionReactor = reactorForConnections;
+}
+
 void InterprocessConnectionServer::run()
 {
     while ((! threadShouldExit()) && socket != nullptr)
@@ -73,8 +78,15 @@ void InterprocessConnectionServer::run()
         ScopedPointer<StreamingSocket> clientSocket (socket->waitForNextConnection());
 
         if (clientSocket != nullptr)
+        {
             if (InterprocessConnection* newConnection = createConnectionObject())
+            {
+                if (newConnection->reactor == nullptr)
+                    newConnection->setSocketReactor (connectionReactor);
+
                 newConnection->initialiseWithSocket (clientSocket.release());
+            }
+        }
     }
 }
 
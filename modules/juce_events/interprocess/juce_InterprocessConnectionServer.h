@@ -80,6 +80,15 @@ public:
     */
     int getBoundPort() const noexcept;
 
+    /** Sets a SocketReactor to be used by the connections that this server creates.
+
+        Rather than each connection having its own thread, their sockets will be watched
+        by the reactor, which must outlive all of the connections.
+
+        @see InterprocessConnection::setSocketReactor
+    */
+    void setSocketReactor (SocketReactor* reactorForConnections) noexcept;
+
 protected:
     /** Creates a suitable connection object for a client process that wants to
         connect to this one.
@@ -95,6 +104,7 @@ protected:
 private:
     //==============================================================================
     ScopedPointer<StreamingSocket> socket;
+    SocketReactor* connectionReactor = nullptr;
 
     void run() override;
 
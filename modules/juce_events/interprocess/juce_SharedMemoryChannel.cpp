@@ -0,0 +1,475 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+struct SharedMemoryChannel::Ring
+{
+    // the positions are free-running byte counts, which are masked to find the
+    // offset in the ring. Each is only changed by one side, and they're kept on
+    // separate cache lines so that the two sides don't contend for them.
+    Atomic<uint32> writePosition;
+    char padding1[60];
+    Atomic<uint32> readPosition;
+    char padding2[60];
+    Atomic<int> wakeCount, numWaiters;
+    char padding3[56];
+};
+
+struct SharedMemoryChannel::Header
+{
+    enum { magicValue = 0x4a53484d, headerSize = 1024 };
+
+    uint32 magic;
+    uint32 ringSize;
+    Atomic<int> closed;
+    char padding[52];
+    Ring rings[2];
+
+    int64 getTotalSize() const noexcept     { return (int64) headerSize + 2 * (int64) ringSize; }
+};
+
+namespace
+{
+    static const uint32 wrapMarker = 0xffffffff;
+    static const int numSpinsBeforeSleeping = 256;
+
+    static uint32 getRecordSize (uint32 numBytes) noexcept     { return (numBytes + 4 + 7) & ~(uint32) 7; }
+
+    static void wakeWaitingReader (Atomic<int>& wakeCount, Atomic<int>& numWaiters, bool wakeAll) noexcept
+    {
+        if (numWaiters.get() > 0 || wakeAll)
+        {
+            ++wakeCount;
+
+           #if JUCE_LINUX
+            // (these futexes aren't private, because they're shared with another process)
+            syscall (SYS_futex, reinterpret_cast<int*> (&wakeCount), FUTEX_WAKE, wakeAll ? std::numeric_limits<int>::max() : 1, nullptr, nullptr, 0);
+           #endif
+        }
+    }
+
+    static void sleepUntilWoken (Atomic<int>& wakeCount, int expectedCount, int timeoutMs) noexcept
+    {
+       #if JUCE_LINUX
+        struct timespec timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (timeoutMs % 1000) * 1000000;
+
+        syscall (SYS_futex, reinterpret_cast<int*> (&wakeCount), FUTEX_WAIT, expectedCount,
+                 timeoutMs >= 0 ? &timeout : nullptr, nullptr, 0);
+       #else
+        ignoreUnused (wakeCount, expectedCount, timeoutMs);
+        Thread::sleep (1);
+       #endif
+    }
+}
+
+//==============================================================================
+SharedMemoryChannel::SharedMemoryChannel (const File& f, int ringSizeInBytes)
+    : file (f), ownsFile (true)
+{
+    static_assert (sizeof (Atomic<int>) == sizeof (int), "the futex needs to be a plain int");
+    static_assert (sizeof (Header) <= Header::headerSize, "the header has grown too large");
+
+    auto ringSize = (uint32) nextPowerOfTwo (jmax (4096, ringSizeInBytes));
+
+    file.deleteFile();
+
+    {
+        FileOutputStream out (file);
+
+        if (out.failedToOpen()
+             || ! out.setPosition ((int64) Header::headerSize + 2 * (int64) ringSize - 1)
+             || ! out.writeByte (0))
+            return;
+    }
+
+    if (openMappedFile())
+    {
+        header->ringSize = ringSize;
+        header->closed = 0;
+
+        for (auto& ring : header->rings)
+        {
+            ring.writePosition = 0;
+            ring.readPosition = 0;
+            ring.wakeCount = 0;
+            ring.numWaiters = 0;
+        }
+
+        // the magic number goes in last, so another process can't open a half-written header
+        header->closed.memoryBarrier();
+        header->magic = (uint32) Header::magicValue;
+
+        connectRings (true);
+    }
+}
+
+SharedMemoryChannel::SharedMemoryChannel (const File& f)  : file (f)
+{
+    if (openMappedFile())
+    {
+        if (header->magic != (uint32) Header::magicValue
+             || header->ringSize < 4096 || ! isPowerOfTwo (header->ringSize)
+             || (int64) mappedFile->getSize() < header->getTotalSize())
+        {
+            header = nullptr;
+            mappedFile = nullptr;
+            return;
+        }
+
+        connectRings (false);
+    }
+}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+    if (header != nullptr)
+    {
+        header->closed = 1;
+
+        for (auto& ring : header->rings)
+            wakeWaitingReader (ring.wakeCount, ring.numWaiters, true);
+    }
+
+    header = nullptr;
+    mappedFile = nullptr;
+
+    if (ownsFile)
+        file.deleteFile();
+}
+
+bool SharedMemoryChannel::openMappedFile()
+{
+    mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readWrite);
+
+    if (mappedFile->getData() == nullptr || mappedFile->getSize() < (size_t) Header::headerSize)
+    {
+        mappedFile = nullptr;
+        return false;
+    }
+
+    header = static_cast<Header*> (mappedFile->getData());
+    return true;
+}
+
+void SharedMemoryChannel::connectRings (bool isCreator) noexcept
+{
+    // the creator writes into the first ring and reads from the second
+    auto* ringData = static_cast<char*> (mappedFile->getData()) + Header::headerSize;
+
+    outgoing     = header->rings + (isCreator ? 0 : 1);
+    incoming     = header->rings + (isCreator ? 1 : 0);
+    outgoingData = ringData + (isCreator ? 0 : header->ringSize);
+    incomingData = ringData + (isCreator ? header->ringSize : 0);
+}
+
+bool SharedMemoryChannel::isClosed() const noexcept
+{
+    return header == nullptr || header->closed.get() != 0;
+}
+
+int SharedMemoryChannel::getMaxMessageSize() const noexcept
+{
+    return header != nullptr ? (int) (header->ringSize / 2 - 8) : 0;
+}
+
+//==============================================================================
+bool SharedMemoryChannel::write (const void* data, int numBytes) noexcept
+{
+    if (isClosed() || numBytes <= 0 || numBytes > getMaxMessageSize())
+        return false;
+
+    auto ringSize = header->ringSize;
+    auto recordSize = getRecordSize ((uint32) numBytes);
+    auto writePosition = outgoing->writePosition.get();
+    auto offset = writePosition & (ringSize - 1);
+    auto spaceAtEnd = ringSize - offset;
+
+    // a record is never split across the end of the ring: if it doesn't fit, the rest
+    // of the ring is skipped, and it goes at the start instead
+    auto spaceNeeded = recordSize + (recordSize > spaceAtEnd ? spaceAtEnd : 0);
+
+    if (ringSize - (writePosition - outgoing->readPosition.get()) < spaceNeeded)
+        return false;
+
+    if (recordSize > spaceAtEnd)
+    {
+        const uint32 marker = wrapMarker;
+        memcpy (outgoingData + offset, &marker, 4);
+        writePosition += spaceAtEnd;
+        offset = 0;
+    }
+
+    auto size = (uint32) numBytes;
+    memcpy (outgoingData + offset, &size, 4);
+    memcpy (outgoingData + offset + 4, data, (size_t) numBytes);
+
+    outgoing->writePosition = writePosition + recordSize;
+    wakeWaitingReader (outgoing->wakeCount, outgoing->numWaiters, false);
+    return true;
+}
+
+const void* SharedMemoryChannel::waitForMessage (int& numBytes, int timeoutMs) noexcept
+{
+    // you need to call finishedReading() before waiting for another message!
+    jassert (pendingReadSize == 0);
+
+    if (header == nullptr)
+        return nullptr;
+
+    auto ringSize = header->ringSize;
+    auto endTime = Time::getMillisecondCounter() + (uint32) jmax (0, timeoutMs);
+
+    for (int numSpins = 0;; ++numSpins)
+    {
+        auto readPosition = incoming->readPosition.get();
+
+        if (incoming->writePosition.get() != readPosition)
+        {
+            auto offset = readPosition & (ringSize - 1);
+            uint32 size;
+            memcpy (&size, incomingData + offset, 4);
+
+            if (size == wrapMarker)
+            {
+                incoming->readPosition = readPosition + (ringSize - offset);
+                continue;
+            }
+
+            numBytes = (int) size;
+            pendingReadSize = getRecordSize (size);
+            return incomingData + offset + 4;
+        }
+
+        if (header->closed.get() != 0)
+            return nullptr;
+
+        if (numSpins < numSpinsBeforeSleeping)
+            continue;
+
+        int msToWait = -1;
+
+        if (timeoutMs >= 0)
+        {
+            auto now = Time::getMillisecondCounter();
+
+            if (now >= endTime)
+                return nullptr;
+
+            msToWait = (int) (endTime - now);
+        }
+
+        // once the writer can see that we're waiting, we check again, so that a message
+        // which arrived in between can't be missed
+        ++(incoming->numWaiters);
+        auto wakeCount = incoming->wakeCount.get();
+
+        if (incoming->writePosition.get() == readPosition && header->closed.get() == 0)
+            sleepUntilWoken (incoming->wakeCount, wakeCount, msToWait);
+
+        --(incoming->numWaiters);
+    }
+}
+
+void SharedMemoryChannel::finishedReading() noexcept
+{
+    if (header != nullptr && pendingReadSize > 0)
+    {
+        incoming->readPosition = incoming->readPosition.get() + pendingReadSize;
+        pendingReadSize = 0;
+    }
+}
+
+int SharedMemoryChannel::read (void* destBuffer, int maxBytes, int timeoutMs) noexcept
+{
+    int numBytes = 0;
+
+    if (auto* data = waitForMessage (numBytes, timeoutMs))
+    {
+        if (numBytes <= maxBytes)
+            memcpy (destBuffer, data, (size_t) numBytes);
+        else
+            numBytes = -1;
+
+        finishedReading();
+        return numBytes;
+    }
+
+    return 0;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SharedMemoryChannelTests  : public UnitTest
+{
+public:
+    SharedMemoryChannelTests() : UnitTest ("SharedMemoryChannel", "Interprocess") {}
+
+    static File createTempFile()
+    {
+        return File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("SharedMemoryChannelTest", ".tmp");
+    }
+
+    static void fillWithPattern (HeapBlock<char>& data, int numBytes, int seed)
+    {
+        for (int i = 0; i < numBytes; ++i)
+            data[i] = (char) (i * 31 + seed);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Messages in both directions, wrapping around the ring");
+        {
+            auto file = createTempFile();
+            SharedMemoryChannel creator (file, 4096);
+            SharedMemoryChannel opener (file);
+
+            expect (creator.isValid() && opener.isValid());
+            expectEquals (creator.getMaxMessageSize(), 2040);
+            expect (! creator.write ("x", 0));
+            expect (! creator.write (nullptr, creator.getMaxMessageSize() + 1));
+
+            Random r = getRandom();
+            HeapBlock<char> sent (4096), received (4096);
+
+            // (with a 4K ring, messages this size wrap round every few writes)
+            for (int i = 0; i < 500; ++i)
+            {
+                auto numBytes = 1 + r.nextInt (1500);
+                fillWithPattern (sent, numBytes, i);
+
+                auto& from = (i & 1) == 0 ? creator : opener;
+                auto& to   = (i & 1) == 0 ? opener : creator;
+
+                expect (from.write (sent, numBytes));
+                expectEquals (to.read (received, 4096, 0), numBytes);
+                expect (memcmp (sent, received, (size_t) numBytes) == 0);
+            }
+        }
+
+        beginTest ("A full ring");
+        {
+            auto file = createTempFile();
+            SharedMemoryChannel creator (file, 4096);
+            SharedMemoryChannel opener (file);
+            HeapBlock<char> data (1000);
+
+            int numWritten = 0;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                fillWithPattern (data, 1000, i);
+
+                if (creator.write (data, 1000))
+                    ++numWritten;
+            }
+
+            expectEquals (numWritten, 4);
+
+            // once a message has been read, there's room for another
+            HeapBlock<char> received (1000);
+            expectEquals (opener.read (received, 1000, 0), 1000);
+            fillWithPattern (data, 1000, 0);
+            expect (memcmp (data, received, 1000) == 0);
+            expect (creator.write (data, 1000));
+        }
+
+        beginTest ("Oversized messages and zero-copy reads");
+        {
+            auto file = createTempFile();
+            SharedMemoryChannel creator (file, 4096);
+            SharedMemoryChannel opener (file);
+
+            HeapBlock<char> data (1500);
+            fillWithPattern (data, 1500, 7);
+            expect (creator.write (data, 1500));
+            expect (creator.write ("abc", 3));
+
+            char small[100];
+            expectEquals (opener.read (small, sizeof (small), 0), -1);
+
+            // the oversized message is discarded, but the next one is still there
+            int numBytes = 0;
+            auto* message = static_cast<const char*> (opener.waitForMessage (numBytes, 0));
+            expect (message != nullptr && numBytes == 3 && memcmp (message, "abc", 3) == 0);
+            opener.finishedReading();
+
+            expect (opener.waitForMessage (numBytes, 0) == nullptr);
+        }
+
+        beginTest ("Timeouts");
+        {
+            auto file = createTempFile();
+            SharedMemoryChannel creator (file, 4096);
+            SharedMemoryChannel opener (file);
+            char buffer[16];
+
+            auto startTime = Time::getMillisecondCounter();
+            expectEquals (opener.read (buffer, sizeof (buffer), 50), 0);
+            expect (Time::getMillisecondCounter() - startTime >= 40);
+        }
+
+        beginTest ("Closing the channel wakes a waiting reader");
+        {
+            auto file = createTempFile();
+            ScopedPointer<SharedMemoryChannel> creator (new SharedMemoryChannel (file, 4096));
+            SharedMemoryChannel opener (file);
+
+            struct ReaderThread  : public Thread
+            {
+                ReaderThread (SharedMemoryChannel& c)  : Thread ("SharedMemoryChannel reader"), channel (c) {}
+
+                void run() override
+                {
+                    char buffer[16];
+                    result = channel.read (buffer, sizeof (buffer), -1);
+                }
+
+                SharedMemoryChannel& channel;
+                int result = -2;
+            };
+
+            ReaderThread reader (opener);
+            reader.startThread();
+            Thread::sleep (50);
+            expect (reader.isThreadRunning());
+
+            creator = nullptr;
+
+            expect (reader.waitForThreadToExit (5000));
+            expectEquals (reader.result, 0);
+            expect (opener.isClosed());
+            expect (! opener.write ("abc", 3));
+        }
+    }
+};
+
+static SharedMemoryChannelTests sharedMemoryChannelTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A two-way channel between two processes, made from a pair of lock-free
+    single-producer, single-consumer ring buffers in a memory-mapped file.
+
+    This is intended for passing data such as audio buffers between processes at a
+    high rate and with low latency, where sending them through a pipe or socket would
+    cost too much. One process creates the channel, and the other opens the same file;
+    each side then writes into one ring and reads from the other.
+
+    Writing never blocks or allocates, so write() can be called from a realtime thread.
+    A reader waiting for a message spins briefly and then sleeps: on Linux it uses a
+    futex in the shared memory, so a writer can wake it directly, and elsewhere it polls
+    with short sleeps.
+
+    Each ring has a single writer and a single reader, so only one thread on each side
+    should be writing, and one reading, at any time.
+
+    @see ChildProcessMaster::openSharedMemoryChannel, InterprocessConnection
+*/
+class JUCE_API  SharedMemoryChannel
+{
+public:
+    //==============================================================================
+    /** Creates a new channel, replacing any existing file at the given location.
+
+        Each direction gets a ring of ringSizeInBytes, which is rounded up to a power
+        of two. The largest message that can be sent is a little under half of this.
+        If the file can't be created, isValid() will return false.
+    */
+    SharedMemoryChannel (const File& file, int ringSizeInBytes);
+
+    /** Opens a channel that was created by another process.
+        If the file doesn't exist or isn't a valid channel, isValid() will return false.
+    */
+    explicit SharedMemoryChannel (const File& file);
+
+    /** Destructor.
+        This closes the channel, waking up any reader that's waiting on either side. If
+        this object created the file, it'll be deleted.
+    */
+    ~SharedMemoryChannel();
+
+    //==============================================================================
+    /** Returns true if the shared memory was successfully created or opened. */
+    bool isValid() const noexcept                       { return header != nullptr; }
+
+    /** Returns true if either side has closed the channel. */
+    bool isClosed() const noexcept;
+
+    /** Returns the file that holds the shared memory. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the size of the largest message that can be written. */
+    int getMaxMessageSize() const noexcept;
+
+    //==============================================================================
+    /** Writes a message for the other side to read.
+
+        This doesn't block or allocate, so it can be used on a realtime thread.
+        Returns false if there isn't room in the ring for the message, if the message
+        is empty or too large, or if the channel has been closed.
+    */
+    bool write (const void* data, int numBytes) noexcept;
+
+    /** Waits for a message from the other side, and copies it into a buffer.
+
+        A negative timeout will wait forever, or until the channel is closed.
+
+        @returns the size of the message, or 0 if nothing arrived before the timeout
+                 (or the channel was closed), or -1 if the message was larger than
+                 maxBytes, in which case it is discarded.
+    */
+    int read (void* destBuffer, int maxBytes, int timeoutMs) noexcept;
+
+    /** Waits for a message from the other side, and returns a pointer to it in the
+        shared memory, so that it can be read without copying.
+
+        If a message arrives before the timeout, this returns a pointer to its data and
+        sets numBytes to its size. The data remains valid until finishedReading() is
+        called, which must be done before waiting for the next message. Returns nullptr
+        on timeout, or if the channel has been closed. A negative timeout will wait
+        forever, or until the channel is closed.
+    */
+    const void* waitForMessage (int& numBytes, int timeoutMs) noexcept;
+
+    /** Releases the message returned by waitForMessage(). */
+    void finishedReading() noexcept;
+
+private:
+    //==============================================================================
+    struct Header;
+    struct Ring;
+
+    File file;
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    Header* header = nullptr;
+    Ring* incoming = nullptr;
+    Ring* outgoing = nullptr;
+    char* incomingData = nullptr;
+    char* outgoingData = nullptr;
+    uint32 pendingReadSize = 0;
+    bool ownsFile = false;
+
+    bool openMappedFile();
+    void connectRings (bool isCreator) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedMemoryChannel)
+};
+
+} // namespace juce
@@ -51,6 +51,8 @@
 
 #elif JUCE_LINUX
  #include <unistd.h>
+ #include <sys/syscall.h>
+ #include <linux/futex.h>
 #endif
 
 //==============================================================================
@@ -65,6 +67,7 @@
 #include "timers/juce_Timer.cpp"
 #include "interprocess/juce_InterprocessConnection.cpp"
 #include "interprocess/juce_InterprocessConnectionServer.cpp"
+#include "interprocess/juce_SharedMemoryChannel.cpp"
 #include "interprocess/juce_ConnectedChildProcess.cpp"
 
 //==============================================================================
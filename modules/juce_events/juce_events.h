@@ -80,6 +80,7 @@
 #include "timers/juce_MultiTimer.h"
 #include "interprocess/juce_InterprocessConnection.h"
 #include "interprocess/juce_InterprocessConnectionServer.h"
+#include "interprocess/juce_SharedMemoryChannel.h"
 #include "interprocess/juce_ConnectedChildProcess.h"
 
 #if JUCE_LINUX
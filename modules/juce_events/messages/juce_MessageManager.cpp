@@ -140,6 +140,11 @@ void MessageManager::stopDispatchLoop()
 
 #endif
 
+#if ! JUCE_LINUX
+MessageManager::QueueStatistics MessageManager::getQueueStatistics()    { return {}; }
+void MessageManager::resetQueueStatistics()                             {}
+#endif
+
 //==============================================================================
 class AsyncFunctionCallback   : public MessageManager::MessageBase
 {
@@ -166,6 +166,30 @@ public:
     /** Deregisters a broadcast listener. */
     void deregisterBroadcastListener (ActionListener* listener);
 
+    //==============================================================================
+    /** Statistics about the traffic through the message queue.
+        @see getQueueStatistics
+    */
+    struct QueueStatistics
+    {
+        int64 numMessagesPosted = 0;        /**< The number of messages that have been posted. */
+        int64 numMessagesDispatched = 0;    /**< The number of messages that have been delivered. */
+        int currentDepth = 0;               /**< The number of messages currently waiting in the queue. */
+        int maxDepth = 0;                   /**< The largest number of messages that have been waiting at once. */
+        double averageLatencyMs = 0;        /**< The mean time between posting and delivering a message. */
+        double maxLatencyMs = 0;            /**< The longest time between posting and delivering a message. */
+    };
+
+    /** Returns statistics about the messages that have passed through the queue since the
+        MessageManager was created, or since resetQueueStatistics() was last called.
+
+        This is currently only implemented on Linux - elsewhere the values will all be zero.
+    */
+    static QueueStatistics getQueueStatistics();
+
+    /** Resets the values returned by getQueueStatistics(). */
+    static void resetQueueStatistics();
+
     //==============================================================================
     /** Internal class used as the base class for all message objects.
         You shouldn't need to use this directly - see the CallbackMessage or Message
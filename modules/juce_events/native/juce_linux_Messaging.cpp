@@ -21,6 +21,7 @@
 */
 
 #include <poll.h>
+#include <sys/eventfd.h>
 
 enum FdType
 {
@@ -33,17 +34,26 @@ namespace juce
 {
 
 //==============================================================================
+/*  Messages can be posted by any thread, but are only removed by the message thread, so
+    the queue is a lock-free stack which producers push onto, and which the message thread
+    empties in one go, reversing it into a local list to get the messages back in order.
+
+    The eventfd is only written when a message is added to an empty stack, so a burst of
+    posts costs a single wakeup, and the message thread then dispatches the whole batch
+    without any further locking or system calls.
+*/
 class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
+        : nodePool (sizeof (Node), 4096)
     {
-        auto ret = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, fd);
-        ignoreUnused (ret); jassert (ret == 0);
+        fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+        jassert (fd >= 0);
 
-        auto internalQueueCb = [this] (int _fd)
+        auto internalQueueCb = [this] (int)
         {
-            if (const MessageManager::MessageBase::Ptr msg = this->popNextMessage (_fd))
+            if (const MessageManager::MessageBase::Ptr msg = this->popNextMessage())
             {
                 JUCE_TRY
                 {
@@ -55,15 +65,17 @@ public:
             return false;
         };
 
-        pfds[INTERNAL_QUEUE_FD].fd = getReadHandle();
+        pfds[INTERNAL_QUEUE_FD].fd = fd;
         pfds[INTERNAL_QUEUE_FD].events = POLLIN;
         readCallback[INTERNAL_QUEUE_FD] = new LinuxEventLoop::CallbackFunction<decltype(internalQueueCb)> (internalQueueCb);
     }
 
     ~InternalMessageQueue()
     {
-        close (getReadHandle());
-        close (getWriteHandle());
+        while (popNextMessage() != nullptr)
+        {}
+
+        close (fd);
 
         clearSingletonInstance();
     }
@@ -71,19 +83,35 @@ public:
     //==============================================================================
     void postMessage (MessageManager::MessageBase* const msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
+        msg->incReferenceCount();
+
+        auto* node = new (nodePool.allocate()) Node();
+        node->message = msg;
+        node->timePosted = Time::getHighResolutionTicks();
 
-        const int maxBytesInSocketQueue = 128;
+        auto depth = ++numPending;
 
-        if (bytesInSocket < maxBytesInSocketQueue)
+        if (depth > maxDepth.get())
+            maxDepth = depth;
+
+        ++numPosted;
+
+        for (;;)
         {
-            bytesInSocket++;
+            auto* head = incoming.get();
+            node->next = head;
+
+            if (incoming.compareAndSetBool (node, head))
+            {
+                if (head == nullptr)
+                {
+                    const uint64 one = 1;
+                    ssize_t bytesWritten = write (fd, &one, sizeof (one));
+                    ignoreUnused (bytesWritten);
+                }
 
-            ScopedUnlock ul (lock);
-            const unsigned char x = 0xff;
-            ssize_t bytesWritten = write (getWriteHandle(), &x, 1);
-            ignoreUnused (bytesWritten);
+                break;
+            }
         }
     }
 
@@ -131,37 +159,101 @@ public:
         return (pnum > 0);
     }
 
+    //==============================================================================
+    MessageManager::QueueStatistics getStatistics() const noexcept
+    {
+        MessageManager::QueueStatistics stats;
+        stats.numMessagesPosted     = numPosted.get();
+        stats.numMessagesDispatched = numDispatched.get();
+        stats.currentDepth          = numPending.get();
+        stats.maxDepth              = maxDepth.get();
+        stats.maxLatencyMs          = Time::highResolutionTicksToSeconds (maxLatencyTicks.get()) * 1000.0;
+
+        if (stats.numMessagesDispatched > 0)
+            stats.averageLatencyMs = Time::highResolutionTicksToSeconds (totalLatencyTicks.get()) * 1000.0
+                                        / (double) stats.numMessagesDispatched;
+
+        return stats;
+    }
+
+    void resetStatistics() noexcept
+    {
+        numPosted = 0;
+        numDispatched = 0;
+        maxDepth = numPending.get();
+        totalLatencyTicks = 0;
+        maxLatencyTicks = 0;
+    }
+
     //==============================================================================
     juce_DeclareSingleton_SingleThreaded_Minimal (InternalMessageQueue)
 
 private:
+    struct Node
+    {
+        MessageManager::MessageBase* message;
+        Node* next;
+        int64 timePosted;
+    };
+
+    FixedSizeMemoryPool nodePool;
+    Atomic<Node*> incoming;     // pushed by any thread, newest first
+    Node* pending = nullptr;    // only used by the message thread, oldest first
     CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
-    int fd[2];
+    int fd;
     pollfd pfds[FD_COUNT];
     ScopedPointer<LinuxEventLoop::CallbackFunctionBase> readCallback[FD_COUNT];
     int fdCount = 1;
     int loopCount = 0;
-    int bytesInSocket = 0;
 
-    int getWriteHandle() const noexcept     { return fd[0]; }
-    int getReadHandle() const noexcept      { return fd[1]; }
+    Atomic<int> numPending, maxDepth;
+    Atomic<int64> numPosted, numDispatched, totalLatencyTicks, maxLatencyTicks;
 
-    MessageManager::MessageBase::Ptr popNextMessage (int _fd) noexcept
+    void takeIncomingMessages() noexcept
     {
-        const ScopedLock sl (lock);
+        // The eventfd must be cleared before taking the messages, so that a message which
+        // arrives after this will write to it again
+        uint64 count;
+        ssize_t numBytes = read (fd, &count, sizeof (count));
+        ignoreUnused (numBytes);
+
+        for (auto* node = incoming.exchange (nullptr); node != nullptr;)
+        {
+            auto* next = node->next;
+            node->next = pending;
+            pending = node;
+            node = next;
+        }
+    }
 
-        if (bytesInSocket > 0)
+    MessageManager::MessageBase::Ptr popNextMessage() noexcept
+    {
+        if (pending == nullptr)
         {
-            --bytesInSocket;
+            takeIncomingMessages();
 
-            const ScopedUnlock ul (lock);
-            unsigned char x;
-            ssize_t numBytes = read (_fd, &x, 1);
-            ignoreUnused (numBytes);
+            if (pending == nullptr)
+                return nullptr;
         }
 
-        return queue.removeAndReturn (0);
+        auto* node = pending;
+        pending = node->next;
+
+        auto latency = Time::getHighResolutionTicks() - node->timePosted;
+        totalLatencyTicks += latency;
+
+        if (latency > maxLatencyTicks.get())
+            maxLatencyTicks = latency;
+
+        --numPending;
+        ++numDispatched;
+
+        MessageManager::MessageBase::Ptr msg (node->message);
+        node->message->decReferenceCount();
+
+        node->~Node();
+        nodePool.deallocate (node);
+        return msg;
     }
 };
 
@@ -224,6 +316,20 @@ void MessageManager::broadcastMessage (const String&)
     // TODO
 }
 
+MessageManager::QueueStatistics MessageManager::getQueueStatistics()
+{
+    if (auto* queue = InternalMessageQueue::getInstanceWithoutCreating())
+        return queue->getStatistics();
+
+    return {};
+}
+
+void MessageManager::resetQueueStatistics()
+{
+    if (auto* queue = InternalMessageQueue::getInstanceWithoutCreating())
+        queue->resetStatistics();
+}
+
 // this function expects that it will NEVER be called simultaneously for two concurrent threads
 bool MessageManager::dispatchNextMessageOnSystemQueue (bool returnIfNoPendingMessages)
 {
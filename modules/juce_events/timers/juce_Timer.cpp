@@ -23,6 +23,264 @@
 namespace juce
 {
 
+//==============================================================================
+/*  A hierarchical timing wheel, which keeps the running timers bucketed by their
+    absolute expiry time so that starting, stopping and re-arming a timer are all
+    O(1), no matter how many others are active.
+
+    Level 0 has a slot for each of the next 256 milliseconds, and each of the three
+    coarser levels covers 64 times the span of the one below it. Whenever level 0
+    wraps around, the next slot of the level above is cascaded down, so a timer only
+    ever moves a few times before it expires. Timers that have expired are moved onto
+    a due list, from which they are called back in expiry order.
+
+    The owner must hold the lock when calling any of these methods.
+*/
+struct Timer::TimerWheel
+{
+    TimerWheel (CriticalSection& l, bool isForTimerService) noexcept
+        : lock (l), isServiceWheel (isForTimerService), currentTime (Time::getMillisecondCounter())
+    {
+    }
+
+    ~TimerWheel()
+    {
+        detachAll (false);
+    }
+
+    /** Unlinks every timer, optionally also marking them as stopped. */
+    void detachAll (bool stopTimers) noexcept
+    {
+        for (auto& s : slots)
+        {
+            for (auto* t = s.first; t != nullptr;)
+            {
+                auto* next = t->nextTimer;
+                t->previousTimer = nullptr;
+                t->nextTimer = nullptr;
+                t->timerSlot = -1;
+
+                if (stopTimers)
+                {
+                    t->timerPeriodMs = 0;
+                    t->timerService = nullptr;
+                }
+
+                t = next;
+            }
+
+            s = {};
+        }
+
+        numScheduled = 0;
+    }
+
+    void add (Timer* t, uint32 expiryTime) noexcept
+    {
+        // trying to add a timer that's already here - shouldn't get to this point,
+        // so if you get this assertion, let me know!
+        jassert (t->timerSlot < 0);
+
+        t->timerExpiryTime = expiryTime;
+        auto delta = (int) (expiryTime - currentTime);
+        int slot;
+
+        if (delta <= 0)
+        {
+            slot = dueSlot;
+        }
+        else
+        {
+            ++numScheduled;
+
+            if (delta < (1 << 8))
+            {
+                slot = (int) (expiryTime & 255);
+            }
+            else if (delta < (1 << 14))
+            {
+                slot = 256 + (int) ((expiryTime >> 8) & 63);
+            }
+            else if (delta < (1 << 20))
+            {
+                slot = 320 + (int) ((expiryTime >> 14) & 63);
+            }
+            else
+            {
+                // anything further away than the top level can hold gets parked in
+                // its furthest slot, and will be re-filed when that slot cascades
+                if (delta >= (1 << 26))
+                    expiryTime = currentTime + (uint32) ((1 << 26) - 1);
+
+                slot = 384 + (int) ((expiryTime >> 20) & 63);
+            }
+        }
+
+        append (t, slot);
+    }
+
+    void remove (Timer* t) noexcept
+    {
+        if (t->timerSlot < 0)
+            return;
+
+        auto& s = slots[t->timerSlot];
+
+        if (t->previousTimer != nullptr)  t->previousTimer->nextTimer = t->nextTimer;
+        else                              s.first = t->nextTimer;
+
+        if (t->nextTimer != nullptr)      t->nextTimer->previousTimer = t->previousTimer;
+        else                              s.last = t->previousTimer;
+
+        if (t->timerSlot != dueSlot)
+            --numScheduled;
+
+        t->nextTimer = nullptr;
+        t->previousTimer = nullptr;
+        t->timerSlot = -1;
+    }
+
+    /** Moves the wheel forward, transferring any timers that expire along the way onto the due list. */
+    void advanceTo (uint32 now) noexcept
+    {
+        while ((int) (now - currentTime) > 0)
+        {
+            if (numScheduled == 0)
+            {
+                currentTime = now;
+                break;
+            }
+
+            ++currentTime;
+
+            if ((currentTime & 255) == 0)
+            {
+                if (((currentTime >> 8) & 63) == 0)
+                {
+                    if (((currentTime >> 14) & 63) == 0)
+                        cascade (384 + (int) ((currentTime >> 20) & 63));
+
+                    cascade (320 + (int) ((currentTime >> 14) & 63));
+                }
+
+                cascade (256 + (int) ((currentTime >> 8) & 63));
+            }
+
+            auto& s = slots[currentTime & 255];
+
+            while (auto* t = s.first)
+            {
+                remove (t);
+                append (t, dueSlot);
+            }
+        }
+    }
+
+    /** Returns how long the owner can sleep before the wheel next needs advancing. */
+    int getMillisecondsUntilNextTimer() const noexcept
+    {
+        if (slots[dueSlot].first != nullptr)
+            return 0;
+
+        if (numScheduled == 0)
+            return 1000;
+
+        // the wheel must also be woken when level 0 wraps, in case cascading
+        // brings down something that's due soon
+        auto limit = jmin (100, 256 - (int) (currentTime & 255));
+
+        for (int i = 1; i < limit; ++i)
+            if (slots[(currentTime + (uint32) i) & 255].first != nullptr)
+                return i;
+
+        return limit;
+    }
+
+    /** Makes the callbacks for any timers that have expired, re-arming each one before it's called. */
+    void callDueTimers (uint32 now)
+    {
+        // avoid getting stuck in a loop if a timer callback repeatedly takes too long
+        auto timeout = Time::getMillisecondCounter() + 100;
+
+        const ScopedLock sl (lock);
+        advanceTo (now);
+
+        while (auto* t = slots[dueSlot].first)
+        {
+            remove (t);
+            add (t, currentTime + (uint32) t->timerPeriodMs);
+
+            // lets stopTimer() on another thread know that it has to wait for this callback
+            if (isServiceWheel)
+                t->serviceThreadInCallback = Thread::getCurrentThreadId();
+
+            {
+                const ScopedUnlock ul (lock);
+
+                JUCE_TRY
+                {
+                    t->timerCallback();
+                }
+                JUCE_CATCH_EXCEPTION
+            }
+
+            // (the timer may be deleted as soon as this is cleared)
+            if (isServiceWheel)
+                t->serviceThreadInCallback = nullptr;
+
+            if (Time::getMillisecondCounter() > timeout)
+                break;
+        }
+    }
+
+    CriticalSection& lock;
+    const bool isServiceWheel;
+
+private:
+    struct Slot
+    {
+        Timer* first = nullptr;
+        Timer* last = nullptr;
+    };
+
+    enum { dueSlot = 448 };
+
+    Slot slots[dueSlot + 1];
+    uint32 currentTime;
+    int numScheduled = 0;
+
+    void append (Timer* t, int slot) noexcept
+    {
+        auto& s = slots[slot];
+        t->timerSlot = slot;
+        t->nextTimer = nullptr;
+        t->previousTimer = s.last;
+
+        if (s.last != nullptr)  s.last->nextTimer = t;
+        else                    s.first = t;
+
+        s.last = t;
+    }
+
+    void cascade (int slot) noexcept
+    {
+        auto* t = slots[slot].first;
+        slots[slot] = {};
+
+        while (t != nullptr)
+        {
+            auto* next = t->nextTimer;
+            t->timerSlot = -1;
+            --numScheduled;
+            add (t, t->timerExpiryTime);
+            t = next;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TimerWheel)
+};
+
+//==============================================================================
 class Timer::TimerThread  : private Thread,
                             private DeletedAtShutdown,
                             private AsyncUpdater
@@ -30,7 +288,7 @@ class Timer::TimerThread  : private Thread,
 public:
     typedef CriticalSection LockType; // (mysteriously, using a SpinLock here causes problems on some XP machines..)
 
-    TimerThread()  : Thread ("Juce Timer")
+    TimerThread()  : Thread ("Juce Timer"), wheel (lock, false)
     {
         triggerAsyncUpdate();
     }
@@ -48,17 +306,17 @@ public:
 
     void run() override
     {
-        auto lastTime = Time::getMillisecondCounter();
         MessageManager::MessageBase::Ptr messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            auto now = Time::getMillisecondCounter();
-            auto elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                  : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
+            int timeUntilFirstTimer;
 
-            auto timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
+            {
+                const LockType::ScopedLockType sl (lock);
+                wheel.advanceTo (Time::getMillisecondCounter());
+                timeUntilFirstTimer = wheel.getMillisecondsUntilNextTimer();
+            }
 
             if (timeUntilFirstTimer <= 0)
             {
@@ -90,31 +348,7 @@ public:
 
     void callTimers()
     {
-        // avoid getting stuck in a loop if a timer callback repeatedly takes too long
-        auto timeout = Time::getMillisecondCounter() + 100;
-
-        const LockType::ScopedLockType sl (lock);
-
-        while (firstTimer != nullptr && firstTimer->timerCountdownMs <= 0)
-        {
-            auto* t = firstTimer;
-            t->timerCountdownMs = t->timerPeriodMs;
-
-            removeTimer (t);
-            addTimer (t);
-
-            const LockType::ScopedUnlockType ul (lock);
-
-            JUCE_TRY
-            {
-                t->timerCallback();
-            }
-            JUCE_CATCH_EXCEPTION
-
-            if (Time::getMillisecondCounter() > timeout)
-                break;
-        }
-
+        wheel.callDueTimers (Time::getMillisecondCounter());
         callbackArrived.signal();
     }
 
@@ -131,41 +365,26 @@ public:
         callTimers();
     }
 
-    static inline void add (Timer* tim) noexcept
+    static inline void add (Timer* tim, int interval) noexcept
     {
         if (instance == nullptr)
             instance = new TimerThread();
 
-        instance->addTimer (tim);
+        instance->wheel.add (tim, Time::getMillisecondCounter() + (uint32) interval);
+        instance->notify();
     }
 
     static inline void remove (Timer* tim) noexcept
     {
         if (instance != nullptr)
-            instance->removeTimer (tim);
-    }
-
-    static inline void resetCounter (Timer* tim, int newCounter) noexcept
-    {
-        if (instance != nullptr)
-        {
-            tim->timerCountdownMs = newCounter;
-            tim->timerPeriodMs = newCounter;
-
-            if ((tim->nextTimer != nullptr && tim->nextTimer->timerCountdownMs < tim->timerCountdownMs)
-                 || (tim->previousTimer != nullptr && tim->previousTimer->timerCountdownMs > tim->timerCountdownMs))
-            {
-                instance->removeTimer (tim);
-                instance->addTimer (tim);
-            }
-        }
+            instance->wheel.remove (tim);
     }
 
     static TimerThread* instance;
     static LockType lock;
 
 private:
-    Timer* firstTimer = nullptr;
+    TimerWheel wheel;
     WaitableEvent callbackArrived;
 
     struct CallTimersMessage  : public MessageManager::MessageBase
@@ -179,100 +398,52 @@ private:
         }
     };
 
-    //==============================================================================
-    void addTimer (Timer* t) noexcept
+    void handleAsyncUpdate() override
     {
-       #if JUCE_DEBUG
-        // trying to add a timer that's already here - shouldn't get to this point,
-        // so if you get this assertion, let me know!
-        jassert (! timerExists (t));
-       #endif
-
-        auto* i = firstTimer;
-
-        if (i == nullptr || i->timerCountdownMs > t->timerCountdownMs)
-        {
-            t->nextTimer = firstTimer;
-            firstTimer = t;
-        }
-        else
-        {
-            while (i->nextTimer != nullptr && i->nextTimer->timerCountdownMs <= t->timerCountdownMs)
-                i = i->nextTimer;
+        startThread (7);
+    }
 
-            jassert (i != nullptr);
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimerThread)
+};
 
-            t->nextTimer = i->nextTimer;
-            t->previousTimer = i;
-            i->nextTimer = t;
-        }
+Timer::TimerThread* Timer::TimerThread::instance = nullptr;
+Timer::TimerThread::LockType Timer::TimerThread::lock;
 
-        if (auto* next = t->nextTimer)
-            next->previousTimer = t;
+//==============================================================================
+TimerService::TimerService (const String& name, int priority)
+    : Thread (name), wheel (new Timer::TimerWheel (lock, true))
+{
+    startThread (priority);
+}
 
-        jassert ((t->nextTimer == nullptr || t->nextTimer->timerCountdownMs >= t->timerCountdownMs)
-                  && (t->previousTimer == nullptr || t->previousTimer->timerCountdownMs <= t->timerCountdownMs));
+TimerService::~TimerService()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread (4000);
 
-        notify();
-    }
+    const ScopedLock sl (lock);
+    wheel->detachAll (true);
+}
 
-    void removeTimer (Timer* t) noexcept
+void TimerService::run()
+{
+    while (! threadShouldExit())
     {
-       #if JUCE_DEBUG
-        // trying to remove a timer that's not here - shouldn't get to this point,
-        // so if you get this assertion, let me know!
-        jassert (timerExists (t));
-       #endif
+        wheel->callDueTimers (Time::getMillisecondCounter());
+
+        int timeUntilFirstTimer;
 
-        if (t->previousTimer != nullptr)
-        {
-            jassert (firstTimer != t);
-            t->previousTimer->nextTimer = t->nextTimer;
-        }
-        else
         {
-            jassert (firstTimer == t);
-            firstTimer = t->nextTimer;
+            const ScopedLock sl (lock);
+            wheel->advanceTo (Time::getMillisecondCounter());
+            timeUntilFirstTimer = wheel->getMillisecondsUntilNextTimer();
         }
 
-        if (t->nextTimer != nullptr)
-            t->nextTimer->previousTimer = t->previousTimer;
-
-        t->nextTimer = nullptr;
-        t->previousTimer = nullptr;
-    }
-
-    int getTimeUntilFirstTimer (int numMillisecsElapsed) const
-    {
-        const LockType::ScopedLockType sl (lock);
-
-        for (auto* t = firstTimer; t != nullptr; t = t->nextTimer)
-            t->timerCountdownMs -= numMillisecsElapsed;
-
-        return firstTimer != nullptr ? firstTimer->timerCountdownMs : 1000;
-    }
-
-    void handleAsyncUpdate() override
-    {
-        startThread (7);
+        if (timeUntilFirstTimer > 0)
+            wait (jmin (100, timeUntilFirstTimer));
     }
-
-   #if JUCE_DEBUG
-    bool timerExists (Timer* t) const noexcept
-    {
-        for (auto* tt = firstTimer; tt != nullptr; tt = tt->nextTimer)
-            if (tt == t)
-                return true;
-
-        return false;
-    }
-   #endif
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimerThread)
-};
-
-Timer::TimerThread* Timer::TimerThread::instance = nullptr;
-Timer::TimerThread::LockType Timer::TimerThread::lock;
+}
 
 //==============================================================================
 Timer::Timer() noexcept {}
@@ -281,6 +452,10 @@ Timer::Timer (const Timer&) noexcept {}
 Timer::~Timer()
 {
     stopTimer();
+
+    // if a TimerService callback that was running restarted the timer, stop it again
+    if (timerService != nullptr)
+        stopTimer();
 }
 
 void Timer::startTimer (int interval) noexcept
@@ -289,17 +464,36 @@ void Timer::startTimer (int interval) noexcept
     // running, then you're not going to get any timer callbacks!
     jassert (MessageManager::getInstanceWithoutCreating() != nullptr);
 
-    const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
+    startTimerInternal (interval, nullptr);
+}
+
+void Timer::startTimer (int interval, TimerService& service) noexcept
+{
+    startTimerInternal (interval, &service);
+}
+
+void Timer::startTimerInternal (int interval, TimerService* service) noexcept
+{
+    if (timerService != service)
+        stopTimer();
 
-    if (timerPeriodMs == 0)
+    if (service == nullptr)
     {
-        timerCountdownMs = interval;
+        const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
+
+        TimerThread::remove (this);
         timerPeriodMs = jmax (1, interval);
-        TimerThread::add (this);
+        TimerThread::add (this, interval);
     }
     else
     {
-        TimerThread::resetCounter (this, interval);
+        const ScopedLock sl (service->lock);
+
+        service->wheel->remove (this);
+        timerPeriodMs = jmax (1, interval);
+        timerService = service;
+        service->wheel->add (this, Time::getMillisecondCounter() + (uint32) interval);
+        service->notify();
     }
 }
 
@@ -313,13 +507,32 @@ void Timer::startTimerHz (int timerFrequencyHz) noexcept
 
 void Timer::stopTimer() noexcept
 {
-    const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
-
-    if (timerPeriodMs > 0)
+    if (auto* service = timerService)
     {
-        TimerThread::remove (this);
+        const ScopedLock sl (service->lock);
+
+        service->wheel->remove (this);
         timerPeriodMs = 0;
+        timerService = nullptr;
+    }
+    else
+    {
+        const TimerThread::LockType::ScopedLockType sl (TimerThread::lock);
+
+        if (timerPeriodMs > 0)
+        {
+            TimerThread::remove (this);
+            timerPeriodMs = 0;
+        }
     }
+
+    // If a TimerService's thread is still running this timer's callback, wait for it,
+    // unless that's the thread we're being called from.
+    auto callbackThread = serviceThreadInCallback.get();
+
+    if (callbackThread != nullptr && callbackThread != Thread::getCurrentThreadId())
+        while (serviceThreadInCallback.get() != nullptr)
+            Thread::sleep (1);
 }
 
 void JUCE_CALLTYPE Timer::callPendingTimersSynchronously()
@@ -352,4 +565,174 @@ void JUCE_CALLTYPE Timer::callAfterDelay (int milliseconds, std::function<void()
     new LambdaInvoker (milliseconds, f);
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimerTests  : public UnitTest
+{
+public:
+    TimerTests() : UnitTest ("Timer", "Events") {}
+
+    struct TestTimer  : public Timer
+    {
+        void timerCallback() override
+        {
+            ++numCalls;
+
+            if (onCallback != nullptr)
+                onCallback (numCalls.get());
+        }
+
+        Atomic<int> numCalls;
+        std::function<void(int)> onCallback;
+    };
+
+    template <typename Condition>
+    static bool waitFor (Condition condition, int timeoutMs = 5000)
+    {
+        for (auto endTime = Time::getMillisecondCounter() + (uint32) timeoutMs; ! condition();)
+        {
+            if (Time::getMillisecondCounter() > endTime)
+                return false;
+
+            Thread::sleep (2);
+        }
+
+        return true;
+    }
+
+    void runTest() override
+    {
+        beginTest ("TimerService timers are called in expiry order");
+        {
+            TimerService service;
+            CriticalSection lock;
+            Array<int> order;
+            TestTimer timers[4];
+            const int intervals[] = { 240, 60, 400, 150 };
+
+            for (int i = 0; i < 4; ++i)
+            {
+                timers[i].onCallback = [&, i] (int)
+                {
+                    timers[i].stopTimer();
+                    const ScopedLock sl (lock);
+                    order.add (i);
+                };
+            }
+
+            for (int i = 0; i < 4; ++i)
+                timers[i].startTimer (intervals[i], service);
+
+            expect (waitFor ([&] { const ScopedLock sl (lock); return order.size() == 4; }));
+
+            const ScopedLock sl (lock);
+            expect (order == Array<int> (1, 3, 0, 2));
+        }
+
+        beginTest ("TimerService timers are called on time");
+        {
+            TimerService service;
+            TestTimer fast, slow;
+            uint32 slowCallTime = 0;
+
+            // long enough that it has to cascade down from the wheel's second level
+            slow.onCallback = [&] (int)
+            {
+                slowCallTime = Time::getMillisecondCounter();
+                slow.stopTimer();
+            };
+
+            auto startTime = Time::getMillisecondCounter();
+            fast.startTimer (20, service);
+            slow.startTimer (700, service);
+
+            expect (waitFor ([&] { return slow.numCalls.get() > 0; }));
+            fast.stopTimer();
+
+            auto elapsed = (int) (slowCallTime - startTime);
+            expect (elapsed >= 700 && elapsed < 900, "called after " + String (elapsed) + "ms");
+
+            // allow plenty of leeway for a busy machine, but not for a wheel that oversleeps
+            auto numFastCalls = fast.numCalls.get();
+            expect (numFastCalls >= 20 && numFastCalls <= 36, String (numFastCalls) + " calls");
+        }
+
+        beginTest ("Stopping and restarting a TimerService timer from its own callback");
+        {
+            TimerService service;
+            TestTimer timer;
+
+            timer.onCallback = [&] (int numCalls)
+            {
+                if (numCalls == 1)
+                    timer.startTimer (300, service);
+                else
+                    timer.stopTimer();
+            };
+
+            timer.startTimer (5, service);
+
+            expect (waitFor ([&] { return timer.numCalls.get() >= 2; }));
+            Thread::sleep (400);
+            expectEquals (timer.numCalls.get(), 2);
+            expect (! timer.isTimerRunning());
+        }
+
+        beginTest ("Stopping or deleting a TimerService timer waits for a callback that's in progress");
+        {
+            TimerService service;
+
+            for (auto deleteTimer : { false, true })
+            {
+                ScopedPointer<TestTimer> timer (new TestTimer());
+                WaitableEvent callbackStarted;
+                Atomic<int> callbackFinished;
+
+                timer->onCallback = [&] (int)
+                {
+                    callbackStarted.signal();
+                    Thread::sleep (150);
+                    callbackFinished = 1;
+                };
+
+                timer->startTimer (5, service);
+                expect (callbackStarted.wait (5000));
+
+                if (deleteTimer)
+                    timer = nullptr;
+                else
+                    timer->stopTimer();
+
+                expectEquals (callbackFinished.get(), 1);
+            }
+        }
+
+        beginTest ("Deleting a TimerService timer after it has stopped itself");
+        {
+            TimerService service;
+            ScopedPointer<TestTimer> timer (new TestTimer());
+            WaitableEvent callbackStarted;
+            Atomic<int> callbackFinished;
+
+            timer->onCallback = [&] (int)
+            {
+                timer->stopTimer();
+                callbackStarted.signal();
+                Thread::sleep (150);
+                callbackFinished = 1;
+            };
+
+            timer->startTimer (5, service);
+            expect (callbackStarted.wait (5000));
+            timer = nullptr;
+            expectEquals (callbackFinished.get(), 1);
+        }
+    }
+};
+
+static TimerTests timerTests;
+
+#endif
+
 } // namespace juce
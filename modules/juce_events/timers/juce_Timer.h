@@ -23,6 +23,8 @@
 namespace juce
 {
 
+class TimerService;
+
 //==============================================================================
 /**
     Makes repeated callbacks to a virtual method at a specified time interval.
@@ -44,7 +46,7 @@ namespace juce
     structure is very similar to the Timer class, but contains multiple timers
     internally, each one identified by an ID number.
 
-    @see HighResolutionTimer, MultiTimer
+    @see HighResolutionTimer, MultiTimer, TimerService
 */
 class JUCE_API  Timer
 {
@@ -87,6 +89,18 @@ public:
     */
     void startTimer (int intervalInMilliseconds) noexcept;
 
+    /** Starts the timer, but makes its callbacks on a TimerService's thread
+        rather than on the message thread.
+
+        This behaves like startTimer (int), except that timerCallback() will be
+        invoked by the given service's background thread, so the timer keeps
+        running even when the message thread is busy. The TimerService must
+        outlive any timers that are using it.
+
+        @see TimerService
+    */
+    void startTimer (int intervalInMilliseconds, TimerService& serviceToUse) noexcept;
+
     /** Starts the timer with an interval specified in Hertz.
         This is effectively the same as calling startTimer (1000 / timerFrequencyHz).
     */
@@ -101,6 +115,12 @@ public:
         future timer callbacks, but it will return without waiting for the current one
         to finish. The current callback will continue, possibly still running some of
         your timer code after this method has returned.
+
+        For a timer that's running on a TimerService, it's the other way round: if the
+        service's thread is in the middle of the callback, this will wait for it to
+        finish (unless it's being called from inside that callback), so the timer can
+        safely be deleted as soon as this returns. Be careful not to call it while
+        holding a lock that your callback might need!
     */
     void stopTimer() noexcept;
 
@@ -125,11 +145,58 @@ public:
 
 private:
     class TimerThread;
+    struct TimerWheel;
     friend class TimerThread;
-    int timerCountdownMs = 0, timerPeriodMs = 0;
+    friend struct TimerWheel;
+    friend class TimerService;
+
+    int timerPeriodMs = 0, timerSlot = -1;
+    uint32 timerExpiryTime = 0;
     Timer* previousTimer = {}, *nextTimer = {};
+    TimerService* timerService = nullptr;
+    Atomic<Thread::ThreadID> serviceThreadInCallback;
+
+    void startTimerInternal (int, TimerService*) noexcept;
 
     Timer& operator= (const Timer&) = delete;
 };
 
+//==============================================================================
+/**
+    A background thread that makes Timer callbacks.
+
+    Timers normally call back on the message thread, which means that a busy
+    message loop will hold them up. A Timer that is started with
+    Timer::startTimer (int, TimerService&) will instead be called by this object's
+    own thread, so it's suitable for housekeeping work that doesn't touch the GUI.
+
+    Each TimerService keeps its own set of timers, so it won't contend with the
+    message-thread timers or with other services.
+
+    @see Timer
+*/
+class JUCE_API  TimerService  : private Thread
+{
+public:
+    //==============================================================================
+    /** Creates a TimerService and starts its thread. */
+    explicit TimerService (const String& name = "Timer Service",
+                           int priority = 5);
+
+    /** Destructor.
+        Any timers that are still running on this service will be stopped.
+    */
+    ~TimerService();
+
+private:
+    //==============================================================================
+    friend class Timer;
+    CriticalSection lock;
+    ScopedPointer<Timer::TimerWheel> wheel;
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimerService)
+};
+
 } // namespace juce
@@ -406,7 +406,7 @@ void Graphics::strokePath (const Path& path,
                            const AffineTransform& transform) const
 {
     Path stroke;
-    strokeType.createStrokedPath (stroke, path, transform, context.getPhysicalPixelScaleFactor());
+    PathRenderingCache::createStrokedPath (stroke, path, strokeType, transform, context.getPhysicalPixelScaleFactor());
     fillPath (stroke);
 }
 
@@ -95,6 +95,20 @@ public:
     virtual void setFont (const Font&) = 0;
     virtual const Font& getFont() = 0;
     virtual void drawGlyph (int glyphNumber, const AffineTransform&) = 0;
+
+    /** Draws a run of glyphs in the current font, each one at a position which is then
+        modified by the given transform.
+
+        The default implementation simply calls drawGlyph() for each one, but renderers
+        can override this to draw the whole run more efficiently.
+    */
+    virtual void drawGlyphs (const int* glyphNumbers, const Point<float>* positions,
+                             int numGlyphs, const AffineTransform& transform)
+    {
+        for (int i = 0; i < numGlyphs; ++i)
+            drawGlyph (glyphNumbers[i], AffineTransform::translation (positions[i]).followedBy (transform));
+    }
+
     virtual bool drawTextLayout (const AttributedString&, const Rectangle<float>&)  { return false; }
 };
 
@@ -42,4 +42,245 @@ LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer (const Image&
 
 LowLevelGraphicsSoftwareRenderer::~LowLevelGraphicsSoftwareRenderer() {}
 
+LowLevelGraphicsSoftwareRenderer::GlyphCacheStatistics LowLevelGraphicsSoftwareRenderer::getGlyphCacheStatistics()
+{
+    auto& cache = RenderingHelpers::SoftwareRendererSavedState::GlyphCacheType::getInstance();
+    return { cache.getTotalHits(), cache.getTotalMisses(), cache.getNumGlyphSlots() };
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SoftwareRendererGlyphTests  : public UnitTest
+{
+public:
+    SoftwareRendererGlyphTests() : UnitTest ("Software renderer glyphs", "Graphics") {}
+
+    typedef RenderingHelpers::CachedGlyphEdgeTable<RenderingHelpers::SoftwareRendererSavedState> CachedGlyph;
+
+    // Draws some text with a randomly-chosen clip, colour, font and position, either as
+    // a single run or one glyph at a time
+    static Image renderText (Image::PixelFormat format, int seed, bool asSingleRun)
+    {
+        Random r (seed);
+        Image image (format, 160, 60, true);
+        image.clear (image.getBounds(), Colour (0xff405060));
+
+        LowLevelGraphicsSoftwareRenderer context (image);
+        context.setOrigin ({ r.nextInt (20) - 10, r.nextInt (20) - 10 });
+
+        switch (r.nextInt (5))
+        {
+            case 0:  break;
+            case 1:  context.clipToRectangle ({ r.nextInt (60), r.nextInt (30), r.nextInt (120), r.nextInt (40) }); break;
+            case 2:  context.excludeClipRectangle ({ r.nextInt (100), r.nextInt (40), 4 + r.nextInt (30), 4 + r.nextInt (20) }); break;
+
+            case 3:
+            {
+                RectangleList<int> list;
+
+                for (int i = 0; i < 6; ++i)
+                    list.add ({ r.nextInt (140), r.nextInt (50), 5 + r.nextInt (40), 5 + r.nextInt (20) });
+
+                context.clipToRectangleList (list);
+                break;
+            }
+
+            default:
+            {
+                Path p;
+                p.addEllipse (5.0f, 5.0f, 140.0f, 45.0f);
+                context.clipToPath (p, {});
+                break;
+            }
+        }
+
+        const Colour colours[] = { Colours::black, Colours::white, Colours::yellow.withAlpha (0.6f),
+                                   Colour (0xff8090a0), Colours::red.withAlpha (0.3f) };
+
+        context.setFill (colours[r.nextInt (numElementsInArray (colours))]);
+
+        Font font (8.0f + r.nextFloat() * 20.0f, r.nextBool() ? Font::italic : Font::plain);
+        font.setHorizontalScale (r.nextBool() ? 1.0f : 0.8f);
+        context.setFont (font);
+
+        Array<int> glyphs;
+        Array<float> xOffsets;
+        font.getGlyphPositions ("Quick fox jumps, ego: 0123456789", glyphs, xOffsets);
+
+        Array<Point<float>> positions;
+        const Point<float> start (r.nextFloat() * 10.0f, 20.0f + r.nextFloat() * 20.0f);
+
+        for (int i = 0; i < glyphs.size(); ++i)
+            positions.add (start + Point<float> (xOffsets[i] + r.nextFloat() * 0.3f, r.nextFloat() * 0.5f));
+
+        auto transform = r.nextInt (4) == 0 ? AffineTransform::scale (1.1f)
+                                            : AffineTransform::translation (r.nextFloat() * 3.0f, r.nextFloat() * 3.0f);
+
+        if (asSingleRun)
+        {
+            context.drawGlyphs (glyphs.begin(), positions.begin(), glyphs.size(), transform);
+        }
+        else
+        {
+            for (int i = 0; i < glyphs.size(); ++i)
+                context.drawGlyph (glyphs[i], AffineTransform::translation (positions[i]).followedBy (transform));
+        }
+
+        return image;
+    }
+
+    static int countDifferences (const Image& a, const Image& b)
+    {
+        int num = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getPixelAt (x, y).getARGB() != b.getPixelAt (x, y).getARGB())
+                    ++num;
+
+        return num;
+    }
+
+    // Lists the calls that iterating an edge-table makes
+    struct CallRecorder
+    {
+        void setEdgeTableYPos (int y)                           { calls << "\n" << y << ":"; }
+        void handleEdgeTablePixel (int x, int level)            { calls << " p" << x << "," << level; }
+        void handleEdgeTablePixelFull (int x)                   { calls << " f" << x; }
+        void handleEdgeTableLine (int x, int w, int level)      { calls << " l" << x << "," << w << "," << level; }
+        void handleEdgeTableLineFull (int x, int w)             { calls << " L" << x << "," << w; }
+
+        String calls;
+    };
+
+    static String describeEdgeTable (const EdgeTable& et)
+    {
+        CallRecorder r;
+        et.iterate (r);
+        return r.calls;
+    }
+
+    struct RecordingRenderer  : public LowLevelGraphicsSoftwareRenderer
+    {
+        RecordingRenderer (const Image& image)  : LowLevelGraphicsSoftwareRenderer (image) {}
+
+        void fillPath (const Path& path, const AffineTransform& t) override
+        {
+            events << "u";
+            LowLevelGraphicsSoftwareRenderer::fillPath (path, t);
+        }
+
+        void drawGlyph (int glyphNumber, const AffineTransform& t) override
+        {
+            events << "g";
+            LowLevelGraphicsSoftwareRenderer::drawGlyph (glyphNumber, t);
+        }
+
+        void drawGlyphs (const int* glyphNumbers, const Point<float>* positions, int numGlyphs, const AffineTransform& t) override
+        {
+            events << String::repeatedString ("g", numGlyphs);
+            LowLevelGraphicsSoftwareRenderer::drawGlyphs (glyphNumbers, positions, numGlyphs, t);
+        }
+
+        String events;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Drawing a run of glyphs gives the same pixels as drawing them one at a time");
+        {
+            const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB, Image::SingleChannel };
+            int numTextPixels = 0;
+
+            for (int seed = 0; seed < 150; ++seed)
+            {
+                auto format = formats[seed % numElementsInArray (formats)];
+                auto run = renderText (format, seed, true);
+                auto separate = renderText (format, seed, false);
+
+                expectEquals (countDifferences (run, separate), 0, "seed " + String (seed));
+
+                Image blank (format, run.getWidth(), run.getHeight(), true);
+                blank.clear (blank.getBounds(), Colour (0xff405060));
+                numTextPixels += countDifferences (run, blank);
+            }
+
+            // make sure that some text was actually drawn
+            expect (numTextPixels > 1000);
+        }
+
+        beginTest ("Positioned edge-tables are cached for each brightness level");
+        {
+            Font font (15.0f);
+            Array<int> glyphs;
+            Array<float> xOffsets;
+            font.getGlyphPositions ("W", glyphs, xOffsets);
+
+            CachedGlyph glyph;
+            glyph.generate (font, glyphs.getFirst());
+
+            auto* normal = glyph.getPositionedEdgeTable (37, 1.0f);
+            auto* bright = glyph.getPositionedEdgeTable (37, 1.8f);
+
+            expect (normal != nullptr && bright != nullptr && normal != bright);
+
+            // switching between colours mustn't throw the previous version away
+            for (int i = 0; i < 4; ++i)
+            {
+                expect (glyph.getPositionedEdgeTable (37, 1.0f) == normal);
+                expect (glyph.getPositionedEdgeTable (37, 1.8f) == bright);
+            }
+
+            EdgeTable expected (*glyph.edgeTable);
+            expected.translate (37 / 256.0f, 0);
+            expected.multiplyLevels (1.8f);
+            expectEquals (describeEdgeTable (*bright), describeEdgeTable (expected));
+
+            // the least-recently-used version is the one that gets replaced
+            for (int i = 0; i < 7; ++i)
+                glyph.getPositionedEdgeTable (i, 1.0f);
+
+            expect (glyph.getPositionedEdgeTable (37, 1.8f) == bright);
+        }
+
+        beginTest ("Glyph cache statistics");
+        {
+            Image image (Image::ARGB, 100, 30, true);
+            Graphics g (image);
+            g.setFont (Font (13.0f));
+
+            g.drawSingleLineText ("statistics", 5, 20);
+            auto before = LowLevelGraphicsSoftwareRenderer::getGlyphCacheStatistics();
+
+            g.drawSingleLineText ("statistics", 5, 20);
+            auto after = LowLevelGraphicsSoftwareRenderer::getGlyphCacheStatistics();
+
+            expectEquals (after.numMisses, before.numMisses);
+            expect (after.numHits >= before.numHits + 10);
+            expect (after.numGlyphSlots > 0);
+        }
+
+        beginTest ("Underlines are drawn in the same order as the glyphs");
+        {
+            Image image (Image::ARGB, 100, 30, true);
+            RecordingRenderer context (image);
+            Graphics g (context);
+
+            GlyphArrangement arrangement;
+            arrangement.addLineOfText (Font (15.0f), "xy", 0.0f, 20.0f);
+            arrangement.addLineOfText (Font (15.0f, Font::underlined), "ab c", 20.0f, 20.0f);
+            arrangement.addLineOfText (Font (15.0f), "z", 60.0f, 20.0f);
+            arrangement.draw (g);
+
+            // each underline must go on top of the glyphs before it, and underneath its own glyph
+            expectEquals (context.events, String ("gguguguugg"));
+        }
+    }
+};
+
+static SoftwareRendererGlyphTests softwareRendererGlyphTests;
+
+#endif
+
 } // namespace juce
@@ -49,6 +49,23 @@ public:
     /** Destructor. */
     ~LowLevelGraphicsSoftwareRenderer();
 
+    //==============================================================================
+    /** Contains some counters which show how well the software renderer's shared
+        glyph cache is working.
+        @see getGlyphCacheStatistics
+    */
+    struct GlyphCacheStatistics
+    {
+        int64 numHits;          /**< The number of glyph lookups that found an existing entry. */
+        int64 numMisses;        /**< The number of glyph lookups that had to rasterise a new glyph. */
+        int numGlyphSlots;      /**< The number of glyphs that the cache can currently hold. */
+    };
+
+    /** Returns the current hit/miss counts for the glyph cache that is shared by all
+        software renderers. The counters are cleared whenever the cache is reset.
+    */
+    static GlyphCacheStatistics getGlyphCacheStatistics();
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsSoftwareRenderer)
 };
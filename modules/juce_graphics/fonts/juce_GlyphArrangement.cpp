@@ -742,17 +742,37 @@ void GlyphArrangement::draw (const Graphics& g, AffineTransform transform) const
     auto lastFont = context.getFont();
     bool needToRestore = false;
 
+    // consecutive glyphs that share a font are handed to the context as a single run
+    Array<int> runGlyphs;
+    Array<Point<float>> runPositions;
+
+    auto flushRun = [&]
+    {
+        if (! runGlyphs.isEmpty())
+        {
+            context.drawGlyphs (runGlyphs.begin(), runPositions.begin(), runGlyphs.size(), transform);
+            runGlyphs.clearQuick();
+            runPositions.clearQuick();
+        }
+    };
+
     for (int i = 0; i < glyphs.size(); ++i)
     {
         auto& pg = glyphs.getReference(i);
 
         if (pg.font.isUnderlined())
+        {
+            // the glyphs before this one have to be drawn first, so that its underline
+            // ends up on top of them, as it would if each glyph were drawn separately
+            flushRun();
             drawGlyphUnderline (g, pg, i, transform);
+        }
 
         if (! pg.isWhitespace())
         {
             if (lastFont != pg.font)
             {
+                flushRun();
                 lastFont = pg.font;
 
                 if (! needToRestore)
@@ -764,11 +784,13 @@ void GlyphArrangement::draw (const Graphics& g, AffineTransform transform) const
                 context.setFont (lastFont);
             }
 
-            context.drawGlyph (pg.glyph, AffineTransform::translation (pg.x, pg.y)
-                                                         .followedBy (transform));
+            runGlyphs.add (pg.glyph);
+            runPositions.add ({ pg.x, pg.y });
         }
     }
 
+    flushRun();
+
     if (needToRestore)
         context.restoreState();
 }
@@ -198,6 +198,9 @@ void TextLayout::draw (Graphics& g, Rectangle<float> area) const
 
     auto& context = g.getInternalContext();
 
+    Array<int> runGlyphs;
+    Array<Point<float>> runPositions;
+
     for (auto* line : lines)
     {
         auto lineOrigin = origin + line->lineOrigin;
@@ -207,9 +210,16 @@ void TextLayout::draw (Graphics& g, Rectangle<float> area) const
             context.setFont (run->font);
             context.setFill (run->colour);
 
+            runGlyphs.clearQuick();
+            runPositions.clearQuick();
+
             for (auto& glyph : run->glyphs)
-                context.drawGlyph (glyph.glyphCode, AffineTransform::translation (lineOrigin.x + glyph.anchor.x,
-                                                                                  lineOrigin.y + glyph.anchor.y));
+            {
+                runGlyphs.add (glyph.glyphCode);
+                runPositions.add (lineOrigin + glyph.anchor);
+            }
+
+            context.drawGlyphs (runGlyphs.begin(), runPositions.begin(), runGlyphs.size(), {});
 
             if (run->font.isUnderlined())
             {
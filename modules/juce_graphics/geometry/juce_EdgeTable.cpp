@@ -287,6 +287,25 @@ EdgeTable& EdgeTable::operator= (const EdgeTable& other)
     return *this;
 }
 
+EdgeTable::EdgeTable (EdgeTable&& other) noexcept
+    : table (static_cast<HeapBlock<int>&&> (other.table)),
+      bounds (other.bounds),
+      maxEdgesPerLine (other.maxEdgesPerLine),
+      lineStrideElements (other.lineStrideElements),
+      needToCheckEmptiness (other.needToCheckEmptiness)
+{
+}
+
+EdgeTable& EdgeTable::operator= (EdgeTable&& other) noexcept
+{
+    table = static_cast<HeapBlock<int>&&> (other.table);
+    bounds = other.bounds;
+    maxEdgesPerLine = other.maxEdgesPerLine;
+    lineStrideElements = other.lineStrideElements;
+    needToCheckEmptiness = other.needToCheckEmptiness;
+    return *this;
+}
+
 EdgeTable::~EdgeTable()
 {
 }
@@ -338,8 +357,10 @@ void EdgeTable::sanitiseLevels (const bool useNonZeroWinding) noexcept
             auto* items = reinterpret_cast<LineItem*> (lineStart + 1);
             auto* itemsEnd = items + num;
 
-            // sort the X coords
-            std::sort (items, itemsEnd);
+            // sort the X coords - lines built from rectangles or simple shapes usually
+            // arrive in order already, so it's worth checking before doing a full sort
+            if (! std::is_sorted (items, itemsEnd))
+                std::sort (items, itemsEnd);
 
             auto* src = items;
             auto correctedNum = num;
@@ -514,7 +535,9 @@ void EdgeTable::intersectWithEdgeTableLine (const int y, const int* const otherL
 
     auto srcNum2 = *otherLine;
 
-    if (srcNum2 == 0)
+    if (srcNum2 == 0
+         || otherLine[srcNum2 * 2 - 1] <= srcLine[1]
+         || otherLine[1] >= srcLine[srcNum1 * 2 - 1])
     {
         *srcLine = 0;
         return;
@@ -568,16 +591,24 @@ void EdgeTable::intersectWithEdgeTableLine (const int y, const int* const otherL
             --srcNum2;
         }
 
-        if (nextX > lastX)
+        if (nextX >= lastX)
         {
             if (nextX >= right)
                 break;
 
-            lastX = nextX;
-
             auto nextLevel = (level1 * (level2 + 1)) >> 8;
             jassert (isPositiveAndBelow (nextLevel, 256));
 
+            // if a line has several points at the same x, the level after the last of them is the one that counts
+            if (nextX == lastX && destIndex > 0 && srcLine[destIndex - 1] == nextX)
+            {
+                srcLine[destIndex] = nextLevel;
+                lastLevel = nextLevel;
+                continue;
+            }
+
+            lastX = nextX;
+
             if (nextLevel != lastLevel)
             {
                 if (destTotal >= maxEdgesPerLine)
@@ -733,7 +764,14 @@ void EdgeTable::excludeRectangle (const Rectangle<int>& r)
                                  std::numeric_limits<int>::max(), 0 };
 
         for (int i = top; i < bottom; ++i)
-            intersectWithEdgeTableLine (i, rectLine);
+        {
+            auto* line = table + lineStrideElements * i;
+            auto num = line[0];
+
+            // lines which are empty or don't reach into the excluded area can be skipped
+            if (num > 0 && line[1] < rectLine[5] && line[num * 2 - 1] > rectLine[3])
+                intersectWithEdgeTableLine (i, rectLine);
+        }
 
         needToCheckEmptiness = true;
     }
@@ -839,4 +877,242 @@ bool EdgeTable::isEmpty() noexcept
     return bounds.getHeight() == 0;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ClipRegionTests  : public UnitTest
+{
+public:
+    ClipRegionTests() : UnitTest ("Clip regions", "Graphics") {}
+
+    enum { size = 64 };
+
+    // Renders an edge table into a grid of pixel levels
+    struct Coverage
+    {
+        Coverage()  { zeromem (levels, sizeof (levels)); }
+
+        void setEdgeTableYPos (int y) noexcept                              { currentY = y; }
+        void handleEdgeTablePixel (int x, int level) noexcept               { set (x, level); }
+        void handleEdgeTablePixelFull (int x) noexcept                      { set (x, 255); }
+        void handleEdgeTableLine (int x, int width, int level) noexcept     { while (--width >= 0) set (x++, level); }
+        void handleEdgeTableLineFull (int x, int width) noexcept            { handleEdgeTableLine (x, width, 255); }
+
+        void set (int x, int level) noexcept
+        {
+            if (isPositiveAndBelow (x, (int) size) && isPositiveAndBelow (currentY, (int) size))
+                levels[currentY][x] = level;
+        }
+
+        template <typename PixelPredicate>
+        void clearPixelsWhere (PixelPredicate shouldClear)
+        {
+            for (int y = 0; y < size; ++y)
+                for (int x = 0; x < size; ++x)
+                    if (shouldClear (x, y))
+                        levels[y][x] = 0;
+        }
+
+        int countDifferences (const Coverage& other) const noexcept
+        {
+            int num = 0;
+
+            for (int y = 0; y < size; ++y)
+                for (int x = 0; x < size; ++x)
+                    if (levels[y][x] != other.levels[y][x])
+                        ++num;
+
+            return num;
+        }
+
+        int currentY = 0;
+        int levels[size][size];
+    };
+
+    static Coverage render (const EdgeTable& et)
+    {
+        Coverage c;
+        et.iterate (c);
+        return c;
+    }
+
+    template <typename ValueType>
+    static Rectangle<ValueType> randomRectangle (Random& r, ValueType scale)
+    {
+        auto next = [&r, scale] (int range) { return (ValueType) r.nextInt (range) / scale; };
+
+        return { next (size + 16) - (ValueType) 8, next (size + 16) - (ValueType) 8, next (24), next (24) };
+    }
+
+    template <typename ValueType>
+    static RectangleList<ValueType> randomList (Random& r, ValueType scale)
+    {
+        RectangleList<ValueType> list;
+        auto allowOverlaps = r.nextBool();
+
+        for (int i = r.nextInt (40) + 1; --i >= 0;)
+        {
+            auto rect = randomRectangle (r, scale);
+
+            if (allowOverlaps)
+                list.addWithoutMerging (rect);
+            else
+                list.add (rect);
+        }
+
+        return list;
+    }
+
+    static Path randomPath (Random& r)
+    {
+        Path p;
+
+        auto randomCoord = [&r] { return r.nextFloat() * (size + 10) - 5.0f; };
+
+        for (int i = r.nextInt (4) + 1; --i >= 0;)
+        {
+            if (r.nextBool())
+                p.addEllipse (randomCoord(), randomCoord(), randomCoord(), randomCoord());
+            else
+                p.addTriangle (randomCoord(), randomCoord(), randomCoord(), randomCoord(), randomCoord(), randomCoord());
+        }
+
+        p.setUsingNonZeroWinding (r.nextBool());
+        return p;
+    }
+
+    // the straightforward version of RectangleList::clipTo, which tests every pair
+    template <typename ValueType>
+    static RectangleList<ValueType> clipPairwise (const RectangleList<ValueType>& list, const RectangleList<ValueType>& other)
+    {
+        RectangleList<ValueType> result;
+
+        for (auto& rect : list)
+        {
+            for (auto& r : other)
+            {
+                auto clipped = r;
+
+                if (rect.intersectRectangle (clipped))
+                    result.addWithoutMerging (clipped);
+            }
+        }
+
+        return result;
+    }
+
+    template <typename ValueType>
+    void checkRectangleListsMatchReference (ValueType scale)
+    {
+        auto r = getRandom();
+
+        for (int i = 0; i < 300; ++i)
+        {
+            auto list = randomList (r, scale);
+            auto other = randomList (r, scale);
+            auto expected = clipPairwise (list, other);
+
+            auto clipped = list;
+            clipped.clipTo (other);
+
+            auto subtracted = list;
+            subtracted.subtract (other);
+
+            int numClipErrors = 0, numSubtractErrors = 0;
+
+            for (int y = -10; y < (size + 10) * (int) scale; ++y)
+            {
+                for (int x = -10; x < (size + 10) * (int) scale; ++x)
+                {
+                    Point<ValueType> p ((ValueType) x / scale, (ValueType) y / scale);
+
+                    if (clipped.containsPoint (p) != expected.containsPoint (p))
+                        ++numClipErrors;
+
+                    if (subtracted.containsPoint (p) != (list.containsPoint (p) && ! other.containsPoint (p)))
+                        ++numSubtractErrors;
+                }
+            }
+
+            expectEquals (numClipErrors, 0);
+            expectEquals (numSubtractErrors, 0);
+            expect (list.intersects (other) == ! expected.isEmpty());
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("RectangleList operations match a pairwise reference");
+        {
+            checkRectangleListsMatchReference (1);
+            checkRectangleListsMatchReference (2.0f);
+        }
+
+        beginTest ("EdgeTables built from rectangles");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 100; ++i)
+            {
+                auto list = randomList (r, 1);
+                auto coverage = render (EdgeTable (list));
+
+                Coverage expected;
+                for (int y = 0; y < size; ++y)
+                    for (int x = 0; x < size; ++x)
+                        expected.levels[y][x] = list.containsPoint (x, y) ? 255 : 0;
+
+                expectEquals (coverage.countDifferences (expected), 0);
+            }
+        }
+
+        beginTest ("EdgeTable clipping matches a per-pixel reference");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 200; ++i)
+            {
+                EdgeTable et ({ 0, 0, size, size }, randomPath (r), AffineTransform());
+                auto expected = render (et);
+
+                for (int j = r.nextInt (5) + 1; --j >= 0;)
+                {
+                    switch (r.nextInt (3))
+                    {
+                        case 0:
+                        {
+                            auto rect = randomRectangle (r, 1);
+                            et.clipToRectangle (rect);
+                            expected.clearPixelsWhere ([rect] (int x, int y) { return ! rect.contains (x, y); });
+                            break;
+                        }
+
+                        case 1:
+                        {
+                            auto rect = randomRectangle (r, 1);
+                            et.excludeRectangle (rect);
+                            expected.clearPixelsWhere ([rect] (int x, int y) { return rect.contains (x, y); });
+                            break;
+                        }
+
+                        default:
+                        {
+                            auto list = randomList (r, 1);
+                            et.clipToEdgeTable (EdgeTable (list));
+                            expected.clearPixelsWhere ([&list] (int x, int y) { return ! list.containsPoint (x, y); });
+                            break;
+                        }
+                    }
+
+                    expectEquals (render (et).countDifferences (expected), 0);
+                }
+            }
+        }
+    }
+};
+
+static ClipRegionTests clipRegionTests;
+
+#endif
+
 } // namespace juce
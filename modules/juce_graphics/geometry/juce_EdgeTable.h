@@ -68,6 +68,12 @@ public:
     /** Copies from another edge table. */
     EdgeTable& operator= (const EdgeTable&);
 
+    /** Move constructor. */
+    EdgeTable (EdgeTable&&) noexcept;
+
+    /** Move assignment operator. */
+    EdgeTable& operator= (EdgeTable&&) noexcept;
+
     /** Destructor. */
     ~EdgeTable();
 
@@ -199,6 +205,8 @@ private:
         bool operator< (const LineItem& other) const noexcept   { return x < other.x; }
     };
 
+    friend class PathRenderingCache;
+
     HeapBlock<int> table;
     Rectangle<int> bounds;
     int maxEdgesPerLine, lineStrideElements;
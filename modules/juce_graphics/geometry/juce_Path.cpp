@@ -139,7 +139,8 @@ Path::~Path()
 Path::Path (const Path& other)
     : numElements (other.numElements),
       bounds (other.bounds),
-      useNonZeroWinding (other.useNonZeroWinding)
+      useNonZeroWinding (other.useNonZeroWinding),
+      contentHash (other.contentHash)
 {
     if (numElements > 0)
     {
@@ -157,6 +158,7 @@ Path& Path::operator= (const Path& other)
         numElements = other.numElements;
         bounds = other.bounds;
         useNonZeroWinding = other.useNonZeroWinding;
+        contentHash = other.contentHash;
 
         if (numElements > 0)
             memcpy (data.elements, other.data.elements, numElements * sizeof (float));
@@ -169,7 +171,8 @@ Path::Path (Path&& other) noexcept
     : data (static_cast<ArrayAllocationBase <float, DummyCriticalSection>&&> (other.data)),
       numElements (other.numElements),
       bounds (other.bounds),
-      useNonZeroWinding (other.useNonZeroWinding)
+      useNonZeroWinding (other.useNonZeroWinding),
+      contentHash (other.contentHash)
 {
 }
 
@@ -179,6 +182,7 @@ Path& Path::operator= (Path&& other) noexcept
     numElements = other.numElements;
     bounds = other.bounds;
     useNonZeroWinding = other.useNonZeroWinding;
+    contentHash = other.contentHash;
     return *this;
 }
 
@@ -203,6 +207,7 @@ void Path::clear() noexcept
 {
     numElements = 0;
     bounds.reset();
+    contentChanged();
 }
 
 void Path::swapWithPath (Path& other) noexcept
@@ -214,12 +219,14 @@ void Path::swapWithPath (Path& other) noexcept
     std::swap (bounds.pathYMin, other.bounds.pathYMin);
     std::swap (bounds.pathYMax, other.bounds.pathYMax);
     std::swap (useNonZeroWinding, other.useNonZeroWinding);
+    contentHash = other.contentHash.exchange (contentHash.get());
 }
 
 //==============================================================================
 void Path::setUsingNonZeroWinding (const bool isNonZero) noexcept
 {
     useNonZeroWinding = isNonZero;
+    contentChanged();
 }
 
 void Path::scaleToFit (float x, float y, float w, float h, bool preserveProportions) noexcept
@@ -276,6 +283,8 @@ void Path::startNewSubPath (const float x, const float y)
     else
         bounds.extend (x, y);
 
+    contentChanged();
+
     preallocateSpace (3);
 
     data.elements[numElements++] = moveMarker;
@@ -295,6 +304,8 @@ void Path::lineTo (const float x, const float y)
     if (numElements == 0)
         startNewSubPath (0, 0);
 
+    contentChanged();
+
     preallocateSpace (3);
 
     data.elements[numElements++] = lineMarker;
@@ -318,6 +329,8 @@ void Path::quadraticTo (const float x1, const float y1,
     if (numElements == 0)
         startNewSubPath (0, 0);
 
+    contentChanged();
+
     preallocateSpace (5);
 
     data.elements[numElements++] = quadMarker;
@@ -346,6 +359,8 @@ void Path::cubicTo (const float x1, const float y1,
     if (numElements == 0)
         startNewSubPath (0, 0);
 
+    contentChanged();
+
     preallocateSpace (7);
 
     data.elements[numElements++] = cubicMarker;
@@ -373,6 +388,7 @@ void Path::closeSubPath()
 {
     if (numElements > 0 && ! isMarker (data.elements[numElements - 1], closeSubPathMarker))
     {
+        contentChanged();
         preallocateSpace (1);
         data.elements[numElements++] = closeSubPathMarker;
     }
@@ -410,6 +426,8 @@ void Path::addRectangle (const float x, const float y,
     if (w < 0) std::swap (x1, x2);
     if (h < 0) std::swap (y1, y2);
 
+    contentChanged();
+
     preallocateSpace (13);
 
     if (numElements == 0)
@@ -921,6 +939,7 @@ void Path::addPath (const Path& other,
 //==============================================================================
 void Path::applyTransform (const AffineTransform& transform) noexcept
 {
+    contentChanged();
     bounds.reset();
     bool firstPoint = true;
     float* d = data.elements;
@@ -1369,11 +1388,11 @@ void Path::loadPathFromStream (InputStream& source)
             break;
 
         case 'n':
-            useNonZeroWinding = true;
+            setUsingNonZeroWinding (true);
             break;
 
         case 'z':
-            useNonZeroWinding = false;
+            setUsingNonZeroWinding (false);
             break;
 
         case 'e':
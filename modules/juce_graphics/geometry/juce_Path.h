@@ -802,6 +802,7 @@ private:
     friend class PathFlatteningIterator;
     friend class Path::Iterator;
     friend class EdgeTable;
+    friend class PathRenderingCache;
 
     ArrayAllocationBase<float, DummyCriticalSection> data;
     size_t numElements = 0;
@@ -821,6 +822,11 @@ private:
     PathBounds bounds;
     bool useNonZeroWinding = true;
 
+    // Worked out on demand by PathRenderingCache, and reset to 0 whenever the path changes.
+    mutable Atomic<uint64> contentHash;
+
+    void contentChanged() noexcept      { if (contentHash.get() != 0) contentHash = 0; }
+
     static const float lineMarker;
     static const float moveMarker;
     static const float quadMarker;
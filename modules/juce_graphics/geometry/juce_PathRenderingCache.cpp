@@ -0,0 +1,734 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct PathRenderingCache::Pimpl  : private DeletedAtShutdown
+{
+    Pimpl() {}
+
+    ~Pimpl()
+    {
+        clear();
+        clearSingletonInstance();
+    }
+
+    juce_DeclareSingleton (PathRenderingCache::Pimpl, false)
+
+    //==============================================================================
+    struct Entry
+    {
+        Entry (int64 h, bool stroke) noexcept  : hash (h), isStroke (stroke) {}
+        virtual ~Entry() {}
+
+        const int64 hash;
+        const bool isStroke;
+        size_t size = 0;
+
+        // neighbours in the shard's list of entries, which is kept in order of use
+        Entry* newer = nullptr;
+        Entry* older = nullptr;
+    };
+
+    struct StrokeEntry  : public Entry
+    {
+        StrokeEntry (int64 h, const Path& s, const PathStrokeType& st,
+                     const AffineTransform& t, float accuracy, const Path& r)
+            : Entry (h, true), source (s), strokeType (st), transform (t), extraAccuracy (accuracy), result (r)
+        {
+            size = sizeof (*this) + getMemoryUsage (source) + getMemoryUsage (result);
+        }
+
+        Path source;
+        PathStrokeType strokeType;
+        AffineTransform transform;
+        float extraAccuracy;
+        Path result;
+    };
+
+    struct EdgeTableEntry  : public Entry
+    {
+        EdgeTableEntry (int64 h, const Path& p, const AffineTransform& t)
+            : Entry (h, false), source (p), transform (t), table (getTableBounds (p, t), p, t)
+        {
+            table.optimiseTable();
+            size = sizeof (*this) + getMemoryUsage (source) + getMemoryUsage (table);
+        }
+
+        static Rectangle<int> getTableBounds (const Path& p, const AffineTransform& t)
+        {
+            return p.getBoundsTransformed (t).getSmallestIntegerContainer().expanded (1, 0);
+        }
+
+        Path source;
+        AffineTransform transform;
+        EdgeTable table;
+    };
+
+    //==============================================================================
+    /*  The cache is split into a few independently-locked shards (chosen by hash), so
+        that threads rendering different paths don't all have to queue up for the
+        same lock. Each shard gets an equal share of the memory limit.
+    */
+    struct Shard
+    {
+        Shard() {}
+        ~Shard()    { clear(); }
+
+        void clear()
+        {
+            while (oldest != nullptr)
+                remove (oldest);
+
+            seenOnce.clear();
+        }
+
+        void markAsUsed (Entry* e) noexcept
+        {
+            if (e != newest)
+            {
+                unlink (e);
+                linkAsNewest (e);
+            }
+        }
+
+        void add (Entry* e, size_t memoryLimit)
+        {
+            if (e->isStroke)
+            {
+                if (auto* old = strokes[e->hash])
+                    remove (old);
+
+                strokes.set (e->hash, static_cast<StrokeEntry*> (e));
+            }
+            else
+            {
+                if (auto* old = edgeTables[e->hash])
+                    remove (old);
+
+                edgeTables.set (e->hash, static_cast<EdgeTableEntry*> (e));
+            }
+
+            linkAsNewest (e);
+            memoryUsed += e->size;
+            trimToSize (memoryLimit);
+        }
+
+        void trimToSize (size_t memoryLimit)
+        {
+            while (memoryUsed > memoryLimit && oldest != nullptr)
+                remove (oldest);
+        }
+
+        // geometry is only cached once it has been seen at least twice
+        bool shouldAddEntry (int64 hash)
+        {
+            if (seenOnce.contains (hash))
+            {
+                seenOnce.remove (hash);
+                return true;
+            }
+
+            if (seenOnce.size() >= maxSeenOnceEntries)
+                seenOnce.clear();
+
+            seenOnce.set (hash, true);
+            return false;
+        }
+
+        HashMap<int64, StrokeEntry*> strokes;
+        HashMap<int64, EdgeTableEntry*> edgeTables;
+        HashMap<int64, bool> seenOnce;
+        Entry* newest = nullptr;
+        Entry* oldest = nullptr;
+        size_t memoryUsed = 0;
+        CriticalSection lock;
+
+    private:
+        void linkAsNewest (Entry* e) noexcept
+        {
+            e->newer = nullptr;
+            e->older = newest;
+
+            if (newest != nullptr)
+                newest->newer = e;
+            else
+                oldest = e;
+
+            newest = e;
+        }
+
+        void unlink (Entry* e) noexcept
+        {
+            (e->newer != nullptr ? e->newer->older : newest) = e->older;
+            (e->older != nullptr ? e->older->newer : oldest) = e->newer;
+        }
+
+        void remove (Entry* e)
+        {
+            unlink (e);
+            memoryUsed -= e->size;
+
+            if (e->isStroke)
+                strokes.remove (e->hash);
+            else
+                edgeTables.remove (e->hash);
+
+            delete e;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (Shard)
+    };
+
+    //==============================================================================
+    void createStrokedPath (Path& destPath, const Path& sourcePath, const PathStrokeType& strokeType,
+                            const AffineTransform& transform, float extraAccuracy)
+    {
+        auto shardMemory = getShardMemoryLimit();
+
+        if (shardMemory == 0 || ! isWorthCaching (sourcePath))
+        {
+            strokeType.createStrokedPath (destPath, sourcePath, transform, extraAccuracy);
+            return;
+        }
+
+        auto hash = hashTransform (getContentHash (sourcePath), transform);
+        hash = combineHash (hash, (uint64) (strokeType.getStrokeThickness() * 4096.0f));
+        hash = combineHash (hash, (uint64) ((int) strokeType.getJointStyle() * 4 + (int) strokeType.getEndStyle()));
+        hash = combineHash (hash, (uint64) (extraAccuracy * 4096.0f));
+
+        auto& shard = getShard (hash);
+
+        {
+            const ScopedLock sl (shard.lock);
+
+            if (auto* e = shard.strokes[(int64) hash])
+            {
+                if (e->strokeType == strokeType && e->transform == transform
+                     && e->extraAccuracy == extraAccuracy && e->source == sourcePath)
+                {
+                    ++numStrokeHits;
+                    shard.markAsUsed (e);
+                    destPath = e->result;
+                    return;
+                }
+            }
+        }
+
+        ++numStrokeMisses;
+        strokeType.createStrokedPath (destPath, sourcePath, transform, extraAccuracy);
+
+        const ScopedLock sl (shard.lock);
+
+        if (shard.shouldAddEntry ((int64) hash))
+        {
+            ScopedPointer<StrokeEntry> e (new StrokeEntry ((int64) hash, sourcePath, strokeType,
+                                                           transform, extraAccuracy, destPath));
+
+            if (e->size < shardMemory / 4)
+                shard.add (e.release(), shardMemory);
+        }
+    }
+
+    EdgeTable createEdgeTable (Rectangle<int> clipLimits, const Path& path, const AffineTransform& transform)
+    {
+        auto shardMemory = getShardMemoryLimit();
+
+        if (shardMemory == 0 || ! isWorthCaching (path))
+            return EdgeTable (clipLimits, path, transform);
+
+        // A table is only re-used for exactly the same transform. Even moving a shape by a
+        // whole number of pixels changes how its transformed coordinates get rounded, so
+        // translating a cached table wouldn't always give the same pixels as drawing it.
+        // And because edges are clamped to the table's bounds while it's being built, a
+        // cached table can only stand in for one whose clip doesn't cut into the shape.
+        auto tableBounds = EdgeTableEntry::getTableBounds (path, transform);
+
+        if (tableBounds.getWidth() > maxCachedEdgeTableSize || tableBounds.getHeight() > maxCachedEdgeTableSize
+             || ! clipLimits.contains (tableBounds))
+            return EdgeTable (clipLimits, path, transform);
+
+        auto hash = hashTransform (getContentHash (path), transform);
+        auto& shard = getShard (hash);
+
+        {
+            const ScopedLock sl (shard.lock);
+
+            if (auto* e = shard.edgeTables[(int64) hash])
+            {
+                if (e->transform == transform && e->source == path)
+                {
+                    ++numEdgeTableHits;
+                    shard.markAsUsed (e);
+                    return e->table;
+                }
+            }
+
+            if (! shard.shouldAddEntry ((int64) hash))
+            {
+                ++numEdgeTableMisses;
+                return EdgeTable (clipLimits, path, transform);
+            }
+        }
+
+        ++numEdgeTableMisses;
+
+        ScopedPointer<EdgeTableEntry> e (new EdgeTableEntry ((int64) hash, path, transform));
+        EdgeTable result (e->table);
+
+        if (e->size < shardMemory / 4)
+        {
+            const ScopedLock sl (shard.lock);
+            shard.add (e.release(), shardMemory);
+        }
+
+        return result;
+    }
+
+    //==============================================================================
+    Statistics getStatistics()
+    {
+        Statistics stats = { numStrokeHits.get(), numStrokeMisses.get(),
+                             numEdgeTableHits.get(), numEdgeTableMisses.get(), 0, 0 };
+
+        for (auto& shard : shards)
+        {
+            const ScopedLock sl (shard.lock);
+            stats.numEntries += shard.strokes.size() + shard.edgeTables.size();
+            stats.memoryUsed += shard.memoryUsed;
+        }
+
+        return stats;
+    }
+
+    void setMaximumMemoryUsage (size_t newMax)
+    {
+        maxMemory = newMax;
+        auto shardMemory = getShardMemoryLimit();
+
+        for (auto& shard : shards)
+        {
+            const ScopedLock sl (shard.lock);
+            shard.trimToSize (shardMemory);
+        }
+    }
+
+    void clear()
+    {
+        for (auto& shard : shards)
+        {
+            const ScopedLock sl (shard.lock);
+            shard.clear();
+        }
+
+        numStrokeHits = 0;
+        numStrokeMisses = 0;
+        numEdgeTableHits = 0;
+        numEdgeTableMisses = 0;
+    }
+
+private:
+    enum { numShards = 4, maxCachedEdgeTableSize = 4096, maxSeenOnceEntries = 256 };
+
+    Shard shards[numShards];
+    Atomic<size_t> maxMemory { 4 * 1024 * 1024 };
+    Atomic<int64> numStrokeHits, numStrokeMisses, numEdgeTableHits, numEdgeTableMisses;
+
+    size_t getShardMemoryLimit() const noexcept     { return maxMemory.get() / numShards; }
+    Shard& getShard (uint64 hash) noexcept          { return shards[(hash >> 32) % numShards]; }
+
+    static uint64 combineHash (uint64 hash, uint64 value) noexcept
+    {
+        return (hash ^ value) * 1099511628211ull;
+    }
+
+    static uint64 hashTransform (uint64 hash, const AffineTransform& t) noexcept
+    {
+        for (auto f : { t.mat00, t.mat01, t.mat02, t.mat10, t.mat11, t.mat12 })
+        {
+            uint32 bits;
+            memcpy (&bits, &f, sizeof (bits));
+            hash = combineHash (hash, bits);
+        }
+
+        return hash;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+juce_ImplementSingleton (PathRenderingCache::Pimpl)
+
+//==============================================================================
+uint64 PathRenderingCache::getContentHash (const Path& path) noexcept
+{
+    // The hash is kept in the path itself, so that a path which is drawn over and
+    // over again only gets hashed once.
+    auto hash = path.contentHash.get();
+
+    if (hash == 0)
+    {
+        hash = 14695981039346656037ull + (path.useNonZeroWinding ? 1 : 0);
+        auto* words = reinterpret_cast<const uint32*> (path.data.elements.get());
+
+        for (size_t i = 0; i < path.numElements; ++i)
+            hash = (hash ^ words[i]) * 1099511628211ull;
+
+        if (hash == 0)
+            hash = 1;
+
+        path.contentHash = hash;
+    }
+
+    return hash;
+}
+
+bool PathRenderingCache::isWorthCaching (const Path& path) noexcept
+{
+    // something as simple as a rectangle is quicker to rasterise again than to look up
+    return path.numElements > 16;
+}
+
+size_t PathRenderingCache::getMemoryUsage (const Path& path) noexcept
+{
+    return sizeof (float) * (size_t) path.data.numAllocated;
+}
+
+size_t PathRenderingCache::getMemoryUsage (const EdgeTable& table) noexcept
+{
+    return sizeof (int) * (size_t) (table.lineStrideElements * (table.bounds.getHeight() + 2));
+}
+
+//==============================================================================
+void PathRenderingCache::createStrokedPath (Path& destPath, const Path& sourcePath, const PathStrokeType& strokeType,
+                                            const AffineTransform& transform, float extraAccuracy)
+{
+    Pimpl::getInstance()->createStrokedPath (destPath, sourcePath, strokeType, transform, extraAccuracy);
+}
+
+EdgeTable PathRenderingCache::createEdgeTable (Rectangle<int> clipLimits, const Path& path, const AffineTransform& transform)
+{
+    return Pimpl::getInstance()->createEdgeTable (clipLimits, path, transform);
+}
+
+PathRenderingCache::Statistics PathRenderingCache::getStatistics()
+{
+    return Pimpl::getInstance()->getStatistics();
+}
+
+void PathRenderingCache::setMaximumMemoryUsage (size_t maxNumBytes)
+{
+    Pimpl::getInstance()->setMaximumMemoryUsage (maxNumBytes);
+}
+
+void PathRenderingCache::clear()
+{
+    Pimpl::getInstance()->clear();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PathRenderingCacheTests  : public UnitTest
+{
+public:
+    PathRenderingCacheTests() : UnitTest ("PathRenderingCache", "Graphics") {}
+
+    // Renders the part of an edge table that lies inside an area into an array of levels
+    struct Coverage
+    {
+        Coverage (Rectangle<int> a)  : area (a)
+        {
+            levels.insertMultiple (0, 0, area.getWidth() * area.getHeight());
+        }
+
+        void setEdgeTableYPos (int y) noexcept                              { currentY = y; }
+        void handleEdgeTablePixel (int x, int level) noexcept               { set (x, level); }
+        void handleEdgeTablePixelFull (int x) noexcept                      { set (x, 255); }
+        void handleEdgeTableLine (int x, int width, int level) noexcept     { while (--width >= 0) set (x++, level); }
+        void handleEdgeTableLineFull (int x, int width) noexcept            { handleEdgeTableLine (x, width, 255); }
+
+        void set (int x, int level) noexcept
+        {
+            if (area.contains (x, currentY))
+                levels.set ((currentY - area.getY()) * area.getWidth() + x - area.getX(), level);
+        }
+
+        Rectangle<int> area;
+        Array<int> levels;
+        int currentY = 0;
+    };
+
+    static bool tablesMatch (EdgeTable a, EdgeTable b, Rectangle<int> area)
+    {
+        a.clipToRectangle (area);
+        b.clipToRectangle (area);
+
+        Coverage ca (area), cb (area);
+        a.iterate (ca);
+        b.iterate (cb);
+        return ca.levels == cb.levels;
+    }
+
+    static Path createShape (float offset, float size = 40.0f)
+    {
+        Path p;
+        p.addEllipse (offset, 0.0f, size, size * 0.75f);
+        p.addStar ({ offset + size * 0.5f, size * 0.4f }, 7, size * 0.1f, size * 0.3f);
+        p.setUsingNonZeroWinding (false);
+        return p;
+    }
+
+    // draws a path through the cache and checks that it matches drawing it directly
+    static bool fillsCorrectly (const Path& path, const AffineTransform& transform,
+                                Rectangle<int> clip = { -20, -20, 240, 200 })
+    {
+        return tablesMatch (PathRenderingCache::createEdgeTable (clip, path, transform),
+                            EdgeTable (clip, path, transform), clip);
+    }
+
+    void expectStatistics (int64 hits, int64 misses, int numEntries)
+    {
+        auto stats = PathRenderingCache::getStatistics();
+        expectEquals (stats.numEdgeTableHits, hits);
+        expectEquals (stats.numEdgeTableMisses, misses);
+        expectEquals (stats.numEntries, numEntries);
+    }
+
+    // Makes a copy of a cached path, changes it, and checks that the two versions
+    // get separate cache entries rather than fighting over the same one.
+    template <typename ChangeFunction>
+    void checkChangeIsNoticed (ChangeFunction change)
+    {
+        PathRenderingCache::clear();
+
+        auto transform = AffineTransform::translation (30.0f, 40.0f);
+        auto original = createShape (0.0f);
+        fillsCorrectly (original, transform);
+        fillsCorrectly (original, transform);
+
+        Path changed (original);
+        change (changed);
+        expect (fillsCorrectly (changed, transform));
+        expect (fillsCorrectly (changed, transform));
+
+        auto hits = PathRenderingCache::getStatistics().numEdgeTableHits;
+        expect (fillsCorrectly (original, transform));
+        expect (fillsCorrectly (changed, transform));
+        expectEquals (PathRenderingCache::getStatistics().numEdgeTableHits, hits + 2);
+    }
+
+    void runTest() override
+    {
+        PathRenderingCache::clear();
+
+        beginTest ("Edge-tables");
+        {
+            auto shape = createShape (0.0f);
+            auto transform = AffineTransform::translation (10.25f, 20.5f);
+
+            expect (fillsCorrectly (shape, transform));
+            expectStatistics (0, 1, 0);
+            expect (fillsCorrectly (shape, transform));
+            expectStatistics (0, 2, 1);
+            expect (fillsCorrectly (shape, transform));
+            expectStatistics (1, 2, 1);
+
+            // a clip that cuts into the shape changes the table, so that bypasses the cache
+            expect (fillsCorrectly (shape, transform, { 25, 30, 13, 9 }));
+            expect (fillsCorrectly (shape, transform, { 25, 30, 13, 9 }));
+            expectStatistics (1, 2, 1);
+
+            // ..but one that's simply bigger doesn't
+            expect (fillsCorrectly (shape, transform, { -500, -500, 1000, 1000 }));
+            expectStatistics (2, 2, 1);
+
+            // any other transform, even a whole-pixel move, needs a table of its own
+            expect (fillsCorrectly (shape, AffineTransform::translation (110.25f, -3.5f)));
+            expect (fillsCorrectly (shape, AffineTransform::translation (10.5f, 20.5f)));
+            expect (fillsCorrectly (shape, transform.scaled (1.5f)));
+            expectStatistics (2, 5, 1);
+
+            // copies of a path find its entry
+            Path copy (shape);
+            expect (fillsCorrectly (copy, transform));
+            expectStatistics (3, 5, 1);
+        }
+
+        beginTest ("Changing a path");
+        {
+            checkChangeIsNoticed ([] (Path& p) { p.applyTransform (AffineTransform::rotation (float_Pi, 20.0f, 15.0f)); });
+            checkChangeIsNoticed ([] (Path& p) { p.lineTo (60.0f, 60.0f); });
+            checkChangeIsNoticed ([] (Path& p) { p.closeSubPath(); p.addRectangle (5.0f, 5.0f, 10.0f, 10.0f); });
+            checkChangeIsNoticed ([] (Path& p) { p.setUsingNonZeroWinding (true); });
+            checkChangeIsNoticed ([] (Path& p) { p.clear(); p.addStar ({ 20.0f, 20.0f }, 9, 5.0f, 15.0f); });
+            checkChangeIsNoticed ([] (Path& p) { Path other (createShape (3.0f)); p.swapWithPath (other); });
+            checkChangeIsNoticed ([] (Path& p) { p = createShape (3.0f); });
+        }
+
+        beginTest ("Strokes");
+        {
+            PathRenderingCache::clear();
+
+            auto shape = createShape (0.0f);
+            PathStrokeType strokeType (3.5f, PathStrokeType::curved, PathStrokeType::rounded);
+            auto transform = AffineTransform::scale (1.5f);
+
+            Path expected;
+            strokeType.createStrokedPath (expected, shape, transform, 1.0f);
+
+            for (int i = 0; i < 4; ++i)
+            {
+                Path result;
+                PathRenderingCache::createStrokedPath (result, shape, strokeType, transform, 1.0f);
+                expect (result == expected);
+            }
+
+            auto stats = PathRenderingCache::getStatistics();
+            expectEquals (stats.numStrokeHits, (int64) 2);
+            expectEquals (stats.numStrokeMisses, (int64) 2);
+
+            Path thicker;
+            PathRenderingCache::createStrokedPath (thicker, shape, PathStrokeType (5.0f), transform, 1.0f);
+            expect (thicker != expected);
+        }
+
+        beginTest ("Simple paths and a disabled cache bypass it");
+        {
+            PathRenderingCache::clear();
+
+            Path rectangle;
+            rectangle.addRectangle (1.5f, 2.5f, 30.0f, 20.0f);
+
+            for (int i = 0; i < 3; ++i)
+                expect (fillsCorrectly (rectangle, {}));
+
+            expectStatistics (0, 0, 0);
+
+            PathRenderingCache::setMaximumMemoryUsage (0);
+            auto shape = createShape (0.0f);
+
+            for (int i = 0; i < 3; ++i)
+                expect (fillsCorrectly (shape, {}));
+
+            expectStatistics (0, 0, 0);
+            PathRenderingCache::setMaximumMemoryUsage (4 * 1024 * 1024);
+        }
+
+        beginTest ("Least-recently-used entries are evicted first");
+        {
+            PathRenderingCache::clear();
+
+            auto favourite = createShape (0.0f);
+            fillsCorrectly (favourite, {});
+            fillsCorrectly (favourite, {});
+
+            auto entrySize = PathRenderingCache::getStatistics().memoryUsed;
+            expect (entrySize > 0);
+
+            auto limit = entrySize * 32;
+            PathRenderingCache::setMaximumMemoryUsage (limit);
+
+            const int numShapes = 200;
+
+            for (int i = 1; i <= numShapes; ++i)
+            {
+                auto shape = createShape ((float) i * 0.125f);
+                fillsCorrectly (shape, {});
+                fillsCorrectly (shape, {});
+
+                auto hitsBefore = PathRenderingCache::getStatistics().numEdgeTableHits;
+                expect (fillsCorrectly (favourite, {}));
+                expectEquals (PathRenderingCache::getStatistics().numEdgeTableHits, hitsBefore + 1);
+
+                expect (PathRenderingCache::getStatistics().memoryUsed <= limit);
+            }
+
+            expect (PathRenderingCache::getStatistics().numEntries < numShapes / 2);
+
+            PathRenderingCache::setMaximumMemoryUsage (entrySize / 2);
+            expectStatistics (PathRenderingCache::getStatistics().numEdgeTableHits,
+                              PathRenderingCache::getStatistics().numEdgeTableMisses, 0);
+
+            PathRenderingCache::setMaximumMemoryUsage (4 * 1024 * 1024);
+        }
+
+        beginTest ("Several threads sharing the cache");
+        {
+            PathRenderingCache::clear();
+
+            Array<Path> shapes;
+
+            for (int i = 0; i < 24; ++i)
+                shapes.add (createShape ((float) i * 0.25f, 20.0f + (float) (i % 5) * 8.0f));
+
+            struct RenderThread  : public Thread
+            {
+                RenderThread (const Array<Path>& s, int seed)  : Thread ("PathRenderingCache test"), shapes (s), random (seed) {}
+
+                void run() override
+                {
+                    for (int i = 0; i < 300 && ok; ++i)
+                    {
+                        auto& shape = shapes.getReference (random.nextInt (shapes.size()));
+                        auto transform = AffineTransform::translation ((float) random.nextInt (4) * 7.5f, (float) random.nextInt (4) * 0.25f);
+
+                        ok = fillsCorrectly (shape, transform);
+                    }
+                }
+
+                const Array<Path>& shapes;
+                Random random;
+                bool ok = true;
+            };
+
+            OwnedArray<RenderThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new RenderThread (shapes, i + 1));
+
+            for (auto* t : threads)
+                t->startThread();
+
+            for (auto* t : threads)
+            {
+                expect (t->waitForThreadToExit (30000));
+                expect (t->ok);
+            }
+
+            expect (PathRenderingCache::getStatistics().numEdgeTableHits > 0);
+        }
+
+        PathRenderingCache::clear();
+    }
+};
+
+static PathRenderingCacheTests pathRenderingCacheTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A global cache of the stroked outlines and rasterised edge-tables of paths
+    that get drawn repeatedly.
+
+    Graphics::strokePath() and the software renderer's path-filling code use this to
+    avoid re-stroking and re-flattening the same geometry every time it's painted. This
+    is common for things like Drawable-based knobs or waveforms, which are redrawn on
+    every repaint even when nothing about them has changed.
+
+    Entries are looked up by a hash of the path's content, along with the stroke
+    parameters and the transform. A cached entry is only used when all of these match
+    exactly (and an edge-table is only used when the clip region doesn't cut into the
+    shape), so drawing through the cache gives exactly the same pixels as drawing
+    without it. To avoid filling the cache with one-off shapes, geometry is only stored
+    once it has been seen at least twice, and the total memory used is bounded - see
+    setMaximumMemoryUsage(). Paths that are as simple as a rectangle are cheaper to
+    rasterise than to look up, so they are never cached.
+
+    @see Path, PathStrokeType, EdgeTable
+*/
+class JUCE_API  PathRenderingCache
+{
+public:
+    //==============================================================================
+    /** Creates a stroked version of a path, re-using a cached copy if this path has
+        recently been stroked with the same parameters.
+
+        The arguments are the same as for PathStrokeType::createStrokedPath().
+    */
+    static void createStrokedPath (Path& destPath, const Path& sourcePath,
+                                   const PathStrokeType& strokeType,
+                                   const AffineTransform& transform,
+                                   float extraAccuracy);
+
+    /** Returns an edge-table for a path, re-using a cached copy if the same path has
+        recently been rasterised with an equivalent transform.
+
+        The table that is returned may extend beyond the clip limits if it came from
+        the cache, so the caller should still clip it before rendering.
+    */
+    static EdgeTable createEdgeTable (Rectangle<int> clipLimits, const Path& path,
+                                      const AffineTransform& transform);
+
+    //==============================================================================
+    /** Contains some counters which show how effective the cache is being.
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        int64 numStrokeHits;        /**< The number of strokes that were found in the cache. */
+        int64 numStrokeMisses;      /**< The number of strokes that had to be created. */
+        int64 numEdgeTableHits;     /**< The number of edge-tables that were found in the cache. */
+        int64 numEdgeTableMisses;   /**< The number of edge-tables that had to be created. */
+        int numEntries;             /**< The number of strokes and edge-tables currently cached. */
+        size_t memoryUsed;          /**< The approximate number of bytes used by the cached entries. */
+    };
+
+    /** Returns the cache's current hit/miss counts and memory usage. */
+    static Statistics getStatistics();
+
+    /** Sets the maximum number of bytes that the cache may use.
+        The default is 4MB. Setting this to zero disables the cache.
+    */
+    static void setMaximumMemoryUsage (size_t maxNumBytes);
+
+    /** Deletes all cached entries and resets the statistics. */
+    static void clear();
+
+private:
+    //==============================================================================
+    struct Pimpl;
+    friend struct Pimpl;
+
+    static uint64 getContentHash (const Path&) noexcept;
+    static bool isWorthCaching (const Path&) noexcept;
+    static size_t getMemoryUsage (const Path&) noexcept;
+    static size_t getMemoryUsage (const EdgeTable&) noexcept;
+
+    PathRenderingCache();
+    ~PathRenderingCache();
+
+    JUCE_DECLARE_NON_COPYABLE (PathRenderingCache)
+};
+
+} // namespace juce
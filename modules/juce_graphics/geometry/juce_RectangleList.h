@@ -290,12 +290,16 @@ public:
     */
     bool subtract (const RectangleList& otherList)
     {
+        // the region can only shrink, so anything outside its original bounds can be ignored
+        auto ourBounds = getBounds();
+
         for (auto& r : otherList)
         {
             if (isEmpty())
                 return false;
 
-            subtract (r);
+            if (ourBounds.intersects (r))
+                subtract (r);
         }
 
         return ! isEmpty();
@@ -351,16 +355,58 @@ public:
         if (isEmpty())
             return false;
 
+        if (other.getNumRectangles() <= 1)
+            return clipTo (other.getRectangle (0).template toType<ValueType>());
+
         RectangleList result;
 
-        for (auto& rect : rects)
+        if (rects.size() < 4 || other.getNumRectangles() < 8)
+        {
+            for (auto& rect : rects)
+            {
+                for (auto& r : other)
+                {
+                    auto clipped = r.template toType<ValueType>();
+
+                    if (rect.intersectRectangle (clipped))
+                        result.rects.add (clipped);
+                }
+            }
+        }
+        else
         {
+            // For bigger lists, sort the other rectangles by their top edge, so that each of
+            // ours only needs to look at the band of them that could possibly overlap it,
+            // rather than checking every pair.
+            Array<RectangleType> sorted;
+            sorted.ensureStorageAllocated (other.getNumRectangles());
+            ValueType maxHeight = 0;
+
             for (auto& r : other)
             {
-                auto clipped = r.template toType<ValueType>();
+                auto converted = r.template toType<ValueType>();
+                maxHeight = jmax (maxHeight, converted.getHeight());
+                sorted.add (converted);
+            }
+
+            std::sort (sorted.begin(), sorted.end(),
+                       [] (const RectangleType& a, const RectangleType& b) { return a.getY() < b.getY(); });
+
+            for (auto& rect : rects)
+            {
+                auto bottom = rect.getBottom();
+
+                // nothing starting at or above this level can reach down as far as our rectangle
+                auto* r = std::upper_bound (sorted.begin(), sorted.end(), rect.getY() - maxHeight,
+                                            [] (ValueType y, const RectangleType& r2) { return y < r2.getY(); });
 
-                if (rect.intersectRectangle (clipped))
-                    result.rects.add (clipped);
+                for (; r != sorted.end() && r->getY() < bottom; ++r)
+                {
+                    auto clipped = *r;
+
+                    if (rect.intersectRectangle (clipped))
+                        result.rects.add (clipped);
+                }
             }
         }
 
@@ -471,6 +517,9 @@ public:
     */
     bool intersects (const RectangleList& other) const noexcept
     {
+        if (! getBounds().intersects (other.getBounds()))
+            return false;
+
         for (auto& r : rects)
             if (other.intersectsRectangle (r))
                 return true;
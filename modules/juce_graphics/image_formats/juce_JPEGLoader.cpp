@@ -328,12 +328,16 @@ Image JPEGImageFormat::decodeImage (InputStream& in)
                         const uint8* src = *buffer;
                         uint8* dest = destData.getLinePointer (y);
 
+                        // JPEGs are always opaque, so the pixels can just be swizzled into place
+                        // without needing to be premultiplied
                         if (hasAlphaChan)
                         {
                             for (int i = width; --i >= 0;)
                             {
-                                ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                                ((PixelARGB*) dest)->premultiply();
+                                dest[PixelARGB::indexA] = 0xff;
+                                dest[PixelARGB::indexR] = src[0];
+                                dest[PixelARGB::indexG] = src[1];
+                                dest[PixelARGB::indexB] = src[2];
                                 dest += destData.pixelStride;
                                 src += 3;
                             }
@@ -342,7 +346,9 @@ Image JPEGImageFormat::decodeImage (InputStream& in)
                         {
                             for (int i = width; --i >= 0;)
                             {
-                                ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                dest[PixelRGB::indexR] = src[0];
+                                dest[PixelRGB::indexG] = src[1];
+                                dest[PixelRGB::indexB] = src[2];
                                 dest += destData.pixelStride;
                                 src += 3;
                             }
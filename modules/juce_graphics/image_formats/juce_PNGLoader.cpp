@@ -396,6 +396,39 @@ namespace PNGHelpers
     #pragma warning (pop)
    #endif
 
+    // Converts a row of RGBA bytes into premultiplied ARGB pixels. Opaque pixels use a
+    // multiplier of 0x100 so that they pass through unchanged, which gives the same results
+    // as PixelARGB::premultiply() but without any branches.
+    static void convertRowToPremultipliedARGB (uint8* dest, const int destStride, const uint8* src, const int numPixels) noexcept
+    {
+        for (int i = 0; i < numPixels; ++i)
+        {
+            const uint32 alpha = src[3];
+            const uint32 multiplier = alpha < 0xff ? alpha : 0x100u;
+
+            dest[PixelARGB::indexA] = (uint8) alpha;
+            dest[PixelARGB::indexR] = (uint8) ((src[0] * multiplier + 0x7f) >> 8);
+            dest[PixelARGB::indexG] = (uint8) ((src[1] * multiplier + 0x7f) >> 8);
+            dest[PixelARGB::indexB] = (uint8) ((src[2] * multiplier + 0x7f) >> 8);
+
+            dest += destStride;
+            src += 4;
+        }
+    }
+
+    static void convertRowToRGB (uint8* dest, const int destStride, const uint8* src, const int numPixels) noexcept
+    {
+        for (int i = 0; i < numPixels; ++i)
+        {
+            dest[PixelRGB::indexR] = src[0];
+            dest[PixelRGB::indexG] = src[1];
+            dest[PixelRGB::indexB] = src[2];
+
+            dest += destStride;
+            src += 4;
+        }
+    }
+
     static Image createImageFromData (bool hasAlphaChan, int width, int height, png_bytepp rows)
     {
         // now convert the data to a juce image format..
@@ -412,24 +445,9 @@ namespace PNGHelpers
             uint8* dest = destData.getLinePointer (y);
 
             if (hasAlphaChan)
-            {
-                for (int i = (int) width; --i >= 0;)
-                {
-                    ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
-                    ((PixelARGB*) dest)->premultiply();
-                    dest += destData.pixelStride;
-                    src += 4;
-                }
-            }
+                convertRowToPremultipliedARGB (dest, destData.pixelStride, src, width);
             else
-            {
-                for (int i = (int) width; --i >= 0;)
-                {
-                    ((PixelRGB*) dest)->setARGB (0, src[0], src[1], src[2]);
-                    dest += destData.pixelStride;
-                    src += 4;
-                }
-            }
+                convertRowToRGB (dest, destData.pixelStride, src, width);
         }
 
         return image;
@@ -28,12 +28,22 @@ namespace juce
 {
 
 struct ImageCache::Pimpl     : private Timer,
+                               private AsyncUpdater,
                                private DeletedAtShutdown
 {
     Pimpl() {}
-    ~Pimpl() { clearSingletonInstance(); }
 
-    juce_DeclareSingleton_SingleThreaded_Minimal (ImageCache::Pimpl)
+    ~Pimpl()
+    {
+        shutDownDecodingPool();
+
+        // now that the decoding threads have gone, any half-written files are just litter
+        trimDecodedImageCache (true);
+        clearSingletonInstance();
+    }
+
+    // the decoding threads call into the cache, so this must be the thread-safe flavour
+    juce_DeclareSingleton (ImageCache::Pimpl, false)
 
     Image getFromHashCode (const int64 hashCode) noexcept
     {
@@ -55,14 +65,28 @@ struct ImageCache::Pimpl     : private Timer,
     {
         if (image.isValid())
         {
-            if (! isTimerRunning())
-                startTimer (2000);
+            {
+                const ScopedLock sl (lock);
+                images.add ({ image, hashCode, Time::getApproximateMillisecondCounter() });
+            }
 
-            const ScopedLock sl (lock);
-            images.add ({ image, hashCode, Time::getApproximateMillisecondCounter() });
+            // Images can arrive from the decoding threads, but the timer may only be
+            // started on the message thread.
+            auto* mm = MessageManager::getInstanceWithoutCreating();
+
+            if (mm != nullptr && mm->isThisTheMessageThread())
+                handleAsyncUpdate();
+            else
+                triggerAsyncUpdate();
         }
     }
 
+    void handleAsyncUpdate() override
+    {
+        if (! isTimerRunning())
+            startTimer (2000);
+    }
+
     void timerCallback() override
     {
         auto now = Time::getApproximateMillisecondCounter();
@@ -97,6 +121,313 @@ struct ImageCache::Pimpl     : private Timer,
                 images.remove (i);
     }
 
+    //==============================================================================
+    AsyncImage::Ptr findPendingLoad (const int64 hashCode)
+    {
+        const ScopedLock sl (lock);
+
+        for (auto* pending : pendingLoads)
+            if (pending->hashCode == hashCode)
+                return pending;
+
+        return nullptr;
+    }
+
+    AsyncImage::Ptr startAsyncLoad (const int64 hashCode, std::function<Image()> loader,
+                                    std::function<void (const Image&)> callback)
+    {
+        AsyncImage::Ptr result;
+
+        {
+            const ScopedLock sl (lock);
+
+            if ((result = findPendingLoad (hashCode)) != nullptr)
+            {
+                const ScopedLock asl (result->lock);
+
+                if (! result->finished)
+                {
+                    if (callback != nullptr)
+                        result->callbacks.add (std::move (callback));
+
+                    return result;
+                }
+            }
+
+            result = new AsyncImage (hashCode);
+
+            if (callback != nullptr)
+                result->callbacks.add (std::move (callback));
+
+            pendingLoads.add (result);
+
+            if (decodingPool == nullptr)
+                decodingPool = new ThreadPool (numDecodingThreads > 0 ? numDecodingThreads
+                                                                      : jmax (1, SystemStats::getNumCpus() - 1));
+        }
+
+        decodingPool->addJob ([this, result, loader]
+        {
+            auto image = loader();
+            addImageToCache (image, result->hashCode);
+
+            {
+                const ScopedLock sl (lock);
+                pendingLoads.removeObject (result);
+            }
+
+            setFinished (*result, image);
+        });
+
+        return result;
+    }
+
+    void shutDownDecodingPool()
+    {
+        ScopedPointer<ThreadPool> pool;
+
+        {
+            const ScopedLock sl (lock);
+            pool = decodingPool.release();
+        }
+
+        // Deleting the pool waits for any running jobs (which use this object) to
+        // finish, and throws away the ones that haven't started..
+        pool = nullptr;
+
+        // ..so anything still pending will never be decoded, and must be released
+        // here to avoid leaving callers blocked in waitUntilFinished().
+        ReferenceCountedArray<AsyncImage> unfinished;
+
+        {
+            const ScopedLock sl (lock);
+            unfinished.swapWith (pendingLoads);
+        }
+
+        for (auto* pending : unfinished)
+            setFinished (*pending, {});
+    }
+
+    static AsyncImage::Ptr createFinishedLoad (const int64 hashCode, const Image& image,
+                                               std::function<void (const Image&)> callback)
+    {
+        AsyncImage::Ptr result (new AsyncImage (hashCode));
+
+        if (callback != nullptr)
+            result->callbacks.add (std::move (callback));
+
+        setFinished (*result, image);
+        return result;
+    }
+
+    static void setFinished (AsyncImage& asyncImage, const Image& image)
+    {
+        Array<std::function<void (const Image&)>> callbacks;
+
+        {
+            const ScopedLock sl (asyncImage.lock);
+            asyncImage.image = image;
+            asyncImage.finished = true;
+            callbacks.swapWith (asyncImage.callbacks);
+        }
+
+        asyncImage.finishedEvent.signal();
+
+        for (auto& callback : callbacks)
+            MessageManager::callAsync ([callback, image] { callback (image); });
+    }
+
+    //==============================================================================
+    Image loadFile (const File& file)
+    {
+        auto cacheFile = getDecodedCacheFile (file);
+
+        if (cacheFile != File())
+        {
+            auto image = readDecodedImage (cacheFile);
+
+            if (image.isValid())
+            {
+                // the modification time marks when it was last used, for trimDecodedImageCache()
+                cacheFile.setLastModificationTime (Time::getCurrentTime());
+                return image;
+            }
+        }
+
+        auto image = ImageFileFormat::loadFrom (file);
+
+        if (image.isValid() && cacheFile != File())
+        {
+            writeDecodedImage (cacheFile, image);
+            deleteOtherVersions (cacheFile);
+            trimDecodedImageCache (false);
+        }
+
+        return image;
+    }
+
+    static bool isUnfinishedDecodedImage (const File& file)
+    {
+        // TemporaryFile adds this to the name of the file it writes before moving it into place
+        return file.getFileNameWithoutExtension().contains ("_temp");
+    }
+
+    // Removes the entries for any earlier versions of a source file, which can never be used again.
+    static void deleteOtherVersions (const File& cacheFile)
+    {
+        auto sourceHash = cacheFile.getFileName().upToFirstOccurrenceOf ("_", true, false);
+
+        for (DirectoryIterator i (cacheFile.getParentDirectory(), false, sourceHash + "*.decodedimage"); i.next();)
+            if (i.getFile() != cacheFile && ! isUnfinishedDecodedImage (i.getFile()))
+                i.getFile().deleteFile();
+    }
+
+    // Deletes the least recently used files until the cache directory is within its size limit.
+    void trimDecodedImageCache (bool deleteUnfinishedFiles)
+    {
+        File directory;
+        int64 maxSize;
+
+        {
+            const ScopedLock sl (lock);
+            directory = decodedImageCacheDirectory;
+            maxSize = maxDecodedImageCacheSize;
+        }
+
+        if (directory == File())
+            return;
+
+        struct CachedFile
+        {
+            File file;
+            int64 size;
+            Time lastUseTime;
+        };
+
+        Array<CachedFile> files;
+        int64 totalSize = 0, size = 0;
+        Time modificationTime;
+
+        for (DirectoryIterator i (directory, false, "*.decodedimage");
+             i.next (nullptr, nullptr, &size, &modificationTime, nullptr, nullptr);)
+        {
+            CachedFile cached { i.getFile(), size, modificationTime };
+
+            if (isUnfinishedDecodedImage (cached.file))
+            {
+                if (deleteUnfinishedFiles)
+                    cached.file.deleteFile();
+            }
+            else
+            {
+                files.add (cached);
+                totalSize += cached.size;
+            }
+        }
+
+        if (totalSize <= maxSize)
+            return;
+
+        std::sort (files.begin(), files.end(),
+                   [] (const CachedFile& a, const CachedFile& b) { return a.lastUseTime < b.lastUseTime; });
+
+        for (auto& cached : files)
+        {
+            if (totalSize <= maxSize)
+                break;
+
+            if (cached.file.deleteFile())
+                totalSize -= cached.size;
+        }
+    }
+
+    File getDecodedCacheFile (const File& sourceFile) const
+    {
+        const ScopedLock sl (lock);
+
+        if (decodedImageCacheDirectory == File())
+            return {};
+
+        // The modification time and size are both kept whole in the name, so an edited
+        // source file can never be mistaken for an older one.
+        return decodedImageCacheDirectory.getChildFile (String::toHexString (sourceFile.hashCode64())
+                                                          + "_" + String::toHexString (sourceFile.getLastModificationTime().toMilliseconds())
+                                                          + "_" + String::toHexString (sourceFile.getSize())
+                                                          + ".decodedimage");
+    }
+
+    enum { decodedImageMagic = 0x6a646331 /* 'jdc1' */ };
+
+    struct DecodedImageHeader
+    {
+        int32 magic, pixelFormat, width, height, bytesPerPixel, originalImageHadAlpha;
+    };
+
+    static Image readDecodedImage (const File& file)
+    {
+        MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+        auto* header = static_cast<const DecodedImageHeader*> (mappedFile.getData());
+
+        if (header == nullptr || mappedFile.getSize() < sizeof (DecodedImageHeader)
+             || header->magic != (int32) decodedImageMagic
+             || header->width <= 0 || header->height <= 0)
+            return {};
+
+        auto format = (Image::PixelFormat) header->pixelFormat;
+
+        if (format != Image::RGB && format != Image::ARGB && format != Image::SingleChannel)
+            return {};
+
+        Image image (format, header->width, header->height, false);
+        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+
+        if (destData.pixelStride != header->bytesPerPixel)
+            return {};
+
+        auto lineBytes = (size_t) (header->width * header->bytesPerPixel);
+
+        if (mappedFile.getSize() < sizeof (DecodedImageHeader) + lineBytes * (size_t) header->height)
+            return {};
+
+        auto* src = reinterpret_cast<const uint8*> (header + 1);
+
+        for (int y = 0; y < header->height; ++y)
+        {
+            memcpy (destData.getLinePointer (y), src, lineBytes);
+            src += lineBytes;
+        }
+
+        image.getProperties()->set ("originalImageHadAlpha", header->originalImageHadAlpha != 0);
+        return image;
+    }
+
+    static void writeDecodedImage (const File& file, const Image& image)
+    {
+        const Image::BitmapData srcData (image, Image::BitmapData::readOnly);
+
+        DecodedImageHeader header = { (int32) decodedImageMagic, (int32) image.getFormat(),
+                                      image.getWidth(), image.getHeight(), srcData.pixelStride,
+                                      image.getProperties()->getWithDefault ("originalImageHadAlpha",
+                                                                             image.hasAlphaChannel()) ? 1 : 0 };
+
+        TemporaryFile temp (file);
+
+        {
+            FileOutputStream out (temp.getFile());
+
+            if (! out.openedOk())
+                return;
+
+            out.write (&header, sizeof (header));
+
+            for (int y = 0; y < header.height; ++y)
+                out.write (srcData.getLinePointer (y), (size_t) (header.width * header.bytesPerPixel));
+        }
+
+        temp.overwriteTargetFileWithTemporary();
+    }
+
+    //==============================================================================
     struct Item
     {
         Image image;
@@ -105,15 +436,41 @@ struct ImageCache::Pimpl     : private Timer,
     };
 
     Array<Item> images;
+    ReferenceCountedArray<AsyncImage> pendingLoads;
     CriticalSection lock;
     unsigned int cacheTimeout = 5000;
+    int numDecodingThreads = 0;
+    File decodedImageCacheDirectory;
+    int64 maxDecodedImageCacheSize = 0;
+    ScopedPointer<ThreadPool> decodingPool;
 
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
 
-juce_ImplementSingleton_SingleThreaded (ImageCache::Pimpl)
+juce_ImplementSingleton (ImageCache::Pimpl)
 
 
+//==============================================================================
+ImageCache::AsyncImage::AsyncImage (int64 hash)  : hashCode (hash) {}
+ImageCache::AsyncImage::~AsyncImage() {}
+
+bool ImageCache::AsyncImage::isFinished() const noexcept
+{
+    const ScopedLock sl (lock);
+    return finished;
+}
+
+bool ImageCache::AsyncImage::waitUntilFinished (int timeoutMilliseconds) const
+{
+    return finishedEvent.wait (timeoutMilliseconds);
+}
+
+Image ImageCache::AsyncImage::getImage() const
+{
+    const ScopedLock sl (lock);
+    return image;
+}
+
 //==============================================================================
 Image ImageCache::getFromHashCode (const int64 hashCode)
 {
@@ -135,7 +492,15 @@ Image ImageCache::getFromFile (const File& file)
 
     if (image.isNull())
     {
-        image = ImageFileFormat::loadFrom (file);
+        auto* pimpl = Pimpl::getInstance();
+
+        if (auto pending = pimpl->findPendingLoad (hashCode))
+        {
+            pending->waitUntilFinished();
+            return pending->getImage();
+        }
+
+        image = pimpl->loadFile (file);
         addImageToCache (image, hashCode);
     }
 
@@ -149,6 +514,12 @@ Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
 
     if (image.isNull())
     {
+        if (auto pending = Pimpl::getInstance()->findPendingLoad (hashCode))
+        {
+            pending->waitUntilFinished();
+            return pending->getImage();
+        }
+
         image = ImageFileFormat::loadFrom (imageData, (size_t) dataSize);
         addImageToCache (image, hashCode);
     }
@@ -156,6 +527,61 @@ Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
     return image;
 }
 
+ImageCache::AsyncImage::Ptr ImageCache::getFromFileAsync (const File& file, std::function<void (const Image&)> callback)
+{
+    auto hashCode = file.hashCode64();
+    auto image = getFromHashCode (hashCode);
+
+    if (image.isValid())
+        return Pimpl::createFinishedLoad (hashCode, image, std::move (callback));
+
+    auto* pimpl = Pimpl::getInstance();
+    return pimpl->startAsyncLoad (hashCode, [pimpl, file] { return pimpl->loadFile (file); }, std::move (callback));
+}
+
+ImageCache::AsyncImage::Ptr ImageCache::getFromMemoryAsync (const void* imageData, const int dataSize,
+                                                            std::function<void (const Image&)> callback)
+{
+    auto hashCode = (int64) (pointer_sized_int) imageData;
+    auto image = getFromHashCode (hashCode);
+
+    if (image.isValid())
+        return Pimpl::createFinishedLoad (hashCode, image, std::move (callback));
+
+    return Pimpl::getInstance()->startAsyncLoad (hashCode,
+                                                 [imageData, dataSize] { return ImageFileFormat::loadFrom (imageData, (size_t) dataSize); },
+                                                 std::move (callback));
+}
+
+void ImageCache::setNumDecodingThreads (int numThreads)
+{
+    auto* pimpl = Pimpl::getInstance();
+    const ScopedLock sl (pimpl->lock);
+
+    // This needs to be set before any asynchronous loads have been started!
+    jassert (pimpl->decodingPool == nullptr);
+
+    pimpl->numDecodingThreads = numThreads;
+}
+
+void ImageCache::setDecodedImageCacheDirectory (const File& directory, int64 maxSizeInBytes)
+{
+    jassert (maxSizeInBytes >= 0);
+
+    if (directory != File())
+        directory.createDirectory();
+
+    auto* pimpl = Pimpl::getInstance();
+
+    {
+        const ScopedLock sl (pimpl->lock);
+        pimpl->decodedImageCacheDirectory = directory;
+        pimpl->maxDecodedImageCacheSize = maxSizeInBytes;
+    }
+
+    pimpl->trimDecodedImageCache (false);
+}
+
 void ImageCache::setCacheTimeout (const int millisecs)
 {
     jassert (millisecs >= 0);
@@ -167,4 +593,267 @@ void ImageCache::releaseUnusedImages()
     Pimpl::getInstance()->releaseUnusedImages();
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageCacheTests  : public UnitTest
+{
+public:
+    ImageCacheTests() : UnitTest ("ImageCache", "Graphics") {}
+
+    static Image createTestImage (int seed)
+    {
+        Image image (Image::ARGB, 24, 16, true);
+
+        for (int y = 0; y < image.getHeight(); ++y)
+            for (int x = 0; x < image.getWidth(); ++x)
+                image.setPixelAt (x, y, Colour ((uint8) (x * 10 + seed), (uint8) (y * 15), (uint8) (seed * 7), (uint8) 255));
+
+        return image;
+    }
+
+    static MemoryBlock createPNG (int seed, size_t paddedSize = 0)
+    {
+        MemoryOutputStream out;
+        PNGImageFormat().writeImageToStream (createTestImage (seed), out);
+
+        // the decoder ignores anything after the end of the PNG data
+        while (out.getDataSize() < paddedSize)
+            out.writeByte (0);
+
+        return out.getMemoryBlock();
+    }
+
+    static bool imagesMatch (const Image& a, const Image& b)
+    {
+        if (a.isNull() || b.isNull() || a.getBounds() != b.getBounds())
+            return false;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getPixelAt (x, y) != b.getPixelAt (x, y))
+                    return false;
+
+        return true;
+    }
+
+    void releaseFromCache (int64 hashCode)
+    {
+        // a decoding thread's job may briefly hang on to the image after it's finished
+        for (int i = 0; i < 200; ++i)
+        {
+            ImageCache::releaseUnusedImages();
+
+            if (ImageCache::getFromHashCode (hashCode).isNull())
+                return;
+
+            Thread::sleep (5);
+        }
+
+        expect (false, "the image was never released");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Asynchronous loads from memory");
+        {
+            auto data = createPNG (1);
+
+            auto first  = ImageCache::getFromMemoryAsync (data.getData(), (int) data.getSize());
+            auto second = ImageCache::getFromMemoryAsync (data.getData(), (int) data.getSize());
+
+            expect (first->waitUntilFinished (5000));
+            expect (second->waitUntilFinished (5000));
+            expect (imagesMatch (first->getImage(), createTestImage (1)));
+
+            // both requests should have been served by the same decode
+            expect (first->getImage() == second->getImage());
+            expect (ImageCache::getFromMemory (data.getData(), (int) data.getSize()) == first->getImage());
+
+            first = nullptr;
+            second = nullptr;
+            releaseFromCache ((int64) (pointer_sized_int) data.getData());
+        }
+
+        beginTest ("Many loads in flight at once");
+        {
+            OwnedArray<MemoryBlock> blocks;
+            ReferenceCountedArray<ImageCache::AsyncImage> loads;
+
+            for (int i = 0; i < 20; ++i)
+            {
+                auto* block = blocks.add (new MemoryBlock (createPNG (i)));
+                loads.add (ImageCache::getFromMemoryAsync (block->getData(), (int) block->getSize()));
+            }
+
+            for (int i = 0; i < loads.size(); ++i)
+            {
+                expect (loads[i]->waitUntilFinished (5000));
+                expect (imagesMatch (loads[i]->getImage(), createTestImage (i)));
+            }
+
+            loads.clear();
+
+            for (auto* block : blocks)
+                releaseFromCache ((int64) (pointer_sized_int) block->getData());
+        }
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        if (MessageManager::getInstance()->isThisTheMessageThread())
+        {
+            beginTest ("Callbacks arrive on the message thread");
+
+            auto data = createPNG (2);
+            bool calledBack = false, wasOnMessageThread = false;
+            Image delivered;
+
+            auto load = ImageCache::getFromMemoryAsync (data.getData(), (int) data.getSize(), [&] (const Image& image)
+            {
+                calledBack = true;
+                wasOnMessageThread = MessageManager::getInstance()->isThisTheMessageThread();
+                delivered = image;
+            });
+
+            for (int i = 0; i < 500 && ! calledBack; ++i)
+                MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+            expect (calledBack);
+            expect (wasOnMessageThread);
+            expect (delivered == load->getImage());
+
+            load = nullptr;
+            delivered = {};
+            releaseFromCache ((int64) (pointer_sized_int) data.getData());
+        }
+       #endif
+
+        beginTest ("Decoded image cache directory");
+        {
+            auto dir = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("ImageCacheTest", {}, false);
+            ImageCache::setDecodedImageCacheDirectory (dir);
+
+            auto source = dir.getSiblingFile (dir.getFileName() + ".png");
+            auto hashCode = source.hashCode64();
+
+            // These times and sizes were chosen so that the two versions of the file
+            // would have produced the same fingerprint under the cache's old scheme of
+            // xor-ing the modification time with the shifted size.
+            const int64 firstTime = 1500000000000, secondTime = 1499868928000;
+            const size_t firstSize = 8192, secondSize = 8192 ^ 157;
+
+            auto writeSource = [&] (const MemoryBlock& data, int64 time)
+            {
+                expect (source.replaceWithData (data.getData(), data.getSize()));
+                expect (source.setLastModificationTime (Time (time)));
+            };
+
+            auto firstData = createPNG (3, firstSize);
+            expectEquals ((int) firstData.getSize(), (int) firstSize);
+            writeSource (firstData, firstTime);
+
+            auto load = ImageCache::getFromFileAsync (source);
+            expect (load->waitUntilFinished (5000));
+            expect (imagesMatch (load->getImage(), createTestImage (3)));
+            expectEquals (dir.getNumberOfChildFiles (File::findFiles), 1);
+
+            load = nullptr;
+            releaseFromCache (hashCode);
+
+            // Same size and timestamp but garbage content: this can only succeed if the
+            // image comes back out of the decoded cache rather than the source file.
+            {
+                MemoryBlock garbage (firstSize, true);
+                writeSource (garbage, firstTime);
+            }
+
+            expect (imagesMatch (ImageCache::getFromFile (source), createTestImage (3)));
+            releaseFromCache (hashCode);
+
+            // A genuinely different file mustn't pick up the stale entry, which is thrown away.
+            auto secondData = createPNG (4, secondSize);
+            expectEquals ((int) secondData.getSize(), (int) secondSize);
+            writeSource (secondData, secondTime);
+
+            expect (imagesMatch (ImageCache::getFromFile (source), createTestImage (4)));
+            expectEquals (dir.getNumberOfChildFiles (File::findFiles), 1);
+            releaseFromCache (hashCode);
+
+            ImageCache::setDecodedImageCacheDirectory ({});
+            source.deleteFile();
+            dir.deleteRecursively();
+        }
+
+        beginTest ("Decoded image cache size limit");
+        {
+            auto dir = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("ImageCacheTest", {}, false);
+            auto sourceDir = dir.getSiblingFile (dir.getFileName() + "_sources");
+            sourceDir.createDirectory();
+            ImageCache::setDecodedImageCacheDirectory (dir);
+
+            File sources[3];
+
+            for (int i = 0; i < 3; ++i)
+            {
+                auto data = createPNG (5 + i);
+                sources[i] = sourceDir.getChildFile (String (i) + ".png");
+                expect (sources[i].replaceWithData (data.getData(), data.getSize()));
+            }
+
+            auto getCacheEntries = [&] (const File& source)
+            {
+                Array<File> entries;
+                dir.findChildFiles (entries, File::findFiles, false, String::toHexString (source.hashCode64()) + "_*");
+                return entries;
+            };
+
+            auto hasCacheEntry = [&] (const File& source)   { return getCacheEntries (source).size() == 1; };
+
+            auto load = [&] (int index)
+            {
+                expect (imagesMatch (ImageCache::getFromFile (sources[index]), createTestImage (5 + index)));
+                releaseFromCache (sources[index].hashCode64());
+            };
+
+            // file times may only be stored to the nearest second, so this pushes an entry's
+            // last use far enough into the past that the order can't be ambiguous
+            auto makeOlder = [&] (const File& source, int seconds)
+            {
+                for (auto& entry : getCacheEntries (source))
+                    expect (entry.setLastModificationTime (Time::getCurrentTime() - RelativeTime::seconds (seconds)));
+            };
+
+            load (0);
+
+            Array<File> entries;
+            dir.findChildFiles (entries, File::findFiles, false);
+            auto entrySize = entries.getFirst().getSize();
+            expect (entrySize > 0);
+
+            // room for two entries, but not three
+            ImageCache::setDecodedImageCacheDirectory (dir, entrySize * 2 + entrySize / 2);
+
+            load (1);
+            makeOlder (sources[0], 20);
+            makeOlder (sources[1], 10);
+
+            // reading the first entry again should make the second the least recently used
+            load (0);
+            load (2);
+
+            expectEquals (dir.getNumberOfChildFiles (File::findFiles), 2);
+            expect (hasCacheEntry (sources[0]));
+            expect (! hasCacheEntry (sources[1]));
+            expect (hasCacheEntry (sources[2]));
+
+            ImageCache::setDecodedImageCacheDirectory ({});
+            sourceDir.deleteRecursively();
+            dir.deleteRecursively();
+        }
+    }
+};
+
+static ImageCacheTests imageCacheTests;
+
+#endif
+
 } // namespace juce
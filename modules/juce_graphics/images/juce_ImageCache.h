@@ -79,6 +79,106 @@ public:
     */
     static Image getFromMemory (const void* imageData, int dataSize);
 
+private:
+    //==============================================================================
+    struct Pimpl;
+    friend struct Pimpl;
+
+public:
+    //==============================================================================
+    /**
+        A handle to an image that the cache is decoding on one of its background threads.
+
+        You get one of these from getFromFileAsync() or getFromMemoryAsync(). If several
+        requests are made for the same image before it has finished loading, they'll all
+        share the same handle, and the image will only be decoded once.
+
+        @see getFromFileAsync, getFromMemoryAsync
+    */
+    class JUCE_API  AsyncImage  : public ReferenceCountedObject
+    {
+    public:
+        /** Destructor. */
+        ~AsyncImage();
+
+        /** Returns true once the image has finished loading (successfully or not). */
+        bool isFinished() const noexcept;
+
+        /** Blocks until the image has finished loading, or the timeout expires.
+            A timeout of less than zero will wait indefinitely.
+            @returns true if the image has finished loading
+        */
+        bool waitUntilFinished (int timeoutMilliseconds = -1) const;
+
+        /** Returns the decoded image.
+            This will be an invalid image if it hasn't finished loading yet, or if
+            the data couldn't be decoded.
+        */
+        Image getImage() const;
+
+        /** A typedef for a pointer to one of these objects. */
+        typedef ReferenceCountedObjectPtr<AsyncImage> Ptr;
+
+    private:
+        friend struct ImageCache::Pimpl;
+
+        AsyncImage (int64 hashCode);
+
+        const int64 hashCode;
+        Image image;
+        Array<std::function<void (const Image&)>> callbacks;
+        WaitableEvent finishedEvent { true };
+        bool finished = false;
+        CriticalSection lock;
+
+        JUCE_DECLARE_NON_COPYABLE (AsyncImage)
+    };
+
+    /** Starts loading an image from a file on a background thread, (or just returns a
+        finished handle if the image is already cached).
+
+        The image is decoded by the cache's pool of decoding threads and added to the cache
+        when it's ready. If you provide a callback, it'll be called on the message thread
+        with the decoded image once it's available, (or with an invalid image if the file
+        couldn't be loaded).
+
+        @see getFromFile, setNumDecodingThreads
+    */
+    static AsyncImage::Ptr getFromFileAsync (const File& file,
+                                             std::function<void (const Image&)> callback = nullptr);
+
+    /** Starts loading an image from an in-memory image file on a background thread, (or just
+        returns a finished handle if the image is already cached).
+
+        The data must remain valid until the load has finished - this is intended for use with
+        things like BinaryData resources, which stay in memory for the lifetime of the app.
+
+        @see getFromMemory, getFromFileAsync
+    */
+    static AsyncImage::Ptr getFromMemoryAsync (const void* imageData, int dataSize,
+                                               std::function<void (const Image&)> callback = nullptr);
+
+    /** Sets the number of threads that the cache will use to decode images asynchronously.
+
+        By default this is one fewer than the number of CPUs. It must be called before
+        the first asynchronous load is started.
+    */
+    static void setNumDecodingThreads (int numThreads);
+
+    /** Sets a folder in which the cache can keep copies of decoded image files.
+
+        When this is set, images that are loaded from files are also written to this folder
+        in a raw, premultiplied form, and subsequent loads of the same (unmodified) file can
+        read the pixels directly from a memory-mapped copy instead of decoding the original.
+
+        If the files in the folder add up to more than maxSizeInBytes, the ones that were
+        least recently used are deleted.
+
+        Pass File() to disable this, which is the default.
+    */
+    static void setDecodedImageCacheDirectory (const File& directory,
+                                               int64 maxSizeInBytes = 256 * 1024 * 1024);
+
     //==============================================================================
     /** Checks the cache for an image with a particular hashcode.
 
@@ -114,9 +214,6 @@ public:
 
 private:
     //==============================================================================
-    struct Pimpl;
-    friend struct Pimpl;
-
     ImageCache();
     ~ImageCache();
 
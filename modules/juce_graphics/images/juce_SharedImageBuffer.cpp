@@ -0,0 +1,477 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct SharedImageBuffer::Header
+{
+    enum
+    {
+        magicValue = 0x6a736962,  // 'jsib'
+        headerSize = 64
+    };
+
+    uint32 magic;
+    int32 pixelFormat, width, height, lineStride, pixelStride;
+
+    // The low two bits of the state hold the index + 1 of the buffer that's being written,
+    // and the next two bits hold the index + 1 of the one that the reader is holding.
+    Atomic<int32> state, lastFrameNumber;
+    Atomic<int32> frameNumbers[2];
+
+    size_t getBufferSize() const noexcept               { return (size_t) lineStride * (size_t) height; }
+    size_t getTotalSize() const noexcept                { return headerSize + 2 * getBufferSize(); }
+
+    uint8* getBufferData (int index) noexcept
+    {
+        return reinterpret_cast<uint8*> (this) + headerSize + getBufferSize() * (size_t) index;
+    }
+
+    static int getWritingIndex (int32 s) noexcept                   { return (s & 3) - 1; }
+    static int getReadingIndex (int32 s) noexcept                   { return ((s >> 2) & 3) - 1; }
+    static int32 withWritingIndex (int32 s, int index) noexcept     { return (s & ~3) | (index + 1); }
+    static int32 withReadingIndex (int32 s, int index) noexcept     { return (s & ~12) | ((index + 1) << 2); }
+};
+
+//==============================================================================
+class SharedImageBuffer::BufferPixelData  : public ImagePixelData
+{
+public:
+    BufferPixelData (SharedImageBuffer& b, int index)
+        : ImagePixelData (b.getFormat(), b.getWidth(), b.getHeight()),
+          owner (&b),
+          imageData (b.header->getBufferData (index)),
+          pixelStride (b.header->pixelStride),
+          lineStride (b.header->lineStride)
+    {
+        // The image will keep the buffer alive, so the buffer has to be held by a
+        // SharedImageBuffer::Ptr, or else releasing the image will delete it!
+        jassert (b.getReferenceCount() > 1);
+    }
+
+    LowLevelGraphicsContext* createLowLevelContext() override
+    {
+        sendDataChangeMessage();
+        return new LowLevelGraphicsSoftwareRenderer (Image (this));
+    }
+
+    void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode mode) override
+    {
+        bitmap.data = imageData + x * pixelStride + y * lineStride;
+        bitmap.pixelFormat = pixelFormat;
+        bitmap.lineStride = lineStride;
+        bitmap.pixelStride = pixelStride;
+
+        if (mode != Image::BitmapData::readOnly)
+            sendDataChangeMessage();
+    }
+
+    ImagePixelData::Ptr clone() override
+    {
+        // copies are made in normal memory, so that they won't be affected by later frames
+        Image copy (SoftwareImageType().create (pixelFormat, width, height, false));
+        Image::BitmapData dest (copy, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+            memcpy (dest.getLinePointer (y), imageData + y * lineStride, (size_t) (width * pixelStride));
+
+        return copy.getPixelData();
+    }
+
+    ImageType* createType() const override    { return new SoftwareImageType(); }
+
+private:
+    SharedImageBuffer::Ptr owner;
+    uint8* const imageData;
+    const int pixelStride, lineStride;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferPixelData)
+};
+
+//==============================================================================
+SharedImageBuffer::SharedImageBuffer (const File& f, Image::PixelFormat format, int width, int height)
+    : file (f), ownsFile (true)
+{
+    jassert (format != Image::UnknownFormat && width > 0 && height > 0);
+
+    auto pixelStride = format == Image::RGB ? 3 : (format == Image::ARGB ? 4 : 1);
+    auto lineStride = (pixelStride * jmax (1, width) + 3) & ~3;
+    auto totalSize = (int64) Header::headerSize + 2 * (int64) lineStride * jmax (1, height);
+
+    file.deleteFile();
+
+    {
+        FileOutputStream out (file);
+
+        if (out.failedToOpen() || ! out.setPosition (totalSize - 1) || ! out.writeByte (0))
+            return;
+    }
+
+    if (openMappedFile())
+    {
+        header->pixelFormat = (int32) format;
+        header->width       = width;
+        header->height      = jmax (1, height);
+        header->lineStride  = lineStride;
+        header->pixelStride = pixelStride;
+        header->state = 0;
+        header->lastFrameNumber = 0;
+        header->frameNumbers[0] = 0;
+        header->frameNumbers[1] = 0;
+
+        // the magic number goes in last, so another process can't open a half-written header
+        header->state.memoryBarrier();
+        header->magic = (uint32) Header::magicValue;
+    }
+}
+
+SharedImageBuffer::SharedImageBuffer (const File& f)  : file (f)
+{
+    if (openMappedFile())
+    {
+        if (header->magic != (uint32) Header::magicValue
+             || header->width <= 0 || header->height <= 0
+             || header->pixelStride != (header->pixelFormat == Image::RGB ? 3 : (header->pixelFormat == Image::ARGB ? 4 : 1))
+             || header->lineStride < header->width * header->pixelStride
+             || mappedFile->getSize() < header->getTotalSize())
+        {
+            header = nullptr;
+            mappedFile = nullptr;
+        }
+    }
+}
+
+SharedImageBuffer::~SharedImageBuffer()
+{
+    if (header != nullptr)
+    {
+        if (readingIndex >= 0)
+            releaseFrame();
+
+        if (writingIndex >= 0)
+        {
+            // abandon the frame without publishing it (beginFrame() has already
+            // invalidated the buffer, so the reader won't pick up the partial frame)
+            for (;;)
+            {
+                auto oldState = header->state.get();
+
+                if (header->state.compareAndSetBool (Header::withWritingIndex (oldState, -1), oldState))
+                    break;
+            }
+        }
+    }
+
+    header = nullptr;
+    mappedFile = nullptr;
+
+    if (ownsFile)
+        file.deleteFile();
+}
+
+bool SharedImageBuffer::openMappedFile()
+{
+    mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readWrite);
+
+    if (mappedFile->getData() == nullptr || mappedFile->getSize() < (size_t) Header::headerSize)
+    {
+        mappedFile = nullptr;
+        return false;
+    }
+
+    header = static_cast<Header*> (mappedFile->getData());
+    return true;
+}
+
+Image::PixelFormat SharedImageBuffer::getFormat() const noexcept    { return header != nullptr ? (Image::PixelFormat) header->pixelFormat : Image::UnknownFormat; }
+int SharedImageBuffer::getWidth() const noexcept                    { return header != nullptr ? header->width : 0; }
+int SharedImageBuffer::getHeight() const noexcept                   { return header != nullptr ? header->height : 0; }
+int SharedImageBuffer::getLatestFrameNumber() const noexcept        { return header != nullptr ? header->lastFrameNumber.get() : 0; }
+
+Image SharedImageBuffer::getImageForBuffer (int index)
+{
+    return Image (new BufferPixelData (*this, index));
+}
+
+//==============================================================================
+Image SharedImageBuffer::beginFrame()
+{
+    jassert (writingIndex < 0); // you need to call endFrame() before starting another one!
+
+    if (header == nullptr || writingIndex >= 0)
+        return {};
+
+    for (;;)
+    {
+        auto oldState = header->state.get();
+        auto readerIndex = Header::getReadingIndex (oldState);
+
+        // use whichever buffer the reader isn't holding, or if it's not holding
+        // either of them, the one with the oldest frame in it
+        auto index = readerIndex >= 0 ? 1 - readerIndex
+                                      : (header->frameNumbers[0].get() <= header->frameNumbers[1].get() ? 0 : 1);
+
+        if (header->state.compareAndSetBool (Header::withWritingIndex (oldState, index), oldState))
+        {
+            // The buffer's old frame is about to be overwritten, so it mustn't be offered
+            // to the reader again, even if this frame is abandoned before it's finished
+            header->frameNumbers[index] = 0;
+
+            writingIndex = index;
+            return getImageForBuffer (index);
+        }
+    }
+}
+
+void SharedImageBuffer::endFrame()
+{
+    jassert (writingIndex >= 0); // this must be preceded by a call to beginFrame()!
+
+    if (header != nullptr && writingIndex >= 0)
+    {
+        header->frameNumbers[writingIndex] = ++(header->lastFrameNumber);
+        writingIndex = -1;
+
+        for (;;)
+        {
+            auto oldState = header->state.get();
+
+            if (header->state.compareAndSetBool (Header::withWritingIndex (oldState, -1), oldState))
+                break;
+        }
+    }
+}
+
+Image SharedImageBuffer::acquireLatestFrame()
+{
+    if (header == nullptr)
+        return {};
+
+    for (;;)
+    {
+        auto oldState = header->state.get();
+        auto writerIndex = Header::getWritingIndex (oldState);
+        int index = -1, frameNumber = 0;
+
+        for (int i = 0; i < 2; ++i)
+        {
+            if (i != writerIndex)
+            {
+                auto n = header->frameNumbers[i].get();
+
+                if (n > frameNumber)
+                {
+                    index = i;
+                    frameNumber = n;
+                }
+            }
+        }
+
+        if (header->state.compareAndSetBool (Header::withReadingIndex (oldState, index), oldState))
+        {
+            readingIndex = index;
+            acquiredFrameNumber = frameNumber;
+
+            return index >= 0 ? getImageForBuffer (index) : Image();
+        }
+    }
+}
+
+void SharedImageBuffer::releaseFrame()
+{
+    if (header != nullptr && readingIndex >= 0)
+    {
+        readingIndex = -1;
+
+        for (;;)
+        {
+            auto oldState = header->state.get();
+
+            if (header->state.compareAndSetBool (Header::withReadingIndex (oldState, -1), oldState))
+                break;
+        }
+    }
+}
+
+//==============================================================================
+bool SharedImageBuffer::sendFrameNotification (InterprocessConnection& connection) const
+{
+    uint32 data[2] = { ByteOrder::swapIfBigEndian ((uint32) 0x6a736966),  // 'jsif'
+                       ByteOrder::swapIfBigEndian ((uint32) getLatestFrameNumber()) };
+
+    return connection.sendMessage (MemoryBlock (data, sizeof (data)));
+}
+
+bool SharedImageBuffer::isFrameNotification (const MemoryBlock& message) noexcept
+{
+    return message.getSize() == 8
+            && ByteOrder::littleEndianInt (message.getData()) == 0x6a736966;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SharedImageBufferTests  : public UnitTest
+{
+public:
+    SharedImageBufferTests() : UnitTest ("SharedImageBuffer", "Graphics") {}
+
+    static Colour getColourForFrame (int frameNumber)
+    {
+        return Colour ((uint8) (frameNumber * 13), (uint8) (frameNumber * 7), (uint8) (frameNumber * 3));
+    }
+
+    static void renderFrame (SharedImageBuffer& buffer, Colour colour)
+    {
+        {
+            auto image = buffer.beginFrame();
+            image.clear (image.getBounds(), colour);
+        }
+
+        buffer.endFrame();
+    }
+
+    static bool isFilledWith (const Image& image, Colour colour)
+    {
+        for (int y = 0; y < image.getHeight(); ++y)
+            for (int x = 0; x < image.getWidth(); ++x)
+                if (image.getPixelAt (x, y) != colour)
+                    return false;
+
+        return true;
+    }
+
+    void runTest() override
+    {
+        auto file = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("SharedImageBufferTest", ".tmp");
+
+        beginTest ("Handing frames over");
+        {
+            SharedImageBuffer::Ptr writer (new SharedImageBuffer (file, Image::ARGB, 16, 8));
+            SharedImageBuffer::Ptr reader (new SharedImageBuffer (file));
+
+            expect (writer->isValid() && reader->isValid());
+            expectEquals (reader->getWidth(), 16);
+            expect (reader->acquireLatestFrame().isNull());
+
+            renderFrame (*writer, Colours::red);
+            expect (isFilledWith (reader->acquireLatestFrame(), Colours::red));
+            expectEquals (reader->getAcquiredFrameNumber(), 1);
+
+            // the frame the reader is holding mustn't be touched by later frames
+            auto held = reader->acquireLatestFrame();
+            renderFrame (*writer, Colours::green);
+            renderFrame (*writer, Colours::blue);
+
+            expect (isFilledWith (held, Colours::red));
+            expectEquals (writer->getLatestFrameNumber(), 3);
+
+            held = {};
+            reader->releaseFrame();
+            expect (isFilledWith (reader->acquireLatestFrame(), Colours::blue));
+            reader->releaseFrame();
+        }
+
+        beginTest ("Abandoned frames aren't offered to the reader");
+        {
+            SharedImageBuffer::Ptr writer (new SharedImageBuffer (file, Image::ARGB, 16, 8));
+            SharedImageBuffer::Ptr reader (new SharedImageBuffer (file));
+
+            renderFrame (*writer, Colours::red);
+            reader->acquireLatestFrame();
+            renderFrame (*writer, Colours::green);
+
+            // with the reader holding the first frame, this overwrites the second one
+            {
+                auto image = writer->beginFrame();
+                image.clear ({ 0, 0, 16, 4 }, Colours::blue);
+            }
+
+            writer = nullptr;
+
+            auto image = reader->acquireLatestFrame();
+            expectEquals (reader->getAcquiredFrameNumber(), 1);
+            expect (isFilledWith (image, Colours::red));
+        }
+
+        beginTest ("A writer and a reader on separate threads");
+        {
+            SharedImageBuffer::Ptr writer (new SharedImageBuffer (file, Image::ARGB, 32, 32));
+            SharedImageBuffer::Ptr reader (new SharedImageBuffer (file));
+
+            struct WriterThread  : public Thread
+            {
+                WriterThread (SharedImageBuffer& b)  : Thread ("SharedImageBuffer writer"), buffer (b) {}
+
+                void run() override
+                {
+                    for (int i = 1; i <= 500 && ! threadShouldExit(); ++i)
+                        renderFrame (buffer, getColourForFrame (i));
+                }
+
+                SharedImageBuffer& buffer;
+            };
+
+            WriterThread thread (*writer);
+            thread.startThread();
+
+            int numFramesChecked = 0, lastFrameNumber = 0;
+            bool allFramesComplete = true, framesInOrder = true;
+
+            while (thread.isThreadRunning() || lastFrameNumber < 500)
+            {
+                auto image = reader->acquireLatestFrame();
+                auto frameNumber = reader->getAcquiredFrameNumber();
+
+                if (image.isValid())
+                {
+                    framesInOrder = framesInOrder && frameNumber >= lastFrameNumber;
+                    allFramesComplete = allFramesComplete && isFilledWith (image, getColourForFrame (frameNumber));
+                    lastFrameNumber = frameNumber;
+                    ++numFramesChecked;
+                }
+
+                image = {};
+                reader->releaseFrame();
+                Thread::yield();
+            }
+
+            expect (numFramesChecked > 0);
+            expect (framesInOrder);
+            expect (allFramesComplete);
+            expectEquals (lastFrameNumber, 500);
+        }
+
+        file.deleteFile();
+    }
+};
+
+static SharedImageBufferTests sharedImageBufferTests;
+
+#endif
+
+} // namespace juce
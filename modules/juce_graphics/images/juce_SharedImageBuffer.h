@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A pair of image buffers held in a memory-mapped file, which two processes can
+    share in order to pass rendered frames between them without copying any pixels.
+
+    One process creates the buffer and renders into it, and the other opens the same
+    file and draws the frames that it produces. A typical use is an editor that's
+    running in a separate process for crash-isolation: the child renders into the
+    shared buffer, and the host composites the latest frame onto its own window.
+
+    The two buffers are handed back and forth with a lock-free protocol that lives in
+    the shared memory itself, so neither side ever has to block. The renderer calls
+    beginFrame() to get an Image to draw into, and endFrame() to publish it. The reader
+    calls acquireLatestFrame() to get the most recently finished frame, which is then
+    guaranteed not to be touched by the renderer until releaseFrame() is called (or the
+    next frame is acquired). The renderer always has a buffer available to draw into,
+    so if the reader is slow it'll just skip the frames in between.
+
+    The buffer doesn't need a connection to work, but if the processes are already
+    talking over an InterprocessConnection, sendFrameNotification() can be used to
+    tell the other side when a new frame is ready, so that it doesn't need to poll:
+
+    @code
+    // in the child process:
+    auto image = sharedBuffer->beginFrame();
+    {
+        Graphics g (image);
+        editor.paintEntireComponent (g, true);
+    }
+    sharedBuffer->endFrame();
+    sharedBuffer->sendFrameNotification (connection);
+
+    // in the host's InterprocessConnection::messageReceived():
+    if (SharedImageBuffer::isFrameNotification (message))
+        repaint();
+
+    // ...and in the host's paint():
+    g.drawImageAt (sharedBuffer->acquireLatestFrame(), 0, 0);
+    @endcode
+
+    Images returned by beginFrame() and acquireLatestFrame() point directly at the
+    shared memory, and only remain valid until the corresponding endFrame() or
+    releaseFrame() call - if you need to keep hold of the pixels for longer, use
+    Image::createCopy().
+
+    Each of those images also holds a reference to the SharedImageBuffer, which keeps the
+    memory mapped for as long as any of them exist. That means a SharedImageBuffer must
+    always be created with new and held by a SharedImageBuffer::Ptr - if it's on the
+    stack or in a ScopedPointer, the last image to be released will delete it.
+
+    @see Image, InterprocessConnection, MemoryMappedFile
+*/
+class JUCE_API  SharedImageBuffer  : public ReferenceCountedObject
+{
+public:
+    //==============================================================================
+    /** Creates a new shared buffer, replacing any existing file at the given location.
+
+        This is normally called by the process that's going to do the rendering, which
+        then passes the file's location to the other process so it can open it.
+        If the file can't be created, isValid() will return false.
+    */
+    SharedImageBuffer (const File& file, Image::PixelFormat format, int width, int height);
+
+    /** Opens a shared buffer that was created by another process.
+        If the file doesn't exist or isn't a valid buffer, isValid() will return false.
+    */
+    explicit SharedImageBuffer (const File& file);
+
+    /** Destructor.
+        If this object created the file, it'll be deleted.
+    */
+    ~SharedImageBuffer();
+
+    /** A pointer to a SharedImageBuffer, which is how one should always be held. */
+    typedef ReferenceCountedObjectPtr<SharedImageBuffer> Ptr;
+
+    //==============================================================================
+    /** Returns true if the shared memory was successfully created or opened. */
+    bool isValid() const noexcept                       { return header != nullptr; }
+
+    /** Returns the file that holds the shared memory. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the pixel format of the buffers. */
+    Image::PixelFormat getFormat() const noexcept;
+
+    /** Returns the width of the buffers. */
+    int getWidth() const noexcept;
+
+    /** Returns the height of the buffers. */
+    int getHeight() const noexcept;
+
+    //==============================================================================
+    /** Called by the renderer to get an image to draw the next frame into.
+
+        This picks whichever buffer the reader isn't currently using. It'll still contain
+        the contents of an older frame, so you'll need to redraw or clear it.
+        Once you've finished drawing, call endFrame() to publish it.
+    */
+    Image beginFrame();
+
+    /** Publishes the frame that was started with beginFrame().
+        After this call, the image that beginFrame() returned must no longer be used.
+    */
+    void endFrame();
+
+    /** Returns the number of the most recent frame that the renderer has published,
+        or 0 if none have been finished yet.
+    */
+    int getLatestFrameNumber() const noexcept;
+
+    //==============================================================================
+    /** Called by the reader to get the most recently published frame.
+
+        The image that's returned won't be modified by the renderer until releaseFrame()
+        is called, or another frame is acquired. If no frames have been published yet,
+        this returns a null image.
+    */
+    Image acquireLatestFrame();
+
+    /** Returns the number of the frame that acquireLatestFrame() last returned, or 0. */
+    int getAcquiredFrameNumber() const noexcept         { return acquiredFrameNumber; }
+
+    /** Allows the renderer to re-use the buffer that was returned by acquireLatestFrame().
+        After this call, that image must no longer be used.
+    */
+    void releaseFrame();
+
+    //==============================================================================
+    /** Sends a short message over a connection to tell the other process that a new
+        frame has been published.
+        @see isFrameNotification
+    */
+    bool sendFrameNotification (InterprocessConnection&) const;
+
+    /** Returns true if a message received by an InterprocessConnection is one that
+        was sent by sendFrameNotification().
+    */
+    static bool isFrameNotification (const MemoryBlock& message) noexcept;
+
+private:
+    //==============================================================================
+    struct Header;
+    class BufferPixelData;
+
+    File file;
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    Header* header = nullptr;
+    bool ownsFile = false;
+    int writingIndex = -1, readingIndex = -1, acquiredFrameNumber = 0;
+
+    bool openMappedFile();
+    Image getImageForBuffer (int index);
+    void clearReadingIndex();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedImageBuffer)
+};
+
+} // namespace juce
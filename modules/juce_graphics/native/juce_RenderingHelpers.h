@@ -138,7 +138,11 @@ public:
 };
 
 //==============================================================================
-/** Holds a cache of recently-used glyph objects of some type. */
+/** Holds a cache of recently-used glyph objects of some type.
+
+    Glyphs are found via a hash of their font and glyph number, and when the cache
+    fills up, the least-recently-used glyphs are recycled.
+*/
 template <class CachedGlyphType, class RenderTargetType>
 class GlyphCache  : private DeletedAtShutdown
 {
@@ -168,9 +172,12 @@ public:
     {
         const ScopedLock sl (lock);
         glyphs.clear();
+        zeromem (hashTable, sizeof (hashTable));
         addNewGlyphSlots (120);
         hits.set (0);
         misses.set (0);
+        totalHits.set (0);
+        totalMisses.set (0);
     }
 
     void drawGlyph (RenderTargetType& target, const Font& font, const int glyphNumber, Point<float> pos)
@@ -185,39 +192,124 @@ public:
     ReferenceCountedObjectPtr<CachedGlyphType> findOrCreateGlyph (const Font& font, int glyphNumber)
     {
         const ScopedLock sl (lock);
+        return findOrCreateGlyph (font, getFontHash (font), glyphNumber);
+    }
+
+    /** Looks up a run of glyphs which all use the same font, and passes each one to
+        the callback, which is called as (int indexInRun, CachedGlyphType&).
+
+        The cache's lock is held for the whole run, so the callback can safely use
+        any lazily-created state inside the glyph objects.
+    */
+    template <typename Callback>
+    void withGlyphRun (const Font& font, const int* glyphNumbers, int numGlyphs, Callback&& callback)
+    {
+        const ScopedLock sl (lock);
+        auto fontHash = getFontHash (font);
 
-        if (CachedGlyphType* g = findExistingGlyph (font, glyphNumber))
+        for (int i = 0; i < numGlyphs; ++i)
         {
-            ++hits;
-            return g;
+            if (auto* g = findOrCreateGlyph (font, fontHash, glyphNumbers[i]))
+            {
+                g->lastAccessCount = ++accessCounter;
+                callback (i, *g);
+            }
         }
+    }
 
-        ++misses;
-        CachedGlyphType* g = getGlyphForReuse();
-        jassert (g != nullptr);
-        g->generate (font, glyphNumber);
-        return g;
+    /** Returns the number of lookups that found an existing glyph since the last reset(). */
+    int64 getTotalHits() const noexcept             { return totalHits.get(); }
+
+    /** Returns the number of lookups that had to create a glyph since the last reset(). */
+    int64 getTotalMisses() const noexcept           { return totalMisses.get(); }
+
+    /** Returns the number of glyph slots currently allocated. */
+    int getNumGlyphSlots() const
+    {
+        const ScopedLock sl (lock);
+        return glyphs.size();
     }
 
 private:
     friend struct ContainerDeletePolicy<CachedGlyphType>;
+    enum { hashTableSize = 256 };
+
     ReferenceCountedArray<CachedGlyphType> glyphs;
+    CachedGlyphType* hashTable[hashTableSize];
     Atomic<int> accessCounter, hits, misses;
+    Atomic<int64> totalHits, totalMisses;
     CriticalSection lock;
 
-    CachedGlyphType* findExistingGlyph (const Font& font, int glyphNumber) const
+    static uint32 getFontHash (const Font& font) noexcept
+    {
+        auto h = (uint32) font.getTypefaceName().hashCode() * 31u + (uint32) font.getTypefaceStyle().hashCode();
+        h = h * 101u + (uint32) roundToInt (font.getHeight() * 64.0f);
+        return h * 101u + (uint32) roundToInt (font.getHorizontalScale() * 256.0f);
+    }
+
+    static uint32 getGlyphHash (uint32 fontHash, int glyphNumber) noexcept
+    {
+        return fontHash * 31u + (uint32) glyphNumber;
+    }
+
+    CachedGlyphType* findOrCreateGlyph (const Font& font, uint32 fontHash, int glyphNumber)
     {
-        for (int i = 0; i < glyphs.size(); ++i)
+        auto hash = getGlyphHash (fontHash, glyphNumber);
+
+        if (CachedGlyphType* g = findExistingGlyph (font, hash, glyphNumber))
         {
-            CachedGlyphType* const g = glyphs.getUnchecked (i);
+            ++hits;
+            ++totalHits;
+            return g;
+        }
+
+        ++misses;
+        ++totalMisses;
+        CachedGlyphType* g = getGlyphForReuse();
+        jassert (g != nullptr);
 
-            if (g->glyph == glyphNumber && g->font == font)
+        removeFromHashTable (g);
+        g->generate (font, glyphNumber);
+        g->hash = hash;
+        addToHashTable (g);
+        return g;
+    }
+
+    CachedGlyphType* findExistingGlyph (const Font& font, uint32 hash, int glyphNumber) const noexcept
+    {
+        for (auto* g = hashTable[hash % hashTableSize]; g != nullptr; g = g->nextInHashBucket)
+            if (g->hash == hash && g->glyph == glyphNumber && g->font == font)
                 return g;
-        }
 
         return nullptr;
     }
 
+    void addToHashTable (CachedGlyphType* g) noexcept
+    {
+        auto& bucket = hashTable[g->hash % hashTableSize];
+        g->nextInHashBucket = bucket;
+        g->isInHashTable = true;
+        bucket = g;
+    }
+
+    void removeFromHashTable (CachedGlyphType* g) noexcept
+    {
+        if (! g->isInHashTable)
+            return;
+
+        for (auto** p = &hashTable[g->hash % hashTableSize]; *p != nullptr; p = &((*p)->nextInHashBucket))
+        {
+            if (*p == g)
+            {
+                *p = g->nextInHashBucket;
+                break;
+            }
+        }
+
+        g->nextInHashBucket = nullptr;
+        g->isInHashTable = false;
+    }
+
     CachedGlyphType* getGlyphForReuse()
     {
         if (hits.value + misses.value > glyphs.size() * 16)
@@ -274,7 +366,9 @@ private:
 };
 
 //==============================================================================
-/** Caches a glyph as an edge-table. */
+/** Caches a glyph as an edge-table, along with copies of it that have already been
+    shifted to the sub-pixel positions and brightness levels it was recently drawn with.
+*/
 template <class RendererType>
 class CachedGlyphEdgeTable  : public ReferenceCountedObject
 {
@@ -297,17 +391,75 @@ public:
         snapToIntegerCoordinate = typeface->isHinted();
         glyph = glyphNumber;
 
+        for (auto& p : positionedEdgeTables)
+            p = {};
+
         const float fontHeight = font.getHeight();
         edgeTable = typeface->getEdgeTableForGlyph (glyphNumber,
                                                     AffineTransform::scale (fontHeight * font.getHorizontalScale(),
                                                                             fontHeight), fontHeight);
     }
 
+    //==============================================================================
+    /** Returns the glyph's edge-table, shifted right by a fraction of a pixel (in 1/256ths
+        of a pixel) and with its levels multiplied by the given amount, which is exactly
+        what fillEdgeTable() would do to it. The last few of these are kept, so that a glyph
+        which keeps getting drawn in the same places doesn't need to be copied each time.
+    */
+    const EdgeTable* getPositionedEdgeTable (int subPixelOffset, float levelMultiplier)
+    {
+        if (edgeTable == nullptr)
+            return nullptr;
+
+        auto* leastRecentlyUsed = positionedEdgeTables;
+
+        for (auto& p : positionedEdgeTables)
+        {
+            if (p.edgeTable != nullptr && p.subPixelOffset == subPixelOffset && p.levelMultiplier == levelMultiplier)
+            {
+                p.lastUsed = ++positionCounter;
+                return p.edgeTable;
+            }
+
+            if (p.lastUsed < leastRecentlyUsed->lastUsed)
+                leastRecentlyUsed = &p;
+        }
+
+        auto& p = *leastRecentlyUsed;
+        p.edgeTable = new EdgeTable (*edgeTable);
+        p.edgeTable->translate (subPixelOffset / 256.0f, 0);
+
+        if (levelMultiplier != 1.0f)
+            p.edgeTable->multiplyLevels (levelMultiplier);
+
+        p.subPixelOffset = subPixelOffset;
+        p.levelMultiplier = levelMultiplier;
+        p.lastUsed = ++positionCounter;
+        return p.edgeTable;
+    }
+
     Font font;
     ScopedPointer<EdgeTable> edgeTable;
     int glyph, lastAccessCount;
     bool snapToIntegerCoordinate;
 
+    // used by the GlyphCache's hash table
+    uint32 hash = 0;
+    CachedGlyphEdgeTable* nextInHashBucket = nullptr;
+    bool isInHashTable = false;
+
+private:
+    struct PositionedEdgeTable
+    {
+        ScopedPointer<EdgeTable> edgeTable;
+        int subPixelOffset = 0, lastUsed = 0;
+        float levelMultiplier = 1.0f;
+    };
+
+    enum { numPositionedEdgeTables = 8 };
+    PositionedEdgeTable positionedEdgeTables[numPositionedEdgeTables];
+    int positionCounter = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedGlyphEdgeTable)
 };
 
@@ -1585,6 +1737,7 @@ struct ClipRegions
     {
     public:
         EdgeTableRegion (const EdgeTable& e)            : edgeTable (e) {}
+        EdgeTableRegion (EdgeTable&& e) noexcept        : edgeTable (static_cast<EdgeTable&&> (e)) {}
         EdgeTableRegion (const Rectangle<int>& r)       : edgeTable (r) {}
         EdgeTableRegion (const Rectangle<float>& r)     : edgeTable (r) {}
         EdgeTableRegion (const RectangleList<int>& r)   : edgeTable (r) {}
@@ -2273,7 +2426,7 @@ public:
             const Rectangle<int> clipRect (clip->getClipBounds());
 
             if (path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
-                fillShape (new EdgeTableRegionType (clipRect, path, trans), false);
+                fillShape (new EdgeTableRegionType (PathRenderingCache::createEdgeTable (clipRect, path, trans)), false);
         }
     }
 
@@ -2296,6 +2449,12 @@ public:
         }
     }
 
+    void drawGlyphs (const int* glyphNumbers, const Point<float>* positions, int numGlyphs, const AffineTransform& trans)
+    {
+        for (int i = 0; i < numGlyphs; ++i)
+            getThis().drawGlyph (glyphNumbers[i], AffineTransform::translation (positions[i]).followedBy (trans));
+    }
+
     void drawLine (Line<float> line)
     {
         Path p;
@@ -2526,6 +2685,56 @@ public:
         }
     }
 
+    /** Draws a run of glyphs. When the clip is a simple list of rectangles and the fill is a
+        solid colour, any glyph that lies entirely inside the clip is filled straight from its
+        cached, pre-positioned edge-table, rather than copying it and clipping the copy.
+        The pixels that get drawn are exactly the same as drawGlyph() would produce.
+    */
+    void drawGlyphs (const int* glyphNumbers, const Point<float>* positions, int numGlyphs, const AffineTransform& trans)
+    {
+        if (clip == nullptr)
+            return;
+
+        if (transform.isOnlyTranslated && trans.isOnlyTranslation() && fillType.isColour())
+        {
+            if (auto* rectangleClip = dynamic_cast<RectangleListRegionType*> (clip.get()))
+            {
+                const PixelARGB colour (fillType.colour.getPixelARGB());
+                const float brightness = fillType.colour.getBrightness() - 0.5f;
+                const float levelMultiplier = brightness > 0.0f ? 1.0f + 1.6f * brightness : 1.0f;
+
+                GlyphCacheType::getInstance().withGlyphRun (font, glyphNumbers, numGlyphs,
+                    [&] (int index, CachedGlyphEdgeTable<SoftwareRendererSavedState>& glyph)
+                    {
+                        // (this is the same arithmetic as drawGlyph() and EdgeTable::translate() use)
+                        const Point<float> pos (Point<float> (positions[index].x + trans.getTranslationX(),
+                                                              positions[index].y + trans.getTranslationY())
+                                                  + transform.offset.toFloat());
+
+                        const float x = glyph.snapToIntegerCoordinate ? std::floor (pos.x + 0.5f) : pos.x;
+                        const int y = roundToInt (pos.y);
+                        const int fixedX = (int) (x * 256.0f);
+
+                        if (auto* et = glyph.getPositionedEdgeTable (fixedX & 255, levelMultiplier))
+                        {
+                            const TranslatedEdgeTable translated { *et, fixedX >> 8, y };
+
+                            if (rectangleClip->clip.containsRectangle (translated.getBounds()
+                                                                         .getUnion (glyph.edgeTable->getMaximumBounds()
+                                                                                      .translated ((int) std::floor (x), y))))
+                                fillWithSolidColour (translated, colour, false);
+                            else
+                                glyph.draw (*this, pos);
+                        }
+                    });
+
+                return;
+            }
+        }
+
+        BaseClass::drawGlyphs (glyphNumbers, positions, numGlyphs, trans);
+    }
+
     Rectangle<int> getMaximumBounds() const     { return image.getBounds(); }
 
     //==============================================================================
@@ -2580,6 +2789,35 @@ public:
     Font font;
 
 private:
+    // Iterates an edge-table as if it had been moved by a whole number of pixels
+    struct TranslatedEdgeTable
+    {
+        template <class Callback>
+        struct TranslatedCallback
+        {
+            forcedinline void setEdgeTableYPos (int y) noexcept                                 { callback.setEdgeTableYPos (y + dy); }
+            forcedinline void handleEdgeTablePixel (int x, int alphaLevel) noexcept             { callback.handleEdgeTablePixel (x + dx, alphaLevel); }
+            forcedinline void handleEdgeTablePixelFull (int x) noexcept                         { callback.handleEdgeTablePixelFull (x + dx); }
+            forcedinline void handleEdgeTableLine (int x, int width, int alphaLevel) noexcept   { callback.handleEdgeTableLine (x + dx, width, alphaLevel); }
+            forcedinline void handleEdgeTableLineFull (int x, int width) noexcept               { callback.handleEdgeTableLineFull (x + dx, width); }
+
+            Callback& callback;
+            const int dx, dy;
+        };
+
+        template <class Callback>
+        void iterate (Callback& callback) const noexcept
+        {
+            TranslatedCallback<Callback> c { callback, dx, dy };
+            edgeTable.iterate (c);
+        }
+
+        Rectangle<int> getBounds() const noexcept    { return edgeTable.getMaximumBounds().translated (dx, dy); }
+
+        const EdgeTable& edgeTable;
+        const int dx, dy;
+    };
+
     SoftwareRendererSavedState& operator= (const SoftwareRendererSavedState&);
 };
 
@@ -2670,6 +2908,8 @@ public:
     void fillPath (const Path& path, const AffineTransform& t) override          { stack->fillPath (path, t); }
     void drawImage (const Image& im, const AffineTransform& t) override          { stack->drawImage (im, t); }
     void drawGlyph (int glyphNumber, const AffineTransform& t) override          { stack->drawGlyph (glyphNumber, t); }
+    void drawGlyphs (const int* glyphNumbers, const Point<float>* positions,
+                     int numGlyphs, const AffineTransform& t) override           { stack->drawGlyphs (glyphNumbers, positions, numGlyphs, t); }
     void drawLine (const Line<float>& line) override                             { stack->drawLine (line); }
     void setFont (const Font& newFont) override                                  { stack->font = newFont; }
     const Font& getFont() override                                               { return stack->font; }
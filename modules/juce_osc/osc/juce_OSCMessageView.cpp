@@ -0,0 +1,312 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace
+{
+    // Returns the number of bytes taken up by an OSC string, including its terminator
+    // and padding, or 0 if it isn't properly terminated and padded before the end.
+    static size_t getPaddedOSCStringSize (const char* s, const char* end) noexcept
+    {
+        auto* terminator = s;
+
+        while (terminator < end && *terminator != 0)
+            ++terminator;
+
+        if (terminator == end)
+            return 0;
+
+        auto size = (size_t) (terminator - s) + 1;
+        auto paddedSize = (size + 3) & ~(size_t) 3;
+
+        if (paddedSize > (size_t) (end - s))
+            return 0;
+
+        for (auto i = size; i < paddedSize; ++i)
+            if (s[i] != 0)
+                return 0;
+
+        return paddedSize;
+    }
+
+    // Returns the number of bytes taken up by an argument, or 0 if it's not valid.
+    static size_t getOSCArgumentSize (OSCType type, const char* data, const char* end) noexcept
+    {
+        auto available = (size_t) (end - data);
+
+        if (type == OSCTypes::int32 || type == OSCTypes::float32)
+            return available >= 4 ? 4 : 0;
+
+        if (type == OSCTypes::string)
+            return getPaddedOSCStringSize (data, end);
+
+        if (type == OSCTypes::blob && available >= 4)
+        {
+            auto blobSize = (size_t) (uint32) ByteOrder::bigEndianInt (data);
+            auto paddedSize = (blobSize + 3) & ~(size_t) 3;
+
+            if (paddedSize < blobSize || paddedSize > available - 4)
+                return 0;
+
+            for (auto i = blobSize; i < paddedSize; ++i)
+                if (data[4 + i] != 0)
+                    return 0;
+
+            return 4 + paddedSize;
+        }
+
+        return 0;
+    }
+
+    static bool isValidOSCAddressPatternString (const char* s) noexcept
+    {
+        if (*s != '/')
+            return false;
+
+        for (; *s != 0; ++s)
+            if (*s <= ' ' || *s > '~' || *s == '#')
+                return false;
+
+        return true;
+    }
+}
+
+//==============================================================================
+OSCMessageView::OSCMessageView (const void* messageData, size_t messageSize) noexcept
+{
+    auto* data = static_cast<const char*> (messageData);
+    auto* end = data + messageSize;
+
+    auto addressSize = getPaddedOSCStringSize (data, end);
+
+    if (addressSize == 0 || ! isValidOSCAddressPatternString (data))
+        return;
+
+    auto* tags = data + addressSize;
+    auto tagsSize = getPaddedOSCStringSize (tags, end);
+
+    if (tagsSize == 0 || *tags != ',')
+        return;
+
+    auto* args = tags + tagsSize;
+    int num = 0;
+
+    for (auto* t = tags + 1; *t != 0; ++t, ++num)
+    {
+        auto size = getOSCArgumentSize (*t, args, end);
+
+        if (size == 0)
+            return;
+
+        args += size;
+    }
+
+    if (args != end)
+        return;
+
+    addressPattern = data;
+    typeTags = tags + 1;
+    arguments = tags + tagsSize;
+    lastArgument = arguments;
+    messageEnd = end;
+    numArguments = num;
+}
+
+//==============================================================================
+OSCType OSCMessageView::getType (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, numArguments));
+    return isPositiveAndBelow (index, numArguments) ? typeTags[index] : 0;
+}
+
+const char* OSCMessageView::getArgumentData (int index, OSCType expectedType) const noexcept
+{
+    if (! isPositiveAndBelow (index, numArguments) || typeTags[index] != expectedType)
+    {
+        jassertfalse; // the index is out of range, or the argument has a different type
+        return nullptr;
+    }
+
+    if (index < lastIndex)
+    {
+        lastIndex = 0;
+        lastArgument = arguments;
+    }
+
+    while (lastIndex < index)
+        lastArgument += getOSCArgumentSize (typeTags[lastIndex++], lastArgument, messageEnd);
+
+    return lastArgument;
+}
+
+int32 OSCMessageView::getInt32 (int index) const noexcept
+{
+    if (auto* d = getArgumentData (index, OSCTypes::int32))
+        return (int32) ByteOrder::bigEndianInt (d);
+
+    return 0;
+}
+
+float OSCMessageView::getFloat32 (int index) const noexcept
+{
+    if (auto* d = getArgumentData (index, OSCTypes::float32))
+    {
+        auto bits = ByteOrder::bigEndianInt (d);
+        float value;
+        memcpy (&value, &bits, sizeof (value));
+        return value;
+    }
+
+    return 0.0f;
+}
+
+const char* OSCMessageView::getString (int index) const noexcept
+{
+    if (auto* d = getArgumentData (index, OSCTypes::string))
+        return d;
+
+    return "";
+}
+
+const void* OSCMessageView::getBlobData (int index) const noexcept
+{
+    if (auto* d = getArgumentData (index, OSCTypes::blob))
+        return d + 4;
+
+    return nullptr;
+}
+
+size_t OSCMessageView::getBlobSize (int index) const noexcept
+{
+    if (auto* d = getArgumentData (index, OSCTypes::blob))
+        return (size_t) ByteOrder::bigEndianInt (d);
+
+    return 0;
+}
+
+//==============================================================================
+OSCMessage OSCMessageView::toMessage() const
+{
+    if (! isValid())
+        throw OSCFormatError ("OSC format error: invalid message data");
+
+    OSCMessage message (OSCAddressPattern (String::fromUTF8 (addressPattern)));
+
+    for (int i = 0; i < numArguments; ++i)
+    {
+        auto type = typeTags[i];
+
+        if (type == OSCTypes::int32)         message.addInt32 (getInt32 (i));
+        else if (type == OSCTypes::float32)  message.addFloat32 (getFloat32 (i));
+        else if (type == OSCTypes::string)   message.addString (String::fromUTF8 (getString (i)));
+        else if (type == OSCTypes::blob)     message.addBlob (MemoryBlock (getBlobData (i), getBlobSize (i)));
+    }
+
+    return message;
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class OSCMessageViewTests  : public UnitTest
+{
+public:
+    OSCMessageViewTests() : UnitTest ("OSCMessageView class", "OSC") {}
+
+    void runTest()
+    {
+        beginTest ("parsing in place");
+        {
+            const uint8 data[] = {
+                '/', 't', 'e', 's', 't', '/', 'f', 'a', 'd', 'e', 'r', '1', '\0', '\0', '\0', '\0',
+                ',', 'i', 'f', 's', 'b', '\0', '\0', '\0',
+                0x00, 0x00, 0x30, 0x39,                 // int32 12345
+                0x40, 0x49, 0x0f, 0xdb,                 // float32 3.14159274
+                'a', 'b', 'c', '\0',
+                0x00, 0x00, 0x00, 0x03, 0x01, 0x02, 0x03, 0x00
+            };
+
+            OSCMessageView view (data, sizeof (data));
+            expect (view.isValid());
+            expectEquals (String (view.getAddressPattern()), String ("/test/fader1"));
+            expectEquals (view.size(), 4);
+            expect (view.getType (0) == OSCTypes::int32 && view.getType (3) == OSCTypes::blob);
+
+            // read them out of order, to check that the argument lookup copes with that
+            expectEquals (String (view.getString (2)), String ("abc"));
+            expectEquals (view.getInt32 (0), 12345);
+            expectEquals (view.getFloat32 (1), 3.14159274f);
+            expectEquals ((int) view.getBlobSize (3), 3);
+            expect (memcmp (view.getBlobData (3), data + sizeof (data) - 4, 3) == 0);
+            expect (view.getString (2) == (const char*) data + 32);
+
+            auto message = view.toMessage();
+            expect (message.getAddressPattern() == OSCAddressPattern ("/test/fader1"));
+            expectEquals (message.size(), 4);
+            expectEquals (message[0].getInt32(), 12345);
+            expectEquals (message[2].getString(), String ("abc"));
+            expect (message[3].getBlob() == MemoryBlock (data + sizeof (data) - 4, 3));
+        }
+
+        beginTest ("rejecting invalid data");
+        {
+            const uint8 noPadding[] = { '/', 'a', '\0', ',', '\0', '\0', '\0', '\0' };
+            expect (! OSCMessageView (noPadding, sizeof (noPadding)).isValid());
+
+            const uint8 noTypeTags[] = { '/', 'a', '\0', '\0', 0x00, 0x00, 0x00, 0x01 };
+            expect (! OSCMessageView (noTypeTags, sizeof (noTypeTags)).isValid());
+
+            const uint8 truncated[] = { '/', 'a', '\0', '\0', ',', 'i', '\0', '\0', 0x00, 0x00 };
+            expect (! OSCMessageView (truncated, sizeof (truncated)).isValid());
+
+            const uint8 tooLong[] = { '/', 'a', '\0', '\0', ',', '\0', '\0', '\0', 0x00, 0x00, 0x00, 0x00 };
+            expect (! OSCMessageView (tooLong, sizeof (tooLong)).isValid());
+
+            const uint8 badType[] = { '/', 'a', '\0', '\0', ',', 'x', '\0', '\0', 0x00, 0x00, 0x00, 0x00 };
+            expect (! OSCMessageView (badType, sizeof (badType)).isValid());
+
+            const uint8 badAddress[] = { '/', 'a', ' ', '\0', ',', '\0', '\0', '\0' };
+            expect (! OSCMessageView (badAddress, sizeof (badAddress)).isValid());
+
+            const uint8 hugeBlob[] = { '/', 'a', '\0', '\0', ',', 'b', '\0', '\0', 0xff, 0xff, 0xff, 0xff };
+            expect (! OSCMessageView (hugeBlob, sizeof (hugeBlob)).isValid());
+
+            const uint8 emptyMessage[] = { '/', 'a', '\0', '\0', ',', '\0', '\0', '\0' };
+            OSCMessageView view (emptyMessage, sizeof (emptyMessage));
+            expect (view.isValid() && view.isEmpty());
+        }
+    }
+};
+
+static OSCMessageViewTests OSCMessageViewUnitTests;
+
+#endif // JUCE_UNIT_TESTS
+
+} // namespace juce
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only view of an OSC message, which is parsed in place from the data
+    it arrived in.
+
+    Unlike OSCMessage, this doesn't copy or allocate anything: the address pattern,
+    strings and blobs that it returns point directly into the original packet, so
+    they're only valid for as long as that data is. OSCReceiver passes these to
+    OSCReceiver::MessageViewListener objects on its network thread, where this
+    makes it cheap to handle large numbers of messages.
+
+    If you need to keep a message, use toMessage() to make an OSCMessage from it.
+
+    @see OSCMessage, OSCReceiver::MessageViewListener
+*/
+class JUCE_API  OSCMessageView
+{
+public:
+    //==============================================================================
+    /** Creates a view of an OSC message.
+
+        The data must contain a single OSC message (not a bundle), and must stay valid
+        for as long as the view is used. If it's not a valid message, isValid() will
+        return false.
+    */
+    OSCMessageView (const void* messageData, size_t messageSize) noexcept;
+
+    /** Returns true if the data that this view was created with is a valid OSC message. */
+    bool isValid() const noexcept                           { return numArguments >= 0; }
+
+    //==============================================================================
+    /** Returns the message's address pattern, as a null-terminated string. */
+    const char* getAddressPattern() const noexcept          { return addressPattern; }
+
+    /** Returns the number of arguments in the message. */
+    int size() const noexcept                               { return jmax (0, numArguments); }
+
+    /** Returns true if the message has no arguments. */
+    bool isEmpty() const noexcept                           { return size() == 0; }
+
+    /** Returns the type of one of the arguments. The index must be in range. */
+    OSCType getType (int index) const noexcept;
+
+    /** Returns the value of an int32 argument. */
+    int32 getInt32 (int index) const noexcept;
+
+    /** Returns the value of a float32 argument. */
+    float getFloat32 (int index) const noexcept;
+
+    /** Returns a string argument, as a null-terminated UTF-8 string. */
+    const char* getString (int index) const noexcept;
+
+    /** Returns a pointer to the data of a blob argument. */
+    const void* getBlobData (int index) const noexcept;
+
+    /** Returns the number of bytes in a blob argument. */
+    size_t getBlobSize (int index) const noexcept;
+
+    //==============================================================================
+    /** Makes an OSCMessage containing a copy of this message.
+        @throw OSCFormatError if the address pattern isn't valid.
+    */
+    OSCMessage toMessage() const;
+
+private:
+    //==============================================================================
+    const char* addressPattern = nullptr;
+    const char* typeTags = nullptr;
+    const char* arguments = nullptr;
+    const char* messageEnd = nullptr;
+    int numArguments = -1;
+
+    // the arguments have different sizes, so the last one that was looked up is
+    // remembered to make iterating through them cheap
+    mutable int lastIndex = 0;
+    mutable const char* lastArgument = nullptr;
+
+    const char* getArgumentData (int index, OSCType expectedType) const noexcept;
+};
+
+} // namespace juce
@@ -316,6 +316,213 @@ namespace
 
 } // namespace
 
+//==============================================================================
+/** Finds the listeners whose addresses match a message's address pattern.
+
+    The listeners' addresses are arranged as a tree of their path segments, so that a
+    pattern only has to be compared with the branches that it can reach, rather than
+    with every listener's address. A segment without any wildcards is found with a
+    binary search, and only segments with wildcards need to run the pattern matcher.
+
+    Listeners may be added and removed on any thread while another one is calling
+    them. Each change builds a new tree and swaps it in, and a call holds a reference
+    to the tree that it started with, so it never sees one that is being modified or
+    deleted.
+*/
+template <typename ListenerType>
+class OSCAddressDispatcher
+{
+public:
+    OSCAddressDispatcher() {}
+
+    void add (const OSCAddress& address, ListenerType* listener)
+    {
+        const ScopedLock sl (entriesLock);
+
+        for (auto& i : entries)
+            if (address == i.first && listener == i.second)
+                return;
+
+        entries.add (std::make_pair (address, listener));
+        rebuild();
+    }
+
+    void remove (ListenerType* listener)
+    {
+        const ScopedLock sl (entriesLock);
+
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            if (listener == entries.getReference (i).second)
+            {
+                // (OSCAddress has no default constructor, so Array::remove() can't be used)
+                entries.swap (i, entries.size() - 1);
+                entries.removeLast();
+                rebuild();
+                break;
+            }
+        }
+    }
+
+    bool isEmpty() const noexcept       { return getTree() == nullptr; }
+
+    template <typename Callback>
+    void call (const char* addressPattern, Callback&& callback)
+    {
+        if (auto t = getTree())
+            callMatching (t->root, addressPattern, callback);
+    }
+
+private:
+    //==============================================================================
+    struct Node
+    {
+        String name;
+        int numBytes = 0;
+        OwnedArray<Node> children;
+        Array<ListenerType*> listeners;
+    };
+
+    struct Tree  : public ReferenceCountedObject
+    {
+        Node root;
+    };
+
+    typedef ReferenceCountedObjectPtr<Tree> TreePtr;
+
+    Array<std::pair<OSCAddress, ListenerType*>> entries;
+    CriticalSection entriesLock;
+    TreePtr tree;
+    SpinLock treeLock;
+
+    TreePtr getTree() const noexcept
+    {
+        const SpinLock::ScopedLockType sl (treeLock);
+        return tree;
+    }
+
+    static int compare (const Node& node, const char* segment, int numBytes) noexcept
+    {
+        if (node.numBytes != numBytes)
+            return node.numBytes < numBytes ? -1 : 1;
+
+        return memcmp (node.name.toRawUTF8(), segment, (size_t) numBytes);
+    }
+
+    static int findChildIndex (const Node& node, const char* segment, int numBytes, bool& found) noexcept
+    {
+        int start = 0, end = node.children.size();
+
+        while (start < end)
+        {
+            auto mid = (start + end) / 2;
+            auto result = compare (*node.children.getUnchecked (mid), segment, numBytes);
+
+            if (result == 0)
+            {
+                found = true;
+                return mid;
+            }
+
+            if (result < 0)  start = mid + 1;
+            else             end = mid;
+        }
+
+        found = false;
+        return start;
+    }
+
+    void rebuild()
+    {
+        TreePtr newTree;
+
+        if (! entries.isEmpty())
+        {
+            newTree = new Tree();
+
+            for (auto& entry : entries)
+            {
+                auto* node = &(newTree->root);
+
+                for (auto& segment : StringArray::fromTokens (entry.first.toString(), "/", {}))
+                {
+                    if (segment.isEmpty())
+                        continue;
+
+                    auto numBytes = (int) segment.getNumBytesAsUTF8();
+                    bool found;
+                    auto index = findChildIndex (*node, segment.toRawUTF8(), numBytes, found);
+
+                    if (! found)
+                    {
+                        auto* child = new Node();
+                        child->name = segment;
+                        child->numBytes = numBytes;
+                        node->children.insert (index, child);
+                    }
+
+                    node = node->children.getUnchecked (index);
+                }
+
+                node->listeners.add (entry.second);
+            }
+        }
+
+        {
+            const SpinLock::ScopedLockType sl (treeLock);
+            std::swap (tree, newTree);
+        }
+
+        // (the old tree is released here, outside the spin lock, unless a call is still using it)
+    }
+
+    template <typename Callback>
+    static void callMatching (const Node& node, const char* pattern, Callback& callback)
+    {
+        while (*pattern == '/')
+            ++pattern;
+
+        if (*pattern == 0)
+        {
+            for (auto* listener : node.listeners)
+                callback (*listener);
+
+            return;
+        }
+
+        auto* segmentEnd = pattern;
+        bool hasWildcards = false;
+
+        for (; *segmentEnd != 0 && *segmentEnd != '/'; ++segmentEnd)
+            if (*segmentEnd == '*' || *segmentEnd == '?' || *segmentEnd == '[' || *segmentEnd == '{')
+                hasWildcards = true;
+
+        if (! hasWildcards)
+        {
+            bool found;
+            auto index = findChildIndex (node, pattern, (int) (segmentEnd - pattern), found);
+
+            if (found)
+                callMatching (*node.children.getUnchecked (index), segmentEnd, callback);
+
+            return;
+        }
+
+        typedef OSCPatternMatcherImpl<CharPointer_UTF8> Matcher;
+
+        for (auto* child : node.children)
+        {
+            auto name = child->name.getCharPointer();
+
+            if (Matcher::match (CharPointer_UTF8 (pattern), CharPointer_UTF8 (segmentEnd),
+                                name, name.findTerminatingNull()))
+                callMatching (*child, segmentEnd, callback);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (OSCAddressDispatcher)
+};
+
 
 //==============================================================================
 struct OSCReceiver::Pimpl   : private Thread,
@@ -374,13 +581,23 @@ struct OSCReceiver::Pimpl   : private Thread,
     void addListener (ListenerWithOSCAddress<MessageLoopCallback>* listenerToAdd,
                       OSCAddress addressToMatch)
     {
-        addListenerWithAddress (listenerToAdd, addressToMatch, listenersWithAddress);
+        listenersWithAddress.add (addressToMatch, listenerToAdd);
     }
 
     void addListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToAdd,
                       OSCAddress addressToMatch)
     {
-        addListenerWithAddress (listenerToAdd, addressToMatch, realtimeListenersWithAddress);
+        realtimeListenersWithAddress.add (addressToMatch, listenerToAdd);
+    }
+
+    void addListener (MessageViewListener* listenerToAdd)
+    {
+        viewListeners.add (listenerToAdd);
+    }
+
+    void addListener (MessageViewListener* listenerToAdd, OSCAddress addressToMatch)
+    {
+        viewListenersWithAddress.add (addressToMatch, listenerToAdd);
     }
 
     void removeListener (OSCReceiver::Listener<MessageLoopCallback>* listenerToRemove)
@@ -395,12 +612,18 @@ struct OSCReceiver::Pimpl   : private Thread,
 
     void removeListener (ListenerWithOSCAddress<MessageLoopCallback>* listenerToRemove)
     {
-        removeListenerWithAddress (listenerToRemove, listenersWithAddress);
+        listenersWithAddress.remove (listenerToRemove);
     }
 
     void removeListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToRemove)
     {
-        removeListenerWithAddress (listenerToRemove, realtimeListenersWithAddress);
+        realtimeListenersWithAddress.remove (listenerToRemove);
+    }
+
+    void removeListener (MessageViewListener* listenerToRemove)
+    {
+        viewListeners.remove (listenerToRemove);
+        viewListenersWithAddress.remove (listenerToRemove);
     }
 
     //==============================================================================
@@ -415,6 +638,27 @@ struct OSCReceiver::Pimpl   : private Thread,
     //==============================================================================
     void handleBuffer (const char* data, size_t dataSize)
     {
+        auto needsParsedContent = ! (listeners.isEmpty() && realtimeListeners.isEmpty()
+                                      && listenersWithAddress.isEmpty() && realtimeListenersWithAddress.isEmpty());
+
+        // The view listeners are given the messages straight from the packet. If there aren't
+        // any other listeners, the packet is only checked in place, without being decoded.
+        if (! (viewListeners.isEmpty() && viewListenersWithAddress.isEmpty()) || ! needsParsedContent)
+        {
+            if (! callViewListeners (data, dataSize, false))
+            {
+                if (formatErrorHandler != nullptr)
+                    formatErrorHandler (data, (int) dataSize);
+
+                return;
+            }
+
+            callViewListeners (data, dataSize, true);
+
+            if (! needsParsedContent)
+                return;
+        }
+
         OSCInputStream inStream (data, dataSize);
 
         try
@@ -430,7 +674,7 @@ struct OSCReceiver::Pimpl   : private Thread,
 
             // now post the message that will trigger the handleMessage callback
             // dealing with the non-realtime listeners.
-            if (listeners.size() > 0 || listenersWithAddress.size() > 0)
+            if (listeners.size() > 0 || ! listenersWithAddress.isEmpty())
                 postMessage (new CallbackMessage (content));
         }
         catch (OSCFormatError)
@@ -450,52 +694,102 @@ private:
     //==============================================================================
     void run() override
     {
+        buffers.malloc ((size_t) (oscBufferSize * maxPacketsPerRead));
+
         while (! threadShouldExit())
         {
             jassert (socket != nullptr);
-            char buffer[oscBufferSize];
             socket->waitUntilReady (true, -1);
 
             if (threadShouldExit())
                 return;
 
-            auto bytesRead = (size_t) socket->read (buffer, (int) sizeof (buffer), false);
-
-            if (bytesRead >= 4)
-                handleBuffer (buffer, bytesRead);
+            // read everything that has arrived before waiting again, so that a burst
+            // of packets doesn't need a wait for each one
+            for (int i = 0; i < 16 && ! threadShouldExit(); ++i)
+                if (readPackets() < maxPacketsPerRead)
+                    break;
         }
     }
 
-    //==============================================================================
-    template <typename ListenerType>
-    void addListenerWithAddress (ListenerType* listenerToAdd,
-                                 OSCAddress address,
-                                 Array<std::pair<OSCAddress, ListenerType*>>& array)
+    int readPackets()
     {
-        for (auto& i : array)
-            if (address == i.first && listenerToAdd == i.second)
-                return;
+       #if JUCE_LINUX
+        // recvmmsg() can fetch a whole batch of packets with a single call
+        struct iovec vectors[maxPacketsPerRead];
+        struct mmsghdr headers[maxPacketsPerRead];
+        zeromem (headers, sizeof (headers));
+
+        for (int i = 0; i < maxPacketsPerRead; ++i)
+        {
+            vectors[i].iov_base = buffers + i * oscBufferSize;
+            vectors[i].iov_len = oscBufferSize;
+            headers[i].msg_hdr.msg_iov = vectors + i;
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        auto numPackets = recvmmsg (socket->getRawSocketHandle(), headers, maxPacketsPerRead, MSG_DONTWAIT, nullptr);
+
+        for (int i = 0; i < numPackets; ++i)
+            if (headers[i].msg_len >= 4)
+                handleBuffer (buffers + i * oscBufferSize, (size_t) headers[i].msg_len);
+
+        return jmax (0, numPackets);
+       #else
+        for (int i = 0; i < maxPacketsPerRead; ++i)
+        {
+            auto bytesRead = socket->read (buffers, oscBufferSize, false);
+
+            if (bytesRead <= 0)
+                return i;
+
+            if (bytesRead >= 4)
+                handleBuffer (buffers, (size_t) bytesRead);
+        }
 
-        array.add (std::make_pair (address, listenerToAdd));
+        return maxPacketsPerRead;
+       #endif
     }
 
     //==============================================================================
-    template <typename ListenerType>
-    void removeListenerWithAddress (ListenerType* listenerToRemove,
-                                    Array<std::pair<OSCAddress, ListenerType*>>& array)
+    bool callViewListeners (const char* data, size_t dataSize, bool shouldCallListeners)
     {
-        for (int i = 0; i < array.size(); ++i)
+        if (*data == '#')
         {
-            if (listenerToRemove == array.getReference (i).second)
+            if (dataSize < 16 || memcmp (data, "#bundle", 8) != 0)
+                return false;
+
+            for (size_t pos = 16; pos < dataSize;)
             {
-                // aarrgh... can't simply call array.remove (i) because this
-                // requires a default c'tor to be present for OSCAddress...
-                // luckily, we don't care about methods preserving element order:
-                array.swap (i, array.size() - 1);
-                array.removeLast();
-                break;
+                if (dataSize - pos < 4)
+                    return false;
+
+                auto elementSize = (size_t) (uint32) ByteOrder::bigEndianInt (data + pos);
+                pos += 4;
+
+                if (elementSize < 4 || elementSize > dataSize - pos
+                     || ! callViewListeners (data + pos, elementSize, shouldCallListeners))
+                    return false;
+
+                pos += elementSize;
             }
+
+            return true;
         }
+
+        OSCMessageView view (data, dataSize);
+
+        if (! view.isValid())
+            return false;
+
+        if (shouldCallListeners)
+        {
+            viewListeners.call (&MessageViewListener::oscMessageReceived, view);
+            viewListenersWithAddress.call (view.getAddressPattern(),
+                                           [&view] (MessageViewListener& l) { l.oscMessageReceived (view); });
+        }
+
+        return true;
     }
 
     //==============================================================================
@@ -536,31 +830,35 @@ private:
     //==============================================================================
     void callListenersWithAddress (const OSCMessage& message)
     {
-        for (auto& entry : listenersWithAddress)
-            if (auto* listener = entry.second)
-                if (message.getAddressPattern().matches (entry.first))
-                    listener->oscMessageReceived (message);
+        typedef OSCReceiver::ListenerWithOSCAddress<OSCReceiver::MessageLoopCallback> Listener;
+
+        listenersWithAddress.call (message.getAddressPattern().toString().toRawUTF8(),
+                                   [&message] (Listener& l) { l.oscMessageReceived (message); });
     }
 
     void callRealtimeListenersWithAddress (const OSCMessage& message)
     {
-        for (auto& entry : realtimeListenersWithAddress)
-            if (auto* listener = entry.second)
-                if (message.getAddressPattern().matches (entry.first))
-                    listener->oscMessageReceived (message);
+        typedef OSCReceiver::ListenerWithOSCAddress<OSCReceiver::RealtimeCallback> Listener;
+
+        realtimeListenersWithAddress.call (message.getAddressPattern().toString().toRawUTF8(),
+                                           [&message] (Listener& l) { l.oscMessageReceived (message); });
     }
 
     //==============================================================================
     ListenerList<OSCReceiver::Listener<OSCReceiver::MessageLoopCallback>> listeners;
     ListenerList<OSCReceiver::Listener<OSCReceiver::RealtimeCallback>>    realtimeListeners;
 
-    Array<std::pair<OSCAddress, OSCReceiver::ListenerWithOSCAddress<OSCReceiver::MessageLoopCallback>*>> listenersWithAddress;
-    Array<std::pair<OSCAddress, OSCReceiver::ListenerWithOSCAddress<OSCReceiver::RealtimeCallback>*>>    realtimeListenersWithAddress;
+    ListenerList<MessageViewListener> viewListeners;
+
+    OSCAddressDispatcher<OSCReceiver::ListenerWithOSCAddress<OSCReceiver::MessageLoopCallback>> listenersWithAddress;
+    OSCAddressDispatcher<OSCReceiver::ListenerWithOSCAddress<OSCReceiver::RealtimeCallback>>    realtimeListenersWithAddress;
+    OSCAddressDispatcher<MessageViewListener> viewListenersWithAddress;
 
     ScopedPointer<DatagramSocket> socket;
     int portNumber = 0;
     OSCReceiver::FormatErrorHandler formatErrorHandler;
-    enum { oscBufferSize = 4098 };
+    enum { oscBufferSize = 4098, maxPacketsPerRead = 32 };
+    HeapBlock<char> buffers;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
 };
@@ -605,6 +903,16 @@ void OSCReceiver::addListener (ListenerWithOSCAddress<RealtimeCallback>* listene
     pimpl->addListener (listenerToAdd, addressToMatch);
 }
 
+void OSCReceiver::addListener (MessageViewListener* listenerToAdd)
+{
+    pimpl->addListener (listenerToAdd);
+}
+
+void OSCReceiver::addListener (MessageViewListener* listenerToAdd, OSCAddress addressToMatch)
+{
+    pimpl->addListener (listenerToAdd, addressToMatch);
+}
+
 void OSCReceiver::removeListener (Listener<MessageLoopCallback>* listenerToRemove)
 {
     pimpl->removeListener (listenerToRemove);
@@ -625,6 +933,11 @@ void OSCReceiver::removeListener (ListenerWithOSCAddress<RealtimeCallback>* list
     pimpl->removeListener (listenerToRemove);
 }
 
+void OSCReceiver::removeListener (MessageViewListener* listenerToRemove)
+{
+    pimpl->removeListener (listenerToRemove);
+}
+
 void OSCReceiver::registerFormatErrorHandler (FormatErrorHandler handler)
 {
     pimpl->registerFormatErrorHandler (handler);
@@ -1158,6 +1471,133 @@ public:
 
 static OSCInputStreamTests OSCInputStreamUnitTests;
 
+//==============================================================================
+class OSCAddressDispatcherTests  : public UnitTest
+{
+public:
+    OSCAddressDispatcherTests() : UnitTest ("OSCAddressDispatcher class", "OSC") {}
+
+    struct TestListener
+    {
+        int numCalls = 0;
+    };
+
+    static void increment (TestListener& l)    { ++l.numCalls; }
+
+    void runTest()
+    {
+        OSCAddressDispatcher<TestListener> dispatcher;
+        TestListener a, b, c, d;
+
+        dispatcher.add (OSCAddress ("/mixer/1/fader"), &a);
+        dispatcher.add (OSCAddress ("/mixer/2/fader"), &b);
+        dispatcher.add (OSCAddress ("/mixer/2/mute"), &c);
+        dispatcher.add (OSCAddress ("/transport"), &d);
+        dispatcher.add (OSCAddress ("/transport"), &d);
+
+        beginTest ("exact addresses");
+        {
+            dispatcher.call ("/mixer/2/fader", increment);
+            dispatcher.call ("/transport", increment);
+            dispatcher.call ("/mixer/2", increment);
+            dispatcher.call ("/mixer/3/fader", increment);
+            dispatcher.call ("/mixer/2/fader/x", increment);
+
+            expectEquals (a.numCalls, 0);
+            expectEquals (b.numCalls, 1);
+            expectEquals (c.numCalls, 0);
+            expectEquals (d.numCalls, 1);
+        }
+
+        beginTest ("wildcard patterns");
+        {
+            a.numCalls = b.numCalls = c.numCalls = d.numCalls = 0;
+
+            dispatcher.call ("/mixer/*/fader", increment);
+            dispatcher.call ("/mixer/2/*", increment);
+            dispatcher.call ("/mixer/[1-2]/f?der", increment);
+            dispatcher.call ("/mixer/{1,3}/fader", increment);
+            dispatcher.call ("/*", increment);
+
+            expectEquals (a.numCalls, 3);
+            expectEquals (b.numCalls, 3);
+            expectEquals (c.numCalls, 1);
+            expectEquals (d.numCalls, 1);
+        }
+
+        beginTest ("removing listeners");
+        {
+            a.numCalls = b.numCalls = c.numCalls = d.numCalls = 0;
+
+            dispatcher.remove (&b);
+            dispatcher.call ("/mixer/*/*", increment);
+
+            expectEquals (a.numCalls, 1);
+            expectEquals (b.numCalls, 0);
+            expectEquals (c.numCalls, 1);
+
+            dispatcher.remove (&a);
+            dispatcher.remove (&c);
+            dispatcher.remove (&d);
+            expect (dispatcher.isEmpty());
+
+            dispatcher.call ("/mixer/*/*", increment);
+            expectEquals (a.numCalls, 1);
+        }
+
+        beginTest ("adding and removing listeners while another thread is calling them");
+        {
+            struct CallingThread  : public Thread
+            {
+                CallingThread (OSCAddressDispatcher<TestListener>& d)  : Thread ("OSC dispatcher test"), dispatcher (d) {}
+
+                void run() override
+                {
+                    while (! threadShouldExit())
+                    {
+                        dispatcher.call ("/mixer/*/fader", [this] (TestListener&) { ++numCalls; });
+                        dispatcher.call ("/mixer/1/fader", [this] (TestListener&) { ++numCalls; });
+                    }
+                }
+
+                OSCAddressDispatcher<TestListener>& dispatcher;
+                Atomic<int> numCalls;
+            };
+
+            TestListener listeners[8];
+            CallingThread thread (dispatcher);
+            thread.startThread();
+
+            auto endTime = Time::getMillisecondCounter() + 10000;
+
+            // (keeps going until the other thread has had a chance to run)
+            for (int i = 0; i < 2000 || (thread.numCalls.get() == 0 && Time::getMillisecondCounter() < endTime); ++i)
+            {
+                // on a single core, this loop could otherwise keep grabbing the lock before the other thread gets it
+                if (i >= 2000)
+                    Thread::sleep (1);
+
+                auto& l = listeners[i % numElementsInArray (listeners)];
+
+                if ((i / numElementsInArray (listeners)) % 2 == 0)
+                    dispatcher.add (OSCAddress ("/mixer/" + String (i % 3) + "/fader"), &l);
+                else
+                    dispatcher.remove (&l);
+            }
+
+            thread.stopThread (4000);
+            expect (thread.numCalls.get() > 0);
+
+            for (auto& l : listeners)
+                dispatcher.remove (&l);
+
+            expect (dispatcher.isEmpty());
+        }
+    }
+};
+
+static OSCAddressDispatcherTests OSCAddressDispatcherUnitTests;
+
 #endif // JUCE_UNIT_TESTS
 
 } // namespace juce
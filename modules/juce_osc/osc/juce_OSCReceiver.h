@@ -145,6 +145,31 @@ public:
         virtual void oscMessageReceived (const OSCMessage& message) = 0;
     };
 
+    //==============================================================================
+    /** A class for receiving OSC messages from an OSCReceiver without any of their
+        contents being copied.
+
+        Each message is passed as an OSCMessageView that points into the packet that
+        was received, so no OSCMessage or OSCArgument objects need to be created. These
+        listeners are always called directly on the network thread, and the view is only
+        valid until the callback returns. Messages that arrive inside bundles are passed
+        to the listener one by one.
+
+        If all of an OSCReceiver's listeners are of this type, it never needs to allocate
+        anything while receiving messages.
+
+        @see OSCMessageView, OSCReceiver::addListener
+    */
+    class JUCE_API  MessageViewListener
+    {
+    public:
+        /** Destructor. */
+        virtual ~MessageViewListener() {}
+
+        /** Called when the OSCReceiver receives an OSC message. */
+        virtual void oscMessageReceived (const OSCMessageView& message) = 0;
+    };
+
     //==============================================================================
     /** Adds a listener that listens to OSC messages and bundles.
         This listener will be called on the application's message loop.
@@ -171,6 +196,17 @@ public:
     void addListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToAdd,
                       OSCAddress addressToMatch);
 
+    /** Adds a listener that receives all OSC messages as OSCMessageView objects.
+        The listener will be called directly on the network thread.
+    */
+    void addListener (MessageViewListener* listenerToAdd);
+
+    /** Adds a listener that receives the OSC messages that match the given address, as
+        OSCMessageView objects.
+        The listener will be called directly on the network thread.
+    */
+    void addListener (MessageViewListener* listenerToAdd, OSCAddress addressToMatch);
+
     /** Removes a previously-registered listener. */
     void removeListener (Listener<MessageLoopCallback>* listenerToRemove);
 
@@ -183,6 +219,9 @@ public:
     /** Removes a previously-registered listener. */
     void removeListener (ListenerWithOSCAddress<RealtimeCallback>* listenerToRemove);
 
+    /** Removes a previously-registered listener. */
+    void removeListener (MessageViewListener* listenerToRemove);
+
     //==============================================================================
     /** An error handler function for OSC format errors that can be called by the
         OSCReceiver.
@@ -27,186 +27,186 @@
 namespace juce
 {
 
-namespace
-{
-    //==============================================================================
-    /** Writes OSC data to an internal memory buffer, which grows as required.
-
-        The data that was written into the stream can then be accessed later as
-        a contiguous block of memory.
+//==============================================================================
+/** Writes OSC data to an internal memory buffer, which grows as required.
 
-        This class implements the Open Sound Control 1.0 Specification for
-        the format in which the OSC data will be written into the buffer.
-    */
-    struct OSCOutputStream
-    {
-        OSCOutputStream() noexcept {}
+    The data that was written into the stream can then be accessed later as
+    a contiguous block of memory.
 
-        /** Returns a pointer to the data that has been written to the stream. */
-        const void* getData() const noexcept    { return output.getData(); }
+    This class implements the Open Sound Control 1.0 Specification for
+    the format in which the OSC data will be written into the buffer.
+*/
+struct OSCOutputStream
+{
+    OSCOutputStream() noexcept {}
 
-        /** Returns the number of bytes of data that have been written to the stream. */
-        size_t getDataSize() const noexcept     { return output.getDataSize(); }
+    /** Returns a pointer to the data that has been written to the stream. */
+    const void* getData() const noexcept    { return output.getData(); }
 
-        //==============================================================================
-        bool writeInt32 (int32 value)
-        {
-            return output.writeIntBigEndian (value);
-        }
+    /** Returns the number of bytes of data that have been written to the stream. */
+    size_t getDataSize() const noexcept     { return output.getDataSize(); }
 
-        bool writeUint64 (uint64 value)
-        {
-            return output.writeInt64BigEndian (int64 (value));
-        }
+    /** Discards the data, but keeps the memory that was allocated for it. */
+    void reset() noexcept                   { output.reset(); }
 
-        bool writeFloat32 (float value)
-        {
-            return output.writeFloatBigEndian (value);
-        }
+    //==============================================================================
+    bool writeInt32 (int32 value)
+    {
+        return output.writeIntBigEndian (value);
+    }
 
-        bool writeString (const String& value)
-        {
-            if (! output.writeString (value))
-                return false;
+    bool writeUint64 (uint64 value)
+    {
+        return output.writeInt64BigEndian (int64 (value));
+    }
 
-            const size_t numPaddingZeros = ~value.length() & 3;
+    bool writeFloat32 (float value)
+    {
+        return output.writeFloatBigEndian (value);
+    }
 
-            return output.writeRepeatedByte ('\0', numPaddingZeros);
-        }
+    bool writeString (const String& value)
+    {
+        if (! output.writeString (value))
+            return false;
 
-        bool writeBlob (const MemoryBlock& blob)
-        {
-            if (! (output.writeIntBigEndian ((int) blob.getSize())
-                    && output.write (blob.getData(), blob.getSize())))
-                return false;
+        const size_t numPaddingZeros = ~value.length() & 3;
 
-            const size_t numPaddingZeros = ~(blob.getSize() - 1) & 3;
+        return output.writeRepeatedByte ('\0', numPaddingZeros);
+    }
 
-            return output.writeRepeatedByte (0, numPaddingZeros);
-        }
+    bool writeBlob (const MemoryBlock& blob)
+    {
+        if (! (output.writeIntBigEndian ((int) blob.getSize())
+                && output.write (blob.getData(), blob.getSize())))
+            return false;
 
-        bool writeTimeTag (OSCTimeTag timeTag)
-        {
-            return output.writeInt64BigEndian (int64 (timeTag.getRawTimeTag()));
-        }
+        const size_t numPaddingZeros = ~(blob.getSize() - 1) & 3;
 
-        bool writeAddress (const OSCAddress& address)
-        {
-            return writeString (address.toString());
-        }
+        return output.writeRepeatedByte (0, numPaddingZeros);
+    }
 
-        bool writeAddressPattern (const OSCAddressPattern& ap)
-        {
-            return writeString (ap.toString());
-        }
+    bool writeTimeTag (OSCTimeTag timeTag)
+    {
+        return output.writeInt64BigEndian (int64 (timeTag.getRawTimeTag()));
+    }
 
-        bool writeTypeTagString (const OSCTypeList& typeList)
-        {
-            output.writeByte (',');
+    bool writeAddress (const OSCAddress& address)
+    {
+        return writeString (address.toString());
+    }
 
-            if (typeList.size() > 0)
-                output.write (typeList.begin(), (size_t) typeList.size());
+    bool writeAddressPattern (const OSCAddressPattern& ap)
+    {
+        return writeString (ap.toString());
+    }
 
-            output.writeByte ('\0');
+    bool writeTypeTagString (const OSCTypeList& typeList)
+    {
+        output.writeByte (',');
 
-            size_t bytesWritten = (size_t) typeList.size() + 1;
-            size_t numPaddingZeros = ~bytesWritten & 0x03;
+        if (typeList.size() > 0)
+            output.write (typeList.begin(), (size_t) typeList.size());
 
-            return output.writeRepeatedByte ('\0', numPaddingZeros);
-        }
+        output.writeByte ('\0');
 
-        bool writeArgument (const OSCArgument& arg)
-        {
-            switch (arg.getType())
-            {
-                case OSCTypes::int32:       return writeInt32 (arg.getInt32());
-                case OSCTypes::float32:     return writeFloat32 (arg.getFloat32());
-                case OSCTypes::string:      return writeString (arg.getString());
-                case OSCTypes::blob:        return writeBlob (arg.getBlob());
+        size_t bytesWritten = (size_t) typeList.size() + 1;
+        size_t numPaddingZeros = ~bytesWritten & 0x03;
 
-                default:
-                    // In this very unlikely case you supplied an invalid OSCType!
-                    jassertfalse;
-                    return false;
-            }
-        }
+        return output.writeRepeatedByte ('\0', numPaddingZeros);
+    }
 
-        //==============================================================================
-        bool writeMessage (const OSCMessage& msg)
+    bool writeArgument (const OSCArgument& arg)
+    {
+        switch (arg.getType())
         {
-            if (! writeAddressPattern (msg.getAddressPattern()))
+            case OSCTypes::int32:       return writeInt32 (arg.getInt32());
+            case OSCTypes::float32:     return writeFloat32 (arg.getFloat32());
+            case OSCTypes::string:      return writeString (arg.getString());
+            case OSCTypes::blob:        return writeBlob (arg.getBlob());
+
+            default:
+                // In this very unlikely case you supplied an invalid OSCType!
+                jassertfalse;
                 return false;
+        }
+    }
 
-            OSCTypeList typeList;
-
-            for (auto& arg : msg)
-                typeList.add (arg.getType());
-
-            if (! writeTypeTagString (typeList))
-                return false;
+    //==============================================================================
+    bool writeMessage (const OSCMessage& msg)
+    {
+        if (! writeAddressPattern (msg.getAddressPattern()))
+            return false;
 
-            for (auto& arg : msg)
-                if (! writeArgument (arg))
-                    return false;
+        // (the type tags are written directly, to avoid building an OSCTypeList)
+        output.writeByte (',');
 
-            return true;
-        }
+        for (auto& arg : msg)
+            output.writeByte (arg.getType());
 
-        bool writeBundle (const OSCBundle& bundle)
-        {
-            if (! writeString ("#bundle"))
-                return false;
+        if (! output.writeRepeatedByte ('\0', 4 - ((size_t) (msg.size() + 1) & 3)))
+            return false;
 
-            if (! writeTimeTag (bundle.getTimeTag()))
+        for (auto& arg : msg)
+            if (! writeArgument (arg))
                 return false;
 
-            for (auto& element : bundle)
-                if (! writeBundleElement (element))
-                    return false;
+        return true;
+    }
 
-            return true;
-        }
+    bool writeBundle (const OSCBundle& bundle)
+    {
+        if (! writeString ("#bundle"))
+            return false;
 
-        //==============================================================================
-        bool writeBundleElement (const OSCBundle::Element& element)
-        {
-            const int64 startPos = output.getPosition();
+        if (! writeTimeTag (bundle.getTimeTag()))
+            return false;
 
-            if (! writeInt32 (0))   // writing dummy value for element size
+        for (auto& element : bundle)
+            if (! writeBundleElement (element))
                 return false;
 
-            if (element.isBundle())
-            {
-                if (! writeBundle (element.getBundle()))
-                    return false;
-            }
-            else
-            {
-                if (! writeMessage (element.getMessage()))
-                    return false;
-            }
+        return true;
+    }
 
-            const int64 endPos = output.getPosition();
-            const int64 elementSize = endPos - (startPos + 4);
+    //==============================================================================
+    bool writeBundleElement (const OSCBundle::Element& element)
+    {
+        const int64 startPos = output.getPosition();
 
-            return output.setPosition (startPos)
-                     && writeInt32 ((int32) elementSize)
-                     && output.setPosition (endPos);
+        if (! writeInt32 (0))   // writing dummy value for element size
+            return false;
+
+        if (element.isBundle())
+        {
+            if (! writeBundle (element.getBundle()))
+                return false;
+        }
+        else
+        {
+            if (! writeMessage (element.getMessage()))
+                return false;
         }
 
-    private:
-        MemoryOutputStream output;
+        const int64 endPos = output.getPosition();
+        const int64 elementSize = endPos - (startPos + 4);
 
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OSCOutputStream)
-    };
+        return output.setPosition (startPos)
+                 && writeInt32 ((int32) elementSize)
+                 && output.setPosition (endPos);
+    }
 
-} // namespace
+private:
+    MemoryOutputStream output;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OSCOutputStream)
+};
 
 
 //==============================================================================
-struct OSCSender::Pimpl
+struct OSCSender::Pimpl  : private Thread
 {
-    Pimpl() noexcept  {}
+    Pimpl() noexcept  : Thread ("JUCE OSC sender") {}
     ~Pimpl() noexcept { disconnect(); }
 
     //==============================================================================
@@ -216,10 +216,9 @@ struct OSCSender::Pimpl
             return false;
 
         socket = new DatagramSocket (true);
-        targetHostName = newTargetHost;
-        targetPortNumber = newTargetPort;
 
-        if (socket->bindToPort (0)) // 0 = use any local port assigned by the OS.
+        if (socket->bindToPort (0) // 0 = use any local port assigned by the OS.
+             && addTarget (newTargetHost, newTargetPort))
             return true;
 
         socket = nullptr;
@@ -228,33 +227,440 @@ struct OSCSender::Pimpl
 
     bool disconnect()
     {
+        stopRealtimeSending();
+
+        const ScopedLock sl (sendLock);
+        targets.clear();
         socket = nullptr;
         return true;
     }
 
+    //==============================================================================
+    bool addTarget (const String& hostName, int portNumber)
+    {
+        Target target;
+        target.hostName = hostName;
+        target.portNumber = portNumber;
+
+       #if JUCE_LINUX
+        // the addresses are looked up here, so that sendmmsg() can be given them directly
+        struct addrinfo hints;
+        zerostruct (hints);
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        hints.ai_flags = AI_NUMERICSERV;
+
+        struct addrinfo* info = nullptr;
+
+        if (getaddrinfo (hostName.toRawUTF8(), String (portNumber).toRawUTF8(), &hints, &info) != 0 || info == nullptr)
+            return false;
+
+        memcpy (&target.address, info->ai_addr, (size_t) info->ai_addrlen);
+        target.addressLength = (socklen_t) info->ai_addrlen;
+        freeaddrinfo (info);
+       #endif
+
+        const ScopedLock sl (sendLock);
+        targets.add (target);
+        return true;
+    }
+
+    void removeTarget (const String& hostName, int portNumber)
+    {
+        const ScopedLock sl (sendLock);
+
+        for (int i = targets.size(); --i >= 0;)
+            if (targets.getReference (i).portNumber == portNumber && targets.getReference (i).hostName == hostName)
+                targets.remove (i);
+    }
+
     //==============================================================================
     bool send (const OSCMessage& message, const String& hostName, int portNumber)
     {
-        OSCOutputStream outStream;
+        const ScopedLock sl (sendLock);
+        outStream.reset();
 
         return outStream.writeMessage (message)
-            && sendOutputStream (outStream, hostName, portNumber);
+            && sendOutputStream (hostName, portNumber);
     }
 
     bool send (const OSCBundle& bundle, const String& hostName, int portNumber)
     {
-        OSCOutputStream outStream;
+        const ScopedLock sl (sendLock);
+        outStream.reset();
 
         return outStream.writeBundle (bundle)
-            && sendOutputStream (outStream, hostName, portNumber);
+            && sendOutputStream (hostName, portNumber);
+    }
+
+    bool send (const OSCMessage& message)
+    {
+        const ScopedLock sl (sendLock);
+        outStream.reset();
+
+        return outStream.writeMessage (message)
+            && sendToAllTargets (static_cast<const char*> (outStream.getData()), (int) outStream.getDataSize());
+    }
+
+    bool send (const OSCBundle& bundle)
+    {
+        const ScopedLock sl (sendLock);
+        outStream.reset();
+
+        return outStream.writeBundle (bundle)
+            && sendToAllTargets (static_cast<const char*> (outStream.getData()), (int) outStream.getDataSize());
+    }
+
+    //==============================================================================
+    bool startRealtimeSending (int fifoSizeInBytes, int intervalMilliseconds, int maxPacketSizeToUse)
+    {
+        stopRealtimeSending();
+
+        // if you hit this, you need to call OSCSender::connect() first.
+        jassert (socket != nullptr);
+
+        if (socket == nullptr || fifoSizeInBytes <= 0 || maxPacketSizeToUse < 64)
+            return false;
+
+        fifoData.calloc ((size_t) fifoSizeInBytes);
+        fifo = new AbstractFifo (fifoSizeInBytes);
+        packets.calloc ((size_t) (maxPacketSizeToUse * maxPacketsPerSend));
+        maxPacketSize = maxPacketSizeToUse;
+        sendInterval = jmax (1, intervalMilliseconds);
+        numDropped = 0;
+
+        startThread (8);
+        isRealtimeSending = 1;
+        return true;
+    }
+
+    void stopRealtimeSending()
+    {
+        // Once the flag is cleared, no new sendRealtime() call can touch the fifo, so
+        // after any that are already running have finished, it's safe to delete it.
+        isRealtimeSending = 0;
+
+        while (numRealtimeWriters.get() != 0)
+            Thread::yield();
+
+        if (isThreadRunning())
+        {
+            signalThreadShouldExit();
+            notify();
+            stopThread (4000);
+        }
+
+        fifo = nullptr;
+    }
+
+    bool sendRealtime (const char* addressPattern, char typeTag, const void* values, int numValues) noexcept
+    {
+        ++numRealtimeWriters;
+
+        auto ok = isRealtimeSending.get() != 0
+                    && writeToFifo (addressPattern, typeTag, values, numValues);
+
+        --numRealtimeWriters;
+        return ok;
     }
 
-    bool send (const OSCMessage& message)   { return send (message, targetHostName, targetPortNumber); }
-    bool send (const OSCBundle& bundle)     { return send (bundle,  targetHostName, targetPortNumber); }
+    int getNumDroppedRealtimeMessages() const noexcept    { return numDropped.get(); }
 
 private:
     //==============================================================================
-    bool sendOutputStream (OSCOutputStream& outStream, const String& hostName, int portNumber)
+    bool writeToFifo (const char* addressPattern, char typeTag, const void* values, int numValues) noexcept
+    {
+        auto* f = fifo.get();
+
+        if (f == nullptr || addressPattern == nullptr || numValues < 0)
+            return false;
+
+        // OSC address patterns must begin with a '/'
+        jassert (*addressPattern == '/');
+
+        auto addressSize = getPaddedSize (strlen (addressPattern) + 1);
+        auto typeTagSize = getPaddedSize ((size_t) numValues + 2);
+        auto messageSize = (int) (addressSize + typeTagSize + 4 * (size_t) numValues);
+
+        // this message is too large to fit into a single datagram
+        jassert (messageSize + 4 <= maxPacketSize - bundleHeaderSize);
+
+        if (messageSize + 4 > maxPacketSize - bundleHeaderSize)
+            return false;
+
+        int start1, size1, start2, size2;
+        f->prepareToWrite (messageSize + 4, start1, size1, start2, size2);
+
+        if (size1 + size2 < messageSize + 4)
+        {
+            ++numDropped;
+            return false;
+        }
+
+        FifoWriter writer { fifoData, start1, size1, start2 };
+        writer.write (&messageSize, 4);
+        writer.write (addressPattern, strlen (addressPattern));
+        writer.writeZeros (addressSize - strlen (addressPattern));
+        writer.write (",", 1);
+
+        for (int i = 0; i < numValues; ++i)
+            writer.write (&typeTag, 1);
+
+        writer.writeZeros (typeTagSize - (size_t) numValues - 1);
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            auto value = ByteOrder::swapIfLittleEndian (static_cast<const uint32*> (values)[i]);
+            writer.write (&value, 4);
+        }
+
+        f->finishedWrite (messageSize + 4);
+        return true;
+    }
+
+    //==============================================================================
+    struct Target
+    {
+        String hostName;
+        int portNumber = 0;
+
+       #if JUCE_LINUX
+        struct sockaddr_storage address;
+        socklen_t addressLength = 0;
+       #endif
+    };
+
+    /** Writes bytes into the two blocks returned by AbstractFifo::prepareToWrite(). */
+    struct FifoWriter
+    {
+        char* data;
+        int position, size1, start2;
+
+        void write (const void* source, size_t numBytes) noexcept
+        {
+            auto* src = static_cast<const char*> (source);
+
+            while (numBytes > 0)
+            {
+                auto num = prepare (numBytes);
+                memcpy (data + position, src, num);
+                src += num;
+                numBytes -= num;
+                position += (int) num;
+            }
+        }
+
+        void writeZeros (size_t numBytes) noexcept
+        {
+            while (numBytes > 0)
+            {
+                auto num = prepare (numBytes);
+                zeromem (data + position, num);
+                numBytes -= num;
+                position += (int) num;
+            }
+        }
+
+        size_t prepare (size_t numBytes) noexcept
+        {
+            if (size1 == 0)
+            {
+                position = start2;
+                size1 = -1;
+            }
+
+            if (size1 < 0)
+                return numBytes;
+
+            auto num = jmin (numBytes, (size_t) size1);
+            size1 -= (int) num;
+            return num;
+        }
+    };
+
+    enum { maxPacketsPerSend = 32, bundleHeaderSize = 16 };
+
+    static size_t getPaddedSize (size_t numBytes) noexcept    { return (numBytes + 3) & ~(size_t) 3; }
+
+    //==============================================================================
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (sendInterval);
+            sendQueuedMessages();
+        }
+
+        sendQueuedMessages();
+    }
+
+    /** Packs the messages in the FIFO into as few datagrams as possible, wrapping
+        them in a bundle when more than one will fit, and sends these to all targets.
+    */
+    void sendQueuedMessages()
+    {
+        int start1, size1, start2, size2;
+        fifo->prepareToRead (fifo->getNumReady(), start1, size1, start2, size2);
+
+        auto numBytes = size1 + size2;
+        auto readPosition = 0;
+        int numPackets = 0, packetSize = 0, numInPacket = 0;
+        int packetSizes[maxPacketsPerSend];
+
+        auto readFromFifo = [&] (void* dest, int num)
+        {
+            auto* d = static_cast<char*> (dest);
+
+            if (readPosition < size1)
+            {
+                auto numFromBlock1 = jmin (num, size1 - readPosition);
+                memcpy (d, fifoData + start1 + readPosition, (size_t) numFromBlock1);
+                d += numFromBlock1;
+                num -= numFromBlock1;
+                readPosition += numFromBlock1;
+            }
+
+            memcpy (d, fifoData + start2 + readPosition - size1, (size_t) num);
+            readPosition += num;
+        };
+
+        auto finishPacket = [&]
+        {
+            if (numInPacket == 0)
+                return;
+
+            auto* packet = packets + numPackets * maxPacketSize;
+
+            if (numInPacket == 1)
+            {
+                // a single message is sent on its own rather than in a bundle
+                packetSize -= bundleHeaderSize + 4;
+                memmove (packet, packet + bundleHeaderSize + 4, (size_t) packetSize);
+            }
+            else
+            {
+                memcpy (packet, "#bundle\0\0\0\0\0\0\0\0\1", (size_t) bundleHeaderSize);
+            }
+
+            packetSizes[numPackets++] = packetSize;
+            numInPacket = 0;
+
+            if (numPackets == maxPacketsPerSend)
+            {
+                sendPackets (packets, packetSizes, numPackets);
+                numPackets = 0;
+            }
+        };
+
+        while (readPosition < numBytes)
+        {
+            int messageSize;
+            readFromFifo (&messageSize, 4);
+
+            if (numInPacket > 0 && packetSize + 4 + messageSize > maxPacketSize)
+                finishPacket();
+
+            if (numInPacket == 0)
+                packetSize = bundleHeaderSize;
+
+            auto* packet = packets + numPackets * maxPacketSize;
+            auto bigEndianSize = ByteOrder::swapIfLittleEndian ((uint32) messageSize);
+            memcpy (packet + packetSize, &bigEndianSize, 4);
+            readFromFifo (packet + packetSize + 4, messageSize);
+            packetSize += 4 + messageSize;
+            ++numInPacket;
+        }
+
+        finishPacket();
+
+        if (numPackets > 0)
+            sendPackets (packets, packetSizes, numPackets);
+
+        fifo->finishedRead (numBytes);
+    }
+
+    void sendPackets (const char* data, const int* sizes, int numPackets)
+    {
+        const ScopedLock sl (sendLock);
+
+        if (socket == nullptr)
+            return;
+
+       #if JUCE_LINUX
+        // all the packets go to all the targets with as few calls to sendmmsg() as possible
+        auto numMessages = (size_t) (numPackets * targets.size());
+
+        if (numMessages > numHeadersAllocated)
+        {
+            headers.calloc (numMessages);
+            vectors.calloc (numMessages);
+            numHeadersAllocated = numMessages;
+        }
+
+        size_t n = 0;
+
+        for (auto& target : targets)
+        {
+            for (int i = 0; i < numPackets; ++i, ++n)
+            {
+                vectors[n].iov_base = const_cast<char*> (data + i * maxPacketSize);
+                vectors[n].iov_len = (size_t) sizes[i];
+
+                zerostruct (headers[n]);
+                headers[n].msg_hdr.msg_name = &target.address;
+                headers[n].msg_hdr.msg_namelen = target.addressLength;
+                headers[n].msg_hdr.msg_iov = vectors + n;
+                headers[n].msg_hdr.msg_iovlen = 1;
+            }
+        }
+
+        for (size_t sent = 0; sent < numMessages;)
+        {
+            auto result = sendmmsg (socket->getRawSocketHandle(), headers + sent, (unsigned int) (numMessages - sent), 0);
+
+            if (result <= 0)
+            {
+                if (result < 0 && errno == EINTR)
+                    continue;
+
+                break;
+            }
+
+            sent += (size_t) result;
+        }
+       #else
+        for (auto& target : targets)
+            for (int i = 0; i < numPackets; ++i)
+                socket->write (target.hostName, target.portNumber, data + i * maxPacketSize, sizes[i]);
+       #endif
+    }
+
+    bool sendToAllTargets (const char* data, int size)
+    {
+        if (socket != nullptr)
+        {
+            bool ok = ! targets.isEmpty();
+
+           #if JUCE_LINUX
+            for (auto& target : targets)
+                ok = sendto (socket->getRawSocketHandle(), data, (size_t) size, 0,
+                             (const struct sockaddr*) &target.address, target.addressLength) == size && ok;
+           #else
+            for (auto& target : targets)
+                ok = socket->write (target.hostName, target.portNumber, data, size) == size && ok;
+           #endif
+
+            return ok;
+        }
+
+        // if you hit this, you tried to send some OSC data without being
+        // connected to a port! You should call OSCSender::connect() first.
+        jassertfalse;
+
+        return false;
+    }
+
+    bool sendOutputStream (const String& hostName, int portNumber)
     {
         if (socket != nullptr)
         {
@@ -274,8 +680,20 @@ private:
 
     //==============================================================================
     ScopedPointer<DatagramSocket> socket;
-    String targetHostName;
-    int targetPortNumber = 0;
+    Array<Target> targets;
+    OSCOutputStream outStream;
+    CriticalSection sendLock;
+
+    ScopedPointer<AbstractFifo> fifo;
+    HeapBlock<char> fifoData, packets;
+    int maxPacketSize = 0, sendInterval = 1;
+    Atomic<int> numDropped, isRealtimeSending, numRealtimeWriters;
+
+   #if JUCE_LINUX
+    HeapBlock<struct mmsghdr> headers;
+    HeapBlock<struct iovec> vectors;
+    size_t numHeadersAllocated = 0;
+   #endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
 };
@@ -303,6 +721,16 @@ bool OSCSender::disconnect()
     return pimpl->disconnect();
 }
 
+bool OSCSender::addTarget (const String& targetHostName, int targetPortNumber)
+{
+    return pimpl->addTarget (targetHostName, targetPortNumber);
+}
+
+void OSCSender::removeTarget (const String& targetHostName, int targetPortNumber)
+{
+    pimpl->removeTarget (targetHostName, targetPortNumber);
+}
+
 //==============================================================================
 bool OSCSender::send (const OSCMessage& message)    { return pimpl->send (message); }
 bool OSCSender::send (const OSCBundle& bundle)      { return pimpl->send (bundle); }
@@ -310,6 +738,32 @@ bool OSCSender::send (const OSCBundle& bundle)      { return pimpl->send (bundle
 bool OSCSender::sendToIPAddress (const String& host, int port, const OSCMessage& message) { return pimpl->send (message, host, port); }
 bool OSCSender::sendToIPAddress (const String& host, int port, const OSCBundle& bundle)   { return pimpl->send (bundle,  host, port); }
 
+//==============================================================================
+bool OSCSender::startRealtimeSending (int fifoSize, int interval, int maxPacketSize)
+{
+    return pimpl->startRealtimeSending (fifoSize, interval, maxPacketSize);
+}
+
+void OSCSender::stopRealtimeSending()
+{
+    pimpl->stopRealtimeSending();
+}
+
+bool OSCSender::sendRealtime (const char* addressPattern, const float* values, int numValues) noexcept
+{
+    return pimpl->sendRealtime (addressPattern, 'f', values, numValues);
+}
+
+bool OSCSender::sendRealtime (const char* addressPattern, const int32* values, int numValues) noexcept
+{
+    return pimpl->sendRealtime (addressPattern, 'i', values, numValues);
+}
+
+int OSCSender::getNumDroppedRealtimeMessages() const noexcept
+{
+    return pimpl->getNumDroppedRealtimeMessages();
+}
+
 //==============================================================================
 //==============================================================================
 #if JUCE_UNIT_TESTS
@@ -845,6 +1299,179 @@ public:
 
 static OSCRoundTripTests OSCRoundTripUnitTests;
 
+//==============================================================================
+class OSCSenderTests  : public UnitTest
+{
+public:
+    OSCSenderTests() : UnitTest ("OSCSender class", "OSC") {}
+
+    /** Reads the datagrams waiting on a socket, and returns the messages that they contain. */
+    Array<OSCMessage> receiveMessages (DatagramSocket& socket, int& numPackets)
+    {
+        Array<OSCMessage> messages;
+        HeapBlock<char> buffer (2048);
+
+        while (socket.waitUntilReady (true, 200) > 0)
+        {
+            auto size = socket.read (buffer, 2048, false);
+
+            if (size <= 0)
+                break;
+
+            ++numPackets;
+            OSCInputStream input (buffer, (size_t) size);
+            auto content = input.readElementWithKnownSize ((size_t) size);
+
+            if (content.isMessage())
+                messages.add (content.getMessage());
+            else
+                for (auto& element : content.getBundle())
+                    messages.add (element.getMessage());
+        }
+
+        return messages;
+    }
+
+    void runTest()
+    {
+        DatagramSocket target1, target2;
+        expect (target1.bindToPort (0, "127.0.0.1"));
+        expect (target2.bindToPort (0, "127.0.0.1"));
+
+        OSCSender sender;
+        expect (sender.connect ("127.0.0.1", target1.getBoundPort()));
+        expect (sender.addTarget ("127.0.0.1", target2.getBoundPort()));
+
+        beginTest ("sending to multiple targets");
+        {
+            expect (sender.send (OSCMessage ("/test/three_args", 1, 2.0f, String ("three"))));
+
+            for (auto* target : { &target1, &target2 })
+            {
+                int numPackets = 0;
+                auto messages = receiveMessages (*target, numPackets);
+
+                expectEquals (messages.size(), 1);
+
+                if (messages.size() == 1)
+                {
+                    expectEquals (messages.getReference (0).size(), 3);
+                    expectEquals (messages.getReference (0)[2].getString(), String ("three"));
+                }
+            }
+        }
+
+        beginTest ("realtime sending");
+        {
+            expect (sender.startRealtimeSending (65536, 1000));
+
+            for (int i = 0; i < 100; ++i)
+            {
+                const float values[] = { (float) i, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+                expect (sender.sendRealtime ("/meter/level", values, numElementsInArray (values)));
+            }
+
+            const int32 ints[] = { 123 };
+            expect (sender.sendRealtime ("/meter/count", ints, 1));
+
+            // stopping sends anything that is still queued
+            sender.stopRealtimeSending();
+            expect (! sender.sendRealtime ("/meter/count", ints, 1));
+
+            for (auto* target : { &target1, &target2 })
+            {
+                int numPackets = 0;
+                auto messages = receiveMessages (*target, numPackets);
+
+                expectEquals (messages.size(), 101);
+                expect (numPackets > 1 && numPackets < 10);
+
+                if (messages.size() == 101)
+                {
+                    expectEquals (messages.getReference (0).getAddressPattern().toString(), String ("/meter/level"));
+                    expectEquals (messages.getReference (57)[0].getFloat32(), 57.0f);
+                    expectEquals (messages.getReference (57)[7].getFloat32(), 7.0f);
+                    expectEquals (messages.getReference (100)[0].getInt32(), 123);
+                }
+            }
+
+            expectEquals (sender.getNumDroppedRealtimeMessages(), 0);
+        }
+
+        beginTest ("dropping realtime messages when the FIFO is full");
+        {
+            expect (sender.startRealtimeSending (256, 1000));
+
+            const float value = 1.0f;
+            int numSent = 0;
+
+            for (int i = 0; i < 20; ++i)
+                if (sender.sendRealtime ("/full", &value, 1))
+                    ++numSent;
+
+            expect (numSent < 20);
+            expectEquals (sender.getNumDroppedRealtimeMessages(), 20 - numSent);
+            sender.stopRealtimeSending();
+
+            int numPackets = 0;
+            expectEquals (receiveMessages (target1, numPackets).size(), numSent);
+            receiveMessages (target2, numPackets);
+        }
+
+        beginTest ("stopping realtime sending while another thread is sending");
+        {
+            struct SendingThread  : public Thread
+            {
+                SendingThread (OSCSender& s)  : Thread ("OSC test sender"), sender (s) {}
+
+                void run() override
+                {
+                    const float value = 1.0f;
+
+                    while (! threadShouldExit())
+                        if (sender.sendRealtime ("/busy", &value, 1))
+                            ++numSent;
+                }
+
+                OSCSender& sender;
+                int numSent = 0;
+            };
+
+            SendingThread thread (sender);
+            thread.startThread();
+
+            for (int i = 0; i < 20; ++i)
+            {
+                expect (sender.startRealtimeSending (1024, 1));
+                Thread::sleep (2);
+                sender.stopRealtimeSending();
+            }
+
+            thread.stopThread (4000);
+            expect (thread.numSent > 0);
+
+            int numPackets = 0;
+            receiveMessages (target1, numPackets);
+            receiveMessages (target2, numPackets);
+        }
+
+        beginTest ("sending with no targets");
+        {
+            sender.removeTarget ("127.0.0.1", target1.getBoundPort());
+            sender.removeTarget ("127.0.0.1", target2.getBoundPort());
+            expect (! sender.send (OSCMessage ("/nobody/listening")));
+
+           #if JUCE_LINUX
+            // (only Linux looks up the address when the target is added)
+            OSCSender unresolvable;
+            expect (! unresolvable.connect ("", 9000));
+           #endif
+        }
+    }
+};
+
+static OSCSenderTests OSCSenderUnitTests;
+
 //==============================================================================
 #endif // JUCE_UNIT_TESTS
 
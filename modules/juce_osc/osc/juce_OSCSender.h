@@ -33,6 +33,14 @@ namespace juce
 
     An OSCSender object can connect to a network port. It then can send OSC
     messages and bundles to a specified host over an UDP socket.
+
+    Further targets can be added with addTarget(), in which case everything that
+    is sent goes to all of them.
+
+    For sending from a realtime thread, such as the audio callback, call
+    startRealtimeSending() and then use sendRealtime(). These messages are written
+    to a pre-allocated FIFO and sent by a background thread, which packs as many of
+    them as will fit into each datagram.
  */
 class JUCE_API  OSCSender
 {
@@ -69,6 +77,20 @@ public:
     */
     bool disconnect();
 
+    //==============================================================================
+    /** Adds another target to which messages will be sent, in addition to the one
+        passed to connect().
+
+        Calling connect() again replaces all the targets with the new one.
+
+        @returns true if the host name could be resolved; false otherwise.
+        @see removeTarget
+    */
+    bool addTarget (const String& targetHostName, int targetPortNumber);
+
+    /** Removes a target that was added with addTarget() or connect(). */
+    void removeTarget (const String& targetHostName, int targetPortNumber);
+
     //==============================================================================
     /** Sends an OSC message to the target.
         @param  message   The OSC message to send.
@@ -127,6 +149,53 @@ public:
                           const OSCAddressPattern& address, Args&&... args);
    #endif
 
+    //==============================================================================
+    /** Starts a background thread which sends the messages passed to sendRealtime().
+
+        @param fifoSizeInBytes      The size of the FIFO that holds the messages until
+                                    the thread sends them.
+        @param intervalMilliseconds How often the thread sends the messages that have
+                                    been queued. A longer interval lets more messages
+                                    share a datagram.
+        @param maxPacketSize        The largest datagram that will be sent. The default
+                                    fits into a standard ethernet MTU.
+
+        @returns true if the sender is connected and the thread was started.
+        @see sendRealtime, stopRealtimeSending
+    */
+    bool startRealtimeSending (int fifoSizeInBytes = 65536,
+                               int intervalMilliseconds = 2,
+                               int maxPacketSize = 1472);
+
+    /** Stops the thread started by startRealtimeSending(), after sending anything
+        that was left in its FIFO.
+    */
+    void stopRealtimeSending();
+
+    /** Queues a message containing some float32 arguments, to be sent to all the targets.
+
+        This doesn't allocate or lock, so can be called from a realtime thread, but only
+        one thread at a time may call it.
+
+        @param addressPattern  The OSC address pattern of the message, as a null-terminated
+                               UTF-8 string which must begin with a '/'.
+        @param values          The arguments for the message.
+        @param numValues       The number of arguments.
+        @returns false if startRealtimeSending() hasn't been called, if the FIFO is full,
+                 or if the message is too large to fit into a datagram.
+    */
+    bool sendRealtime (const char* addressPattern, const float* values, int numValues) noexcept;
+
+    /** Queues a message containing some int32 arguments, to be sent to all the targets.
+        @see sendRealtime
+    */
+    bool sendRealtime (const char* addressPattern, const int32* values, int numValues) noexcept;
+
+    /** Returns the number of messages that sendRealtime() has had to drop because the
+        FIFO was full.
+    */
+    int getNumDroppedRealtimeMessages() const noexcept;
+
 private:
     //==============================================================================
     struct Pimpl;